@@ -99,6 +99,9 @@
 #define NETCALC_ESETMOD                -13
 #define NETCALC_ERANGE                 -14
 #define NETCALC_EBADFAM                -15
+#define NETCALC_EIO                    -16
+#define NETCALC_EBADFILE               -17
+#define NETCALC_EOBSERVER              -18  // modification was applied, but an observer failed
 
 
 #define NETCALC_FLD_FAMILY             0
@@ -133,9 +136,9 @@
 //                                     0x00000020  // flag: OPEN
 //                                     0x00000040  // flag: OPEN
 //                                     0x00000080  // flag: OPEN
-//                                     0x00000100  // flag: OPEN
-//                                     0x00000200  // flag: OPEN
-//                                     0x00000400  // flag: OPEN
+#define NETCALC_FLG_FILTER             0x00000100  // flag set: reject queries with filter of prefixes
+#define NETCALC_FLG_HOSTS              0x00000200  // flag set: index host records by address
+#define NETCALC_FLG_COUNT              0x00000400  // flag set: count queries matching records
 #define NETCALC_FLG_UNIQ               0x00000800  // flag set: require unique subnets
 #define NETCALC_USR                    0x0000f000  // user: mask for user reserved flags
 #define NETCALC_FLG_USR1               0x00001000  // user: reserved for use by library users
@@ -180,6 +183,9 @@
                                           | NETCALC_AF \
                                        )
 #define NETCALC_FLGS_SET               (  NETCALC_FLG_UNIQ \
+                                          | NETCALC_FLG_COUNT \
+                                          | NETCALC_FLG_HOSTS \
+                                          | NETCALC_FLG_FILTER \
                                           | NETCALC_FLG_IFACE \
                                           | NETCALC_FLG_PORT \
                                           | NETCALC_FLG_NETWORK \
@@ -225,6 +231,33 @@
 #define  NETCALC_CMP_AFTER             NETCALC_IDX_AFTER
 
 
+#define  NETCALC_MOD_ADD               1  // modification: record was added
+#define  NETCALC_MOD_DEL               2  // modification: record was deleted
+#define  NETCALC_MOD_UPDATE            3  // modification: comment, data, or flags of record were updated
+
+
+// categories of the IANA special-purpose address registries [RFC6890]
+#define  NETCALC_CLASS_UNSPECIFIED     0x0001  // class: unspecified address or "this network" [RFC1122]
+#define  NETCALC_CLASS_LOOPBACK        0x0002  // class: loopback addresses [RFC1122][RFC4291]
+#define  NETCALC_CLASS_PRIVATE         0x0004  // class: private-use networks [RFC1918]
+#define  NETCALC_CLASS_SHARED          0x0008  // class: shared address space [RFC6598]
+#define  NETCALC_CLASS_LINK_LOCAL      0x0010  // class: link-local addresses [RFC3927][RFC4291]
+#define  NETCALC_CLASS_MULTICAST       0x0020  // class: multicast addresses [RFC5771][RFC4291]
+#define  NETCALC_CLASS_DOCUMENTATION   0x0040  // class: documentation networks [RFC5737][RFC3849][RFC9637]
+#define  NETCALC_CLASS_BENCHMARK       0x0080  // class: benchmarking networks [RFC2544][RFC5180]
+#define  NETCALC_CLASS_PROTOCOL        0x0100  // class: IETF protocol assignments [RFC6890][RFC2928]
+#define  NETCALC_CLASS_RESERVED        0x0200  // class: reserved for future use [RFC1112]
+#define  NETCALC_CLASS_BROADCAST       0x0400  // class: limited broadcast address [RFC919]
+#define  NETCALC_CLASS_UNIQUE_LOCAL    0x0800  // class: unique local addresses [RFC4193]
+#define  NETCALC_CLASS_IPV4_MAPPED     0x1000  // class: IPv4 mapped IPv6 addresses [RFC4291]
+#define  NETCALC_CLASS_TRANSITION      0x2000  // class: translation and tunneling prefixes [RFC6052][RFC4380][RFC3056]
+#define  NETCALC_CLASS_DISCARD         0x4000  // class: discard-only prefix [RFC6666]
+#define  NETCALC_CLASS_AS112           0x8000  // class: AS112 DNS service [RFC7534][RFC7535]
+
+
+#define  NETCALC_SMALLSET_MAX          64      // maximum number of networks within small set
+
+
 //////////////////
 //              //
 //  Data Types  //
@@ -236,8 +269,13 @@ typedef union  _libnetcalc_address     netcalc_addr_t;
 typedef struct _libnetcalc_cursor      netcalc_cur_t;
 typedef struct _libnetcalc_network     netcalc_net_t;
 typedef struct _libnetcalc_record      netcalc_rec_t;
+typedef struct _libnetcalc_rcu         netcalc_rcu_t;
+typedef struct _libnetcalc_range_set   netcalc_rset_t;
 typedef struct _libnetcalc_records     netcalc_recs_t;
 typedef struct _libnetcalc_set         netcalc_set_t;
+typedef struct _libnetcalc_small_set   netcalc_smallset_t;
+typedef struct _libnetcalc_subnet_iter netcalc_subnet_iter_t;
+typedef struct _libnetcalc_superblock  netcalc_superblock_acc_t;
 
 
 /////////////////
@@ -276,6 +314,16 @@ netcalc_cur_init(
          netcalc_cur_t **              curp );
 
 
+_NETCALC_F int
+netcalc_cur_last(
+         netcalc_cur_t *               cur,
+         netcalc_net_t **              netp,
+         char **                       commentp,
+         void **                       datap,
+         int *                         flagsp,
+         int *                         depthp );
+
+
 _NETCALC_F int
 netcalc_cur_next(
          netcalc_cur_t *               cur,
@@ -286,6 +334,51 @@ netcalc_cur_next(
          int *                         depthp );
 
 
+_NETCALC_F int
+netcalc_cur_prev(
+         netcalc_cur_t *               cur,
+         netcalc_net_t **              netp,
+         char **                       commentp,
+         void **                       datap,
+         int *                         flagsp,
+         int *                         depthp );
+
+
+_NETCALC_F netcalc_rec_t *
+netcalc_cur_record(
+         netcalc_cur_t *               cur );
+
+
+_NETCALC_F int
+netcalc_cur_seek(
+         netcalc_cur_t *               cur,
+         const netcalc_net_t *         net,
+         netcalc_net_t **              netp,
+         char **                       commentp,
+         void **                       datap,
+         int *                         flagsp,
+         int *                         depthp );
+
+
+_NETCALC_F int
+netcalc_net_add(
+         netcalc_net_t *               net,
+         uint64_t                      offset );
+
+
+_NETCALC_F int
+netcalc_net_classify(
+         const netcalc_net_t *         net,
+         uint32_t *                    classp );
+
+
+_NETCALC_F int
+netcalc_net_classify_batch(
+         const netcalc_net_t * const * nets,
+         uint32_t *                    classes,
+         size_t                        nel );
+
+
 _NETCALC_F int
 netcalc_net_cmp(
          const netcalc_net_t *         n1,
@@ -300,6 +393,13 @@ netcalc_net_convert(
          const netcalc_net_t *         prefix );
 
 
+_NETCALC_F int
+netcalc_net_distance(
+         const netcalc_net_t *         n1,
+         const netcalc_net_t *         n2,
+         uint64_t *                    distp );
+
+
 _NETCALC_F int
 netcalc_net_dup(
          netcalc_net_t **              netp,
@@ -332,6 +432,19 @@ netcalc_net_mask(
          int                           cidr );
 
 
+_NETCALC_F int
+netcalc_net_range(
+         const netcalc_net_t *         net,
+         netcalc_net_t **              firstp,
+         netcalc_net_t **              lastp );
+
+
+_NETCALC_F int
+netcalc_net_sub(
+         netcalc_net_t *               net,
+         uint64_t                      offset );
+
+
 _NETCALC_F int
 netcalc_net_superblock(
          netcalc_net_t **              netp,
@@ -354,6 +467,177 @@ netcalc_ntop(
          int                           flags );
 
 
+_NETCALC_F void
+netcalc_range_free(
+         netcalc_net_t **              nets );
+
+
+_NETCALC_F int
+netcalc_range_to_cidrs(
+         const netcalc_net_t *         first,
+         const netcalc_net_t *         last,
+         netcalc_net_t ***             netsp,
+         size_t *                      lenp );
+
+
+_NETCALC_F void
+netcalc_rcu_abort(
+         netcalc_rcu_t *               rcu,
+         netcalc_set_t *               ns );
+
+
+_NETCALC_F int
+netcalc_rcu_begin(
+         netcalc_rcu_t *               rcu,
+         netcalc_set_t **              nsp );
+
+
+_NETCALC_F int
+netcalc_rcu_commit(
+         netcalc_rcu_t *               rcu,
+         netcalc_set_t *               ns );
+
+
+_NETCALC_F void
+netcalc_rcu_free(
+         netcalc_rcu_t *               rcu );
+
+
+_NETCALC_F int
+netcalc_rcu_init(
+         netcalc_rcu_t **              rcup,
+         netcalc_set_t *               ns,
+         int                           readers );
+
+
+_NETCALC_F netcalc_set_t *
+netcalc_rcu_read_lock(
+         netcalc_rcu_t *               rcu,
+         int                           reader );
+
+
+_NETCALC_F void
+netcalc_rcu_read_unlock(
+         netcalc_rcu_t *               rcu,
+         int                           reader );
+
+
+_NETCALC_F int
+netcalc_rcu_register(
+         netcalc_rcu_t *               rcu,
+         int *                         readerp );
+
+
+_NETCALC_F void
+netcalc_rcu_unregister(
+         netcalc_rcu_t *               rcu,
+         int                           reader );
+
+
+// handles of records remain valid while netcalc_rec_serial() of the set is
+// unchanged, the serial changes when records of the set are deleted, when
+// records shared with a clone are copied, and when a set opened from a
+// snapshot is first modified; netcalc_rec_update() returns NETCALC_ESETMOD
+// for handles returned at a previous serial
+_NETCALC_F const char *
+netcalc_rec_comment(
+         const netcalc_rec_t *         rec );
+
+
+_NETCALC_F void *
+netcalc_rec_data(
+         const netcalc_rec_t *         rec );
+
+
+_NETCALC_F int
+netcalc_rec_flags(
+         const netcalc_rec_t *         rec );
+
+
+_NETCALC_F int
+netcalc_rec_get(
+         const netcalc_rec_t *         rec,
+         netcalc_net_t **              netp,
+         char **                       commentp,
+         void **                       datap,
+         int *                         flagsp );
+
+
+_NETCALC_F uintmax_t
+netcalc_rec_hits(
+         const netcalc_rec_t *         rec );
+
+
+_NETCALC_F uint32_t
+netcalc_rec_serial(
+         const netcalc_set_t *         ns );
+
+
+_NETCALC_F int
+netcalc_rec_update(
+         netcalc_set_t *               ns,
+         netcalc_rec_t *               rec,
+         uint32_t                      serial,
+         const char *                  comment,
+         void *                        data,
+         int                           flags,
+         netcalc_rec_t **              recp );
+
+
+_NETCALC_F int
+netcalc_rset_add(
+         netcalc_rset_t *              rs,
+         const netcalc_net_t *         first,
+         const netcalc_net_t *         last,
+         const char *                  comment,
+         void *                        data );
+
+
+_NETCALC_F int
+netcalc_rset_add_str(
+         netcalc_rset_t *              rs,
+         const char *                  address,
+         const char *                  comment,
+         void *                        data );
+
+
+_NETCALC_F void
+netcalc_rset_free(
+         netcalc_rset_t *              rs );
+
+
+_NETCALC_F int
+netcalc_rset_init(
+         netcalc_rset_t **             rsp );
+
+
+_NETCALC_F int
+netcalc_rset_query(
+         netcalc_rset_t *              rs,
+         const netcalc_net_t *         net,
+         netcalc_net_t **              firstp,
+         netcalc_net_t **              lastp,
+         char **                       commentp,
+         void **                       datap );
+
+
+_NETCALC_F int
+netcalc_rset_query_str(
+         netcalc_rset_t *              rs,
+         const char *                  address,
+         netcalc_net_t **              firstp,
+         netcalc_net_t **              lastp,
+         char **                       commentp,
+         void **                       datap );
+
+
+_NETCALC_F int
+netcalc_rset_stats(
+         netcalc_rset_t *              rs,
+         size_t *                      lenp,
+         size_t *                      sizep );
+
+
 _NETCALC_F int
 netcalc_set_add(
          netcalc_set_t *               ns,
@@ -363,6 +647,16 @@ netcalc_set_add(
          int                           flags );
 
 
+_NETCALC_F int
+netcalc_set_add_range(
+         netcalc_set_t *               ns,
+         const char *                  address,
+         const char *                  comment,
+         void *                        data,
+         int                           flags,
+         netcalc_net_t **              lastp );
+
+
 _NETCALC_F int
 netcalc_set_add_str(
          netcalc_set_t *               ns,
@@ -372,17 +666,121 @@ netcalc_set_add_str(
          int                           flags );
 
 
+_NETCALC_F int
+netcalc_set_allocate(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         parent,
+         int                           cidr,
+         const char *                  comment,
+         void *                        data,
+         int                           flags,
+         netcalc_net_t **              netp );
+
+
+_NETCALC_F int
+netcalc_set_cache(
+         netcalc_set_t *               ns,
+         size_t                        size );
+
+
+_NETCALC_F void
+netcalc_set_cache_stats(
+         const netcalc_set_t *         ns,
+         size_t *                      sizep,
+         uintmax_t *                   hitsp,
+         uintmax_t *                   missesp );
+
+
+_NETCALC_F int
+netcalc_set_clone(
+         netcalc_set_t **              nsp,
+         netcalc_set_t *               ns );
+
+
+_NETCALC_F int
+netcalc_set_compact(
+         netcalc_set_t *               ns,
+         const char *                  snapshot );
+
+
 _NETCALC_F void
 netcalc_set_debug(
          netcalc_set_t *               ns,
          const char *                  prefix );
 
 
+_NETCALC_F int
+netcalc_set_del(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net );
+
+
+_NETCALC_F int
+netcalc_set_diff(
+         const netcalc_set_t *         ns1,
+         const netcalc_set_t *         ns2,
+         int (*func)(void * ctx, int op, const netcalc_net_t * net, const char * comment1, const char * comment2),
+         void *                        ctx );
+
+
+_NETCALC_F int
+netcalc_set_export_compact(
+         netcalc_set_t *               ns,
+         const char *                  path );
+
+
+_NETCALC_F void
+netcalc_set_filter_stats(
+         const netcalc_set_t *         ns,
+         size_t *                      bitsp,
+         size_t *                      setp,
+         size_t *                      lensp,
+         uintmax_t *                   rejectsp,
+         uintmax_t *                   passesp,
+         uintmax_t *                   falsep );
+
+
 _NETCALC_F void
 netcalc_set_free(
          netcalc_set_t *               ns );
 
 
+_NETCALC_F int
+netcalc_set_free_blocks(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net,
+         netcalc_cur_t **              curp );
+
+
+_NETCALC_F void
+netcalc_set_hits_reset(
+         netcalc_set_t *               ns );
+
+
+_NETCALC_F int
+netcalc_set_hits_top(
+         netcalc_set_t *               ns,
+         const netcalc_rec_t **        recs,
+         size_t                        nel,
+         size_t *                      countp );
+
+
+_NETCALC_F void
+netcalc_set_hosts_stats(
+         const netcalc_set_t *         ns,
+         size_t *                      countp,
+         size_t *                      slotsp,
+         size_t *                      bytesp,
+         size_t *                      probesp,
+         size_t *                      maxprobep );
+
+
+_NETCALC_F int
+netcalc_set_import_compact(
+         netcalc_set_t **              nsp,
+         const char *                  path );
+
+
 _NETCALC_F int
 netcalc_set_init(
          netcalc_set_t **              nsp,
@@ -390,6 +788,33 @@ netcalc_set_init(
          int                           flags );
 
 
+_NETCALC_F int
+netcalc_set_journal(
+         netcalc_set_t *               ns,
+         const char *                  path );
+
+
+_NETCALC_F int
+netcalc_set_neighbors(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net,
+         const netcalc_rec_t **        prevp,
+         const netcalc_rec_t **        nextp );
+
+
+_NETCALC_F int
+netcalc_set_observe(
+         netcalc_set_t *               ns,
+         int (*func)(void * ctx, int op, const netcalc_net_t * net, const char * comment, void * data, int flags, uint32_t serial),
+         void *                        ctx );
+
+
+_NETCALC_F int
+netcalc_set_open_mmap(
+         netcalc_set_t **              nsp,
+         const char *                  path );
+
+
 _NETCALC_F int
 netcalc_set_query(
          netcalc_set_t *               ns,
@@ -400,6 +825,20 @@ netcalc_set_query(
          int *                         flagsp );
 
 
+_NETCALC_F int
+netcalc_set_query_chain(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net,
+         netcalc_cur_t **              curp );
+
+
+_NETCALC_F int
+netcalc_set_query_covered(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net,
+         netcalc_cur_t **              curp );
+
+
 _NETCALC_F int
 netcalc_set_query_str(
          netcalc_set_t *               ns,
@@ -410,6 +849,19 @@ netcalc_set_query_str(
          int *                         flagsp );
 
 
+_NETCALC_F int
+netcalc_set_replay(
+         netcalc_set_t **              nsp,
+         const char *                  snapshot,
+         const char *                  journal );
+
+
+_NETCALC_F int
+netcalc_set_save(
+         netcalc_set_t *               ns,
+         const char *                  path );
+
+
 _NETCALC_F int
 netcalc_set_stats(
          netcalc_set_t *               ns,
@@ -418,6 +870,55 @@ netcalc_set_stats(
          int *                         familiesp );
 
 
+_NETCALC_F int
+netcalc_set_unobserve(
+         netcalc_set_t *               ns,
+         int (*func)(void * ctx, int op, const netcalc_net_t * net, const char * comment, void * data, int flags, uint32_t serial),
+         void *                        ctx );
+
+
+_NETCALC_F int
+netcalc_set_update(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net,
+         const char *                  comment,
+         void *                        data,
+         int                           flags );
+
+
+// merge() is passed the existing record and the comment, data, and flags
+// being upserted, and may replace the values which are applied to the record
+_NETCALC_F int
+netcalc_set_upsert(
+         netcalc_set_t *               ns,
+         netcalc_net_t *               net,
+         const char *                  comment,
+         void *                        data,
+         int                           flags,
+         int (*merge)(void * ctx, const netcalc_rec_t * rec, const char ** commentp, void ** datap, int * flagsp),
+         void *                        ctx,
+         netcalc_rec_t **              recp );
+
+
+_NETCALC_F void
+netcalc_smallset_free(
+         netcalc_smallset_t *          ss );
+
+
+_NETCALC_F int
+netcalc_smallset_init(
+         netcalc_smallset_t **         ssp,
+         const netcalc_net_t * const * nets,
+         size_t                        nel );
+
+
+_NETCALC_F int
+netcalc_smallset_query(
+         const netcalc_smallset_t *    ss,
+         const netcalc_net_t *         net,
+         size_t *                      idxp );
+
+
 _NETCALC_F const char *
 netcalc_strcmp(
          int                           code );
@@ -437,4 +938,44 @@ netcalc_strfnet(
          int                           flags );
 
 
+_NETCALC_F void
+netcalc_subnet_iter_free(
+         netcalc_subnet_iter_t *       iter );
+
+
+_NETCALC_F int
+netcalc_subnet_iter_init(
+         netcalc_subnet_iter_t **      iterp,
+         const netcalc_net_t *         net,
+         int                           cidr );
+
+
+_NETCALC_F int
+netcalc_subnet_iter_next(
+         netcalc_subnet_iter_t *       iter,
+         netcalc_net_t **              netp );
+
+
+_NETCALC_F int
+netcalc_superblock_acc_add(
+         netcalc_superblock_acc_t *    acc,
+         const netcalc_net_t *         net );
+
+
+_NETCALC_F int
+netcalc_superblock_acc_finish(
+         netcalc_superblock_acc_t *    acc,
+         netcalc_net_t **              netp );
+
+
+_NETCALC_F void
+netcalc_superblock_acc_free(
+         netcalc_superblock_acc_t *    acc );
+
+
+_NETCALC_F int
+netcalc_superblock_acc_init(
+         netcalc_superblock_acc_t **   accp );
+
+
 #endif /* end of header */
@@ -79,6 +79,115 @@
 /////////////////
 // MARK: - Functions
 
+// returns 64-bit word of address, in host byte order, with the most
+// significant bytes first
+uint64_t
+netcalc_addr_be64(
+         const netcalc_addr_t *        addr,
+         int                           idx )
+{
+   uint64_t       word;
+#if defined(WORDS_BIGENDIAN)
+   memcpy(&word, &addr->addr8[idx * 8], sizeof(word));
+#elif defined(__GNUC__) || defined(__clang__)
+   memcpy(&word, &addr->addr8[idx * 8], sizeof(word));
+   word = __builtin_bswap64(word);
+#else
+   int            pos;
+   for(word = 0, pos = idx * 8; (pos < ((idx * 8) + 8)); pos++)
+      word = (word << 8) | addr->addr8[pos];
+#endif
+   return(word);
+}
+
+
+// stores 64-bit word in address with the most significant bytes first
+void
+netcalc_addr_be64_set(
+         netcalc_addr_t *              addr,
+         int                           idx,
+         uint64_t                      word )
+{
+   int            pos;
+   for(pos = (idx * 8) + 7; (pos >= (idx * 8)); pos--)
+   {  addr->addr8[pos] = (uint8_t)(word & 0xff);
+      word >>= 8;
+   };
+   return;
+}
+
+
+// returns prefix length of the largest aligned block which starts at
+// 'first' and does not extend past 'last'
+uint8_t
+netcalc_addr_block(
+         const netcalc_addr_t *        first,
+         const netcalc_addr_t *        last )
+{
+   int                     idx;
+   int                     align;
+   int                     span;
+   unsigned                bits;
+
+   assert(first != NULL);
+   assert(last  != NULL);
+
+   // determine alignment of first address (trailing zero bits)
+   for(idx = 15, align = 0; ((idx >= 0) && (!(first->addr8[idx]))); idx--)
+      align += 8;
+   if (idx >= 0)
+      for(bits = first->addr8[idx]; (!(bits & 0x01)); bits >>= 1)
+         align++;
+
+   span = netcalc_addr_span(first, last);
+
+   return((uint8_t)(128 - ((align < span) ? align : span)));
+}
+
+
+// rounds address up to the next boundary of the prefix length, returns
+// non-zero if address wrapped
+int
+netcalc_addr_ceil(
+         netcalc_addr_t *              addr,
+         uint8_t                       cidr )
+{
+   int                     idx;
+   const netcalc_addr_t *  mask;
+
+   assert(addr != NULL);
+
+   mask = &_netcalc_netmasks[cidr];
+   for(idx = 0; (idx < 4); idx++)
+      if ((addr->addr32[idx] & ~mask->addr32[idx]))
+         break;
+   if (idx == 4)
+      return(0);
+
+   netcalc_addr_last(addr, addr, cidr);
+
+   return(netcalc_addr_incr(addr));
+}
+
+
+// returns number of leading zero bits of a non-zero word
+unsigned
+netcalc_addr_clz(
+         uint64_t                      word )
+{
+#if defined(__GNUC__) || defined(__clang__)
+   return((unsigned)__builtin_clzll(word));
+#else
+   unsigned       bits;
+   for(bits = 0; (!(word & 0x8000000000000000ULL)); bits++)
+      word <<= 1;
+   return(bits);
+#endif
+}
+
+
+// compares addresses as two integers, the addresses are ordered by the
+// first differing bit if the shorter prefix includes the bit
 int
 netcalc_addr_cmp(
          const netcalc_addr_t *        a1,
@@ -86,31 +195,26 @@ netcalc_addr_cmp(
          const netcalc_addr_t *        a2,
          uint8_t                       c2 )
 {
-   uint8_t                 cidr;
-   uint32_t                idx8;
-   uint32_t                idx32;
-   uint8_t                 b1;   // byte 1 (32 bits)
-   uint8_t                 b2;   // byte 2 (32 bits)
-   uint32_t                t1;   // tetra 1 (32 bits)
-   uint32_t                t2;   // tetra 2 (32 bits)
-   const netcalc_addr_t *  mask;
-
-   cidr = (c1 < c2) ? c1 : c2;
-   mask = &_netcalc_netmasks[cidr];
+   unsigned                cidr;
+   unsigned                common;  // number of leading bits shared by addresses
+   uint64_t                w1;
+   uint64_t                w2;
+
+   cidr   = (c1 < c2) ? c1 : c2;
+   common = 0;
+
+   w1 = netcalc_addr_be64(a1, 0);
+   w2 = netcalc_addr_be64(a2, 0);
+   if ( (w1 == w2) && (cidr > 64) )
+   {  w1     = netcalc_addr_be64(a1, 1);
+      w2     = netcalc_addr_be64(a2, 1);
+      common = 64;
+   };
 
-   for(idx32 = 0; (idx32 < 4); idx32++)
-   {  t1 = mask->addr32[idx32] & a1->addr32[idx32];
-      t2 = mask->addr32[idx32] & a2->addr32[idx32];
-      if ( t1 != t2 )
-      {  for(idx8 = (idx32*4); (idx8 < ((idx32*4)+4)); idx8++)
-         {  b1 = mask->addr8[idx8] & a1->addr8[idx8];
-            b2 = mask->addr8[idx8] & a2->addr8[idx8];
-            if (b1 < b2)
-               return(NETCALC_CMP_BEFORE);
-            if (b1 > b2)
-               return(NETCALC_CMP_AFTER);
-         };
-      };
+   if (w1 != w2)
+   {  common += netcalc_addr_clz(w1 ^ w2);
+      if (common < cidr)
+         return( (w1 < w2) ? NETCALC_CMP_BEFORE : NETCALC_CMP_AFTER );
    };
 
    if (c1 < c2)
@@ -284,4 +388,137 @@ netcalc_addr_convert_inet6(
 }
 
 
+void
+netcalc_addr_decr(
+         netcalc_addr_t *              addr )
+{
+   int      idx;
+   assert(addr != NULL);
+   for(idx = 15; (idx >= 0); idx--)
+      if ((addr->addr8[idx]--))
+         return;
+   return;
+}
+
+
+// mixes bits of network for indexes of hash tables
+size_t
+netcalc_addr_hash(
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr )
+{
+   uint64_t       hash;
+
+   assert(addr != NULL);
+
+   hash  = addr->addr64[0] ^ (addr->addr64[1] * 0x9e3779b97f4a7c15ULL) ^ cidr;
+   hash ^= hash >> 29;
+   hash *= 0xbf58476d1ce4e5b9ULL;
+   hash ^= hash >> 32;
+
+   return((size_t)hash);
+}
+
+
+// returns non-zero if address wrapped
+int
+netcalc_addr_incr(
+         netcalc_addr_t *              addr )
+{
+   int      idx;
+   assert(addr != NULL);
+   for(idx = 15; (idx >= 0); idx--)
+      if ((++addr->addr8[idx]))
+         return(0);
+   return(1);
+}
+
+
+// returns prefix length of the largest aligned block which is contained
+// within the range of addresses
+uint8_t
+netcalc_addr_largest(
+         const netcalc_addr_t *        first,
+         const netcalc_addr_t *        last )
+{
+   int                     span;
+   netcalc_addr_t          addr;
+
+   assert(first != NULL);
+   assert(last  != NULL);
+
+   if ((span = netcalc_addr_span(first, last)) == 128)
+      return(0);
+
+   // a range of 2^n addresses always contains an aligned block of 2^(n-1)
+   // addresses, check if the range contains an aligned block of 2^n
+   memcpy(&addr, first, sizeof(netcalc_addr_t));
+   if ((netcalc_addr_ceil(&addr, (uint8_t)(128 - span))))
+      return((uint8_t)(129 - span));
+   netcalc_addr_last(&addr, &addr, (uint8_t)(128 - span));
+   if (memcmp(&addr, last, sizeof(netcalc_addr_t)) > 0)
+      return((uint8_t)(129 - span));
+
+   return((uint8_t)(128 - span));
+}
+
+
+void
+netcalc_addr_last(
+         netcalc_addr_t *              dst,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr )
+{
+   int                     idx;
+   const netcalc_addr_t *  mask;
+
+   assert(dst  != NULL);
+   assert(addr != NULL);
+
+   mask = &_netcalc_netmasks[cidr];
+   for(idx = 0; (idx < 4); idx++)
+      dst->addr32[idx] = addr->addr32[idx] | ~mask->addr32[idx];
+
+   return;
+}
+
+
+// returns log2 of the number of addresses within the range, rounded down
+int
+netcalc_addr_span(
+         const netcalc_addr_t *        first,
+         const netcalc_addr_t *        last )
+{
+   int                     idx;
+   int                     span;
+   unsigned                borrow;
+   unsigned                diff;
+   uint8_t                 count[16];
+
+   assert(first != NULL);
+   assert(last  != NULL);
+
+   // determine number of addresses in range (last - first + 1)
+   for(idx = 15, borrow = 0; (idx >= 0); idx--)
+   {  diff        = (unsigned)last->addr8[idx] - (unsigned)first->addr8[idx] - borrow;
+      count[idx]  = (uint8_t)(diff & 0xff);
+      borrow      = (diff >> 8) & 0x01;
+   };
+   for(idx = 15; (idx >= 0); idx--)
+      if ((++count[idx]))
+         break;
+   if (idx < 0)
+      return(128);
+
+   // determine largest power of two within range
+   for(idx = 0; (!(count[idx])); idx++)
+      continue;
+   span = (15 - idx) * 8;
+   for(diff = count[idx]; (diff > 1); diff >>= 1)
+      span++;
+
+   return(span);
+}
+
+
 /* end of source */
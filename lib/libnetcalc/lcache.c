@@ -0,0 +1,269 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __LIB_LIBNETCALC_LCACHE_C 1
+#include "libnetcalc.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static uint64_t
+netcalc_cache_tag(
+         const netcalc_set_t *         ns );
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+// invalidates cached results after records are replaced or released without
+// incrementing the serial of the set
+void
+netcalc_cache_flush(
+         netcalc_set_t *               ns )
+{
+   assert(ns != NULL);
+   if ((ns->set_cache))
+      ns->set_cache->cache_gen++;
+   return;
+}
+
+
+void
+netcalc_cache_free(
+         netcalc_cache_t *             cache )
+{
+   if (!(cache))
+      return;
+   if ((cache->cache_ents))
+      free(cache->cache_ents);
+   netcalc_aligned_free(cache->cache_ctrs);
+   free(cache);
+   return;
+}
+
+
+// retrieves result of previous query, returns non-zero if result is cached
+int
+netcalc_cache_get(
+         netcalc_set_t *               ns,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr,
+         netcalc_rec_t **              recp )
+{
+   unsigned                seq;
+   uint64_t                tag;
+   uint64_t                key[2];
+   unsigned                ent_cidr;
+   netcalc_rec_t *         rec;
+   netcalc_cache_t *       cache;
+   netcalc_cache_ent_t *   ent;
+
+   assert(ns   != NULL);
+   assert(addr != NULL);
+   assert(recp != NULL);
+
+   cache = ns->set_cache;
+   ent   = &cache->cache_ents[netcalc_addr_hash(addr, cidr) & cache->cache_mask];
+
+   // entry is being replaced by another reader
+   seq = atomic_load_explicit(&ent->ent_seq, memory_order_acquire);
+   if ((seq & 1))
+   {  netcalc_stripes_add(cache->cache_ctrs, NETCALC_CTR_CACHE_MISSES);
+      return(0);
+   };
+
+   tag      = atomic_load_explicit(&ent->ent_tag,    memory_order_relaxed);
+   key[0]   = atomic_load_explicit(&ent->ent_key[0], memory_order_relaxed);
+   key[1]   = atomic_load_explicit(&ent->ent_key[1], memory_order_relaxed);
+   ent_cidr = atomic_load_explicit(&ent->ent_cidr,   memory_order_relaxed);
+   rec      = atomic_load_explicit(&ent->ent_rec,    memory_order_relaxed);
+
+   // discard entry if replaced while reading
+   atomic_thread_fence(memory_order_acquire);
+   if (atomic_load_explicit(&ent->ent_seq, memory_order_relaxed) != seq)
+   {  netcalc_stripes_add(cache->cache_ctrs, NETCALC_CTR_CACHE_MISSES);
+      return(0);
+   };
+
+   if ( (tag != netcalc_cache_tag(ns)) || (ent_cidr != cidr) || (key[0] != addr->addr64[0]) || (key[1] != addr->addr64[1]) )
+   {  netcalc_stripes_add(cache->cache_ctrs, NETCALC_CTR_CACHE_MISSES);
+      return(0);
+   };
+
+   netcalc_stripes_add(cache->cache_ctrs, NETCALC_CTR_CACHE_HITS);
+   *recp = rec;
+
+   return(1);
+}
+
+
+// stores result of query, the entry is skipped if another reader is
+// replacing the entry
+void
+netcalc_cache_put(
+         netcalc_set_t *               ns,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr,
+         netcalc_rec_t *               rec )
+{
+   unsigned                seq;
+   netcalc_cache_t *       cache;
+   netcalc_cache_ent_t *   ent;
+
+   assert(ns   != NULL);
+   assert(addr != NULL);
+
+   cache = ns->set_cache;
+   ent   = &cache->cache_ents[netcalc_addr_hash(addr, cidr) & cache->cache_mask];
+
+   seq = atomic_load_explicit(&ent->ent_seq, memory_order_relaxed);
+   if ((seq & 1))
+      return;
+   if (!(atomic_compare_exchange_strong_explicit(&ent->ent_seq, &seq, seq + 1, memory_order_acquire, memory_order_relaxed)))
+      return;
+   atomic_thread_fence(memory_order_release);
+
+   atomic_store_explicit(&ent->ent_tag,      netcalc_cache_tag(ns),  memory_order_relaxed);
+   atomic_store_explicit(&ent->ent_key[0],   addr->addr64[0],        memory_order_relaxed);
+   atomic_store_explicit(&ent->ent_key[1],   addr->addr64[1],        memory_order_relaxed);
+   atomic_store_explicit(&ent->ent_cidr,     cidr,                   memory_order_relaxed);
+   atomic_store_explicit(&ent->ent_rec,      rec,                    memory_order_relaxed);
+
+   atomic_store_explicit(&ent->ent_seq, seq + 2, memory_order_release);
+
+   return;
+}
+
+
+// entries are valid for the serial of the set within the generation of cache
+uint64_t
+netcalc_cache_tag(
+         const netcalc_set_t *         ns )
+{
+   assert(ns != NULL);
+   return( ((uint64_t)ns->set_cache->cache_gen << 32) | (uint64_t)ns->set_serial );
+}
+
+
+int
+netcalc_set_cache(
+         netcalc_set_t *               ns,
+         size_t                        size )
+{
+   size_t               idx;
+   size_t               len;
+   netcalc_cache_t *    cache;
+
+   assert(ns != NULL);
+
+   netcalc_cache_free(ns->set_cache);
+   ns->set_cache = NULL;
+
+   if (!(size))
+      return(0);
+
+   // round number of entries up to a power of two
+   for(len = 1; (len < size); len <<= 1)
+      if (len > (SIZE_MAX / 2 / sizeof(netcalc_cache_ent_t)))
+         return(NETCALC_EINVAL);
+
+   if ((cache = malloc(sizeof(netcalc_cache_t))) == NULL)
+      return(NETCALC_ENOMEM);
+   memset(cache, 0, sizeof(netcalc_cache_t));
+   cache->cache_gen  = 1;
+   cache->cache_mask = len - 1;
+
+   if ((cache->cache_ctrs = netcalc_stripes_alloc()) == NULL)
+   {  free(cache);
+      return(NETCALC_ENOMEM);
+   };
+   if ((cache->cache_ents = malloc(sizeof(netcalc_cache_ent_t) * len)) == NULL)
+   {  netcalc_cache_free(cache);
+      return(NETCALC_ENOMEM);
+   };
+   for(idx = 0; (idx < len); idx++)
+   {  atomic_init(&cache->cache_ents[idx].ent_seq,    0);
+      atomic_init(&cache->cache_ents[idx].ent_cidr,   0);
+      atomic_init(&cache->cache_ents[idx].ent_tag,    0);
+      atomic_init(&cache->cache_ents[idx].ent_key[0], 0);
+      atomic_init(&cache->cache_ents[idx].ent_key[1], 0);
+      atomic_init(&cache->cache_ents[idx].ent_rec,    NULL);
+   };
+
+   ns->set_cache = cache;
+
+   return(0);
+}
+
+
+void
+netcalc_set_cache_stats(
+         const netcalc_set_t *         ns,
+         size_t *                      sizep,
+         uintmax_t *                   hitsp,
+         uintmax_t *                   missesp )
+{
+   assert(ns != NULL);
+
+   if ((sizep))
+      *sizep = ((ns->set_cache)) ? ns->set_cache->cache_mask + 1 : 0;
+   if ((hitsp))
+      *hitsp = ((ns->set_cache)) ? netcalc_stripes_sum(ns->set_cache->cache_ctrs, NETCALC_CTR_CACHE_HITS) : 0;
+   if ((missesp))
+      *missesp = ((ns->set_cache)) ? netcalc_stripes_sum(ns->set_cache->cache_ctrs, NETCALC_CTR_CACHE_MISSES) : 0;
+
+   return;
+}
+
+
+/* end of source */
@@ -0,0 +1,247 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __LIB_LIBNETCALC_LCLASS_C 1
+#include "libnetcalc.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static const netcalc_class_node_t *
+netcalc_class_compile(
+         void );
+
+
+static uint8_t
+netcalc_class_insert(
+         netcalc_class_node_t *        nodes,
+         size_t *                      lenp,
+         uint8_t                       node,
+         const uint8_t *               addr,
+         unsigned                      cidr,
+         uint32_t                      cls );
+
+
+static uint32_t
+netcalc_class_lookup(
+         const netcalc_class_node_t *  nodes,
+         const netcalc_net_t *         net );
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+// compiles registry into trie once, returns NULL if memory is exhausted,
+// concurrent callers compile separate tries and keep the first trie
+// published so that callers never wait on each other
+const netcalc_class_node_t *
+netcalc_class_compile(
+         void )
+{
+   size_t                        len;
+   uint8_t                       node;
+   netcalc_class_node_t *        nodes;
+   netcalc_class_node_t *        trie;
+   const netcalc_class_pfx_t *   pfx;
+
+   if ((trie = atomic_load_explicit(&_netcalc_class_trie, memory_order_acquire)) != NULL)
+      return(trie);
+
+   if ((nodes = calloc(NETCALC_CLASS_NODES, sizeof(netcalc_class_node_t))) == NULL)
+      return(NULL);
+   len = 2;
+
+   for(pfx = _netcalc_class_registry; ((pfx->pfx_family)); pfx++)
+   {  node = (pfx->pfx_family == NETCALC_AF_INET) ? NETCALC_CLASS_ROOT_INET : NETCALC_CLASS_ROOT_INET6;
+      netcalc_class_insert(nodes, &len, node, pfx->pfx_addr, pfx->pfx_cidr, pfx->pfx_class);
+   };
+
+   // IPv4 mapped addresses continue into the trie of IPv4 addresses
+   node = netcalc_class_insert(nodes, &len, NETCALC_CLASS_ROOT_INET6, _netcalc_ipv4_mapped_ipv6.net_addr.addr8, _netcalc_ipv4_mapped_ipv6.net_cidr, 0);
+   nodes[node].node_child[_netcalc_ipv4_mapped_ipv6.net_addr.addr8[11]] = NETCALC_CLASS_ROOT_INET;
+
+   trie = NULL;
+   if (!(atomic_compare_exchange_strong_explicit(&_netcalc_class_trie, &trie, nodes, memory_order_acq_rel, memory_order_acquire)))
+   {  free(nodes);
+      return(trie);
+   };
+
+   return(nodes);
+}
+
+
+// adds categories to entries of prefix, returns node containing entries
+uint8_t
+netcalc_class_insert(
+         netcalc_class_node_t *        nodes,
+         size_t *                      lenp,
+         uint8_t                       node,
+         const uint8_t *               addr,
+         unsigned                      cidr,
+         uint32_t                      cls )
+{
+   unsigned       depth;
+   unsigned       last;
+   unsigned       idx;
+   unsigned       span;
+
+   assert(nodes != NULL);
+   assert(lenp  != NULL);
+   assert(addr  != NULL);
+
+   last = (cidr > 0) ? ((cidr - 1) / 8) : 0;
+   for(depth = 0; (depth < last); depth++)
+   {  if (!(nodes[node].node_child[addr[depth]]))
+      {  assert(*lenp < NETCALC_CLASS_NODES);
+         nodes[node].node_child[addr[depth]] = (uint8_t)(*lenp)++;
+      };
+      node = nodes[node].node_child[addr[depth]];
+   };
+
+   span = 1U << ((last + 1) * 8 - cidr);
+   for(idx = addr[last] & ~(span - 1); (idx < ((addr[last] & ~(span - 1)) + span)); idx++)
+      nodes[node].node_class[idx] |= (uint16_t)cls;
+
+   return(node);
+}
+
+
+// returns union of categories of entries along path of address
+uint32_t
+netcalc_class_lookup(
+         const netcalc_class_node_t *  nodes,
+         const netcalc_net_t *         net )
+{
+   size_t            idx;
+   uint8_t           node;
+   uint32_t          cls;
+   const uint8_t *   addr8;
+
+   addr8 = net->net_addr.addr8;
+   if ((net->net_flags & NETCALC_AF) == NETCALC_AF_INET)
+   {  node  = NETCALC_CLASS_ROOT_INET;
+      idx   = 12;
+   } else
+   {  node  = NETCALC_CLASS_ROOT_INET6;
+      idx   = 0;
+   };
+
+   for(cls = 0; (idx < 16); idx++)
+   {  cls |= nodes[node].node_class[addr8[idx]];
+      if ((node = nodes[node].node_child[addr8[idx]]) == 0)
+         break;
+   };
+
+   return(cls);
+}
+
+
+int
+netcalc_net_classify(
+         const netcalc_net_t *         net,
+         uint32_t *                    classp )
+{
+   uint32_t                      family;
+   const netcalc_class_node_t *  nodes;
+
+   assert(net    != NULL);
+   assert(classp != NULL);
+
+   *classp = 0;
+
+   family = net->net_flags & NETCALC_AF;
+   if ( (family != NETCALC_AF_INET) && (family != NETCALC_AF_INET6) )
+      return(NETCALC_ENOTSUP);
+
+   if ((nodes = netcalc_class_compile()) == NULL)
+      return(NETCALC_ENOMEM);
+   *classp = netcalc_class_lookup(nodes, net);
+
+   return(0);
+}
+
+
+int
+netcalc_net_classify_batch(
+         const netcalc_net_t * const * nets,
+         uint32_t *                    classes,
+         size_t                        nel )
+{
+   int                           rc;
+   size_t                        pos;
+   uint32_t                      family;
+   const netcalc_class_node_t *  nodes;
+
+   assert(nets    != NULL);
+   assert(classes != NULL);
+
+   if ((nodes = netcalc_class_compile()) == NULL)
+      return(NETCALC_ENOMEM);
+
+   // addresses of unsupported families are classified as zero
+   rc = 0;
+   for(pos = 0; (pos < nel); pos++)
+   {  family = nets[pos]->net_flags & NETCALC_AF;
+      if ( (family != NETCALC_AF_INET) && (family != NETCALC_AF_INET6) )
+      {  classes[pos] = 0;
+         rc           = NETCALC_ENOTSUP;
+         continue;
+      };
+      classes[pos] = netcalc_class_lookup(nodes, nets[pos]);
+   };
+
+   return(rc);
+}
+
+
+/* end of source */
@@ -0,0 +1,586 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __LIB_LIBNETCALC_LEXPORT_C 1
+#include "libnetcalc.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#define NETCALC_CMPT_MAGIC       "NCLST\0\r\n"
+#define NETCALC_CMPT_VERSION     1
+
+// leading byte of encoded record
+#define NETCALC_CMPT_LEAD        0x1f  // number of leading bytes shared with previous record
+#define NETCALC_CMPT_FLAGS       0x20  // flags differ from flags of previous record
+#define NETCALC_CMPT_COMMENT     0x40  // record has comment
+#define NETCALC_CMPT_LAST        0x80  // address has bits beyond prefix length
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+netcalc_cmpt_load(
+         netcalc_set_t *               ns,
+         netcalc_snap_t *              snap,
+         const uint8_t *               ptr,
+         const uint8_t *               end );
+
+
+static int
+netcalc_cmpt_strcmp(
+         const void *                  a,
+         const void *                  b );
+
+
+static int
+netcalc_cmpt_varint(
+         const uint8_t **              ptrp,
+         const uint8_t *               end,
+         uint32_t *                    valp );
+
+
+static int
+netcalc_cmpt_write(
+         FILE *                        fs,
+         const netcalc_set_t *         ns );
+
+
+static int
+netcalc_cmpt_write_varint(
+         FILE *                        fs,
+         uint32_t                      val );
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+// builds set from records in cursor order, records and lists of children are
+// allocated as single arrays in the same manner as records of a snapshot
+int
+netcalc_cmpt_load(
+         netcalc_set_t *               ns,
+         netcalc_snap_t *              snap,
+         const uint8_t *               ptr,
+         const uint8_t *               end )
+{
+   int                  rc;
+   int                  cmp;
+   uint8_t              info;
+   uint8_t              lead;
+   uint8_t              last;
+   uint8_t              cidr;
+   uint32_t             idx;
+   uint32_t             pos;
+   uint32_t             val;
+   uint32_t             count;
+   uint32_t             lists;
+   uint32_t             depth;
+   uint32_t             flags;
+   uint32_t             nstrs;
+   uint32_t             len;
+   uint32_t *           parents;
+   const char **        strs;
+   const char *         str;
+   netcalc_rec_t *      rec;
+   netcalc_rec_t *      prev;
+   netcalc_recs_t *     recs;
+   uint32_t             stack[129];
+
+   assert(ns   != NULL);
+   assert(snap != NULL);
+   assert(ptr  != NULL);
+   assert(end  != NULL);
+
+   // read dictionary of comments
+   if ((netcalc_cmpt_varint(&ptr, end, &count)))
+      return(NETCALC_EBADFILE);
+   if ((netcalc_cmpt_varint(&ptr, end, &nstrs)))
+      return(NETCALC_EBADFILE);
+   if ((netcalc_cmpt_varint(&ptr, end, &len)))
+      return(NETCALC_EBADFILE);
+   if ( (len > (size_t)(end - ptr)) || (nstrs > len) || ( ((len)) && ((ptr[len-1])) ) )
+      return(NETCALC_EBADFILE);
+   if (count > (((size_t)(end - ptr) - len) / 2))
+      return(NETCALC_EBADFILE);
+   if ((strs = malloc(sizeof(char *) * ((size_t)nstrs + 1))) == NULL)
+      return(NETCALC_ENOMEM);
+   str = (const char *)ptr;
+   for(idx = 0; (idx < nstrs); idx++)
+   {  if (str >= (const char *)&ptr[len])
+      {  free(strs);
+         return(NETCALC_EBADFILE);
+      };
+      strs[idx]   = str;
+      str        += strlen(str) + 1;
+   };
+   if (str != (const char *)&ptr[len])
+   {  free(strs);
+      return(NETCALC_EBADFILE);
+   };
+   ptr += len;
+
+   if ((snap->snap_recs = calloc((size_t)count + 1, sizeof(netcalc_rec_t))) == NULL)
+   {  free(strs);
+      return(NETCALC_ENOMEM);
+   };
+   snap->snap_count = count;
+   if ((parents = malloc(sizeof(uint32_t) * ((size_t)count + 1))) == NULL)
+   {  free(strs);
+      return(NETCALC_ENOMEM);
+   };
+
+   // decode records and determine parent of each record
+   rc    = 0;
+   lists = 1;
+   depth = 0;
+   flags = 0;
+   prev  = NULL;
+   for(idx = 0; ( (idx < count) && (rc == 0) ); idx++)
+   {  rc    = NETCALC_EBADFILE;
+      rec   = &snap->snap_recs[idx];
+
+      // decode address
+      if ((end - ptr) < 2)
+         break;
+      info  = *ptr++;
+      cidr  = *ptr++;
+      lead  = info & NETCALC_CMPT_LEAD;
+      last  = (uint8_t)((cidr + 7) / 8);
+      if ( ((info & NETCALC_CMPT_LAST)) && (ptr < end) )
+         last = *ptr++;
+      if ( (cidr > 128) || (last > 16) || (lead > last) || ((end - ptr) < (last - lead)) )
+         break;
+      if ((prev))
+         memcpy(&rec->rec_addr, &prev->rec_addr, lead);
+      memcpy(&rec->rec_addr.addr8[lead], ptr, (size_t)(last - lead));
+      ptr           += last - lead;
+      rec->rec_cidr  = cidr;
+
+      // decode flags and comment
+      if ( ((info & NETCALC_CMPT_FLAGS)) && ((netcalc_cmpt_varint(&ptr, end, &val))) )
+         break;
+      flags          ^= ((info & NETCALC_CMPT_FLAGS)) ? val : 0;
+      rec->rec_flags  = flags;
+      if ((info & NETCALC_CMPT_COMMENT))
+      {  if ( ((netcalc_cmpt_varint(&ptr, end, &val))) || (val >= nstrs) )
+            break;
+         rec->rec_comment = (char *)strs[val];
+      };
+
+      // verify record follows previous record and is within superblock
+      if ((prev))
+      {  cmp = netcalc_addr_cmp(&prev->rec_addr, prev->rec_cidr, &rec->rec_addr, rec->rec_cidr);
+         if ( (cmp != NETCALC_CMP_BEFORE) && (cmp != NETCALC_CMP_SUPERNET) )
+            break;
+      };
+      if ((ns->set_superblock))
+      {  cmp = netcalc_addr_cmp(&rec->rec_addr, rec->rec_cidr, &ns->set_superblock->net_addr, ns->set_superblock->net_cidr);
+         if ( (cmp != NETCALC_CMP_SAME) && (cmp != NETCALC_CMP_SUBNET) )
+            break;
+      };
+
+      // parent is the nearest preceding record which contains the record
+      while( ((depth)) && (netcalc_addr_cmp(&rec->rec_addr, rec->rec_cidr, &snap->snap_recs[stack[depth-1]].rec_addr, snap->snap_recs[stack[depth-1]].rec_cidr) != NETCALC_CMP_SUBNET) )
+         depth--;
+      if ((depth))
+      {  if ((ns->set_flags & NETCALC_FLG_UNIQ))
+            break;
+         parents[idx]   = stack[depth-1];
+         recs           = &snap->snap_recs[parents[idx]].rec_children;
+         lists         += ((recs->len)) ? 0 : 1;
+      } else
+      {  parents[idx]   = UINT32_MAX;
+         recs           = &ns->set_recs;
+      };
+      recs->len++;
+      stack[depth++] = idx;
+
+      prev  = rec;
+      rc    = 0;
+   };
+   free(strs);
+   if ( (rc == 0) && (ptr != end) )
+      rc = NETCALC_EBADFILE;
+   if (rc != 0)
+   {  free(parents);
+      return(rc);
+   };
+
+   // assign lists of children
+   if ((snap->snap_lists = malloc(sizeof(netcalc_rec_t *) * ((size_t)count + lists))) == NULL)
+   {  free(parents);
+      return(NETCALC_ENOMEM);
+   };
+   pos                  = 0;
+   recs                 = &ns->set_recs;
+   recs->list           = &snap->snap_lists[pos];
+   recs->size           = recs->len;
+   pos                 += recs->len + 1;
+   recs->list[recs->len] = NULL;
+   recs->len            = 0;
+   for(idx = 0; (idx < count); idx++)
+   {  recs = &snap->snap_recs[idx].rec_children;
+      if (!(recs->len))
+         continue;
+      recs->list              = &snap->snap_lists[pos];
+      recs->size              = recs->len;
+      pos                    += recs->len + 1;
+      recs->list[recs->len]   = NULL;
+      recs->len               = 0;
+   };
+
+   // populate lists of children in order
+   for(idx = 0; (idx < count); idx++)
+   {  recs = (parents[idx] == UINT32_MAX) ? &ns->set_recs : &snap->snap_recs[parents[idx]].rec_children;
+      recs->list[recs->len++] = &snap->snap_recs[idx];
+   };
+   free(parents);
+
+   return(0);
+}
+
+
+int
+netcalc_cmpt_strcmp(
+         const void *                  a,
+         const void *                  b )
+{
+   return(strcmp(*(const char * const *)a, *(const char * const *)b));
+}
+
+
+int
+netcalc_cmpt_varint(
+         const uint8_t **              ptrp,
+         const uint8_t *               end,
+         uint32_t *                    valp )
+{
+   uint32_t             bits;
+   uint64_t             val;
+   const uint8_t *      ptr;
+
+   assert(ptrp != NULL);
+   assert(end  != NULL);
+   assert(valp != NULL);
+
+   val = 0;
+   ptr = *ptrp;
+   for(bits = 0; ( (ptr < end) && (bits < 35) ); bits += 7)
+   {  val |= (uint64_t)(*ptr & 0x7f) << bits;
+      if (!(*ptr++ & 0x80))
+      {  if (val > UINT32_MAX)
+            return(NETCALC_EBADFILE);
+         *ptrp = ptr;
+         *valp = (uint32_t)val;
+         return(0);
+      };
+   };
+
+   return(NETCALC_EBADFILE);
+}
+
+
+int
+netcalc_cmpt_write(
+         FILE *                        fs,
+         const netcalc_set_t *         ns )
+{
+   int                        rc;
+   uint8_t                    info;
+   uint8_t                    lead;
+   uint8_t                    last;
+   uint32_t                   idx;
+   uint32_t                   uniq;
+   uint32_t                   count;
+   uint32_t                   nstrs;
+   uint32_t                   flags;
+   uint32_t                   depth;
+   size_t                     size;
+   uint64_t                   len;
+   void *                     ptr;
+   const char **              strs;
+   const char **              str;
+   const netcalc_rec_t *      rec;
+   const netcalc_rec_t *      prev;
+   const netcalc_rec_t **     order;
+   const netcalc_recs_t *     recs[129];
+   uint32_t                   pos[129];
+
+   assert(fs != NULL);
+   assert(ns != NULL);
+
+   // list records in cursor order
+   count = 0;
+   size  = 1024;
+   if ((order = malloc(sizeof(netcalc_rec_t *) * size)) == NULL)
+      return(NETCALC_ENOMEM);
+   depth       = 0;
+   recs[0]     = &ns->set_recs;
+   pos[0]      = 0;
+   while(depth < 129)
+   {  if (pos[depth] >= recs[depth]->len)
+      {  if (!(depth))
+            break;
+         depth--;
+         continue;
+      };
+      rec = recs[depth]->list[pos[depth]++];
+      if (count >= size)
+      {  size *= 2;
+         if ((ptr = realloc(order, sizeof(netcalc_rec_t *) * size)) == NULL)
+         {  free(order);
+            return(NETCALC_ENOMEM);
+         };
+         order = ptr;
+      };
+      order[count++] = rec;
+      if ((rec->rec_children.len))
+      {  depth++;
+         recs[depth] = &rec->rec_children;
+         pos[depth]  = 0;
+      };
+   };
+
+   // build dictionary of unique comments
+   if ((strs = malloc(sizeof(char *) * ((size_t)count + 1))) == NULL)
+   {  free(order);
+      return(NETCALC_ENOMEM);
+   };
+   nstrs = 0;
+   for(idx = 0; (idx < count); idx++)
+      if ((order[idx]->rec_comment))
+         strs[nstrs++] = order[idx]->rec_comment;
+   qsort(strs, nstrs, sizeof(char *), netcalc_cmpt_strcmp);
+   len   = 0;
+   uniq  = 0;
+   for(idx = 0; (idx < nstrs); idx++)
+   {  if ( ((uniq)) && (!(strcmp(strs[uniq-1], strs[idx]))) )
+         continue;
+      strs[uniq++]  = strs[idx];
+      len          += strlen(strs[idx]) + 1;
+   };
+   nstrs = uniq;
+   if (len > UINT32_MAX)
+   {  free(strs);
+      free(order);
+      return(NETCALC_ERANGE);
+   };
+
+   // write header and dictionary
+   rc    = 0;
+   rc   |= (fwrite(NETCALC_CMPT_MAGIC, 8, 1, fs) != 1) ? NETCALC_EIO : 0;
+   rc   |= netcalc_cmpt_write_varint(fs, NETCALC_CMPT_VERSION);
+   rc   |= netcalc_cmpt_write_varint(fs, ns->set_flags);
+   if ((ns->set_superblock))
+   {  rc |= netcalc_cmpt_write_varint(fs, ns->set_superblock->net_flags);
+      rc |= (fputc(ns->set_superblock->net_cidr, fs) == EOF) ? NETCALC_EIO : 0;
+      rc |= (fwrite(&ns->set_superblock->net_addr, 16, 1, fs) != 1) ? NETCALC_EIO : 0;
+   } else
+      rc |= netcalc_cmpt_write_varint(fs, 0);
+   rc   |= netcalc_cmpt_write_varint(fs, count);
+   rc   |= netcalc_cmpt_write_varint(fs, nstrs);
+   rc   |= netcalc_cmpt_write_varint(fs, (uint32_t)len);
+   for(idx = 0; (idx < nstrs); idx++)
+      rc |= (fwrite(strs[idx], strlen(strs[idx]) + 1, 1, fs) != 1) ? NETCALC_EIO : 0;
+
+   // write records with leading bytes shared with previous record omitted
+   flags = 0;
+   prev  = NULL;
+   for(idx = 0; ( (idx < count) && (rc == 0) ); idx++)
+   {  rec   = order[idx];
+      info  = 0;
+      for(last = 16; ( (last > 0) && (!(rec->rec_addr.addr8[last-1])) ); last--);
+      if (last > ((rec->rec_cidr + 7) / 8))
+         info |= NETCALC_CMPT_LAST;
+      else
+         last  = (uint8_t)((rec->rec_cidr + 7) / 8);
+      for(lead = 0; ( ((prev)) && (lead < last) && (prev->rec_addr.addr8[lead] == rec->rec_addr.addr8[lead]) ); lead++);
+      info |= lead;
+      info |= (rec->rec_flags != flags)   ? NETCALC_CMPT_FLAGS   : 0;
+      info |= ((rec->rec_comment))        ? NETCALC_CMPT_COMMENT : 0;
+      rc   |= (fputc(info, fs) == EOF) ? NETCALC_EIO : 0;
+      rc   |= (fputc(rec->rec_cidr, fs) == EOF) ? NETCALC_EIO : 0;
+      if ((info & NETCALC_CMPT_LAST))
+         rc |= (fputc(last, fs) == EOF) ? NETCALC_EIO : 0;
+      if (last > lead)
+         rc |= (fwrite(&rec->rec_addr.addr8[lead], (size_t)(last - lead), 1, fs) != 1) ? NETCALC_EIO : 0;
+      if ((info & NETCALC_CMPT_FLAGS))
+         rc |= netcalc_cmpt_write_varint(fs, rec->rec_flags ^ flags);
+      if ((info & NETCALC_CMPT_COMMENT))
+      {  str = bsearch(&rec->rec_comment, strs, nstrs, sizeof(char *), netcalc_cmpt_strcmp);
+         rc |= netcalc_cmpt_write_varint(fs, (uint32_t)(str - strs));
+      };
+      flags = rec->rec_flags;
+      prev  = rec;
+   };
+
+   free(strs);
+   free(order);
+
+   return( ((rc)) ? NETCALC_EIO : 0 );
+}
+
+
+int
+netcalc_cmpt_write_varint(
+         FILE *                        fs,
+         uint32_t                      val )
+{
+   assert(fs != NULL);
+   while(val >= 0x80)
+   {  if (fputc((int)((val & 0x7f) | 0x80), fs) == EOF)
+         return(NETCALC_EIO);
+      val >>= 7;
+   };
+   return( (fputc((int)val, fs) == EOF) ? NETCALC_EIO : 0 );
+}
+
+
+int
+netcalc_set_export_compact(
+         netcalc_set_t *               ns,
+         const char *                  path )
+{
+   assert(ns   != NULL);
+   assert(path != NULL);
+   return(netcalc_snap_save(ns, path, &netcalc_cmpt_write));
+}
+
+
+int
+netcalc_set_import_compact(
+         netcalc_set_t **              nsp,
+         const char *                  path )
+{
+   int                  rc;
+   uint32_t             version;
+   uint32_t             flags;
+   uint32_t             sb_flags;
+   const uint8_t *      ptr;
+   const uint8_t *      end;
+   netcalc_set_t *      ns;
+   netcalc_snap_t *     snap;
+   netcalc_buff_t       nbuff;
+
+   assert(nsp  != NULL);
+   assert(path != NULL);
+
+   *nsp = NULL;
+
+   if ((rc = netcalc_snap_map(&snap, path)) != 0)
+      return(rc);
+   ptr = snap->snap_map;
+   end = &ptr[snap->snap_len];
+
+   // verify header
+   rc = NETCALC_EBADFILE;
+   if ( (snap->snap_len < 8) || ((memcmp(ptr, NETCALC_CMPT_MAGIC, 8))) )
+   {  netcalc_snap_unmap(snap);
+      return(rc);
+   };
+   ptr += 8;
+   if ( ((netcalc_cmpt_varint(&ptr, end, &version))) || (version != NETCALC_CMPT_VERSION) )
+   {  netcalc_snap_unmap(snap);
+      return(rc);
+   };
+   if ( ((netcalc_cmpt_varint(&ptr, end, &flags))) || ((netcalc_cmpt_varint(&ptr, end, &sb_flags))) )
+   {  netcalc_snap_unmap(snap);
+      return(rc);
+   };
+
+   // initialize set with superblock of list
+   memset(&nbuff, 0, sizeof(netcalc_buff_t));
+   if ((sb_flags))
+   {  if ( ((end - ptr) < 17) || (ptr[0] > 128) )
+      {  netcalc_snap_unmap(snap);
+         return(rc);
+      };
+      memcpy(&nbuff.buff_net.net_addr, &ptr[1], sizeof(netcalc_addr_t));
+      nbuff.buff_net.net_cidr    = ptr[0];
+      nbuff.buff_net.net_flags   = sb_flags;
+      ptr                       += 17;
+   };
+   if ((rc = netcalc_set_init(&ns, ((sb_flags)) ? &nbuff.buff_net : NULL, 0)) != 0)
+   {  netcalc_snap_unmap(snap);
+      return(rc);
+   };
+   ns->set_snap   = snap;
+   ns->set_flags  = flags;
+
+   if ((rc = netcalc_cmpt_load(ns, snap, ptr, end)) != 0)
+   {  netcalc_set_free(ns);
+      return(rc);
+   };
+   if ((rc = netcalc_hosts_build(ns)) != 0)
+   {  netcalc_set_free(ns);
+      return(rc);
+   };
+   if ((rc = netcalc_filter_build(ns)) != 0)
+   {  netcalc_set_free(ns);
+      return(rc);
+   };
+
+   *nsp = ns;
+
+   return(0);
+}
+
+
+/* end of source */
@@ -0,0 +1,430 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __LIB_LIBNETCALC_LFILTER_C 1
+#include "libnetcalc.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#define NETCALC_FILTER_WORDS     16    // minimum number of words of filter
+#define NETCALC_FILTER_LOAD      4     // maximum number of prefixes per word
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static void
+netcalc_filter_add(
+         netcalc_filter_t *            filter,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr );
+
+
+static void
+netcalc_filter_build_recs(
+         netcalc_filter_t *            filter,
+         const netcalc_recs_t *        recs );
+
+
+static size_t
+netcalc_filter_count(
+         const netcalc_recs_t *        recs );
+
+
+static uint64_t
+netcalc_filter_key(
+         const netcalc_filter_t *      filter,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr,
+         size_t *                      wordp );
+
+
+static void
+netcalc_filter_lens(
+         netcalc_filter_t *            filter );
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+// sets bits of prefix and counts prefix length
+void
+netcalc_filter_add(
+         netcalc_filter_t *            filter,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr )
+{
+   size_t         word;
+   uint64_t       bits;
+
+   assert(filter != NULL);
+   assert(addr   != NULL);
+
+   bits = netcalc_filter_key(filter, addr, cidr, &word);
+   filter->filter_words[word] |= bits;
+   filter->filter_count++;
+   filter->filter_prefixes[cidr]++;
+
+   return;
+}
+
+
+// sizes filter for the prefixes of set, replacing the previous filter
+int
+netcalc_filter_build(
+         netcalc_set_t *               ns )
+{
+   size_t               count;
+   size_t               words;
+   netcalc_filter_t *   filter;
+
+   assert(ns != NULL);
+
+   netcalc_filter_free(ns);
+
+   if (!(ns->set_flags & NETCALC_FLG_FILTER))
+      return(0);
+
+   // reserve room for the prefixes to double before resizing filter
+   count = netcalc_filter_count(&ns->set_recs);
+   for(words = NETCALC_FILTER_WORDS; ((words * NETCALC_FILTER_LOAD) < (count * 2)); words <<= 1);
+
+   if ((filter = malloc(sizeof(netcalc_filter_t))) == NULL)
+      return(NETCALC_ENOMEM);
+   memset(filter, 0, sizeof(netcalc_filter_t));
+   if ((filter->filter_words = malloc(sizeof(uint64_t) * words)) == NULL)
+   {  free(filter);
+      return(NETCALC_ENOMEM);
+   };
+   memset(filter->filter_words, 0, (sizeof(uint64_t) * words));
+   filter->filter_mask = words - 1;
+   if ((filter->filter_ctrs = netcalc_stripes_alloc()) == NULL)
+   {  free(filter->filter_words);
+      free(filter);
+      return(NETCALC_ENOMEM);
+   };
+
+   netcalc_filter_build_recs(filter, &ns->set_recs);
+   netcalc_filter_lens(filter);
+
+   ns->set_filter = filter;
+
+   return(0);
+}
+
+
+void
+netcalc_filter_build_recs(
+         netcalc_filter_t *            filter,
+         const netcalc_recs_t *        recs )
+{
+   uint32_t             idx;
+   netcalc_rec_t *      rec;
+
+   assert(filter != NULL);
+   assert(recs   != NULL);
+
+   for(idx = 0; (idx < recs->len); idx++)
+   {  rec = recs->list[idx];
+      netcalc_filter_add(filter, &rec->rec_addr, rec->rec_cidr);
+      netcalc_filter_build_recs(filter, &rec->rec_children);
+   };
+
+   return;
+}
+
+
+// copies filter of set which shares records
+int
+netcalc_filter_copy(
+         netcalc_set_t *               dst,
+         const netcalc_set_t *         src )
+{
+   size_t               words;
+   netcalc_filter_t *   filter;
+
+   assert(dst != NULL);
+   assert(src != NULL);
+
+   netcalc_filter_free(dst);
+
+   if (!(src->set_filter))
+      return(0);
+
+   if ((filter = malloc(sizeof(netcalc_filter_t))) == NULL)
+      return(NETCALC_ENOMEM);
+   memcpy(filter, src->set_filter, sizeof(netcalc_filter_t));
+   words = src->set_filter->filter_mask + 1;
+   if ((filter->filter_words = malloc(sizeof(uint64_t) * words)) == NULL)
+   {  free(filter);
+      return(NETCALC_ENOMEM);
+   };
+   memcpy(filter->filter_words, src->set_filter->filter_words, (sizeof(uint64_t) * words));
+   if ((filter->filter_ctrs = netcalc_stripes_alloc()) == NULL)
+   {  free(filter->filter_words);
+      free(filter);
+      return(NETCALC_ENOMEM);
+   };
+
+   dst->set_filter = filter;
+
+   return(0);
+}
+
+
+size_t
+netcalc_filter_count(
+         const netcalc_recs_t *        recs )
+{
+   uint32_t             idx;
+   size_t               count;
+
+   assert(recs != NULL);
+
+   count = recs->len;
+   for(idx = 0; (idx < recs->len); idx++)
+      count += netcalc_filter_count(&recs->list[idx]->rec_children);
+
+   return(count);
+}
+
+
+void
+netcalc_filter_free(
+         netcalc_set_t *               ns )
+{
+   assert(ns != NULL);
+   if (!(ns->set_filter))
+      return;
+   free(ns->set_filter->filter_words);
+   netcalc_aligned_free(ns->set_filter->filter_ctrs);
+   free(ns->set_filter);
+   ns->set_filter = NULL;
+   return;
+}
+
+
+// adds prefix of record added to set
+void
+netcalc_filter_insert(
+         netcalc_set_t *               ns,
+         const netcalc_rec_t *         rec )
+{
+   netcalc_filter_t *   filter;
+
+   assert(ns  != NULL);
+   assert(rec != NULL);
+
+   if (!(ns->set_flags & NETCALC_FLG_FILTER))
+      return;
+
+   // a set without a filter is not filtered until the filter is rebuilt
+   filter = ns->set_filter;
+   if ( (!(filter)) || (filter->filter_count >= ((filter->filter_mask + 1) * NETCALC_FILTER_LOAD)) )
+   {  netcalc_filter_build(ns);
+      return;
+   };
+
+   netcalc_filter_add(filter, &rec->rec_addr, rec->rec_cidr);
+   if (filter->filter_prefixes[rec->rec_cidr] == 1)
+      netcalc_filter_lens(filter);
+
+   return;
+}
+
+
+// returns bits of prefix within word of filter
+uint64_t
+netcalc_filter_key(
+         const netcalc_filter_t *      filter,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr,
+         size_t *                      wordp )
+{
+   uint64_t          hash;
+   netcalc_addr_t    prefix;
+
+   prefix.addr64[0] = addr->addr64[0] & _netcalc_netmasks[cidr].addr64[0];
+   prefix.addr64[1] = addr->addr64[1] & _netcalc_netmasks[cidr].addr64[1];
+
+   // three bits within a single word limits each probe to one cache line
+   hash   = (uint64_t)netcalc_addr_hash(&prefix, cidr);
+   *wordp = (size_t)(hash >> 18) & filter->filter_mask;
+
+   return( (1ULL << (hash & 0x3f)) | (1ULL << ((hash >> 6) & 0x3f)) | (1ULL << ((hash >> 12) & 0x3f)) );
+}
+
+
+// lists prefix lengths of records in ascending order
+void
+netcalc_filter_lens(
+         netcalc_filter_t *            filter )
+{
+   unsigned       cidr;
+
+   assert(filter != NULL);
+
+   filter->filter_nlens = 0;
+   for(cidr = 0; (cidr <= 128); cidr++)
+      if ((filter->filter_prefixes[cidr]))
+         filter->filter_lens[filter->filter_nlens++] = (uint8_t)cidr;
+
+   return;
+}
+
+
+// removes prefix length of record deleted from set, bits of the record
+// remain set until the filter is rebuilt
+void
+netcalc_filter_remove(
+         netcalc_set_t *               ns,
+         const netcalc_rec_t *         rec )
+{
+   netcalc_filter_t *   filter;
+
+   assert(ns  != NULL);
+   assert(rec != NULL);
+
+   if ((filter = ns->set_filter) == NULL)
+      return;
+
+   filter->filter_stale++;
+   filter->filter_prefixes[rec->rec_cidr]--;
+   if (!(filter->filter_prefixes[rec->rec_cidr]))
+      netcalc_filter_lens(filter);
+
+   if ((filter->filter_stale * 2) > filter->filter_count)
+      netcalc_filter_build(ns);
+
+   return;
+}
+
+
+// returns zero if network is not within a prefix of set
+int
+netcalc_filter_test(
+         netcalc_set_t *               ns,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr )
+{
+   size_t               idx;
+   size_t               word;
+   uint64_t             bits;
+   netcalc_filter_t *   filter;
+
+   assert(ns   != NULL);
+   assert(addr != NULL);
+
+   filter = ns->set_filter;
+
+   for(idx = 0; ( (idx < filter->filter_nlens) && (filter->filter_lens[idx] <= cidr) ); idx++)
+   {  bits = netcalc_filter_key(filter, addr, filter->filter_lens[idx], &word);
+      if ((filter->filter_words[word] & bits) == bits)
+      {  netcalc_stripes_add(filter->filter_ctrs, NETCALC_CTR_FILTER_PASSES);
+         return(1);
+      };
+   };
+
+   netcalc_stripes_add(filter->filter_ctrs, NETCALC_CTR_FILTER_REJECTS);
+
+   return(0);
+}
+
+
+void
+netcalc_set_filter_stats(
+         const netcalc_set_t *         ns,
+         size_t *                      bitsp,
+         size_t *                      setp,
+         size_t *                      lensp,
+         uintmax_t *                   rejectsp,
+         uintmax_t *                   passesp,
+         uintmax_t *                   falsep )
+{
+   size_t               idx;
+   size_t               set;
+   uint64_t             word;
+   netcalc_filter_t *   filter;
+
+   assert(ns != NULL);
+
+   filter = ns->set_filter;
+
+   set = 0;
+   for(idx = 0; ( ((filter)) && (idx <= filter->filter_mask) ); idx++)
+      for(word = filter->filter_words[idx]; ((word)); word &= word - 1)
+         set++;
+
+   if ((bitsp))
+      *bitsp = ((filter)) ? (filter->filter_mask + 1) * 64 : 0;
+   if ((setp))
+      *setp = set;
+   if ((lensp))
+      *lensp = ((filter)) ? filter->filter_nlens : 0;
+   if ((rejectsp))
+      *rejectsp = ((filter)) ? netcalc_stripes_sum(filter->filter_ctrs, NETCALC_CTR_FILTER_REJECTS) : 0;
+   if ((passesp))
+      *passesp = ((filter)) ? netcalc_stripes_sum(filter->filter_ctrs, NETCALC_CTR_FILTER_PASSES) : 0;
+   if ((falsep))
+      *falsep = ((filter)) ? netcalc_stripes_sum(filter->filter_ctrs, NETCALC_CTR_FILTER_FALSE) : 0;
+
+   return;
+}
+
+
+/* end of source */
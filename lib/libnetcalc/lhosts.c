@@ -0,0 +1,407 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __LIB_LIBNETCALC_LHOSTS_C 1
+#include "libnetcalc.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#define NETCALC_HOSTS_SLOTS      16
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+netcalc_hosts_build_recs(
+         netcalc_set_t *               ns,
+         const netcalc_recs_t *        recs );
+
+
+static int
+netcalc_hosts_grow(
+         netcalc_hosts_t *             hosts );
+
+
+static size_t
+netcalc_hosts_slot(
+         const netcalc_hosts_t *       hosts,
+         const netcalc_addr_t *        addr );
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+// indexes the host records of set, replacing the previous index
+int
+netcalc_hosts_build(
+         netcalc_set_t *               ns )
+{
+   int                  rc;
+
+   assert(ns != NULL);
+
+   netcalc_hosts_free(ns);
+
+   if (!(ns->set_flags & NETCALC_FLG_HOSTS))
+      return(0);
+
+   if ((rc = netcalc_hosts_build_recs(ns, &ns->set_recs)) != 0)
+   {  netcalc_hosts_free(ns);
+      return(rc);
+   };
+
+   return(0);
+}
+
+
+int
+netcalc_hosts_build_recs(
+         netcalc_set_t *               ns,
+         const netcalc_recs_t *        recs )
+{
+   int                  rc;
+   uint32_t             idx;
+   netcalc_rec_t *      rec;
+
+   assert(ns   != NULL);
+   assert(recs != NULL);
+
+   for(idx = 0; (idx < recs->len); idx++)
+   {  rec = recs->list[idx];
+      if ( (rec->rec_cidr == 128) && ((rc = netcalc_hosts_insert(ns, rec)) != 0) )
+         return(rc);
+      if ((rc = netcalc_hosts_build_recs(ns, &rec->rec_children)) != 0)
+         return(rc);
+   };
+
+   return(0);
+}
+
+
+// copies index of set which shares records
+int
+netcalc_hosts_copy(
+         netcalc_set_t *               dst,
+         const netcalc_set_t *         src )
+{
+   size_t               slots;
+   netcalc_hosts_t *    hosts;
+
+   assert(dst != NULL);
+   assert(src != NULL);
+
+   netcalc_hosts_free(dst);
+
+   if (!(src->set_hosts))
+      return(0);
+
+   if ((hosts = malloc(sizeof(netcalc_hosts_t))) == NULL)
+      return(NETCALC_ENOMEM);
+   slots = src->set_hosts->hosts_mask + 1;
+   if ((hosts->hosts_table = malloc(sizeof(netcalc_rec_t *) * slots)) == NULL)
+   {  free(hosts);
+      return(NETCALC_ENOMEM);
+   };
+   memcpy(hosts->hosts_table, src->set_hosts->hosts_table, (sizeof(netcalc_rec_t *) * slots));
+   hosts->hosts_len  = src->set_hosts->hosts_len;
+   hosts->hosts_mask = src->set_hosts->hosts_mask;
+
+   dst->set_hosts = hosts;
+
+   return(0);
+}
+
+
+// returns record of host, the address must be in IPv6 notation
+netcalc_rec_t *
+netcalc_hosts_find(
+         const netcalc_set_t *         ns,
+         const netcalc_addr_t *        addr )
+{
+   size_t               slot;
+   netcalc_rec_t *      rec;
+   netcalc_hosts_t *    hosts;
+
+   assert(ns   != NULL);
+   assert(addr != NULL);
+
+   if ((hosts = ns->set_hosts) == NULL)
+      return(NULL);
+
+   for(slot = netcalc_hosts_slot(hosts, addr); ((rec = hosts->hosts_table[slot]) != NULL); slot = (slot + 1) & hosts->hosts_mask)
+      if ( (rec->rec_addr.addr64[0] == addr->addr64[0]) && (rec->rec_addr.addr64[1] == addr->addr64[1]) )
+         return(rec);
+
+   return(NULL);
+}
+
+
+void
+netcalc_hosts_free(
+         netcalc_set_t *               ns )
+{
+   assert(ns != NULL);
+   if (!(ns->set_hosts))
+      return;
+   free(ns->set_hosts->hosts_table);
+   free(ns->set_hosts);
+   ns->set_hosts = NULL;
+   return;
+}
+
+
+// doubles number of slots of index
+int
+netcalc_hosts_grow(
+         netcalc_hosts_t *             hosts )
+{
+   size_t               idx;
+   size_t               slot;
+   size_t               slots;
+   netcalc_rec_t *      rec;
+   netcalc_rec_t **     table;
+   netcalc_hosts_t      grown;
+
+   assert(hosts != NULL);
+
+   slots = (hosts->hosts_mask + 1) * 2;
+   if ((table = malloc(sizeof(netcalc_rec_t *) * slots)) == NULL)
+      return(NETCALC_ENOMEM);
+   memset(table, 0, (sizeof(netcalc_rec_t *) * slots));
+
+   grown.hosts_len   = hosts->hosts_len;
+   grown.hosts_mask  = slots - 1;
+   grown.hosts_table = table;
+   for(idx = 0; (idx <= hosts->hosts_mask); idx++)
+   {  if ((rec = hosts->hosts_table[idx]) == NULL)
+         continue;
+      for(slot = netcalc_hosts_slot(&grown, &rec->rec_addr); ((table[slot])); slot = (slot + 1) & grown.hosts_mask);
+      table[slot] = rec;
+   };
+
+   free(hosts->hosts_table);
+   memcpy(hosts, &grown, sizeof(netcalc_hosts_t));
+
+   return(0);
+}
+
+
+int
+netcalc_hosts_insert(
+         netcalc_set_t *               ns,
+         netcalc_rec_t *               rec )
+{
+   int                  rc;
+   size_t               slot;
+   netcalc_hosts_t *    hosts;
+
+   assert(ns  != NULL);
+   assert(rec != NULL);
+   assert(rec->rec_cidr == 128);
+
+   if (!(ns->set_flags & NETCALC_FLG_HOSTS))
+      return(0);
+
+   if ((hosts = ns->set_hosts) == NULL)
+   {  if ((hosts = malloc(sizeof(netcalc_hosts_t))) == NULL)
+         return(NETCALC_ENOMEM);
+      if ((hosts->hosts_table = malloc(sizeof(netcalc_rec_t *) * NETCALC_HOSTS_SLOTS)) == NULL)
+      {  free(hosts);
+         return(NETCALC_ENOMEM);
+      };
+      memset(hosts->hosts_table, 0, (sizeof(netcalc_rec_t *) * NETCALC_HOSTS_SLOTS));
+      hosts->hosts_len  = 0;
+      hosts->hosts_mask = NETCALC_HOSTS_SLOTS - 1;
+      ns->set_hosts     = hosts;
+   };
+
+   // keep at least half of the slots empty to bound probe sequences
+   if ( ((hosts->hosts_len + 1) * 2) > (hosts->hosts_mask + 1) )
+      if ((rc = netcalc_hosts_grow(hosts)) != 0)
+         return(rc);
+
+   for(slot = netcalc_hosts_slot(hosts, &rec->rec_addr); ((hosts->hosts_table[slot])); slot = (slot + 1) & hosts->hosts_mask)
+   {  if (hosts->hosts_table[slot] == rec)
+         return(0);
+   };
+   hosts->hosts_table[slot] = rec;
+   hosts->hosts_len++;
+
+   return(0);
+}
+
+
+void
+netcalc_hosts_remove(
+         netcalc_set_t *               ns,
+         const netcalc_rec_t *         rec )
+{
+   size_t               slot;
+   size_t               next;
+   size_t               home;
+   netcalc_hosts_t *    hosts;
+
+   assert(ns  != NULL);
+   assert(rec != NULL);
+
+   if ((hosts = ns->set_hosts) == NULL)
+      return;
+
+   for(slot = netcalc_hosts_slot(hosts, &rec->rec_addr); (hosts->hosts_table[slot] != rec); slot = (slot + 1) & hosts->hosts_mask)
+      if (!(hosts->hosts_table[slot]))
+         return;
+
+   // shift following records of probe sequence which may occupy the slot
+   for(next = (slot + 1) & hosts->hosts_mask; ((hosts->hosts_table[next])); next = (next + 1) & hosts->hosts_mask)
+   {  home = netcalc_hosts_slot(hosts, &hosts->hosts_table[next]->rec_addr);
+      if (((next - home) & hosts->hosts_mask) < ((next - slot) & hosts->hosts_mask))
+         continue;
+      hosts->hosts_table[slot] = hosts->hosts_table[next];
+      slot = next;
+   };
+   hosts->hosts_table[slot] = NULL;
+   hosts->hosts_len--;
+
+   return;
+}
+
+
+// replaces record with a copy of the record, the replaced record is not
+// referenced
+void
+netcalc_hosts_replace(
+         netcalc_set_t *               ns,
+         const netcalc_rec_t *         src,
+         netcalc_rec_t *               rec )
+{
+   size_t               slot;
+   netcalc_hosts_t *    hosts;
+
+   assert(ns  != NULL);
+   assert(rec != NULL);
+
+   if ((hosts = ns->set_hosts) == NULL)
+      return;
+
+   for(slot = netcalc_hosts_slot(hosts, &rec->rec_addr); ((hosts->hosts_table[slot])); slot = (slot + 1) & hosts->hosts_mask)
+   {  if (hosts->hosts_table[slot] == src)
+      {  hosts->hosts_table[slot] = rec;
+         return;
+      };
+   };
+
+   return;
+}
+
+
+size_t
+netcalc_hosts_slot(
+         const netcalc_hosts_t *       hosts,
+         const netcalc_addr_t *        addr )
+{
+   return(netcalc_addr_hash(addr, 128) & hosts->hosts_mask);
+}
+
+
+void
+netcalc_set_hosts_stats(
+         const netcalc_set_t *         ns,
+         size_t *                      countp,
+         size_t *                      slotsp,
+         size_t *                      bytesp,
+         size_t *                      probesp,
+         size_t *                      maxprobep )
+{
+   size_t               slot;
+   size_t               probe;
+   size_t               probes;
+   size_t               maxprobe;
+   netcalc_hosts_t *    hosts;
+
+   assert(ns != NULL);
+
+   // probe length of record is the number of slots examined to find record
+   probes   = 0;
+   maxprobe = 0;
+   if ((hosts = ns->set_hosts) != NULL)
+   {  for(slot = 0; (slot <= hosts->hosts_mask); slot++)
+      {  if (!(hosts->hosts_table[slot]))
+            continue;
+         probe     = ((slot - netcalc_hosts_slot(hosts, &hosts->hosts_table[slot]->rec_addr)) & hosts->hosts_mask) + 1;
+         probes   += probe;
+         maxprobe  = (probe > maxprobe) ? probe : maxprobe;
+      };
+   };
+
+   if ((countp))
+      *countp = ((hosts)) ? hosts->hosts_len : 0;
+   if ((slotsp))
+      *slotsp = ((hosts)) ? hosts->hosts_mask + 1 : 0;
+   if ((bytesp))
+      *bytesp = ((hosts)) ? sizeof(netcalc_hosts_t) + (sizeof(netcalc_rec_t *) * (hosts->hosts_mask + 1)) : 0;
+   if ((probesp))
+      *probesp = probes;
+   if ((maxprobep))
+      *maxprobep = maxprobe;
+
+   return;
+}
+
+
+/* end of source */
@@ -52,6 +52,9 @@
 #   include <config.h>
 #endif
 
+#include <stdio.h>
+#include <stdatomic.h>
+
 #include <netcalc.h>
 
 
@@ -70,6 +73,29 @@
 ///////////////////
 // MARK: - Definitions
 
+#define NETCALC_CLASS_NODES            80    // classes: nodes available to compiled registry
+#define NETCALC_CLASS_ROOT_INET6       0     // classes: node of first byte of IPv6 addresses
+#define NETCALC_CLASS_ROOT_INET        1     // classes: node of first byte of IPv4 addresses
+
+#define NETCALC_CUR_RECS               0     // cursor: iterates records within set
+#define NETCALC_CUR_BLOCKS             1     // cursor: iterates unallocated blocks within network
+#define NETCALC_CUR_COVERED            2     // cursor: iterates records within network
+#define NETCALC_CUR_CHAIN              3     // cursor: iterates records containing network
+
+#if defined(HAVE_IMMINTRIN_H) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#   define NETCALC_SMALLSET_X86        1     // small sets: compare networks with SSE2 and AVX2 instructions
+#endif
+
+#define NETCALC_GAP_NONE               0xff  // gaps: no unallocated addresses between records
+
+#define NETCALC_STRIPES                16    // counters: slots of counters shared by threads
+#define NETCALC_STRIPE_CTRS            4     // counters: counters within each slot
+#define NETCALC_CTR_CACHE_HITS         0     // counters: queries answered by cache
+#define NETCALC_CTR_CACHE_MISSES       1     // counters: queries not answered by cache
+#define NETCALC_CTR_FILTER_REJECTS     0     // counters: queries rejected by filter
+#define NETCALC_CTR_FILTER_PASSES      1     // counters: queries passed by filter
+#define NETCALC_CTR_FILTER_FALSE       2     // counters: queries passed by filter which did not match a record
+
 
 //////////////////
 //              //
@@ -78,7 +104,22 @@
 //////////////////
 // MARK: - Data Types
 
+typedef struct _libnetcalc_cache             netcalc_cache_t;
+typedef struct _libnetcalc_cache_entry       netcalc_cache_ent_t;
+typedef struct _libnetcalc_class_node        netcalc_class_node_t;
+typedef struct _libnetcalc_class_prefix      netcalc_class_pfx_t;
+typedef struct _libnetcalc_filter            netcalc_filter_t;
+typedef struct _libnetcalc_gaps              netcalc_gaps_t;
+typedef struct _libnetcalc_hosts             netcalc_hosts_t;
+typedef struct _libnetcalc_journal           netcalc_jrnl_t;
+typedef struct _libnetcalc_keys              netcalc_keys_t;
 typedef struct _libnetcalc_network_buffer    netcalc_buff_t;
+typedef struct _libnetcalc_observer          netcalc_obs_t;
+typedef struct _libnetcalc_range_entry       netcalc_rent_t;
+typedef struct _libnetcalc_rcu_reader        netcalc_rcu_rdr_t;
+typedef struct _libnetcalc_rcu_retired       netcalc_rcu_old_t;
+typedef struct _libnetcalc_snapshot          netcalc_snap_t;
+typedef struct _libnetcalc_stripe            netcalc_stripe_t;
 
 
 union _libnetcalc_address
@@ -103,6 +144,99 @@ struct _libnetcalc_records
 {  uint32_t                   len;
    uint32_t                   size;
    netcalc_rec_t **           list;
+   netcalc_gaps_t *           gaps;
+   _Atomic(netcalc_keys_t *)  keys;
+};
+
+
+// results of queries are cached in a direct-mapped table, entries are
+// replaced under a sequence lock so that concurrent readers may fill the
+// cache of a set without locking
+struct _libnetcalc_cache
+{  uint32_t                   cache_gen;     // incremented when records are replaced without modifying set
+   uint32_t                   __pad_uint32_t;
+   size_t                     cache_mask;    // number of entries minus one
+   netcalc_stripe_t *         cache_ctrs;    // hits and misses
+   netcalc_cache_ent_t *      cache_ents;
+};
+
+
+struct _libnetcalc_cache_entry
+{  atomic_uint                ent_seq;       // odd while entry is being replaced
+   atomic_uint                ent_cidr;
+   atomic_uint_least64_t      ent_tag;       // generation and serial of set, zero if unused
+   atomic_uint_least64_t      ent_key[2];
+   _Atomic(netcalc_rec_t *)   ent_rec;       // NULL if query did not match a record
+};
+
+
+// special-purpose prefixes are compiled into a trie with a stride of one
+// byte, the categories of an address are the union of the categories of
+// the entries along the path of the address
+struct _libnetcalc_class_node
+{  uint16_t                   node_class[256];  // categories of prefixes ending within entry
+   uint8_t                    node_child[256];  // index of next node, zero if none
+};
+
+
+struct _libnetcalc_class_prefix
+{  uint32_t                   pfx_family;    // address family of prefix, zero terminates registry
+   uint32_t                   pfx_class;     // categories of addresses within prefix
+   uint8_t                    pfx_cidr;      // prefix length relative to family
+   uint8_t                    pfx_addr[16];  // prefix in network byte order, IPv4 uses first four bytes
+   uint8_t                    __pad[3];
+};
+
+
+// prefixes of records are added to a blocked Bloom filter, each prefix sets
+// bits within a single word, deleted records clear the count of the prefix
+// length and leave stale bits until the filter is rebuilt
+struct _libnetcalc_filter
+{  size_t                     filter_mask;           // number of words minus one
+   size_t                     filter_count;          // number of prefixes added to filter
+   size_t                     filter_stale;          // number of prefixes of deleted records
+   netcalc_stripe_t *         filter_ctrs;           // rejects, passes, and false positives
+   uint64_t *                 filter_words;
+   uint32_t                   filter_prefixes[129];  // number of records of each prefix length
+   uint8_t                    filter_lens[129];      // prefix lengths of records in ascending order
+   uint8_t                    filter_nlens;
+   uint16_t                   __pad_uint16_t;
+};
+
+
+// segment tree of the largest unallocated block between adjacent records,
+// leaf 'n' describes the addresses between list[n] and list[n+1]
+struct _libnetcalc_gaps
+{  uint32_t                   gaps_leaves;
+   uint8_t                    gaps_tree[];
+};
+
+
+// records of hosts are indexed by address in an open addressing hash table
+// with linear probing, slots of removed records are filled by shifting the
+// following records of the probe sequence
+struct _libnetcalc_hosts
+{  size_t                     hosts_len;     // number of indexed records
+   size_t                     hosts_mask;    // number of slots minus one
+   netcalc_rec_t **           hosts_table;
+};
+
+
+// addresses of records are packed into arrays of integers which are
+// compared in place of the records, records within IPv4 mapped addresses
+// and within the link-local addresses to which EUI addresses are mapped are
+// also packed into arrays of the width of the family
+struct _libnetcalc_keys
+{  uint32_t                   keys_in6_len;  // number of records which are not within the other families
+   uint32_t                   keys_in4;      // index of first record within IPv4 mapped addresses
+   uint32_t                   keys_in4_len;
+   uint32_t                   keys_eui;      // index of first record within link-local addresses of EUI addresses
+   uint32_t                   keys_eui_len;
+   uint32_t                   __pad;
+   uint64_t *                 keys_in6;      // two integers per record, most significant first
+   uint64_t *                 keys_eui64;    // least significant 64 bits of records within link-local addresses
+   uint32_t *                 keys_in4_32;   // least significant 32 bits of records within IPv4 mapped addresses
+   uint8_t *                  keys_cidrs;    // prefix lengths of records of each family, in order of the arrays above
 };
 
 
@@ -111,6 +245,8 @@ struct _libnetcalc_record
    uint16_t                   __pad_uint16_t;
    uint8_t                    rec_cidr;
    uint8_t                    rec_used;
+   atomic_uintmax_t           rec_refs;      // number of lists referencing record
+   atomic_uintmax_t           rec_hits;      // number of queries matching record
    netcalc_addr_t             rec_addr;
    char *                     rec_comment;
    void *                     rec_data;
@@ -121,8 +257,135 @@ struct _libnetcalc_record
 struct _libnetcalc_set
 {  uint32_t                   set_flags;
    uint32_t                   set_serial;
+   uint32_t                   set_handles;   // serial of record handles, incremented when records are freed or replaced
+   uint32_t                   __pad_uint32_t;
    netcalc_net_t *            set_superblock;
    netcalc_recs_t             set_recs;
+   atomic_uintmax_t *         set_shared;    // number of sets referencing list of top level records, NULL if not shared
+   atomic_uintmax_t *         set_clones;    // number of clones sharing records, NULL if records are not shared
+   netcalc_snap_t *           set_snap;      // image of snapshot referenced by records
+   netcalc_jrnl_t *           set_jrnl;      // journal of modifications
+   netcalc_obs_t *            set_obs;       // callbacks notified of modifications
+   netcalc_cache_t *          set_cache;     // results of previous queries, NULL if not cached
+   netcalc_hosts_t *          set_hosts;     // index of host records, NULL if not indexed
+   netcalc_filter_t *         set_filter;    // filter of prefixes of records, NULL if not filtered
+};
+
+
+struct _libnetcalc_journal
+{  int                        jrnl_fd;
+   uint32_t                   jrnl_len;      // length of entry buffer
+   uint64_t                   jrnl_off;      // offset of last appended entry
+   uint8_t *                  jrnl_buff;     // entry buffer
+};
+
+
+struct _libnetcalc_observer
+{  int (*obs_func)(void * ctx, int op, const netcalc_net_t * net, const char * comment, void * data, int flags, uint32_t serial);
+   void *                     obs_ctx;
+   netcalc_obs_t *            obs_next;
+};
+
+
+// payload of a range within a set of ranges
+struct _libnetcalc_range_entry
+{  uint32_t                   ent_flags;     // address family of range
+   uint32_t                   __pad_uint32_t;
+   char *                     ent_comment;
+   void *                     ent_data;
+};
+
+
+// disjoint ranges are stored in ascending order, the first and last
+// addresses of ranges are packed into separate arrays of integers so that
+// searches only read the first addresses of ranges
+struct _libnetcalc_range_set
+{  size_t                     rset_len;      // number of ranges
+   size_t                     rset_size;     // number of ranges which fit within arrays
+   uint64_t *                 rset_first;    // two integers per range, most significant first
+   uint64_t *                 rset_last;     // two integers per range, most significant first
+   netcalc_rent_t *           rset_ents;
+};
+
+
+// readers publish the epoch observed when entering a read-side critical
+// section, versions retired at a later epoch may not be referenced
+struct _libnetcalc_rcu
+{  _Atomic(netcalc_set_t *)   rcu_set;       // published version of set
+   atomic_uintmax_t           rcu_epoch;
+   atomic_uintmax_t           rcu_writer;    // non-zero while a writer is modifying a copy of set
+   netcalc_rcu_rdr_t *        rcu_rdrs;
+   size_t                     rcu_nrdrs;
+   netcalc_rcu_old_t *        rcu_retired;   // versions waiting to be freed
+};
+
+
+// reader slots are aligned to cache lines to prevent false sharing
+struct _libnetcalc_rcu_reader
+{  atomic_uintmax_t           rdr_epoch;     // epoch observed by reader, zero if reader is quiescent
+   atomic_uintmax_t           rdr_used;      // non-zero if slot is registered
+   uint8_t                    __pad[48];
+};
+
+
+struct _libnetcalc_rcu_retired
+{  netcalc_set_t *            old_set;
+   uintmax_t                  old_epoch;     // epoch at which version was replaced
+   netcalc_rcu_old_t *        old_next;
+};
+
+
+// keys and masks of networks are stored in separate arrays for each 32-bit
+// word of the address and are ordered from the most specific to the least
+// specific network, an address is compared with several networks by each
+// vector instruction and the first matching network is the most specific
+struct _libnetcalc_small_set
+{  uint32_t                   ss_keys[4][NETCALC_SMALLSET_MAX];   // words of networks, aligned for vector loads
+   uint32_t                   ss_masks[4][NETCALC_SMALLSET_MAX];  // words of netmasks, zero for unused entries
+   uint8_t                    ss_cidrs[NETCALC_SMALLSET_MAX];
+   uint8_t                    ss_index[NETCALC_SMALLSET_MAX];     // position of network within list used to initialize set
+   uint64_t                   ss_valid;                           // bit of each used entry
+   size_t                     ss_len;
+   uint64_t (*ss_match)(const netcalc_smallset_t * ss, const netcalc_addr_t * addr);
+};
+
+
+// records of a set opened from a snapshot are allocated as a single array
+// and reference the comments within the image of the snapshot
+struct _libnetcalc_snapshot
+{  void *                     snap_map;
+   size_t                     snap_len;
+   netcalc_rec_t *            snap_recs;
+   netcalc_rec_t **           snap_lists;
+   uint32_t                   snap_count;
+   uint32_t                   snap_mmap;     // image is mapped instead of allocated
+};
+
+
+// statistics are counted within slots aligned to cache lines, each thread
+// increments the slot assigned to the thread and readers of the statistics
+// sum the slots
+struct _libnetcalc_stripe
+{  atomic_uintmax_t           stripe_ctrs[NETCALC_STRIPE_CTRS];
+   uint8_t                    __pad[32];
+};
+
+
+struct _libnetcalc_subnet_iter
+{  netcalc_net_t              iter_net;      // next subnet
+   netcalc_addr_t             iter_last;     // address of last subnet
+   uint64_t                   iter_done;     // last subnet has been returned
+};
+
+
+struct _libnetcalc_superblock
+{  uint64_t                   acc_diff[2];   // bits which differ from first address, most significant first
+   uint64_t                   acc_count;     // number of networks added
+   uint32_t                   acc_flags;     // address family of first network
+   uint32_t                   acc_mixed;     // networks of more than one address family were added
+   uint8_t                    acc_cidr;      // shortest prefix length of networks
+   uint8_t                    __pad[15];
+   netcalc_addr_t             acc_addr;      // address of first network
 };
 
 
@@ -130,7 +393,18 @@ struct _libnetcalc_cursor
 {  uint32_t                   cur_depth;
    uint32_t                   cur_serial;
    uint32_t                   cur_idx[130];
+   uint32_t                   cur_type;
+   uint32_t                   cur_end;       // blocks: end of records within network; chain: length of chain
+   uint32_t                   cur_flags;     // blocks: address family of network
+   uint32_t                   cur_base;      // covered: depth of first record
+   uint8_t                    cur_cidr;      // prefix length of network
+   uint8_t                    cur_done;      // no further records or blocks
+   uint8_t                    __pad[6];
+   netcalc_addr_t             cur_addr;      // address of network
+   netcalc_addr_t             cur_pos;       // blocks: next unexamined address
+   netcalc_recs_t *           cur_recs;      // blocks: list of records within network
    netcalc_set_t *            cur_set;
+   netcalc_rec_t *            cur_last;      // record returned by previous call, NULL if none
 };
 
 
@@ -147,6 +421,8 @@ struct _libnetcalc_network_buffer
 /////////////////
 // MARK: - Variables
 
+extern const netcalc_class_pfx_t _netcalc_class_registry[];
+extern _Atomic(netcalc_class_node_t *) _netcalc_class_trie;
 extern const netcalc_net_t    _netcalc_ipv4_mapped_ipv6;
 extern const netcalc_net_t    _netcalc_link_local_in;
 extern const netcalc_net_t    _netcalc_link_local_in6;
@@ -163,6 +439,47 @@ extern const netcalc_net_t    _netcalc_slaac_in6;
 //////////////////
 // MARK: - Prototypes
 
+extern void *
+netcalc_aligned_alloc(
+         size_t                        alignment,
+         size_t                        size );
+
+
+extern void
+netcalc_aligned_free(
+         void *                        ptr );
+
+
+extern uint64_t
+netcalc_addr_be64(
+         const netcalc_addr_t *        addr,
+         int                           idx );
+
+
+extern void
+netcalc_addr_be64_set(
+         netcalc_addr_t *              addr,
+         int                           idx,
+         uint64_t                      word );
+
+
+extern uint8_t
+netcalc_addr_block(
+         const netcalc_addr_t *        first,
+         const netcalc_addr_t *        last );
+
+
+extern int
+netcalc_addr_ceil(
+         netcalc_addr_t *              addr,
+         uint8_t                       cidr );
+
+
+extern unsigned
+netcalc_addr_clz(
+         uint64_t                      word );
+
+
 extern int
 netcalc_addr_cmp(
          const netcalc_addr_t *        a1,
@@ -202,6 +519,178 @@ netcalc_addr_convert_inet6(
          int                           family  );
 
 
+extern void
+netcalc_addr_decr(
+         netcalc_addr_t *              addr );
+
+
+extern size_t
+netcalc_addr_hash(
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr );
+
+
+extern int
+netcalc_addr_incr(
+         netcalc_addr_t *              addr );
+
+
+extern uint8_t
+netcalc_addr_largest(
+         const netcalc_addr_t *        first,
+         const netcalc_addr_t *        last );
+
+
+extern void
+netcalc_addr_last(
+         netcalc_addr_t *              dst,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr );
+
+
+extern int
+netcalc_addr_span(
+         const netcalc_addr_t *        first,
+         const netcalc_addr_t *        last );
+
+
+extern void
+netcalc_cache_flush(
+         netcalc_set_t *               ns );
+
+
+extern void
+netcalc_cache_free(
+         netcalc_cache_t *             cache );
+
+
+extern int
+netcalc_cache_get(
+         netcalc_set_t *               ns,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr,
+         netcalc_rec_t **              recp );
+
+
+extern void
+netcalc_cache_put(
+         netcalc_set_t *               ns,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr,
+         netcalc_rec_t *               rec );
+
+
+extern int
+netcalc_filter_build(
+         netcalc_set_t *               ns );
+
+
+extern int
+netcalc_filter_copy(
+         netcalc_set_t *               dst,
+         const netcalc_set_t *         src );
+
+
+extern void
+netcalc_filter_free(
+         netcalc_set_t *               ns );
+
+
+extern void
+netcalc_filter_insert(
+         netcalc_set_t *               ns,
+         const netcalc_rec_t *         rec );
+
+
+extern void
+netcalc_filter_remove(
+         netcalc_set_t *               ns,
+         const netcalc_rec_t *         rec );
+
+
+extern int
+netcalc_filter_test(
+         netcalc_set_t *               ns,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr );
+
+
+extern int
+netcalc_hosts_build(
+         netcalc_set_t *               ns );
+
+
+extern int
+netcalc_hosts_copy(
+         netcalc_set_t *               dst,
+         const netcalc_set_t *         src );
+
+
+extern netcalc_rec_t *
+netcalc_hosts_find(
+         const netcalc_set_t *         ns,
+         const netcalc_addr_t *        addr );
+
+
+extern void
+netcalc_hosts_free(
+         netcalc_set_t *               ns );
+
+
+extern int
+netcalc_hosts_insert(
+         netcalc_set_t *               ns,
+         netcalc_rec_t *               rec );
+
+
+extern void
+netcalc_hosts_remove(
+         netcalc_set_t *               ns,
+         const netcalc_rec_t *         rec );
+
+
+extern void
+netcalc_hosts_replace(
+         netcalc_set_t *               ns,
+         const netcalc_rec_t *         src,
+         netcalc_rec_t *               rec );
+
+
+extern int
+netcalc_jrnl_append(
+         netcalc_set_t *               ns,
+         int                           op,
+         const netcalc_rec_t *         rec );
+
+
+extern void
+netcalc_jrnl_close(
+         netcalc_set_t *               ns );
+
+
+extern int
+netcalc_jrnl_revert(
+         netcalc_set_t *               ns );
+
+
+extern int
+netcalc_keys_bindex(
+         const netcalc_keys_t *        keys,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr,
+         uint32_t *                    wouldbep );
+
+
+extern void
+netcalc_keys_free(
+         netcalc_recs_t *              recs );
+
+
+extern netcalc_keys_t *
+netcalc_keys_get(
+         netcalc_recs_t *              recs );
+
+
 extern int
 netcalc_net_parse(
          netcalc_buff_t *              b,
@@ -209,6 +698,105 @@ netcalc_net_parse(
          int                           flags );
 
 
+extern int
+netcalc_range_addrs(
+         const netcalc_net_t *         first,
+         const netcalc_net_t *         last,
+         netcalc_addr_t *              startp,
+         netcalc_addr_t *              endp );
+
+
+extern int
+netcalc_range_parse(
+         const char *                  address,
+         int                           flags,
+         netcalc_buff_t *              firstp,
+         netcalc_buff_t *              lastp );
+
+
+extern int
+netcalc_rec_dup(
+         const netcalc_rec_t *         src,
+         netcalc_rec_t **              recp );
+
+
+extern void
+netcalc_rec_free(
+         netcalc_rec_t *               rec );
+
+
+extern int
+netcalc_set_dup(
+         netcalc_set_t **              nsp,
+         const netcalc_set_t *         ns );
+
+
+#ifdef NETCALC_SMALLSET_X86
+extern uint64_t
+netcalc_smallset_match_avx2(
+         const netcalc_smallset_t *    ss,
+         const netcalc_addr_t *        addr );
+#endif
+
+
+extern uint64_t
+netcalc_smallset_match_scalar(
+         const netcalc_smallset_t *    ss,
+         const netcalc_addr_t *        addr );
+
+
+#ifdef NETCALC_SMALLSET_X86
+extern uint64_t
+netcalc_smallset_match_sse2(
+         const netcalc_smallset_t *    ss,
+         const netcalc_addr_t *        addr );
+#endif
+
+
+extern int
+netcalc_snap_copy(
+         netcalc_set_t *               ns );
+
+
+extern void
+netcalc_snap_free(
+         netcalc_set_t *               ns );
+
+
+extern int
+netcalc_snap_map(
+         netcalc_snap_t **             snapp,
+         const char *                  path );
+
+
+extern int
+netcalc_snap_save(
+         netcalc_set_t *               ns,
+         const char *                  path,
+         int (*writer)(FILE *, const netcalc_set_t *) );
+
+
+extern void
+netcalc_snap_unmap(
+         netcalc_snap_t *              snap );
+
+
+extern void
+netcalc_stripes_add(
+         netcalc_stripe_t *            stripes,
+         int                           ctr );
+
+
+extern netcalc_stripe_t *
+netcalc_stripes_alloc( void );
+
+
+extern uintmax_t
+netcalc_stripes_sum(
+         const netcalc_stripe_t *      stripes,
+         int                           ctr );
+
+
 extern size_t
 netcalc_strlcat(
          char * restrict               dst,
@@ -223,5 +811,9 @@ netcalc_strlcpy(
          size_t                        dstsize );
 
 
+extern void
+netcalc_yield( void );
+
+
 #endif /* end of header */
 
@@ -0,0 +1,535 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __LIB_LIBNETCALC_LJOURNAL_C 1
+#include "libnetcalc.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#define NETCALC_JRNL_MAGIC       "NCJNL\0\r\n"
+#define NETCALC_JRNL_ORDER       0x01020304
+#define NETCALC_JRNL_VERSION     2
+
+
+//////////////////
+//              //
+//  Data Types  //
+//              //
+//////////////////
+// MARK: - Data Types
+
+typedef struct _libnetcalc_jrnl_header    netcalc_jrnl_hdr_t;
+typedef struct _libnetcalc_jrnl_entry     netcalc_jrnl_ent_t;
+
+
+struct _libnetcalc_jrnl_header
+{  uint8_t                    hdr_magic[8];
+   uint32_t                   hdr_order;     // byte order of journal
+   uint32_t                   hdr_version;
+   uint32_t                   hdr_flags;     // flags of set
+   uint32_t                   hdr_sb_flags;  // flags of superblock, zero if set does not have a superblock
+   uint8_t                    hdr_sb_cidr;
+   uint8_t                    __pad[3];
+   uint8_t                    hdr_sb_addr[16];
+};
+
+
+// entry is immediately followed by the comment
+struct _libnetcalc_jrnl_entry
+{  uint32_t                   jent_len;      // length of entry including comment
+   uint32_t                   jent_flags;    // flags of record
+   uint32_t                   jent_comment;  // length of comment including terminating NUL, zero if no comment
+   uint8_t                    jent_op;       // type of modification
+   uint8_t                    jent_cidr;
+   uint8_t                    __pad[2];
+   uint8_t                    jent_addr[16];
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+netcalc_jrnl_apply(
+         netcalc_set_t *               ns,
+         const netcalc_jrnl_ent_t *    jent,
+         const char *                  comment,
+         int                           overlap );
+
+
+static void
+netcalc_jrnl_header(
+         const netcalc_set_t *         ns,
+         netcalc_jrnl_hdr_t *          hdr );
+
+
+static int
+netcalc_jrnl_write(
+         int                           fd,
+         const void *                  buff,
+         size_t                        len );
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+// appends entry to journal of set before the modification is applied, a
+// partially written entry is removed so the set is not modified
+int
+netcalc_jrnl_append(
+         netcalc_set_t *               ns,
+         int                           op,
+         const netcalc_rec_t *         rec )
+{
+   size_t                  len;
+   size_t                  comment;
+   off_t                   off;
+   void *                  ptr;
+   netcalc_jrnl_t *        jrnl;
+   netcalc_jrnl_ent_t      jent;
+
+   assert(ns            != NULL);
+   assert(rec           != NULL);
+
+   if ((jrnl = ns->set_jrnl) == NULL)
+      return(0);
+
+   comment  = ( (op != NETCALC_MOD_DEL) && ((rec->rec_comment)) ) ? strlen(rec->rec_comment) + 1 : 0;
+   len      = sizeof(netcalc_jrnl_ent_t) + comment;
+   if (len > UINT32_MAX)
+      return(NETCALC_ERANGE);
+
+   memset(&jent, 0, sizeof(jent));
+   memcpy(jent.jent_addr, &rec->rec_addr, sizeof(jent.jent_addr));
+   jent.jent_len     = (uint32_t)len;
+   jent.jent_flags   = rec->rec_flags;
+   jent.jent_comment = (uint32_t)comment;
+   jent.jent_op      = (uint8_t)op;
+   jent.jent_cidr    = rec->rec_cidr;
+
+   // assemble entry so it is appended with a single write
+   if (len > jrnl->jrnl_len)
+   {  if ((ptr = realloc(jrnl->jrnl_buff, len)) == NULL)
+         return(NETCALC_ENOMEM);
+      jrnl->jrnl_buff   = ptr;
+      jrnl->jrnl_len    = (uint32_t)len;
+   };
+   memcpy(jrnl->jrnl_buff, &jent, sizeof(jent));
+   if ((comment))
+      memcpy(&jrnl->jrnl_buff[sizeof(jent)], rec->rec_comment, comment);
+
+   if ((off = lseek(jrnl->jrnl_fd, 0, SEEK_END)) == -1)
+      return(NETCALC_EIO);
+   jrnl->jrnl_off = (uint64_t)off;
+
+   if (netcalc_jrnl_write(jrnl->jrnl_fd, jrnl->jrnl_buff, len) != 0)
+   {  netcalc_jrnl_revert(ns);
+      return(NETCALC_EIO);
+   };
+
+   return(0);
+}
+
+
+// applies journal entry to set, modifications are journaled only if they
+// are accepted by the set, so entries are only rejected if they overlap a
+// snapshot which was saved before the journal was truncated
+int
+netcalc_jrnl_apply(
+         netcalc_set_t *               ns,
+         const netcalc_jrnl_ent_t *    jent,
+         const char *                  comment,
+         int                           overlap )
+{
+   int                  rc;
+   int                  flags;
+   netcalc_buff_t       nbuff;
+   netcalc_net_t *      net;
+
+   assert(ns   != NULL);
+   assert(jent != NULL);
+
+   net = &nbuff.buff_net;
+   memset(net, 0, sizeof(netcalc_net_t));
+   memcpy(&net->net_addr, jent->jent_addr, sizeof(netcalc_addr_t));
+   net->net_cidr  = jent->jent_cidr;
+   net->net_flags = jent->jent_flags & NETCALC_AF;
+   if ((rc = netcalc_addr_convert(&net->net_addr, (int)(net->net_flags & NETCALC_AF), NETCALC_AF_INET6)) != 0)
+      return(NETCALC_EBADFILE);
+   flags = (int)(jent->jent_flags & NETCALC_USR);
+
+   switch(jent->jent_op)
+   {  case NETCALC_MOD_ADD:
+         rc = netcalc_set_add(ns, net, comment, NULL, flags);
+         break;
+
+      case NETCALC_MOD_DEL:
+         rc = netcalc_set_del(ns, net);
+         break;
+
+      case NETCALC_MOD_UPDATE:
+         rc = netcalc_set_update(ns, net, comment, NULL, flags);
+         break;
+
+      default:
+         return(NETCALC_EBADFILE);
+   };
+
+   if (!(overlap))
+      return( ((rc)) ? NETCALC_EBADFILE : 0 );
+
+   // records of snapshot may conflict with subnets and supernets which were
+   // added and deleted before the snapshot was saved
+   switch(rc)
+   {  case NETCALC_EEXISTS:
+      case NETCALC_ENOREC:
+         return(0);
+
+      case NETCALC_ESUBNET:
+      case NETCALC_ESUPERNET:
+         return( ((ns->set_flags & NETCALC_FLG_UNIQ)) ? 0 : NETCALC_EBADFILE );
+
+      case NETCALC_ERANGE:
+         return(NETCALC_EBADFILE);
+
+      default:
+         break;
+   };
+
+   return(rc);
+}
+
+
+void
+netcalc_jrnl_close(
+         netcalc_set_t *               ns )
+{
+   assert(ns != NULL);
+
+   if (!(ns->set_jrnl))
+      return;
+
+   close(ns->set_jrnl->jrnl_fd);
+   if ((ns->set_jrnl->jrnl_buff))
+      free(ns->set_jrnl->jrnl_buff);
+   free(ns->set_jrnl);
+   ns->set_jrnl = NULL;
+
+   return;
+}
+
+
+// initializes header of journal of set
+void
+netcalc_jrnl_header(
+         const netcalc_set_t *         ns,
+         netcalc_jrnl_hdr_t *          hdr )
+{
+   assert(ns  != NULL);
+   assert(hdr != NULL);
+
+   memset(hdr, 0, sizeof(netcalc_jrnl_hdr_t));
+   memcpy(hdr->hdr_magic, NETCALC_JRNL_MAGIC, sizeof(hdr->hdr_magic));
+   hdr->hdr_order    = NETCALC_JRNL_ORDER;
+   hdr->hdr_version  = NETCALC_JRNL_VERSION;
+   hdr->hdr_flags    = ns->set_flags;
+   if ((ns->set_superblock))
+   {  memcpy(hdr->hdr_sb_addr, &ns->set_superblock->net_addr, sizeof(hdr->hdr_sb_addr));
+      hdr->hdr_sb_cidr  = ns->set_superblock->net_cidr;
+      hdr->hdr_sb_flags = ns->set_superblock->net_flags;
+   };
+
+   return;
+}
+
+
+// removes last appended entry when the modification could not be applied
+int
+netcalc_jrnl_revert(
+         netcalc_set_t *               ns )
+{
+   assert(ns != NULL);
+
+   if (!(ns->set_jrnl))
+      return(0);
+
+   if (ftruncate(ns->set_jrnl->jrnl_fd, (off_t)ns->set_jrnl->jrnl_off) == -1)
+      return(NETCALC_EIO);
+
+   return(0);
+}
+
+
+int
+netcalc_jrnl_write(
+         int                           fd,
+         const void *                  buff,
+         size_t                        len )
+{
+   ssize_t              rc;
+   const uint8_t *      ptr;
+
+   assert(buff != NULL);
+
+   ptr = buff;
+   while(len > 0)
+   {  if ((rc = write(fd, ptr, len)) < 0)
+         return(NETCALC_EIO);
+      ptr += rc;
+      len -= (size_t)rc;
+   };
+
+   return(0);
+}
+
+
+int
+netcalc_set_compact(
+         netcalc_set_t *               ns,
+         const char *                  snapshot )
+{
+   int                  rc;
+
+   assert(ns       != NULL);
+   assert(snapshot != NULL);
+
+   if ((rc = netcalc_set_save(ns, snapshot)) != 0)
+      return(rc);
+
+   // discard entries included in snapshot
+   if ((ns->set_jrnl))
+      if (ftruncate(ns->set_jrnl->jrnl_fd, (off_t)sizeof(netcalc_jrnl_hdr_t)) == -1)
+         return(NETCALC_EIO);
+
+   return(0);
+}
+
+
+int
+netcalc_set_journal(
+         netcalc_set_t *               ns,
+         const char *                  path )
+{
+   int                     fd;
+   struct stat             sb;
+   netcalc_jrnl_t *        jrnl;
+   netcalc_jrnl_hdr_t      hdr;
+   netcalc_jrnl_hdr_t      exp;
+
+   assert(ns != NULL);
+
+   netcalc_jrnl_close(ns);
+   if (!(path))
+      return(0);
+
+   netcalc_jrnl_header(ns, &exp);
+
+   if ((fd = open(path, O_RDWR | O_CREAT | O_APPEND, 0644)) == -1)
+      return(NETCALC_EIO);
+   if (fstat(fd, &sb) == -1)
+   {  close(fd);
+      return(NETCALC_EIO);
+   };
+
+   // write header of new journal, or verify existing journal is of a set
+   // with the same flags and superblock
+   if (sb.st_size == 0)
+   {  if (netcalc_jrnl_write(fd, &exp, sizeof(exp)) != 0)
+      {  close(fd);
+         return(NETCALC_EIO);
+      };
+   } else
+   {  if ( (sb.st_size < (off_t)sizeof(hdr)) || (pread(fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr)) )
+      {  close(fd);
+         return(NETCALC_EBADFILE);
+      };
+      if ((memcmp(&hdr, &exp, sizeof(hdr))))
+      {  close(fd);
+         return(NETCALC_EBADFILE);
+      };
+   };
+
+   if ((jrnl = malloc(sizeof(netcalc_jrnl_t))) == NULL)
+   {  close(fd);
+      return(NETCALC_ENOMEM);
+   };
+   memset(jrnl, 0, sizeof(netcalc_jrnl_t));
+   jrnl->jrnl_fd  = fd;
+   ns->set_jrnl   = jrnl;
+
+   return(0);
+}
+
+
+int
+netcalc_set_replay(
+         netcalc_set_t **              nsp,
+         const char *                  snapshot,
+         const char *                  journal )
+{
+   int                     rc;
+   size_t                  len;
+   size_t                  size;
+   char *                  comment;
+   void *                  ptr;
+   FILE *                  fs;
+   netcalc_set_t *         ns;
+   netcalc_jrnl_hdr_t      hdr;
+   netcalc_jrnl_hdr_t      exp;
+   netcalc_jrnl_ent_t      jent;
+   netcalc_buff_t          nbuff;
+
+   assert(nsp != NULL);
+
+   *nsp = NULL;
+
+   // verify journal
+   fs = NULL;
+   if ((journal))
+   {  if ((fs = fopen(journal, "rb")) == NULL)
+         return(NETCALC_EIO);
+      if ( (fread(&hdr, sizeof(hdr), 1, fs) != 1) ||
+           ((memcmp(hdr.hdr_magic, NETCALC_JRNL_MAGIC, sizeof(hdr.hdr_magic)))) ||
+           (hdr.hdr_order != NETCALC_JRNL_ORDER) ||
+           (hdr.hdr_version != NETCALC_JRNL_VERSION) ||
+           ((hdr.hdr_flags & ~((uint32_t)NETCALC_FLGS_SET))) ||
+           (hdr.hdr_sb_cidr > 128) )
+      {  fclose(fs);
+         return(NETCALC_EBADFILE);
+      };
+   };
+
+   // load snapshot, or initialize set with flags and superblock of journal
+   if ((snapshot))
+   {  rc = netcalc_set_open_mmap(&ns, snapshot);
+   } else if ( ((fs)) && ((hdr.hdr_sb_flags)) )
+   {  memset(&nbuff, 0, sizeof(netcalc_buff_t));
+      memcpy(&nbuff.buff_net.net_addr, hdr.hdr_sb_addr, sizeof(netcalc_addr_t));
+      nbuff.buff_net.net_cidr    = hdr.hdr_sb_cidr;
+      nbuff.buff_net.net_flags   = hdr.hdr_sb_flags;
+      rc = netcalc_set_init(&ns, &nbuff.buff_net, (int)hdr.hdr_flags);
+   } else
+   {  rc = netcalc_set_init(&ns, NULL, ((fs)) ? (int)hdr.hdr_flags : 0);
+   };
+   if (rc != 0)
+   {  if ((fs))
+         fclose(fs);
+      return(rc);
+   };
+
+   if (!(fs))
+   {  *nsp = ns;
+      return(0);
+   };
+
+   // journal must be of a set with the same flags and superblock as snapshot
+   netcalc_jrnl_header(ns, &exp);
+   if ((memcmp(&hdr, &exp, sizeof(hdr))))
+   {  fclose(fs);
+      netcalc_set_free(ns);
+      return(NETCALC_EBADFILE);
+   };
+
+   // apply entries, stopping at an incomplete entry at the end of the journal
+   rc       = 0;
+   size     = 0;
+   comment  = NULL;
+   while( (rc == 0) && (fread(&jent, sizeof(jent), 1, fs) == 1) )
+   {  len = jent.jent_len - sizeof(jent);
+      if ( (jent.jent_len < sizeof(jent)) || (len != jent.jent_comment) || (jent.jent_cidr > 128) )
+      {  rc = NETCALC_EBADFILE;
+         break;
+      };
+      if ( ((len)) && (len > size) )
+      {  if ((ptr = realloc(comment, len)) == NULL)
+         {  rc = NETCALC_ENOMEM;
+            break;
+         };
+         comment  = ptr;
+         size     = len;
+      };
+      if ( ((len)) && (fread(comment, len, 1, fs) != 1) )
+         break;
+      if ( ((len)) && ((comment[len-1])) )
+      {  rc = NETCALC_EBADFILE;
+         break;
+      };
+      rc = netcalc_jrnl_apply(ns, &jent, ((len)) ? comment : NULL, ((snapshot)) ? 1 : 0);
+   };
+   if ( (rc == 0) && ((ferror(fs))) )
+      rc = NETCALC_EIO;
+   fclose(fs);
+   if ((comment))
+      free(comment);
+
+   if (rc != 0)
+   {  netcalc_set_free(ns);
+      return(rc);
+   };
+
+   *nsp = ns;
+
+   return(0);
+}
+
+
+/* end of source */
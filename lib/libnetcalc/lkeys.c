@@ -0,0 +1,401 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __LIB_LIBNETCALC_LKEYS_C 1
+#include "libnetcalc.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#define NETCALC_KEYS_MIN         8     // minimum number of records of indexed lists
+
+#define NETCALC_KEYS_IN6         0     // records compared as two 64-bit integers
+#define NETCALC_KEYS_IN4         1     // records within IPv4 mapped addresses compared as 32-bit integers
+#define NETCALC_KEYS_EUI         2     // records within link-local addresses of EUI addresses compared as 64-bit integers
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static netcalc_keys_t *
+netcalc_keys_alloc(
+         uint32_t                      len,
+         uint32_t                      in4_len,
+         uint32_t                      eui_len );
+
+
+static int
+netcalc_keys_cmp(
+         const netcalc_keys_t *        keys,
+         int                           family,
+         uint32_t                      pos,
+         uint64_t                      hi,
+         uint64_t                      lo,
+         uint8_t                       cidr );
+
+
+static int
+netcalc_keys_family(
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr );
+
+
+static int
+netcalc_keys_run(
+         const netcalc_recs_t *        recs,
+         int                           family,
+         uint32_t *                    firstp,
+         uint32_t *                    lenp );
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+// allocates keys and arrays of keys in a single block, the key of each
+// record is stored once within the array of its family
+netcalc_keys_t *
+netcalc_keys_alloc(
+         uint32_t                      len,
+         uint32_t                      in4_len,
+         uint32_t                      eui_len )
+{
+   size_t               size;
+   uint32_t             in6_len;
+   netcalc_keys_t *     keys;
+
+   in6_len  = len - in4_len - eui_len;
+   size     = sizeof(netcalc_keys_t) + ((size_t)in6_len * sizeof(uint64_t) * 2) + ((size_t)eui_len * sizeof(uint64_t)) + ((size_t)in4_len * sizeof(uint32_t)) + len;
+   if ((keys = malloc(size)) == NULL)
+      return(NULL);
+   memset(keys, 0, sizeof(netcalc_keys_t));
+
+   keys->keys_in6_len   = in6_len;
+   keys->keys_in4_len   = in4_len;
+   keys->keys_eui_len   = eui_len;
+   keys->keys_in6       = (uint64_t *)&keys[1];
+   keys->keys_eui64     = &keys->keys_in6[(size_t)in6_len * 2];
+   keys->keys_in4_32    = (uint32_t *)&keys->keys_eui64[eui_len];
+   keys->keys_cidrs     = (uint8_t *)&keys->keys_in4_32[in4_len];
+
+   return(keys);
+}
+
+
+// returns the relation of the network to the record at 'wouldbe', returns
+// NETCALC_IDX_ERROR if the network is not compared using the keys
+int
+netcalc_keys_bindex(
+         const netcalc_keys_t *        keys,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr,
+         uint32_t *                    wouldbep )
+{
+   int               rc;
+   int               family;
+   uint32_t          low;
+   uint32_t          mid;
+   uint32_t          high;
+   uint32_t          len;
+   uint64_t          hi;
+   uint64_t          lo;
+
+   assert(keys       != NULL);
+   assert(addr       != NULL);
+   assert(wouldbep   != NULL);
+
+   hi = netcalc_addr_be64(addr, 0);
+   lo = netcalc_addr_be64(addr, 1);
+
+   // records of other families within a list do not overlap a family, so
+   // only the records of the family are searched
+   family = netcalc_keys_family(addr, cidr);
+   switch(family)
+   {  case NETCALC_KEYS_IN4:
+         len = keys->keys_in4_len;
+         break;
+
+      case NETCALC_KEYS_EUI:
+         len = keys->keys_eui_len;
+         break;
+
+      default:
+         len = keys->keys_in6_len;
+         // networks which contain records of the other families are not
+         // compared using the keys
+         if ( ((keys->keys_in4_len)) && (netcalc_addr_cmp(addr, cidr, &_netcalc_ipv4_mapped_ipv6.net_addr, 96) == NETCALC_CMP_SUPERNET) )
+            return(NETCALC_IDX_ERROR);
+         if ( ((keys->keys_eui_len)) && (netcalc_addr_cmp(addr, cidr, &_netcalc_slaac_in6.net_addr, 64) == NETCALC_CMP_SUPERNET) )
+            return(NETCALC_IDX_ERROR);
+         break;
+   };
+   if (!(len))
+      return(NETCALC_IDX_ERROR);
+
+   low   = 0;
+   high  = len - 1;
+   while(1)
+   {  mid = (low + high) / 2;
+      rc  = netcalc_keys_cmp(keys, family, mid, hi, lo, cidr);
+      if ( ((rc == NETCALC_CMP_BEFORE) || (rc == NETCALC_CMP_SUPERNET)) && (low != mid) )
+         high = mid;
+      else if ( (rc == NETCALC_CMP_AFTER) && (high != mid) )
+         low = (mid < high) ? mid + 1 : mid;
+      else
+         break;
+   };
+
+   // convert position within family to index within list
+   switch(family)
+   {  case NETCALC_KEYS_IN4:
+         *wouldbep = keys->keys_in4 + mid;
+         break;
+
+      case NETCALC_KEYS_EUI:
+         *wouldbep = keys->keys_eui + mid;
+         break;
+
+      default:
+         if ( ((keys->keys_in4_len)) && (mid >= keys->keys_in4) )
+            mid += keys->keys_in4_len;
+         if ( ((keys->keys_eui_len)) && (mid >= keys->keys_eui) )
+            mid += keys->keys_eui_len;
+         *wouldbep = mid;
+         break;
+   };
+
+   return(rc);
+}
+
+
+// compares network with key of record as integers of the width of the family
+int
+netcalc_keys_cmp(
+         const netcalc_keys_t *        keys,
+         int                           family,
+         uint32_t                      pos,
+         uint64_t                      hi,
+         uint64_t                      lo,
+         uint8_t                       cidr )
+{
+   uint8_t        min;
+   uint8_t        key_cidr;
+   uint32_t       key32;
+   uint32_t       mask32;
+   uint64_t       key64;
+   uint64_t       mask64;
+
+   switch(family)
+   {  case NETCALC_KEYS_IN4:
+         key_cidr = keys->keys_cidrs[keys->keys_in6_len + keys->keys_eui_len + pos];
+         min      = (cidr < key_cidr) ? cidr : key_cidr;
+         mask32   = ((min -= 96)) ? (UINT32_MAX << (32 - min)) : 0;
+         key32    = keys->keys_in4_32[pos] & mask32;
+         if (((uint32_t)lo & mask32) != key32)
+            return( (((uint32_t)lo & mask32) < key32) ? NETCALC_CMP_BEFORE : NETCALC_CMP_AFTER );
+         break;
+
+      case NETCALC_KEYS_EUI:
+         key_cidr = keys->keys_cidrs[keys->keys_in6_len + pos];
+         min      = (cidr < key_cidr) ? cidr : key_cidr;
+         mask64   = ((min -= 64)) ? (UINT64_MAX << (64 - min)) : 0;
+         key64    = keys->keys_eui64[pos] & mask64;
+         if ((lo & mask64) != key64)
+            return( ((lo & mask64) < key64) ? NETCALC_CMP_BEFORE : NETCALC_CMP_AFTER );
+         break;
+
+      default:
+         key_cidr = keys->keys_cidrs[pos];
+         min      = (cidr < key_cidr) ? cidr : key_cidr;
+         mask64   = (min >= 64) ? UINT64_MAX : (((min)) ? (UINT64_MAX << (64 - min)) : 0);
+         key64    = keys->keys_in6[(size_t)pos * 2] & mask64;
+         if ((hi & mask64) != key64)
+            return( ((hi & mask64) < key64) ? NETCALC_CMP_BEFORE : NETCALC_CMP_AFTER );
+         mask64   = (min > 64) ? (UINT64_MAX << (128 - min)) : 0;
+         key64    = keys->keys_in6[(size_t)pos * 2 + 1] & mask64;
+         if ((lo & mask64) != key64)
+            return( ((lo & mask64) < key64) ? NETCALC_CMP_BEFORE : NETCALC_CMP_AFTER );
+         break;
+   };
+
+   if (cidr < key_cidr)
+      return(NETCALC_CMP_SUPERNET);
+   if (key_cidr < cidr)
+      return(NETCALC_CMP_SUBNET);
+   return(NETCALC_CMP_SAME);
+}
+
+
+int
+netcalc_keys_family(
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr )
+{
+   if ( (cidr >= 96) && (addr->addr64[0] == _netcalc_ipv4_mapped_ipv6.net_addr.addr64[0]) && (addr->addr32[2] == _netcalc_ipv4_mapped_ipv6.net_addr.addr32[2]) )
+      return(NETCALC_KEYS_IN4);
+   if ( (cidr >= 64) && (addr->addr64[0] == _netcalc_slaac_in6.net_addr.addr64[0]) )
+      return(NETCALC_KEYS_EUI);
+   return(NETCALC_KEYS_IN6);
+}
+
+
+void
+netcalc_keys_free(
+         netcalc_recs_t *              recs )
+{
+   assert(recs != NULL);
+   free(atomic_load_explicit(&recs->keys, memory_order_relaxed));
+   atomic_store_explicit(&recs->keys, NULL, memory_order_relaxed);
+   return;
+}
+
+
+// returns keys of list, building keys of lists which are not indexed, keys
+// are built by queries and are discarded when the list is modified
+netcalc_keys_t *
+netcalc_keys_get(
+         netcalc_recs_t *              recs )
+{
+   int                  family;
+   uint32_t             idx;
+   uint32_t             in6;
+   uint32_t             in4;
+   uint32_t             in4_len;
+   uint32_t             eui;
+   uint32_t             eui_len;
+   netcalc_rec_t *      rec;
+   netcalc_keys_t *     keys;
+   netcalc_keys_t *     prev;
+
+   assert(recs != NULL);
+
+   if ( ((keys = atomic_load_explicit(&recs->keys, memory_order_acquire)) != NULL) || (recs->len < NETCALC_KEYS_MIN) )
+      return(keys);
+
+   // records of a family are contiguous within a list because no sibling
+   // overlaps the range of the family
+   if ( ((netcalc_keys_run(recs, NETCALC_KEYS_IN4, &in4, &in4_len))) || ((netcalc_keys_run(recs, NETCALC_KEYS_EUI, &eui, &eui_len))) )
+      return(NULL);
+
+   if ((keys = netcalc_keys_alloc(recs->len, in4_len, eui_len)) == NULL)
+      return(NULL);
+   keys->keys_in4 = in4;
+   keys->keys_eui = eui;
+
+   for(idx = 0, in6 = 0; (idx < recs->len); idx++)
+   {  rec    = recs->list[idx];
+      family = netcalc_keys_family(&rec->rec_addr, rec->rec_cidr);
+      if (family == NETCALC_KEYS_IN4)
+      {  keys->keys_in4_32[idx - in4]                                   = (uint32_t)netcalc_addr_be64(&rec->rec_addr, 1);
+         keys->keys_cidrs[keys->keys_in6_len + eui_len + (idx - in4)]   = rec->rec_cidr;
+      } else if (family == NETCALC_KEYS_EUI)
+      {  keys->keys_eui64[idx - eui]                                    = netcalc_addr_be64(&rec->rec_addr, 1);
+         keys->keys_cidrs[keys->keys_in6_len + (idx - eui)]             = rec->rec_cidr;
+      } else
+      {  keys->keys_in6[(size_t)in6 * 2]                                = netcalc_addr_be64(&rec->rec_addr, 0);
+         keys->keys_in6[(size_t)in6 * 2 + 1]                            = netcalc_addr_be64(&rec->rec_addr, 1);
+         keys->keys_cidrs[in6]                                          = rec->rec_cidr;
+         in6++;
+      };
+   };
+
+   // lists of records shared by clones may be indexed by concurrent queries
+   prev = NULL;
+   if (!(atomic_compare_exchange_strong_explicit(&recs->keys, &prev, keys, memory_order_acq_rel, memory_order_acquire)))
+   {  free(keys);
+      keys = prev;
+   };
+
+   return(keys);
+}
+
+
+// locates the run of records of family within list, returns non-zero if
+// the records of the family are not contiguous
+int
+netcalc_keys_run(
+         const netcalc_recs_t *        recs,
+         int                           family,
+         uint32_t *                    firstp,
+         uint32_t *                    lenp )
+{
+   uint32_t                first;
+   uint32_t                idx;
+   const netcalc_rec_t *   rec;
+
+   for(first = 0; (first < recs->len); first++)
+   {  rec = recs->list[first];
+      if (netcalc_keys_family(&rec->rec_addr, rec->rec_cidr) == family)
+         break;
+   };
+   for(idx = first; (idx < recs->len); idx++)
+   {  rec = recs->list[idx];
+      if (netcalc_keys_family(&rec->rec_addr, rec->rec_cidr) != family)
+         break;
+   };
+   *firstp  = first;
+   *lenp    = idx - first;
+   for(; (idx < recs->len); idx++)
+   {  rec = recs->list[idx];
+      if (netcalc_keys_family(&rec->rec_addr, rec->rec_cidr) == family)
+         return(1);
+   };
+
+   return(0);
+}
+
+
+/* end of source */
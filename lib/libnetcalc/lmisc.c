@@ -42,9 +42,19 @@
 // MARK: - Headers
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#ifdef HAVE_SCHED_H
+#   include <sched.h>
+#endif
+#if defined(_WIN32) && !(defined(HAVE_SCHED_YIELD))
+#   include <windows.h>
+#endif
+#if defined(_WIN32) && !(defined(HAVE_POSIX_MEMALIGN))
+#   include <malloc.h>
+#endif
 
 
 //////////////
@@ -54,6 +64,14 @@
 //////////////
 // MARK: - Macros
 
+#if defined(_MSC_VER)
+#   define NETCALC_THREAD_LOCAL        __declspec(thread)
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+#   define NETCALC_THREAD_LOCAL        _Thread_local
+#elif defined(__GNUC__)
+#   define NETCALC_THREAD_LOCAL        __thread
+#endif
+
 
 ///////////////////
 //               //
@@ -70,6 +88,9 @@
 //////////////////
 // MARK: - Prototypes
 
+static unsigned
+netcalc_stripe( void );
+
 
 /////////////////
 //             //
@@ -78,6 +99,56 @@
 /////////////////
 // MARK: - Functions
 
+// allocates memory aligned to a power of two, memory is released with
+// netcalc_aligned_free()
+void *
+netcalc_aligned_alloc(
+         size_t                        alignment,
+         size_t                        size )
+{
+   void *         ptr;
+#if !(defined(HAVE_POSIX_MEMALIGN)) && !(defined(_WIN32))
+   uintptr_t      addr;
+#endif
+
+   assert((alignment & (alignment - 1)) == 0);
+   assert(alignment >= sizeof(void *));
+
+#if defined(HAVE_POSIX_MEMALIGN)
+   if (posix_memalign(&ptr, alignment, size) != 0)
+      return(NULL);
+#elif defined(_WIN32)
+   ptr = _aligned_malloc(size, alignment);
+#else
+   // store address of allocation before aligned memory
+   if ((ptr = malloc(size + alignment + sizeof(void *))) == NULL)
+      return(NULL);
+   addr = ((uintptr_t)ptr + sizeof(void *) + alignment - 1) & ~((uintptr_t)alignment - 1);
+   ((void **)addr)[-1] = ptr;
+   ptr = (void *)addr;
+#endif
+
+   return(ptr);
+}
+
+
+void
+netcalc_aligned_free(
+         void *                        ptr )
+{
+   if (!(ptr))
+      return;
+#if defined(HAVE_POSIX_MEMALIGN)
+   free(ptr);
+#elif defined(_WIN32)
+   _aligned_free(ptr);
+#else
+   free(((void **)ptr)[-1]);
+#endif
+   return;
+}
+
+
 const char *
 netcalc_strcmp(
          int                           code )
@@ -105,13 +176,16 @@ netcalc_strerror(
 
       case NETCALC_EBADADDR:     return("bad address string");
       case NETCALC_EBADFAM:      return("bad or unsupported family");
+      case NETCALC_EBADFILE:     return("bad or unsupported file format");
       case NETCALC_EBUFFLEN:     return("buffer length exceeeded");
       case NETCALC_EEXISTS:      return("record exists");
       case NETCALC_EFIELD:       return("unknown or unsupported field");
       case NETCALC_EINVAL:       return("invalid argument");
+      case NETCALC_EIO:          return("input/output error");
       case NETCALC_ENOMEM:       return("out of virtual memory");
       case NETCALC_ENOREC:       return("no record found or availble");
       case NETCALC_ENOTSUP:      return("operation not supported");
+      case NETCALC_EOBSERVER:    return("observer of modification failed");
       case NETCALC_ERANGE:       return("address is out of range");
       case NETCALC_ESETMOD:      return("set was modified");
       case NETCALC_ESUBNET:      return("subnet record exists");
@@ -125,6 +199,74 @@ netcalc_strerror(
 }
 
 
+// returns slot of counters used by the calling thread, slots are assigned
+// to threads in turn on first use
+unsigned
+netcalc_stripe( void )
+{
+#if defined(NETCALC_THREAD_LOCAL)
+   static atomic_uint                        next;
+   static NETCALC_THREAD_LOCAL unsigned      stripe;
+   if (!(stripe))
+      stripe = (atomic_fetch_add_explicit(&next, 1, memory_order_relaxed) % NETCALC_STRIPES) + 1;
+   return(stripe - 1);
+#else
+   // all threads share the first slot without thread-local storage
+   return(0);
+#endif
+}
+
+
+void
+netcalc_stripes_add(
+         netcalc_stripe_t *            stripes,
+         int                           ctr )
+{
+   assert(stripes != NULL);
+   assert(ctr     <  NETCALC_STRIPE_CTRS);
+   atomic_fetch_add_explicit(&stripes[netcalc_stripe()].stripe_ctrs[ctr], 1, memory_order_relaxed);
+   return;
+}
+
+
+// allocates zeroed slots of counters, slots are released with
+// netcalc_aligned_free()
+netcalc_stripe_t *
+netcalc_stripes_alloc( void )
+{
+   int                  ctr;
+   size_t               idx;
+   netcalc_stripe_t *   stripes;
+
+   if ((stripes = netcalc_aligned_alloc(sizeof(netcalc_stripe_t), (sizeof(netcalc_stripe_t) * NETCALC_STRIPES))) == NULL)
+      return(NULL);
+   for(idx = 0; (idx < NETCALC_STRIPES); idx++)
+      for(ctr = 0; (ctr < NETCALC_STRIPE_CTRS); ctr++)
+         atomic_init(&stripes[idx].stripe_ctrs[ctr], 0);
+
+   return(stripes);
+}
+
+
+uintmax_t
+netcalc_stripes_sum(
+         const netcalc_stripe_t *      stripes,
+         int                           ctr )
+{
+   size_t               idx;
+   uintmax_t            sum;
+
+   assert(ctr < NETCALC_STRIPE_CTRS);
+
+   if (!(stripes))
+      return(0);
+   for(idx = 0, sum = 0; (idx < NETCALC_STRIPES); idx++)
+      sum += atomic_load_explicit(&stripes[idx].stripe_ctrs[ctr], memory_order_relaxed);
+
+   return(sum);
+}
+
+
 size_t
 netcalc_strlcat(
          char * restrict               dst,
@@ -172,4 +314,17 @@ netcalc_strlcpy(
 }
 
 
+// yields processor to other threads while waiting on a spin lock
+void
+netcalc_yield( void )
+{
+#if defined(HAVE_SCHED_YIELD)
+   sched_yield();
+#elif defined(_WIN32)
+   SwitchToThread();
+#endif
+   return;
+}
+
+
 /* end of source */
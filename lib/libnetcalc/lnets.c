@@ -116,6 +116,13 @@ netcalc_ntop_inet6(
          int                           flags );
 
 
+static int
+netcalc_net_offset(
+         netcalc_net_t *               net,
+         uint64_t                      offset,
+         int                           subtract );
+
+
 static int
 netcalc_net_parse_eui(
          netcalc_buff_t *              b,
@@ -142,6 +149,16 @@ netcalc_net_parse_inet6(
 /////////////////
 // MARK: - Functions
 
+int
+netcalc_net_add(
+         netcalc_net_t *               net,
+         uint64_t                      offset )
+{
+   assert(net != NULL);
+   return(netcalc_net_offset(net, offset, 0));
+}
+
+
 int
 netcalc_net_cmp(
          const netcalc_net_t *         n1,
@@ -303,6 +320,67 @@ netcalc_net_convert_inet6(
 }
 
 
+// returns number of blocks of the prefix length of n1 between the
+// addresses of the networks
+int
+netcalc_net_distance(
+         const netcalc_net_t *         n1,
+         const netcalc_net_t *         n2,
+         uint64_t *                    distp )
+{
+   int               family;
+   unsigned          shift;
+   uint64_t          hi;
+   uint64_t          lo;
+   uint64_t          hi2;
+   uint64_t          lo2;
+
+   assert(n1    != NULL);
+   assert(n2    != NULL);
+   assert(distp != NULL);
+
+   family = n1->net_flags & NETCALC_AF;
+   if ( (family != NETCALC_AF_INET) && (family != NETCALC_AF_INET6) )
+      return(NETCALC_ENOTSUP);
+   family = n2->net_flags & NETCALC_AF;
+   if ( (family != NETCALC_AF_INET) && (family != NETCALC_AF_INET6) )
+      return(NETCALC_ENOTSUP);
+
+   hi    = netcalc_addr_be64(&n1->net_addr, 0);
+   lo    = netcalc_addr_be64(&n1->net_addr, 1);
+   hi2   = netcalc_addr_be64(&n2->net_addr, 0);
+   lo2   = netcalc_addr_be64(&n2->net_addr, 1);
+
+   // difference of larger and smaller address
+   if ( (hi2 < hi) || ((hi2 == hi) && (lo2 < lo)) )
+   {  hi2 = hi  - hi2 - ((lo < lo2) ? 1 : 0);
+      lo2 = lo  - lo2;
+   } else
+   {  hi2 = hi2 - hi  - ((lo2 < lo) ? 1 : 0);
+      lo2 = lo2 - lo;
+   };
+
+   // convert difference to blocks of prefix length
+   shift = 128U - n1->net_cidr;
+   if (shift >= 128)
+   {  lo2 = 0;
+      hi2 = 0;
+   } else if (shift >= 64)
+   {  lo2 = hi2 >> (shift - 64);
+      hi2 = 0;
+   } else if (shift > 0)
+   {  lo2 = (lo2 >> shift) | (hi2 << (64 - shift));
+      hi2 = hi2 >> shift;
+   };
+   if ((hi2))
+      return(NETCALC_ERANGE);
+
+   *distp = lo2;
+
+   return(0);
+}
+
+
 int
 netcalc_net_dup(
          netcalc_net_t **              netp,
@@ -533,6 +611,75 @@ netcalc_net_mask(
 }
 
 
+// moves address of network by offset blocks of the prefix length of the
+// network, the address is not changed if the result would leave the
+// address space of the address family
+int
+netcalc_net_offset(
+         netcalc_net_t *               net,
+         uint64_t                      offset,
+         int                           subtract )
+{
+   int               family;
+   unsigned          shift;
+   uint64_t          hi;
+   uint64_t          lo;
+   uint64_t          dhi;
+   uint64_t          dlo;
+   uint64_t          rhi;
+   uint64_t          rlo;
+   uint64_t          carry;
+
+   assert(net != NULL);
+
+   family = net->net_flags & NETCALC_AF;
+   if ( (family != NETCALC_AF_INET) && (family != NETCALC_AF_INET6) )
+      return(NETCALC_ENOTSUP);
+   if (!(offset))
+      return(0);
+
+   // offset in addresses
+   shift = 128U - net->net_cidr;
+   if (shift >= 128)
+      return(NETCALC_ERANGE);
+   if (shift >= 64)
+   {  if ( (shift > 64) && ((offset >> (128 - shift))) )
+         return(NETCALC_ERANGE);
+      dhi = offset << (shift - 64);
+      dlo = 0;
+   } else
+   {  dhi = ((shift)) ? offset >> (64 - shift) : 0;
+      dlo = offset << shift;
+   };
+
+   hi = netcalc_addr_be64(&net->net_addr, 0);
+   lo = netcalc_addr_be64(&net->net_addr, 1);
+
+   if (!(subtract))
+   {  rlo   = lo + dlo;
+      carry = (rlo < lo) ? 1 : 0;
+      rhi   = hi + dhi + carry;
+      if (rhi < hi)
+         return(NETCALC_ERANGE);
+   } else
+   {  rlo   = lo - dlo;
+      carry = (lo < dlo) ? 1 : 0;
+      rhi   = hi - dhi - carry;
+      if (rhi > hi)
+         return(NETCALC_ERANGE);
+   };
+
+   // IPv4 addresses are restricted to the last 32 bits
+   if ( (family == NETCALC_AF_INET) && ( (rhi != hi) || ((rlo >> 32) != (lo >> 32)) ) )
+      return(NETCALC_ERANGE);
+
+   netcalc_addr_be64_set(&net->net_addr, 0, rhi);
+   netcalc_addr_be64_set(&net->net_addr, 1, rlo);
+
+   return(0);
+}
+
+
 int
 netcalc_net_parse(
          netcalc_buff_t *              b,
@@ -1096,19 +1243,82 @@ netcalc_net_parse_inet6(
 }
 
 
+// returns the first and last host addresses of the network, matching the
+// NETCALC_TYPE_FIRST and NETCALC_TYPE_LAST formats of netcalc_ntop()
+int
+netcalc_net_range(
+         const netcalc_net_t *         net,
+         netcalc_net_t **              firstp,
+         netcalc_net_t **              lastp )
+{
+   int                  rc;
+   int                  idx;
+   int                  family;
+   netcalc_net_t        first;
+   netcalc_net_t        last;
+
+   assert(net != NULL);
+
+   family = net->net_flags & NETCALC_AF;
+   if ( (family != NETCALC_AF_INET) && (family != NETCALC_AF_INET6) )
+      return(NETCALC_ENOTSUP);
+
+   memset(&first, 0, sizeof(netcalc_net_t));
+   first.net_flags   = net->net_flags & ~((uint32_t)(NETCALC_FLG_IFACE | NETCALC_FLG_PORT));
+   first.net_cidr    = 128;
+   memcpy(&last, &first, sizeof(netcalc_net_t));
+   for(idx = 0; (idx < 4); idx++)
+   {  first.net_addr.addr32[idx] = net->net_addr.addr32[idx] &  _netcalc_netmasks[net->net_cidr].addr32[idx];
+      last.net_addr.addr32[idx]  = net->net_addr.addr32[idx] | ~_netcalc_netmasks[net->net_cidr].addr32[idx];
+   };
+
+   // network and broadcast addresses are excluded from networks with
+   // more than two addresses
+   if (net->net_cidr < 127)
+   {  first.net_addr.addr8[15]++;
+      last.net_addr.addr8[15]--;
+   };
+
+   if ((firstp))
+   {  if ((rc = netcalc_net_dup(firstp, &first)) != 0)
+         return(rc);
+   };
+
+   if ((lastp))
+   {  if ((rc = netcalc_net_dup(lastp, &last)) != 0)
+      {  if ((firstp))
+         {  netcalc_net_free(*firstp);
+            *firstp = NULL;
+         };
+         return(rc);
+      };
+   };
+
+   return(0);
+}
+
+
+int
+netcalc_net_sub(
+         netcalc_net_t *               net,
+         uint64_t                      offset )
+{
+   assert(net != NULL);
+   return(netcalc_net_offset(net, offset, 1));
+}
+
+
+// the common prefix of the networks is the prefix shared by the first
+// network and each other network, so the networks are examined once
 int
 netcalc_net_superblock(
          netcalc_net_t **              netp,
          const netcalc_net_t * const * nets,
          size_t                        nel )
 {
-   int                     byte;
-   int                     cidr;
-   int                     matches;
-   size_t                  idx;
-   netcalc_net_t           nbuff;
-   const netcalc_addr_t *  ref;
-   const uint8_t *         addr8;
+   int                        rc;
+   size_t                     idx;
+   netcalc_superblock_acc_t   acc;
 
    assert(netp != NULL);
    assert(nets != NULL);
@@ -1117,35 +1327,15 @@ netcalc_net_superblock(
    for(idx = 0; (idx < nel); idx++)
       assert(nets[idx] != NULL);
 
-   matches  = 1;
-   ref      = &nets[0]->net_addr;
-
    if (nel == 1)
       return(netcalc_net_dup(netp, nets[0]));
 
-   memset(&nbuff, 0, sizeof(netcalc_net_t));
-   nbuff.net_flags = nets[0]->net_flags & NETCALC_AF;
-
-   cidr = 1;
-   while ((cidr < 129) && ((matches)))
-   {  addr8 = (const uint8_t *)&_netcalc_netmasks[cidr].addr8;
-      for(idx = 1; ((idx < nel) && ((matches))); idx++)
-      {  byte = (cidr-1) / 8;
-         if ( (ref->addr8[byte] & addr8[byte]) != (nets[idx]->net_addr.addr8[byte] & addr8[byte]) )
-            matches = 0;
-         else if (cidr > nets[idx]->net_cidr)
-            matches = 0;
-      };
-      if ((matches))
-         cidr++;
-   };
-   cidr--;
-
-   nbuff.net_cidr = cidr;
-   for(byte = 0; (byte < 16); byte++)
-      nbuff.net_addr.addr8[byte] = nets[0]->net_addr.addr8[byte] & _netcalc_netmasks[cidr].addr8[byte];
+   memset(&acc, 0, sizeof(acc));
+   for(idx = 0; (idx < nel); idx++)
+      if ((rc = netcalc_superblock_acc_add(&acc, nets[idx])) != 0)
+         return(rc);
 
-   return(netcalc_net_dup(netp, &nbuff));
+   return(netcalc_superblock_acc_finish(&acc, netp));
 }
 
 
@@ -1975,4 +2165,91 @@ netcalc_strfnet(
 }
 
 
+int
+netcalc_superblock_acc_add(
+         netcalc_superblock_acc_t *    acc,
+         const netcalc_net_t *         net )
+{
+   assert(acc != NULL);
+   assert(net != NULL);
+
+   if (!(acc->acc_count++))
+   {  acc->acc_addr  = net->net_addr;
+      acc->acc_cidr  = net->net_cidr;
+      acc->acc_flags = net->net_flags & NETCALC_AF;
+      return(0);
+   };
+
+   acc->acc_diff[0] |= netcalc_addr_be64(&acc->acc_addr, 0) ^ netcalc_addr_be64(&net->net_addr, 0);
+   acc->acc_diff[1] |= netcalc_addr_be64(&acc->acc_addr, 1) ^ netcalc_addr_be64(&net->net_addr, 1);
+   acc->acc_cidr     = (net->net_cidr < acc->acc_cidr) ? net->net_cidr : acc->acc_cidr;
+   if ((net->net_flags & NETCALC_AF) != acc->acc_flags)
+      acc->acc_mixed = 1;
+
+   return(0);
+}
+
+
+int
+netcalc_superblock_acc_finish(
+         netcalc_superblock_acc_t *    acc,
+         netcalc_net_t **              netp )
+{
+   int                  byte;
+   unsigned             cidr;
+   netcalc_net_t        nbuff;
+
+   assert(acc  != NULL);
+   assert(netp != NULL);
+
+   if (!(acc->acc_count))
+      return(NETCALC_ENOREC);
+
+   if ((acc->acc_diff[0]))
+      cidr = netcalc_addr_clz(acc->acc_diff[0]);
+   else if ((acc->acc_diff[1]))
+      cidr = 64 + netcalc_addr_clz(acc->acc_diff[1]);
+   else
+      cidr = 128;
+   cidr = (acc->acc_cidr < cidr) ? acc->acc_cidr : cidr;
+
+   // IPv4 networks within a superblock of IPv6 networks are IPv4-mapped IPv6
+   memset(&nbuff, 0, sizeof(netcalc_net_t));
+   nbuff.net_flags = ((acc->acc_mixed)) ? NETCALC_AF_INET6 : acc->acc_flags;
+   nbuff.net_cidr  = (uint8_t)cidr;
+   for(byte = 0; (byte < 16); byte++)
+      nbuff.net_addr.addr8[byte] = acc->acc_addr.addr8[byte] & _netcalc_netmasks[cidr].addr8[byte];
+
+   return(netcalc_net_dup(netp, &nbuff));
+}
+
+
+void
+netcalc_superblock_acc_free(
+         netcalc_superblock_acc_t *    acc )
+{
+   if ((acc))
+      free(acc);
+   return;
+}
+
+
+int
+netcalc_superblock_acc_init(
+         netcalc_superblock_acc_t **   accp )
+{
+   netcalc_superblock_acc_t *    acc;
+
+   assert(accp != NULL);
+
+   if ((acc = malloc(sizeof(netcalc_superblock_acc_t))) == NULL)
+      return(NETCALC_ENOMEM);
+   memset(acc, 0, sizeof(netcalc_superblock_acc_t));
+
+   *accp = acc;
+
+   return(0);
+}
+
+
 /* end of source */
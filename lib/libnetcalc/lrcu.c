@@ -0,0 +1,309 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __LIB_LIBNETCALC_LRCU_C 1
+#include "libnetcalc.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static void
+netcalc_rcu_reclaim(
+         netcalc_rcu_t *               rcu );
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+void
+netcalc_rcu_abort(
+         netcalc_rcu_t *               rcu,
+         netcalc_set_t *               ns )
+{
+   assert(rcu != NULL);
+   assert(atomic_load(&rcu->rcu_writer) != 0);
+
+   if ((ns))
+      netcalc_set_free(ns);
+   atomic_store(&rcu->rcu_writer, 0);
+
+   return;
+}
+
+
+int
+netcalc_rcu_begin(
+         netcalc_rcu_t *               rcu,
+         netcalc_set_t **              nsp )
+{
+   int                  rc;
+   uintmax_t            writer;
+
+   assert(rcu != NULL);
+   assert(nsp != NULL);
+
+   *nsp = NULL;
+
+   // serialize writers
+   writer = 0;
+   while(!(atomic_compare_exchange_weak(&rcu->rcu_writer, &writer, 1)))
+   {  writer = 0;
+      netcalc_yield();
+   };
+
+   if ((rc = netcalc_set_clone(nsp, atomic_load(&rcu->rcu_set))) != 0)
+   {  atomic_store(&rcu->rcu_writer, 0);
+      return(rc);
+   };
+
+   return(0);
+}
+
+
+int
+netcalc_rcu_commit(
+         netcalc_rcu_t *               rcu,
+         netcalc_set_t *               ns )
+{
+   netcalc_rcu_old_t *     old;
+
+   assert(rcu != NULL);
+   assert(ns  != NULL);
+   assert(atomic_load(&rcu->rcu_writer) != 0);
+
+   if ((old = malloc(sizeof(netcalc_rcu_old_t))) == NULL)
+      return(NETCALC_ENOMEM);
+
+   // publish version, readers which observe the new epoch observe the new version
+   old->old_set      = atomic_exchange(&rcu->rcu_set, ns);
+   old->old_epoch    = atomic_fetch_add(&rcu->rcu_epoch, 1) + 1;
+   old->old_next     = rcu->rcu_retired;
+   rcu->rcu_retired  = old;
+
+   netcalc_rcu_reclaim(rcu);
+
+   atomic_store(&rcu->rcu_writer, 0);
+
+   return(0);
+}
+
+
+void
+netcalc_rcu_free(
+         netcalc_rcu_t *               rcu )
+{
+   netcalc_rcu_old_t *     old;
+
+   if (!(rcu))
+      return;
+
+   while((old = rcu->rcu_retired) != NULL)
+   {  rcu->rcu_retired = old->old_next;
+      netcalc_set_free(old->old_set);
+      free(old);
+   };
+
+   if ((atomic_load(&rcu->rcu_set)))
+      netcalc_set_free(atomic_load(&rcu->rcu_set));
+   if ((rcu->rcu_rdrs))
+      netcalc_aligned_free(rcu->rcu_rdrs);
+   free(rcu);
+
+   return;
+}
+
+
+int
+netcalc_rcu_init(
+         netcalc_rcu_t **              rcup,
+         netcalc_set_t *               ns,
+         int                           readers )
+{
+   int                  idx;
+   void *               ptr;
+   netcalc_rcu_t *      rcu;
+
+   assert(rcup != NULL);
+   assert(ns   != NULL);
+
+   if (readers < 1)
+      return(NETCALC_EINVAL);
+
+   if ((rcu = malloc(sizeof(netcalc_rcu_t))) == NULL)
+      return(NETCALC_ENOMEM);
+   memset(rcu, 0, sizeof(netcalc_rcu_t));
+
+   if ((ptr = netcalc_aligned_alloc(sizeof(netcalc_rcu_rdr_t), sizeof(netcalc_rcu_rdr_t) * (size_t)readers)) == NULL)
+   {  free(rcu);
+      return(NETCALC_ENOMEM);
+   };
+   rcu->rcu_rdrs  = ptr;
+   rcu->rcu_nrdrs = (size_t)readers;
+   for(idx = 0; (idx < readers); idx++)
+   {  atomic_init(&rcu->rcu_rdrs[idx].rdr_epoch, 0);
+      atomic_init(&rcu->rcu_rdrs[idx].rdr_used,  0);
+   };
+
+   atomic_init(&rcu->rcu_set,    ns);
+   atomic_init(&rcu->rcu_epoch,  1);
+   atomic_init(&rcu->rcu_writer, 0);
+
+   *rcup = rcu;
+
+   return(0);
+}
+
+
+netcalc_set_t *
+netcalc_rcu_read_lock(
+         netcalc_rcu_t *               rcu,
+         int                           reader )
+{
+   netcalc_rcu_rdr_t *     rdr;
+
+   assert(rcu != NULL);
+   assert( (reader >= 0) && ((size_t)reader < rcu->rcu_nrdrs) );
+
+   // epoch must be visible to writers before the version is loaded
+   rdr = &rcu->rcu_rdrs[reader];
+   atomic_store(&rdr->rdr_epoch, atomic_load(&rcu->rcu_epoch));
+
+   return(atomic_load(&rcu->rcu_set));
+}
+
+
+void
+netcalc_rcu_read_unlock(
+         netcalc_rcu_t *               rcu,
+         int                           reader )
+{
+   assert(rcu != NULL);
+   assert( (reader >= 0) && ((size_t)reader < rcu->rcu_nrdrs) );
+   atomic_store_explicit(&rcu->rcu_rdrs[reader].rdr_epoch, 0, memory_order_release);
+   return;
+}
+
+
+// frees retired versions which are not referenced by a reader
+void
+netcalc_rcu_reclaim(
+         netcalc_rcu_t *               rcu )
+{
+   size_t                  idx;
+   uintmax_t               epoch;
+   uintmax_t               oldest;
+   netcalc_rcu_old_t *     old;
+   netcalc_rcu_old_t **    prevp;
+
+   assert(rcu != NULL);
+
+   oldest = UINTMAX_MAX;
+   for(idx = 0; (idx < rcu->rcu_nrdrs); idx++)
+   {  epoch = atomic_load(&rcu->rcu_rdrs[idx].rdr_epoch);
+      if ( ((epoch)) && (epoch < oldest) )
+         oldest = epoch;
+   };
+
+   prevp = &rcu->rcu_retired;
+   while((old = *prevp) != NULL)
+   {  if (old->old_epoch > oldest)
+      {  prevp = &old->old_next;
+         continue;
+      };
+      *prevp = old->old_next;
+      netcalc_set_free(old->old_set);
+      free(old);
+   };
+
+   return;
+}
+
+
+int
+netcalc_rcu_register(
+         netcalc_rcu_t *               rcu,
+         int *                         readerp )
+{
+   size_t               idx;
+   uintmax_t            used;
+
+   assert(rcu     != NULL);
+   assert(readerp != NULL);
+
+   for(idx = 0; (idx < rcu->rcu_nrdrs); idx++)
+   {  used = 0;
+      if ((atomic_compare_exchange_strong(&rcu->rcu_rdrs[idx].rdr_used, &used, 1)))
+      {  atomic_store(&rcu->rcu_rdrs[idx].rdr_epoch, 0);
+         *readerp = (int)idx;
+         return(0);
+      };
+   };
+
+   return(NETCALC_ERANGE);
+}
+
+
+void
+netcalc_rcu_unregister(
+         netcalc_rcu_t *               rcu,
+         int                           reader )
+{
+   assert(rcu != NULL);
+   assert( (reader >= 0) && ((size_t)reader < rcu->rcu_nrdrs) );
+   atomic_store(&rcu->rcu_rdrs[reader].rdr_epoch, 0);
+   atomic_store(&rcu->rcu_rdrs[reader].rdr_used,  0);
+   return;
+}
+
+
+/* end of source */
@@ -0,0 +1,444 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __LIB_LIBNETCALC_LRSETS_C 1
+#include "libnetcalc.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+netcalc_rset_cmp(
+         const uint64_t *              key,
+         uint64_t                      hi,
+         uint64_t                      lo );
+
+
+static int
+netcalc_rset_grow(
+         netcalc_rset_t *              rs );
+
+
+static int
+netcalc_rset_result(
+         const netcalc_rset_t *        rs,
+         size_t                        idx,
+         netcalc_net_t **              firstp,
+         netcalc_net_t **              lastp,
+         char **                       commentp,
+         void **                       datap );
+
+
+static size_t
+netcalc_rset_search(
+         const netcalc_rset_t *        rs,
+         uint64_t                      hi,
+         uint64_t                      lo );
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+netcalc_rset_add(
+         netcalc_rset_t *              rs,
+         const netcalc_net_t *         first,
+         const netcalc_net_t *         last,
+         const char *                  comment,
+         void *                        data )
+{
+   int                  rc;
+   size_t               pos;
+   size_t               len;
+   uint64_t             start[2];
+   uint64_t             end[2];
+   char *               dup;
+   netcalc_addr_t       addr;
+   netcalc_addr_t       addr_end;
+   netcalc_rent_t *     ent;
+
+   assert(rs    != NULL);
+   assert(first != NULL);
+   assert(last  != NULL);
+
+   if ((rc = netcalc_range_addrs(first, last, &addr, &addr_end)) != 0)
+      return(rc);
+   start[0] = netcalc_addr_be64(&addr,     0);
+   start[1] = netcalc_addr_be64(&addr,     1);
+   end[0]   = netcalc_addr_be64(&addr_end, 0);
+   end[1]   = netcalc_addr_be64(&addr_end, 1);
+
+   // ranges of sorted input are appended without searching the ranges
+   len = rs->rset_len;
+   pos = len;
+   if ( (len > 0) && (netcalc_rset_cmp(&rs->rset_last[(len-1)*2], start[0], start[1]) >= 0) )
+   {  pos = netcalc_rset_search(rs, start[0], start[1]);
+      pos = (pos == len) ? 0 : (pos + 1);
+      if ( (pos > 0) && (netcalc_rset_cmp(&rs->rset_last[(pos-1)*2], start[0], start[1]) >= 0) )
+         return(NETCALC_EEXISTS);
+      if ( (pos < len) && (netcalc_rset_cmp(&rs->rset_first[pos*2], end[0], end[1]) <= 0) )
+         return(NETCALC_EEXISTS);
+   };
+
+   if ( (len == rs->rset_size) && ((rc = netcalc_rset_grow(rs)) != 0) )
+      return(rc);
+
+   dup = NULL;
+   if ( ((comment)) && ((dup = strdup(comment)) == NULL) )
+      return(NETCALC_ENOMEM);
+
+   if (pos < len)
+   {  memmove(&rs->rset_first[(pos+1)*2], &rs->rset_first[pos*2], (sizeof(uint64_t) * 2 * (len - pos)));
+      memmove(&rs->rset_last[(pos+1)*2],  &rs->rset_last[pos*2],  (sizeof(uint64_t) * 2 * (len - pos)));
+      memmove(&rs->rset_ents[pos+1],      &rs->rset_ents[pos],    (sizeof(netcalc_rent_t) * (len - pos)));
+   };
+
+   rs->rset_first[(pos*2)+0]  = start[0];
+   rs->rset_first[(pos*2)+1]  = start[1];
+   rs->rset_last[(pos*2)+0]   = end[0];
+   rs->rset_last[(pos*2)+1]   = end[1];
+   ent                        = &rs->rset_ents[pos];
+   memset(ent, 0, sizeof(netcalc_rent_t));
+   ent->ent_flags             = first->net_flags & NETCALC_AF;
+   ent->ent_comment           = dup;
+   ent->ent_data              = data;
+   rs->rset_len++;
+
+   return(0);
+}
+
+
+int
+netcalc_rset_add_str(
+         netcalc_rset_t *              rs,
+         const char *                  address,
+         const char *                  comment,
+         void *                        data )
+{
+   int                  rc;
+   netcalc_buff_t       first;
+   netcalc_buff_t       last;
+
+   assert(rs      != NULL);
+   assert(address != NULL);
+
+   // a network is added as the range of its addresses
+   if ((rc = netcalc_net_parse(&first, address, 0)) == 0)
+      return(netcalc_rset_add(rs, &first.buff_net, &first.buff_net, comment, data));
+   if (!(strchr(address, '-')))
+      return(rc);
+
+   if ((rc = netcalc_range_parse(address, 0, &first, &last)) != 0)
+      return(rc);
+
+   return(netcalc_rset_add(rs, &first.buff_net, &last.buff_net, comment, data));
+}
+
+
+// compares packed address with address, returns less than, equal to, or
+// greater than zero
+int
+netcalc_rset_cmp(
+         const uint64_t *              key,
+         uint64_t                      hi,
+         uint64_t                      lo )
+{
+   if (key[0] != hi)
+      return( (key[0] < hi) ? -1 : 1 );
+   if (key[1] != lo)
+      return( (key[1] < lo) ? -1 : 1 );
+   return(0);
+}
+
+
+void
+netcalc_rset_free(
+         netcalc_rset_t *              rs )
+{
+   size_t               idx;
+
+   if (!(rs))
+      return;
+
+   for(idx = 0; (idx < rs->rset_len); idx++)
+      if ((rs->rset_ents[idx].ent_comment))
+         free(rs->rset_ents[idx].ent_comment);
+
+   if ((rs->rset_first))
+      free(rs->rset_first);
+   if ((rs->rset_last))
+      free(rs->rset_last);
+   if ((rs->rset_ents))
+      free(rs->rset_ents);
+   free(rs);
+
+   return;
+}
+
+
+// doubles the number of ranges which fit within arrays
+int
+netcalc_rset_grow(
+         netcalc_rset_t *              rs )
+{
+   size_t               size;
+   void *               ptr;
+
+   assert(rs != NULL);
+
+   size = ((rs->rset_size)) ? (rs->rset_size * 2) : 64;
+
+   if ((ptr = realloc(rs->rset_first, (sizeof(uint64_t) * 2 * size))) == NULL)
+      return(NETCALC_ENOMEM);
+   rs->rset_first = ptr;
+
+   if ((ptr = realloc(rs->rset_last, (sizeof(uint64_t) * 2 * size))) == NULL)
+      return(NETCALC_ENOMEM);
+   rs->rset_last = ptr;
+
+   if ((ptr = realloc(rs->rset_ents, (sizeof(netcalc_rent_t) * size))) == NULL)
+      return(NETCALC_ENOMEM);
+   rs->rset_ents = ptr;
+
+   rs->rset_size = size;
+
+   return(0);
+}
+
+
+int
+netcalc_rset_init(
+         netcalc_rset_t **             rsp )
+{
+   netcalc_rset_t *     rs;
+
+   assert(rsp != NULL);
+
+   if ((rs = malloc(sizeof(netcalc_rset_t))) == NULL)
+      return(NETCALC_ENOMEM);
+   memset(rs, 0, sizeof(netcalc_rset_t));
+
+   *rsp = rs;
+
+   return(0);
+}
+
+
+int
+netcalc_rset_query(
+         netcalc_rset_t *              rs,
+         const netcalc_net_t *         net,
+         netcalc_net_t **              firstp,
+         netcalc_net_t **              lastp,
+         char **                       commentp,
+         void **                       datap )
+{
+   int                  rc;
+   size_t               idx;
+   netcalc_addr_t       start;
+   netcalc_addr_t       end;
+
+   assert(rs  != NULL);
+   assert(net != NULL);
+
+   // network must be contained within a single range
+   if ((rc = netcalc_range_addrs(net, net, &start, &end)) != 0)
+      return(rc);
+   if ((idx = netcalc_rset_search(rs, netcalc_addr_be64(&start, 0), netcalc_addr_be64(&start, 1))) == rs->rset_len)
+      return(NETCALC_ENOREC);
+   if (netcalc_rset_cmp(&rs->rset_last[idx*2], netcalc_addr_be64(&end, 0), netcalc_addr_be64(&end, 1)) < 0)
+      return(NETCALC_ENOREC);
+
+   return(netcalc_rset_result(rs, idx, firstp, lastp, commentp, datap));
+}
+
+
+int
+netcalc_rset_query_str(
+         netcalc_rset_t *              rs,
+         const char *                  address,
+         netcalc_net_t **              firstp,
+         netcalc_net_t **              lastp,
+         char **                       commentp,
+         void **                       datap )
+{
+   int                  rc;
+   netcalc_buff_t       b;
+
+   assert(rs      != NULL);
+   assert(address != NULL);
+
+   if ((rc = netcalc_net_parse(&b, address, 0)) != 0)
+      return(rc);
+
+   return(netcalc_rset_query(rs, &b.buff_net, firstp, lastp, commentp, datap));
+}
+
+
+// copies first address, last address, comment, and data of range
+int
+netcalc_rset_result(
+         const netcalc_rset_t *        rs,
+         size_t                        idx,
+         netcalc_net_t **              firstp,
+         netcalc_net_t **              lastp,
+         char **                       commentp,
+         void **                       datap )
+{
+   int                     rc;
+   char *                  comment;
+   netcalc_net_t *         first;
+   netcalc_net_t *         last;
+   netcalc_net_t           nbuff;
+   const netcalc_rent_t *  ent;
+
+   assert(rs != NULL);
+
+   ent      = &rs->rset_ents[idx];
+   comment  = NULL;
+   first    = NULL;
+   last     = NULL;
+
+   memset(&nbuff, 0, sizeof(netcalc_net_t));
+   nbuff.net_flags   = ent->ent_flags;
+   nbuff.net_cidr    = 128;
+
+   if ((firstp))
+   {  netcalc_addr_be64_set(&nbuff.net_addr, 0, rs->rset_first[(idx*2)+0]);
+      netcalc_addr_be64_set(&nbuff.net_addr, 1, rs->rset_first[(idx*2)+1]);
+      if ((rc = netcalc_net_dup(&first, &nbuff)) != 0)
+         return(rc);
+   };
+
+   if ((lastp))
+   {  netcalc_addr_be64_set(&nbuff.net_addr, 0, rs->rset_last[(idx*2)+0]);
+      netcalc_addr_be64_set(&nbuff.net_addr, 1, rs->rset_last[(idx*2)+1]);
+      if ((rc = netcalc_net_dup(&last, &nbuff)) != 0)
+      {  netcalc_net_free(first);
+         return(rc);
+      };
+   };
+
+   if ( ((commentp)) && ((ent->ent_comment)) )
+   {  if ((comment = strdup(ent->ent_comment)) == NULL)
+      {  netcalc_net_free(first);
+         netcalc_net_free(last);
+         return(NETCALC_ENOMEM);
+      };
+   };
+
+   if ((firstp))
+      *firstp = first;
+   if ((lastp))
+      *lastp = last;
+   if ((commentp))
+      *commentp = comment;
+   if ((datap))
+      *datap = ent->ent_data;
+
+   return(0);
+}
+
+
+// returns index of the last range which starts at or before the address,
+// returns the number of ranges if the address precedes all ranges
+size_t
+netcalc_rset_search(
+         const netcalc_rset_t *        rs,
+         uint64_t                      hi,
+         uint64_t                      lo )
+{
+   size_t               base;
+   size_t               half;
+   size_t               len;
+
+   assert(rs != NULL);
+
+   if ((len = rs->rset_len) == 0)
+      return(0);
+
+   // the number of iterations depends only upon the number of ranges
+   base = 0;
+   while(len > 1)
+   {  half  = len / 2;
+      base  = (netcalc_rset_cmp(&rs->rset_first[(base+half)*2], hi, lo) <= 0) ? (base + half) : base;
+      len  -= half;
+   };
+
+   if (netcalc_rset_cmp(&rs->rset_first[base*2], hi, lo) > 0)
+      return(rs->rset_len);
+
+   return(base);
+}
+
+
+int
+netcalc_rset_stats(
+         netcalc_rset_t *              rs,
+         size_t *                      lenp,
+         size_t *                      sizep )
+{
+   assert(rs != NULL);
+
+   if ((lenp))
+      *lenp = rs->rset_len;
+
+   // memory used by set, excluding comments
+   if ((sizep))
+      *sizep = sizeof(netcalc_rset_t) + (rs->rset_size * ((sizeof(uint64_t) * 4) + sizeof(netcalc_rent_t)));
+
+   return(0);
+}
+
+
+/* end of source */
@@ -72,23 +72,167 @@
 // MARK: - Prototypes
 
 static void
-netcalc_cur_reset(
-         netcalc_set_t *               ns,
+netcalc_cur_advance(
+         netcalc_cur_t *               cur,
+         netcalc_recs_t **             list );
+
+
+static void
+netcalc_cur_blocks_first(
          netcalc_cur_t *               cur );
 
 
+static int
+netcalc_cur_blocks_next(
+         netcalc_cur_t *               cur,
+         netcalc_net_t **              netp,
+         int *                         flagsp );
+
+
 static void
-netcalc_rec_free(
-         netcalc_rec_t *               rec );
+netcalc_cur_chain_first(
+         netcalc_cur_t *               cur );
 
 
 static int
-netcalc_rec_get(
-         netcalc_rec_t *               rec,
+netcalc_cur_chain_next(
+         netcalc_cur_t *               cur,
          netcalc_net_t **              netp,
          char **                       commentp,
          void **                       datap,
-         int *                         flagsp );
+         int *                         flagsp,
+         int *                         depthp );
+
+
+static void
+netcalc_cur_covered_first(
+         netcalc_cur_t *               cur );
+
+
+static void
+netcalc_cur_locate(
+         netcalc_cur_t *               cur,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr );
+
+
+static int
+netcalc_cur_query(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net,
+         uint32_t                      type,
+         netcalc_cur_t **              curp );
+
+
+static netcalc_rec_t *
+netcalc_cur_rec(
+         netcalc_cur_t *               cur,
+         netcalc_recs_t **             list );
+
+
+static void
+netcalc_cur_reset(
+         netcalc_set_t *               ns,
+         netcalc_cur_t *               cur );
+
+
+static netcalc_rec_t *
+netcalc_cur_retreat(
+         netcalc_cur_t *               cur );
+
+
+static int
+netcalc_rec_alloc(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net,
+         const char *                  comment,
+         void *                        data,
+         int                           flags,
+         netcalc_rec_t **              recp );
+
+
+static int
+netcalc_rec_modify(
+         netcalc_set_t *               ns,
+         netcalc_rec_t *               rec,
+         const char *                  comment,
+         void *                        data,
+         int                           flags );
+
+
+static int
+netcalc_rec_unshare(
+         netcalc_rec_t **              recp );
+
+
+static int
+netcalc_recs_bindex(
+         const netcalc_recs_t *        recs,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr,
+         uint32_t *                    wouldbep );
+
+
+static uint8_t
+netcalc_recs_gap(
+         const netcalc_recs_t *        recs,
+         uint32_t                      idx );
+
+
+static int
+netcalc_recs_gaps(
+         netcalc_recs_t *              recs );
+
+
+static uint32_t
+netcalc_recs_gaps_find(
+         const netcalc_gaps_t *        gaps,
+         uint32_t                      node,
+         uint32_t                      node_low,
+         uint32_t                      node_high,
+         uint32_t                      low,
+         uint32_t                      high,
+         uint8_t                       cidr );
+
+
+static void
+netcalc_recs_gaps_free(
+         netcalc_recs_t *              recs );
+
+
+static void
+netcalc_recs_gaps_update(
+         netcalc_recs_t *              recs,
+         uint32_t                      idx );
+
+
+static int
+netcalc_recs_insert(
+         netcalc_recs_t *              recs,
+         uint32_t                      idx,
+         netcalc_rec_t *               rec );
+
+
+static uint32_t
+netcalc_recs_lbound(
+         const netcalc_recs_t *        recs,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr );
+
+
+static uint32_t
+netcalc_recs_ubound(
+         const netcalc_recs_t *        recs,
+         uint32_t                      low,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr );
+
+
+static int
+netcalc_set_allocate_fit(
+         netcalc_addr_t *              first,
+         const netcalc_addr_t *        last,
+         uint8_t                       cidr );
 
 
 static int
@@ -97,7 +241,8 @@ netcalc_set_bindex(
          const netcalc_net_t *         key,
          netcalc_recs_t **             basep,
          uint32_t *                    wouldbep,
-         netcalc_rec_t **              parentp );
+         netcalc_rec_t **              parentp,
+         int                           query );
 
 
 static void
@@ -111,6 +256,103 @@ netcalc_set_debug_print(
          int                           flags );
 
 
+static const netcalc_rec_t *
+netcalc_set_diff_next(
+         const netcalc_recs_t **       list,
+         uint32_t *                    idxs,
+         int *                         depthp );
+
+
+static int
+netcalc_set_find(
+         netcalc_set_t *               ns,
+         netcalc_buff_t *              nbuff,
+         const netcalc_net_t *         net,
+         netcalc_recs_t **             recsp,
+         uint32_t *                    idxp );
+
+
+static int
+netcalc_set_hits_less(
+         const netcalc_rec_t *         rec1,
+         const netcalc_rec_t *         rec2 );
+
+
+static void
+netcalc_set_hits_sift(
+         const netcalc_rec_t **        recs,
+         size_t                        len,
+         size_t                        pos );
+
+
+static int
+netcalc_set_insert(
+         netcalc_set_t *               ns,
+         netcalc_recs_t *              base,
+         uint32_t                      wouldbe,
+         int                           idx,
+         netcalc_rec_t *               rec );
+
+
+static int
+netcalc_set_modified(
+         netcalc_set_t *               ns,
+         int                           op,
+         const netcalc_rec_t *         rec );
+
+
+static int
+netcalc_set_prepare(
+         netcalc_set_t *               ns,
+         netcalc_buff_t *              nbuff,
+         const netcalc_net_t *         net );
+
+
+static int
+netcalc_set_query_result(
+         netcalc_set_t *               ns,
+         netcalc_rec_t *               rec,
+         netcalc_net_t **              resp,
+         char **                       commentp,
+         void **                       datap,
+         int *                         flagsp );
+
+
+static void
+netcalc_set_subnets(
+         netcalc_set_t *               ns,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr,
+         netcalc_recs_t **             recsp,
+         uint32_t *                    lowp,
+         uint32_t *                    highp,
+         netcalc_rec_t **              parentp );
+
+
+static int
+netcalc_set_cloned(
+         netcalc_set_t *               ns );
+
+
+static int
+netcalc_set_unshare(
+         netcalc_set_t *               ns,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr );
+
+
+static int
+netcalc_set_unshare_list(
+         netcalc_set_t *               ns );
+
+
+static int
+netcalc_set_unshare_rec(
+         netcalc_set_t *               ns,
+         netcalc_recs_t *              recs,
+         uint32_t                      idx );
+
+
 /////////////////
 //             //
 //  Functions  //
@@ -131,43 +373,167 @@ netcalc_cur_first(
    cur->cur_idx[0]   = 0;
    cur->cur_depth    = 0;
    cur->cur_serial   = cur->cur_set->set_serial;
+   switch(cur->cur_type)
+   {  case NETCALC_CUR_BLOCKS:
+         netcalc_cur_blocks_first(cur);
+         break;
+
+      case NETCALC_CUR_CHAIN:
+         netcalc_cur_chain_first(cur);
+         break;
+
+      case NETCALC_CUR_COVERED:
+         netcalc_cur_covered_first(cur);
+         break;
+
+      default:
+         break;
+   };
    return(netcalc_cur_next(cur, netp, commentp, datap, flagsp, depthp));
 }
 
 
+// moves cursor position to the next record in cursor order, the list of
+// records at each depth of the current position must be provided
 void
-netcalc_cur_free(
+netcalc_cur_advance(
+         netcalc_cur_t *               cur,
+         netcalc_recs_t **             list )
+{
+   uint32_t             depth;
+   uint32_t             idx;
+
+   assert(cur  != NULL);
+   assert(list != NULL);
+
+   depth = cur->cur_depth;
+   idx   = cur->cur_idx[depth];
+   if ((list[depth]->list[idx]->rec_children.len))
+   {  cur->cur_depth++;
+      cur->cur_idx[cur->cur_depth] = 0;
+      return;
+   };
+
+   cur->cur_idx[depth]++;
+   while ( (cur->cur_idx[depth] >= list[depth]->len) && (depth != 0) )
+   {  cur->cur_depth--;
+      depth = cur->cur_depth;
+      cur->cur_idx[depth]++;
+   };
+
+   return;
+}
+
+
+// positions cursor at the start of the network and locates the list of
+// records which are subnets of the network
+void
+netcalc_cur_blocks_first(
          netcalc_cur_t *               cur )
 {
    assert(cur != NULL);
-   free(cur);
+
+   memcpy(&cur->cur_pos, &cur->cur_addr, sizeof(netcalc_addr_t));
+   cur->cur_done     = 0;
+
+   netcalc_set_subnets(cur->cur_set, &cur->cur_addr, cur->cur_cidr, &cur->cur_recs, &cur->cur_idx[0], &cur->cur_end, NULL);
+
    return;
 }
 
 
 int
-netcalc_cur_init(
-         netcalc_set_t *               ns,
-         netcalc_cur_t **              curp )
+netcalc_cur_blocks_next(
+         netcalc_cur_t *               cur,
+         netcalc_net_t **              netp,
+         int *                         flagsp )
 {
-   netcalc_cur_t *   cur;
+   uint8_t              cidr;
+   netcalc_rec_t *      rec;
+   netcalc_addr_t       last;
+   netcalc_buff_t       nbuff;
+   netcalc_net_t *      net;
 
-   assert(ns   != NULL);
-   assert(curp != NULL);
+   assert(cur != NULL);
 
-   if ((cur = malloc(sizeof(netcalc_cur_t))) == NULL)
-      return(NETCALC_ENOMEM);
+   // find end of next unallocated range
+   while(!(cur->cur_done))
+   {  if (cur->cur_idx[0] >= cur->cur_end)
+      {  netcalc_addr_last(&last, &cur->cur_addr, cur->cur_cidr);
+         if (memcmp(&cur->cur_pos, &last, sizeof(netcalc_addr_t)) <= 0)
+            break;
+         cur->cur_done = 1;
+         continue;
+      };
+      rec = cur->cur_recs->list[cur->cur_idx[0]];
+      if (memcmp(&cur->cur_pos, &rec->rec_addr, sizeof(netcalc_addr_t)) < 0)
+      {  memcpy(&last, &rec->rec_addr, sizeof(netcalc_addr_t));
+         netcalc_addr_decr(&last);
+         break;
+      };
+      // skip allocated range
+      netcalc_addr_last(&cur->cur_pos, &rec->rec_addr, rec->rec_cidr);
+      cur->cur_done = (uint8_t)netcalc_addr_incr(&cur->cur_pos);
+      cur->cur_idx[0]++;
+   };
+   if ((cur->cur_done))
+      return(NETCALC_ENOREC);
 
-   netcalc_cur_reset(ns, cur);
+   // largest aligned block at start of unallocated range
+   cidr = netcalc_addr_block(&cur->cur_pos, &last);
+   if ((netp))
+   {  net = &nbuff.buff_net;
+      memset(net, 0, sizeof(netcalc_net_t));
+      memcpy(&net->net_addr, &cur->cur_pos, sizeof(netcalc_addr_t));
+      net->net_cidr  = cidr;
+      net->net_flags = cur->cur_flags;
+      if ((netcalc_net_dup(netp, net)))
+         return(NETCALC_ENOMEM);
+   };
+   if ((flagsp))
+      *flagsp = (int)cur->cur_flags;
 
-   *curp = cur;
+   // advance position past block
+   netcalc_addr_last(&cur->cur_pos, &cur->cur_pos, cidr);
+   cur->cur_done = (uint8_t)netcalc_addr_incr(&cur->cur_pos);
 
    return(0);
 }
 
 
+// records path to each record which contains the network
+void
+netcalc_cur_chain_first(
+         netcalc_cur_t *               cur )
+{
+   int                  rc;
+   uint32_t             idx;
+   netcalc_rec_t *      rec;
+   netcalc_recs_t *     base;
+
+   assert(cur != NULL);
+
+   cur->cur_depth = 0;
+   cur->cur_end   = 0;
+
+   base = &cur->cur_set->set_recs;
+   while ((idx = netcalc_recs_lbound(base, &cur->cur_addr, cur->cur_cidr)) < base->len)
+   {  rec = base->list[idx];
+      rc  = netcalc_addr_cmp(&cur->cur_addr, cur->cur_cidr, &rec->rec_addr, rec->rec_cidr);
+      if ( (rc != NETCALC_CMP_SUBNET) && (rc != NETCALC_CMP_SAME) )
+         return;
+      cur->cur_idx[cur->cur_end++] = idx;
+      if (rc == NETCALC_CMP_SAME)
+         return;
+      base = &rec->rec_children;
+   };
+
+   return;
+}
+
+
 int
-netcalc_cur_next(
+netcalc_cur_chain_next(
          netcalc_cur_t *               cur,
          netcalc_net_t **              netp,
          char **                       commentp,
@@ -176,110 +542,156 @@ netcalc_cur_next(
          int *                         depthp )
 {
    uint32_t             depth;
-   uint32_t             idx;
    netcalc_rec_t *      rec;
    netcalc_recs_t *     recs;
-   netcalc_recs_t *     list[129];
 
    assert(cur != NULL);
 
-   if ((netp))
-      *netp = NULL;
-   if ((commentp))
-      *commentp = NULL;
-   if ((datap))
-      *datap = NULL;
-   if ((flagsp))
-      *flagsp = 0;
-   if ((depthp))
-      *depthp = 0;
-
-   if (cur->cur_serial != cur->cur_set->set_serial)
-      return(NETCALC_ESETMOD);
-
-   rec      = NULL;
-   recs     = &cur->cur_set->set_recs;
+   if (cur->cur_depth >= cur->cur_end)
+      return(NETCALC_ENOREC);
 
-   // fast forward to position
+   // follow path to record
+   rec  = NULL;
+   recs = &cur->cur_set->set_recs;
    for(depth = 0; (depth <= cur->cur_depth); depth++)
-   {  list[depth] = recs;
-      idx         = cur->cur_idx[depth];
-      if (depth < cur->cur_depth)
-         recs     = &recs->list[idx]->rec_children;
+   {  rec  = recs->list[cur->cur_idx[depth]];
+      recs = &rec->rec_children;
    };
 
-   // retrieve current record
-   depth = cur->cur_depth;
-   idx   = cur->cur_idx[depth];
-   if (idx >= list[depth]->len)
-      return(NETCALC_ENOREC);
-   rec = list[depth]->list[idx];
    if ((depthp))
       *depthp = (int)cur->cur_depth;
-
-   // increment index
-   depth = cur->cur_depth;
-   idx   = cur->cur_idx[depth];
-   if ((list[depth]->list[idx]->rec_children.len))
-   {  cur->cur_depth++;
-      cur->cur_idx[cur->cur_depth] = 0;
-   } else
-   {  cur->cur_idx[depth]++;
-      while ( (cur->cur_idx[depth] >= list[depth]->len) && (depth != 0) )
-      {  cur->cur_depth--;
-         depth = cur->cur_depth;
-         cur->cur_idx[depth]++;
-      };
-   };
+   cur->cur_depth++;
+   cur->cur_last = rec;
 
    return(netcalc_rec_get(rec, netp, commentp, datap, flagsp));
 }
 
 
+// positions cursor at the first record within the network
 void
-netcalc_cur_reset(
-         netcalc_set_t *               ns,
+netcalc_cur_covered_first(
          netcalc_cur_t *               cur )
 {
-   assert(ns   != NULL);
-   assert(cur  != NULL);
+   int                  rc;
+   uint32_t             idx;
+   netcalc_rec_t *      rec;
+   netcalc_recs_t *     base;
 
-   memset(cur, 0, sizeof(netcalc_cur_t));
-   cur->cur_serial   = ns->set_serial;
-   cur->cur_set      = ns;
+   assert(cur != NULL);
+
+   cur->cur_depth = 0;
+   cur->cur_base  = 0;
+   cur->cur_done  = 1;
+
+   base = &cur->cur_set->set_recs;
+   while ((idx = netcalc_recs_lbound(base, &cur->cur_addr, cur->cur_cidr)) < base->len)
+   {  cur->cur_idx[cur->cur_depth] = idx;
+      rec = base->list[idx];
+      rc  = netcalc_addr_cmp(&cur->cur_addr, cur->cur_cidr, &rec->rec_addr, rec->rec_cidr);
+      switch(rc)
+      {  case NETCALC_CMP_SUBNET:
+            base = &rec->rec_children;
+            cur->cur_depth++;
+            break;
+
+         case NETCALC_CMP_SAME:
+         case NETCALC_CMP_SUPERNET:
+            cur->cur_base = cur->cur_depth;
+            cur->cur_done = 0;
+            return;
+
+         default:
+            return;
+      };
+   };
 
    return;
 }
 
 
 void
-netcalc_rec_free(
-         netcalc_rec_t *               rec )
+netcalc_cur_free(
+         netcalc_cur_t *               cur )
 {
-   uint32_t                   rec_idx;
-   netcalc_rec_t *            recs[129];
+   assert(cur != NULL);
+   free(cur);
+   return;
+}
 
-   assert(rec != NULL);
 
-   rec_idx        = 0;
-   recs[rec_idx]  = rec;
+int
+netcalc_cur_init(
+         netcalc_set_t *               ns,
+         netcalc_cur_t **              curp )
+{
+   netcalc_cur_t *   cur;
 
-   while(rec)
-   {  if ((rec->rec_children.len))
-      {  recs[++rec_idx] = rec->rec_children.list[--rec->rec_children.len];
-         rec = recs[rec_idx];
-         continue;
-      };
+   assert(ns   != NULL);
+   assert(curp != NULL);
 
-      if ((rec->rec_children.list))
-         free(rec->rec_children.list);
+   if ((cur = malloc(sizeof(netcalc_cur_t))) == NULL)
+      return(NETCALC_ENOMEM);
 
-      if ((rec->rec_comment))
-         free(rec->rec_comment);
+   netcalc_cur_reset(ns, cur);
 
-      free(rec);
+   *curp = cur;
 
-      rec = ((rec_idx)) ? recs[--rec_idx] : NULL;
+   return(0);
+}
+
+
+int
+netcalc_cur_last(
+         netcalc_cur_t *               cur,
+         netcalc_net_t **              netp,
+         char **                       commentp,
+         void **                       datap,
+         int *                         flagsp,
+         int *                         depthp )
+{
+   assert(cur != NULL);
+   if (cur->cur_type != NETCALC_CUR_RECS)
+      return(NETCALC_ENOTSUP);
+   cur->cur_idx[0]   = cur->cur_set->set_recs.len;
+   cur->cur_depth    = 0;
+   cur->cur_serial   = cur->cur_set->set_serial;
+   return(netcalc_cur_prev(cur, netp, commentp, datap, flagsp, depthp));
+}
+
+
+// positions cursor at the first record which is not before the network
+void
+netcalc_cur_locate(
+         netcalc_cur_t *               cur,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr )
+{
+   uint32_t             depth;
+   uint32_t             idx;
+   netcalc_rec_t *      rec;
+   netcalc_recs_t *     list[129];
+
+   assert(cur  != NULL);
+   assert(addr != NULL);
+
+   // descend while the key is within a record which precedes it
+   depth       = 0;
+   list[depth] = &cur->cur_set->set_recs;
+   while ((idx = netcalc_recs_lbound(list[depth], addr, cidr)) < list[depth]->len)
+   {  rec = list[depth]->list[idx];
+      if (netcalc_addr_cmp(addr, cidr, &rec->rec_addr, rec->rec_cidr) != NETCALC_CMP_SUBNET)
+         break;
+      cur->cur_idx[depth++] = idx;
+      list[depth] = &rec->rec_children;
+   };
+   cur->cur_idx[depth]  = idx;
+   cur->cur_depth       = depth;
+
+   // move past end of list to next record in parent list
+   while ( (cur->cur_idx[depth] >= list[depth]->len) && (depth != 0) )
+   {  cur->cur_depth--;
+      depth = cur->cur_depth;
+      cur->cur_idx[depth]++;
    };
 
    return;
@@ -287,245 +699,2022 @@ netcalc_rec_free(
 
 
 int
-netcalc_rec_get(
-         netcalc_rec_t *               rec,
+netcalc_cur_next(
+         netcalc_cur_t *               cur,
          netcalc_net_t **              netp,
          char **                       commentp,
          void **                       datap,
-         int *                         flagsp )
+         int *                         flagsp,
+         int *                         depthp )
 {
-   int                  rc;
-   netcalc_buff_t       nbuff;
-   netcalc_net_t *      net;
-
-   assert(rec != NULL);
+   netcalc_rec_t *      rec;
+   netcalc_recs_t *     list[129];
 
-   net = &nbuff.buff_net;
+   assert(cur != NULL);
 
+   if ((netp))
+      *netp = NULL;
+   if ((commentp))
+      *commentp = NULL;
    if ((datap))
-      *datap = rec->rec_data;
+      *datap = NULL;
    if ((flagsp))
-      *flagsp = rec->rec_flags;
+      *flagsp = 0;
+   if ((depthp))
+      *depthp = 0;
+   cur->cur_last = NULL;
 
-   if ( ((netp)) && ((net)) )
-   {  memset(net, 0, sizeof(netcalc_net_t));
-      memcpy(&net->net_addr, &rec->rec_addr, sizeof(netcalc_addr_t));
-      net->net_cidr  = rec->rec_cidr;
-      net->net_flags = rec->rec_flags;
-      if ((rc = netcalc_net_dup(netp, net)) != NETCALC_SUCCESS)
-      {  if ((datap))
-            *datap = NULL;
-         if ((flagsp))
-            *flagsp = 0;
-         return(rc);
-      };
-   };
+   if (cur->cur_serial != cur->cur_set->set_serial)
+      return(NETCALC_ESETMOD);
 
-   if ( ((commentp)) && ((rec->rec_comment)) )
-   {  if ((*commentp = strdup(rec->rec_comment)) == NULL)
-      {  if ((datap))
-            *datap = NULL;
-         if ((flagsp))
-            *flagsp = 0;
-         if ((netp))
-         {  netcalc_net_free(*netp);
-            *netp = NULL;
-         };
-         return(NETCALC_ENOMEM);
+   if (cur->cur_type == NETCALC_CUR_BLOCKS)
+      return(netcalc_cur_blocks_next(cur, netp, flagsp));
+   if (cur->cur_type == NETCALC_CUR_CHAIN)
+      return(netcalc_cur_chain_next(cur, netp, commentp, datap, flagsp, depthp));
+   if ((cur->cur_done))
+      return(NETCALC_ENOREC);
+
+   // retrieve current record
+   if ((rec = netcalc_cur_rec(cur, list)) == NULL)
+      return(NETCALC_ENOREC);
+   if (cur->cur_type == NETCALC_CUR_COVERED)
+   {  switch(netcalc_addr_cmp(&cur->cur_addr, cur->cur_cidr, &rec->rec_addr, rec->rec_cidr))
+      {  case NETCALC_CMP_SAME:
+         case NETCALC_CMP_SUPERNET:
+            break;
+
+         default:
+            cur->cur_done = 1;
+            return(NETCALC_ENOREC);
       };
    };
+   if ((depthp))
+      *depthp = (int)(cur->cur_depth - cur->cur_base);
 
-   return(0);
+   netcalc_cur_advance(cur, list);
+   cur->cur_last = rec;
+
+   return(netcalc_rec_get(rec, netp, commentp, datap, flagsp));
 }
 
 
-// returns code which describes the key's relation to the record specified
-// by 'wouldbe'
-//    NETCALC_IDX_BEFORE   - key is before specified record
-//    NETCALC_IDX_SUPERNET - key is supernet of specified record
-//    NETCALC_IDX_SAME     - key is same as specified record
-//    NETCALC_IDX_SUBNET   - key is subnet of specified record
-//    NETCALC_IDX_AFTER    - key is after specified record
-//    NETCALC_IDX_ERROR    - an error was detected
 int
-netcalc_set_bindex(
+netcalc_cur_prev(
+         netcalc_cur_t *               cur,
+         netcalc_net_t **              netp,
+         char **                       commentp,
+         void **                       datap,
+         int *                         flagsp,
+         int *                         depthp )
+{
+   netcalc_rec_t *      rec;
+
+   assert(cur != NULL);
+
+   if ((netp))
+      *netp = NULL;
+   if ((commentp))
+      *commentp = NULL;
+   if ((datap))
+      *datap = NULL;
+   if ((flagsp))
+      *flagsp = 0;
+   if ((depthp))
+      *depthp = 0;
+   cur->cur_last = NULL;
+
+   if (cur->cur_type != NETCALC_CUR_RECS)
+      return(NETCALC_ENOTSUP);
+   if (cur->cur_serial != cur->cur_set->set_serial)
+      return(NETCALC_ESETMOD);
+
+   if ((rec = netcalc_cur_retreat(cur)) == NULL)
+      return(NETCALC_ENOREC);
+
+   if ((depthp))
+      *depthp = (int)cur->cur_depth;
+   cur->cur_last = rec;
+
+   return(netcalc_rec_get(rec, netp, commentp, datap, flagsp));
+}
+
+
+// allocates cursor which iterates records relative to the network
+int
+netcalc_cur_query(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net,
+         uint32_t                      type,
+         netcalc_cur_t **              curp )
+{
+   netcalc_cur_t *      cur;
+
+   assert(ns   != NULL);
+   assert(net  != NULL);
+   assert(curp != NULL);
+
+   if ((cur = malloc(sizeof(netcalc_cur_t))) == NULL)
+      return(NETCALC_ENOMEM);
+   netcalc_cur_reset(ns, cur);
+
+   memcpy(&cur->cur_addr, &net->net_addr, sizeof(netcalc_addr_t));
+   netcalc_addr_convert_inet6(&cur->cur_addr, (int)(net->net_flags & NETCALC_AF));
+   cur->cur_type     = type;
+   cur->cur_cidr     = net->net_cidr;
+   cur->cur_flags    = net->net_flags & NETCALC_AF;
+
+   if (type == NETCALC_CUR_CHAIN)
+      netcalc_cur_chain_first(cur);
+   else
+      netcalc_cur_covered_first(cur);
+
+   *curp = cur;
+
+   return(0);
+}
+
+
+// returns record at cursor position and the list of records at each depth
+netcalc_rec_t *
+netcalc_cur_rec(
+         netcalc_cur_t *               cur,
+         netcalc_recs_t **             list )
+{
+   uint32_t             depth;
+   netcalc_recs_t *     recs;
+
+   assert(cur  != NULL);
+   assert(list != NULL);
+
+   // fast forward to position
+   recs = &cur->cur_set->set_recs;
+   for(depth = 0; (depth <= cur->cur_depth); depth++)
+   {  list[depth] = recs;
+      if (depth < cur->cur_depth)
+         recs     = &recs->list[cur->cur_idx[depth]]->rec_children;
+   };
+
+   if (cur->cur_idx[cur->cur_depth] >= recs->len)
+      return(NULL);
+
+   return(recs->list[cur->cur_idx[cur->cur_depth]]);
+}
+
+
+// returns record returned by the previous call to iterate the cursor
+netcalc_rec_t *
+netcalc_cur_record(
+         netcalc_cur_t *               cur )
+{
+   assert(cur != NULL);
+   if (cur->cur_serial != cur->cur_set->set_serial)
+      return(NULL);
+   return(cur->cur_last);
+}
+
+
+void
+netcalc_cur_reset(
+         netcalc_set_t *               ns,
+         netcalc_cur_t *               cur )
+{
+   assert(ns   != NULL);
+   assert(cur  != NULL);
+
+   memset(cur, 0, sizeof(netcalc_cur_t));
+   cur->cur_serial   = ns->set_serial;
+   cur->cur_set      = ns;
+
+   return;
+}
+
+
+// moves cursor position to the previous record in cursor order
+netcalc_rec_t *
+netcalc_cur_retreat(
+         netcalc_cur_t *               cur )
+{
+   uint32_t             depth;
+   netcalc_rec_t *      rec;
+   netcalc_recs_t *     recs;
+   netcalc_recs_t *     list[129];
+
+   assert(cur != NULL);
+
+   netcalc_cur_rec(cur, list);
+
+   // first record in set
+   depth = cur->cur_depth;
+   if ( (!(depth)) && (!(cur->cur_idx[0])) )
+      return(NULL);
+
+   // parent of first record in list
+   if (!(cur->cur_idx[depth]))
+   {  cur->cur_depth--;
+      depth = cur->cur_depth;
+      return(list[depth]->list[cur->cur_idx[depth]]);
+   };
+
+   // last descendant of previous sibling
+   cur->cur_idx[depth]--;
+   rec   = list[depth]->list[cur->cur_idx[depth]];
+   while ((rec->rec_children.len))
+   {  recs = &rec->rec_children;
+      cur->cur_depth++;
+      depth = cur->cur_depth;
+      cur->cur_idx[depth] = recs->len - 1;
+      rec   = recs->list[cur->cur_idx[depth]];
+   };
+
+   return(rec);
+}
+
+
+int
+netcalc_cur_seek(
+         netcalc_cur_t *               cur,
+         const netcalc_net_t *         net,
+         netcalc_net_t **              netp,
+         char **                       commentp,
+         void **                       datap,
+         int *                         flagsp,
+         int *                         depthp )
+{
+   netcalc_addr_t       addr;
+
+   assert(cur != NULL);
+   assert(net != NULL);
+
+   if (cur->cur_type != NETCALC_CUR_RECS)
+      return(NETCALC_ENOTSUP);
+
+   memcpy(&addr, &net->net_addr, sizeof(netcalc_addr_t));
+   netcalc_addr_convert_inet6(&addr, (int)(net->net_flags & NETCALC_AF));
+
+   cur->cur_serial   = cur->cur_set->set_serial;
+   netcalc_cur_locate(cur, &addr, net->net_cidr);
+
+   return(netcalc_cur_next(cur, netp, commentp, datap, flagsp, depthp));
+}
+
+
+// allocates record for network, the network must be in IPv6 notation
+int
+netcalc_rec_alloc(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net,
+         const char *                  comment,
+         void *                        data,
+         int                           flags,
+         netcalc_rec_t **              recp )
+{
+   netcalc_rec_t *      rec;
+
+   assert(ns   != NULL);
+   assert(net  != NULL);
+   assert(recp != NULL);
+
+   if ((rec = malloc(sizeof(netcalc_rec_t))) == NULL)
+      return(NETCALC_ENOMEM);
+   memset(rec, 0, sizeof(netcalc_rec_t));
+   atomic_init(&rec->rec_refs, 1);
+   atomic_init(&rec->rec_hits, 0);
+   memcpy(&rec->rec_addr.addr8, &net->net_addr.addr8, sizeof(netcalc_addr_t));
+   rec->rec_cidr   = net->net_cidr;
+   rec->rec_data   = data;
+   rec->rec_flags  = ns->set_flags & ~(NETCALC_AF | NETCALC_USR);
+   rec->rec_flags |= net->net_flags & NETCALC_AF;
+   rec->rec_flags |= flags & NETCALC_USR;
+   if ((comment))
+   {  if ((rec->rec_comment = strdup(comment)) == NULL)
+      {  netcalc_rec_free(rec);
+         return(NETCALC_ENOMEM);
+      };
+   };
+
+   *recp = rec;
+
+   return(0);
+}
+
+
+const char *
+netcalc_rec_comment(
+         const netcalc_rec_t *         rec )
+{
+   assert(rec != NULL);
+   return(rec->rec_comment);
+}
+
+
+void *
+netcalc_rec_data(
+         const netcalc_rec_t *         rec )
+{
+   assert(rec != NULL);
+   return(rec->rec_data);
+}
+
+
+// copies record and subnets of record
+int
+netcalc_rec_dup(
+         const netcalc_rec_t *         src,
+         netcalc_rec_t **              recp )
+{
+   int                  rc;
+   uint32_t             idx;
+   netcalc_rec_t *      rec;
+
+   assert(src  != NULL);
+   assert(recp != NULL);
+
+   if ((rec = malloc(sizeof(netcalc_rec_t))) == NULL)
+      return(NETCALC_ENOMEM);
+   memcpy(rec, src, sizeof(netcalc_rec_t));
+   memset(&rec->rec_children, 0, sizeof(netcalc_recs_t));
+   atomic_init(&rec->rec_refs, 1);
+   atomic_init(&rec->rec_hits, atomic_load_explicit(&src->rec_hits, memory_order_relaxed));
+
+   if ( ((src->rec_comment)) && ((rec->rec_comment = strdup(src->rec_comment)) == NULL) )
+   {  free(rec);
+      return(NETCALC_ENOMEM);
+   };
+
+   if ((src->rec_children.len))
+   {  if ((rec->rec_children.list = malloc(sizeof(netcalc_rec_t *) * (src->rec_children.len + 1))) == NULL)
+      {  netcalc_rec_free(rec);
+         return(NETCALC_ENOMEM);
+      };
+      rec->rec_children.size = src->rec_children.len;
+      for(idx = 0; (idx < src->rec_children.len); idx++)
+      {  if ((rc = netcalc_rec_dup(src->rec_children.list[idx], &rec->rec_children.list[idx])) != 0)
+         {  netcalc_rec_free(rec);
+            return(rc);
+         };
+         rec->rec_children.len++;
+         rec->rec_children.list[rec->rec_children.len] = NULL;
+      };
+   };
+
+   *recp = rec;
+
+   return(0);
+}
+
+
+int
+netcalc_rec_flags(
+         const netcalc_rec_t *         rec )
+{
+   assert(rec != NULL);
+   return((int)rec->rec_flags);
+}
+
+
+void
+netcalc_rec_free(
+         netcalc_rec_t *               rec )
+{
+   uint32_t                   rec_idx;
+   netcalc_rec_t *            child;
+   netcalc_rec_t *            recs[129];
+
+   assert(rec != NULL);
+
+   // records shared with clones are freed by the last reference
+   if (atomic_fetch_sub(&rec->rec_refs, 1) > 1)
+      return;
+
+   rec_idx        = 0;
+   recs[rec_idx]  = rec;
+
+   while(rec)
+   {  if ((rec->rec_children.len))
+      {  child = rec->rec_children.list[--rec->rec_children.len];
+         if (atomic_fetch_sub(&child->rec_refs, 1) > 1)
+            continue;
+         recs[++rec_idx] = child;
+         rec = recs[rec_idx];
+         continue;
+      };
+
+      if ((rec->rec_children.list))
+         free(rec->rec_children.list);
+
+      if ((rec->rec_children.gaps))
+         free(rec->rec_children.gaps);
+      netcalc_keys_free(&rec->rec_children);
+
+      if ((rec->rec_comment))
+         free(rec->rec_comment);
+
+      free(rec);
+
+      rec = ((rec_idx)) ? recs[--rec_idx] : NULL;
+   };
+
+   return;
+}
+
+
+int
+netcalc_rec_get(
+         const netcalc_rec_t *         rec,
+         netcalc_net_t **              netp,
+         char **                       commentp,
+         void **                       datap,
+         int *                         flagsp )
+{
+   int                  rc;
+   netcalc_buff_t       nbuff;
+   netcalc_net_t *      net;
+
+   assert(rec != NULL);
+
+   net = &nbuff.buff_net;
+
+   if ((datap))
+      *datap = rec->rec_data;
+   if ((flagsp))
+      *flagsp = rec->rec_flags;
+
+   if ( ((netp)) && ((net)) )
+   {  memset(net, 0, sizeof(netcalc_net_t));
+      memcpy(&net->net_addr, &rec->rec_addr, sizeof(netcalc_addr_t));
+      net->net_cidr  = rec->rec_cidr;
+      net->net_flags = rec->rec_flags;
+      if ((rc = netcalc_net_dup(netp, net)) != NETCALC_SUCCESS)
+      {  if ((datap))
+            *datap = NULL;
+         if ((flagsp))
+            *flagsp = 0;
+         return(rc);
+      };
+   };
+
+   if ( ((commentp)) && ((rec->rec_comment)) )
+   {  if ((*commentp = strdup(rec->rec_comment)) == NULL)
+      {  if ((datap))
+            *datap = NULL;
+         if ((flagsp))
+            *flagsp = 0;
+         if ((netp))
+         {  netcalc_net_free(*netp);
+            *netp = NULL;
+         };
+         return(NETCALC_ENOMEM);
+      };
+   };
+
+   return(0);
+}
+
+
+uintmax_t
+netcalc_rec_hits(
+         const netcalc_rec_t *         rec )
+{
+   assert(rec != NULL);
+   return(atomic_load_explicit(&rec->rec_hits, memory_order_relaxed));
+}
+
+
+// updates comment, data, and user flags of record
+int
+netcalc_rec_modify(
+         netcalc_set_t *               ns,
+         netcalc_rec_t *               rec,
+         const char *                  comment,
+         void *                        data,
+         int                           flags )
+{
+   int                  rc;
+   char *               str;
+   netcalc_rec_t        upd;
+
+   assert(ns  != NULL);
+   assert(rec != NULL);
+
+   str = NULL;
+   if ( ((comment)) && ((str = strdup(comment)) == NULL) )
+      return(NETCALC_ENOMEM);
+
+   // journal updated record before modifying record
+   memset(&upd, 0, sizeof(upd));
+   memcpy(&upd.rec_addr, &rec->rec_addr, sizeof(netcalc_addr_t));
+   upd.rec_cidr      = rec->rec_cidr;
+   upd.rec_comment   = str;
+   upd.rec_flags     = (rec->rec_flags & ~((uint32_t)NETCALC_USR)) | ((uint32_t)flags & NETCALC_USR);
+   if ((rc = netcalc_jrnl_append(ns, NETCALC_MOD_UPDATE, &upd)) != 0)
+   {  free(str);
+      return(rc);
+   };
+
+   if ((rec->rec_comment))
+      free(rec->rec_comment);
+
+   rec->rec_comment  = str;
+   rec->rec_data     = data;
+   rec->rec_flags    = upd.rec_flags;
+
+   return(netcalc_set_modified(ns, NETCALC_MOD_UPDATE, rec));
+}
+
+
+// replaces record shared with clones of set with a copy which shares the
+// subnets of the record
+int
+netcalc_rec_unshare(
+         netcalc_rec_t **              recp )
+{
+   uint32_t             idx;
+   netcalc_rec_t *      src;
+   netcalc_rec_t *      rec;
+
+   assert(recp != NULL);
+
+   src = *recp;
+   if (atomic_load(&src->rec_refs) < 2)
+      return(0);
+
+   if ((rec = malloc(sizeof(netcalc_rec_t))) == NULL)
+      return(NETCALC_ENOMEM);
+   memset(rec, 0, sizeof(netcalc_rec_t));
+   atomic_init(&rec->rec_refs, 1);
+   atomic_init(&rec->rec_hits, atomic_load_explicit(&src->rec_hits, memory_order_relaxed));
+   memcpy(&rec->rec_addr, &src->rec_addr, sizeof(netcalc_addr_t));
+   rec->rec_flags = src->rec_flags;
+   rec->rec_cidr  = src->rec_cidr;
+   rec->rec_data  = src->rec_data;
+
+   if ( ((src->rec_comment)) && ((rec->rec_comment = strdup(src->rec_comment)) == NULL) )
+   {  free(rec);
+      return(NETCALC_ENOMEM);
+   };
+
+   if ((src->rec_children.len))
+   {  if ((rec->rec_children.list = malloc(sizeof(netcalc_rec_t *) * ((size_t)src->rec_children.len + 1))) == NULL)
+      {  if ((rec->rec_comment))
+            free(rec->rec_comment);
+         free(rec);
+         return(NETCALC_ENOMEM);
+      };
+      for(idx = 0; (idx < src->rec_children.len); idx++)
+      {  rec->rec_children.list[idx] = src->rec_children.list[idx];
+         atomic_fetch_add(&rec->rec_children.list[idx]->rec_refs, 1);
+      };
+      rec->rec_children.list[idx]   = NULL;
+      rec->rec_children.len         = src->rec_children.len;
+      rec->rec_children.size        = src->rec_children.len;
+   };
+
+   *recp = rec;
+   netcalc_rec_free(src);
+
+   return(0);
+}
+
+
+uint32_t
+netcalc_rec_serial(
+         const netcalc_set_t *         ns )
+{
+   assert(ns != NULL);
+   return(ns->set_handles);
+}
+
+
+// updates record referenced by handle, records which may be shared with a
+// snapshot or with clones are located by network and copied before the
+// record is updated
+int
+netcalc_rec_update(
+         netcalc_set_t *               ns,
+         netcalc_rec_t *               rec,
+         uint32_t                      serial,
+         const char *                  comment,
+         void *                        data,
+         int                           flags,
+         netcalc_rec_t **              recp )
+{
+   int                  rc;
+   uint32_t             idx;
+   netcalc_net_t        net;
+   netcalc_recs_t *     recs;
+   netcalc_buff_t       nbuff;
+
+   assert(ns   != NULL);
+   assert(rec  != NULL);
+
+   if ((recp))
+      *recp = NULL;
+
+   // records were freed or replaced since handle was returned
+   if (serial != ns->set_handles)
+      return(NETCALC_ESETMOD);
+
+   if ( ((ns->set_snap)) || ((netcalc_set_cloned(ns))) )
+   {  memset(&net, 0, sizeof(net));
+      memcpy(&net.net_addr, &rec->rec_addr, sizeof(netcalc_addr_t));
+      net.net_cidr   = rec->rec_cidr;
+      net.net_flags  = NETCALC_AF_INET6;
+      if ((rc = netcalc_set_find(ns, &nbuff, &net, &recs, &idx)) != 0)
+         return(rc);
+      rec = recs->list[idx];
+   };
+
+   if ((recp))
+      *recp = rec;
+
+   return(netcalc_rec_modify(ns, rec, comment, data, flags));
+}
+
+
+// returns relation of the key to the record at 'wouldbe' within list
+int
+netcalc_recs_bindex(
+         const netcalc_recs_t *        recs,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr,
+         uint32_t *                    wouldbep )
+{
+   int                  rc;
+   int32_t              low;
+   int32_t              mid;
+   int32_t              high;
+   netcalc_rec_t *      rec;
+
+   assert(recs       != NULL);
+   assert(addr       != NULL);
+   assert(wouldbep   != NULL);
+   assert(recs->len  > 0);
+
+   low  = 0;
+   high = (int32_t)(recs->len - 1);
+
+   while(1)
+   {  mid   = (low+high) / 2;
+      rec   = recs->list[mid];
+      rc    = netcalc_addr_cmp(addr, cidr, &rec->rec_addr, rec->rec_cidr);
+      switch(rc)
+      {  case NETCALC_CMP_BEFORE:
+         case NETCALC_CMP_SUPERNET:
+            if (low == mid)
+            {  *wouldbep = (uint32_t)mid;
+               return(rc);
+            };
+            high = mid;
+            break;
+
+         case NETCALC_CMP_AFTER:
+            if (high == mid)
+            {  *wouldbep = (uint32_t)mid;
+               return(rc);
+            };
+            low = (mid < high) ? mid + 1 : mid;
+            break;
+
+         default:
+            *wouldbep = (uint32_t)mid;
+            return(rc);
+      };
+   };
+
+   return(NETCALC_IDX_ERROR);
+}
+
+
+// returns prefix length of largest unallocated block between list[idx]
+// and list[idx+1]
+uint8_t
+netcalc_recs_gap(
+         const netcalc_recs_t *        recs,
+         uint32_t                      idx )
+{
+   netcalc_addr_t       first;
+   netcalc_addr_t       last;
+   netcalc_rec_t *      rec;
+
+   rec = recs->list[idx];
+   netcalc_addr_last(&first, &rec->rec_addr, rec->rec_cidr);
+   if ((netcalc_addr_incr(&first)))
+      return(NETCALC_GAP_NONE);
+
+   rec = recs->list[idx+1];
+   if (memcmp(&first, &rec->rec_addr, sizeof(netcalc_addr_t)) >= 0)
+      return(NETCALC_GAP_NONE);
+   memcpy(&last, &rec->rec_addr, sizeof(netcalc_addr_t));
+   netcalc_addr_decr(&last);
+
+   return(netcalc_addr_largest(&first, &last));
+}
+
+
+// builds segment tree of unallocated blocks between records
+int
+netcalc_recs_gaps(
+         netcalc_recs_t *              recs )
+{
+   uint32_t             leaves;
+   uint32_t             node;
+   netcalc_gaps_t *     gaps;
+
+   assert(recs != NULL);
+
+   for(leaves = 1; (leaves < recs->len); leaves <<= 1)
+      continue;
+
+   if ((gaps = recs->gaps) == NULL)
+   {  if ((gaps = malloc(sizeof(netcalc_gaps_t) + ((size_t)leaves * 2))) == NULL)
+         return(NETCALC_ENOMEM);
+      gaps->gaps_leaves = leaves;
+      recs->gaps        = gaps;
+   };
+
+   memset(gaps->gaps_tree, NETCALC_GAP_NONE, ((size_t)gaps->gaps_leaves * 2));
+   for(node = 0; ((node+1) < recs->len); node++)
+      gaps->gaps_tree[gaps->gaps_leaves + node] = netcalc_recs_gap(recs, node);
+   for(node = gaps->gaps_leaves - 1; (node > 0); node--)
+      gaps->gaps_tree[node] = (gaps->gaps_tree[node*2] < gaps->gaps_tree[node*2+1])
+                            ? gaps->gaps_tree[node*2]
+                            : gaps->gaps_tree[node*2+1];
+
+   return(0);
+}
+
+
+// returns first leaf, between 'low' and 'high', which contains a block of
+// the requested prefix length, or UINT32_MAX if no leaf is found
+uint32_t
+netcalc_recs_gaps_find(
+         const netcalc_gaps_t *        gaps,
+         uint32_t                      node,
+         uint32_t                      node_low,
+         uint32_t                      node_high,
+         uint32_t                      low,
+         uint32_t                      high,
+         uint8_t                       cidr )
+{
+   uint32_t             mid;
+   uint32_t             leaf;
+
+   if ( (node_high <= low) || (node_low >= high) || (gaps->gaps_tree[node] > cidr) )
+      return(UINT32_MAX);
+   if ((node_high - node_low) == 1)
+      return(node_low);
+
+   mid = node_low + ((node_high - node_low) / 2);
+   if ((leaf = netcalc_recs_gaps_find(gaps, node*2, node_low, mid, low, high, cidr)) != UINT32_MAX)
+      return(leaf);
+
+   return(netcalc_recs_gaps_find(gaps, node*2+1, mid, node_high, low, high, cidr));
+}
+
+
+void
+netcalc_recs_gaps_free(
+         netcalc_recs_t *              recs )
+{
+   if ((recs->gaps))
+      free(recs->gaps);
+   recs->gaps = NULL;
+   return;
+}
+
+
+// updates segment tree after a record was inserted at 'idx', only the
+// nodes above the leaves which were recalculated or shifted are updated
+void
+netcalc_recs_gaps_update(
+         netcalc_recs_t *              recs,
+         uint32_t                      idx )
+{
+   uint32_t             node;
+   uint32_t             low;
+   uint32_t             high;
+   uint8_t *            leaves;
+   netcalc_gaps_t *     gaps;
+
+   if ((gaps = recs->gaps) == NULL)
+      return;
+   if ((recs->len - 1) > gaps->gaps_leaves)
+   {  netcalc_recs_gaps_free(recs);
+      return;
+   };
+
+   leaves = &gaps->gaps_tree[gaps->gaps_leaves];
+   if ((idx+2) < recs->len)
+      memmove(&leaves[idx+1], &leaves[idx], (size_t)(recs->len - idx - 2));
+   if ((idx))
+      leaves[idx-1] = netcalc_recs_gap(recs, idx-1);
+   if ((idx+1) < recs->len)
+      leaves[idx] = netcalc_recs_gap(recs, idx);
+   if (recs->len < 2)
+      return;
+
+   // leaves between the leaf before the record and the last leaf changed
+   low  = gaps->gaps_leaves + (((idx)) ? (idx - 1) : 0);
+   high = gaps->gaps_leaves + (recs->len - 2);
+   while(low > 1)
+   {  low  >>= 1;
+      high >>= 1;
+      for(node = low; (node <= high); node++)
+         gaps->gaps_tree[node] = (gaps->gaps_tree[node*2] < gaps->gaps_tree[node*2+1])
+                               ? gaps->gaps_tree[node*2]
+                               : gaps->gaps_tree[node*2+1];
+   };
+
+   return;
+}
+
+
+int
+netcalc_recs_insert(
+         netcalc_recs_t *              recs,
+         uint32_t                      idx,
+         netcalc_rec_t *               rec )
+{
+   uint32_t             pos;
+   size_t               size;
+   void *               ptr;
+
+   assert(recs != NULL);
+   assert(rec  != NULL);
+   assert(idx  <= recs->len);
+
+   // allocate memory for net record pointer
+   if (recs->len >= recs->size)
+   {  size = ((size_t)recs->size + 2) * sizeof(netcalc_rec_t *);
+      if ((ptr = realloc(recs->list, size)) == NULL)
+         return(NETCALC_ENOMEM);
+      recs->size++;
+      recs->list              = ptr;
+      recs->list[recs->size]  = NULL;
+   };
+
+   // shift records down list
+   for(pos = recs->len; (pos > idx); pos--)
+      recs->list[pos] = recs->list[pos-1];
+
+   // record new record
+   recs->list[idx] = rec;
+   recs->len++;
+
+   netcalc_recs_gaps_update(recs, idx);
+   netcalc_keys_free(recs);
+
+   return(0);
+}
+
+
+// returns index of first record which is not before the key
+uint32_t
+netcalc_recs_lbound(
+         const netcalc_recs_t *        recs,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr )
+{
+   uint32_t             low;
+   uint32_t             mid;
+   uint32_t             high;
+   netcalc_rec_t *      rec;
+
+   assert(recs != NULL);
+   assert(addr != NULL);
+
+   low  = 0;
+   high = recs->len;
+   while(low < high)
+   {  mid = low + ((high - low) / 2);
+      rec = recs->list[mid];
+      if (netcalc_addr_cmp(addr, cidr, &rec->rec_addr, rec->rec_cidr) == NETCALC_CMP_AFTER)
+         low  = mid + 1;
+      else
+         high = mid;
+   };
+
+   return(low);
+}
+
+
+// returns index of first record, starting at 'low', which is after the key
+uint32_t
+netcalc_recs_ubound(
+         const netcalc_recs_t *        recs,
+         uint32_t                      low,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr )
+{
+   uint32_t             mid;
+   uint32_t             high;
+   netcalc_rec_t *      rec;
+
+   assert(recs != NULL);
+   assert(addr != NULL);
+
+   high = recs->len;
+   while(low < high)
+   {  mid = low + ((high - low) / 2);
+      rec = recs->list[mid];
+      if (netcalc_addr_cmp(addr, cidr, &rec->rec_addr, rec->rec_cidr) != NETCALC_CMP_BEFORE)
+         low  = mid + 1;
+      else
+         high = mid;
+   };
+
+   return(low);
+}
+
+
+// returns code which describes the key's relation to the record specified
+// by 'wouldbe'
+//    NETCALC_IDX_BEFORE   - key is before specified record
+//    NETCALC_IDX_SUPERNET - key is supernet of specified record
+//    NETCALC_IDX_SAME     - key is same as specified record
+//    NETCALC_IDX_SUBNET   - key is subnet of specified record
+//    NETCALC_IDX_AFTER    - key is after specified record
+//    NETCALC_IDX_ERROR    - an error was detected
+// lists of records are indexed only by queries, since the keys locate
+// records but not positions at which records are inserted, descents which
+// modify the set copy the records along the path shared with clones
+int
+netcalc_set_bindex(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         key,
+         netcalc_recs_t **             basep,
+         uint32_t *                    wouldbep,
+         netcalc_rec_t **              parentp,
+         int                           query )
+{
+   int                  rc;
+   int                  cloned;
+   uint32_t             wouldbe;
+   netcalc_rec_t *      rec;
+   netcalc_recs_t *     base;
+   netcalc_keys_t *     keys;
+
+   assert(ns         != NULL);
+   assert(key        != NULL);
+   assert(basep      != NULL);
+   assert(*basep     != NULL);
+   assert(wouldbep   != NULL);
+
+   if ((parentp))
+      *parentp = NULL;
+
+   // copy list of top level records shared with clones
+   cloned = ( (!(query)) && ((netcalc_set_cloned(ns))) ) ? 1 : 0;
+   if ( ((cloned)) && (*basep == &ns->set_recs) && ((netcalc_set_unshare_list(ns))) )
+      return(NETCALC_IDX_ERROR);
+
+   base = *basep;
+   if (base->len == 0)
+   {  if ((wouldbep))
+         *wouldbep = 0;
+      return(NETCALC_IDX_INSERT);
+   };
+
+   while(1)
+   {  // compare keys of list in place of records when list is indexed
+      keys = ((query)) ? netcalc_keys_get(base) : NULL;
+      rc   = ((keys)) ? netcalc_keys_bindex(keys, &key->net_addr, key->net_cidr, &wouldbe) : NETCALC_IDX_ERROR;
+      if (rc == NETCALC_IDX_ERROR)
+         rc = netcalc_recs_bindex(base, &key->net_addr, key->net_cidr, &wouldbe);
+      if ( ((cloned)) && ( (rc == NETCALC_CMP_SAME) || (rc == NETCALC_CMP_SUBNET) ) && ((netcalc_set_unshare_rec(ns, base, wouldbe))) )
+         return(NETCALC_IDX_ERROR);
+      if (rc != NETCALC_CMP_SUBNET)
+      {  *wouldbep = wouldbe;
+         return(rc);
+      };
+
+      rec = base->list[wouldbe];
+      if ((parentp))
+         *parentp = rec;
+      if (!(rec->rec_children.len))
+      {  *wouldbep = wouldbe;
+         return(NETCALC_IDX_SUBNET);
+      };
+      *basep   = &rec->rec_children;
+      base     = *basep;
+   };
+
+   return(NETCALC_IDX_ERROR);
+}
+
+
+int
+netcalc_set_add(
+         netcalc_set_t *               ns,
+         netcalc_net_t *               net,
+         const char *                  comment,
+         void *                        data,
+         int                           flags )
+{
+   int                  rc;
+   uint32_t             wouldbe;
+   netcalc_recs_t *     base;
+   netcalc_rec_t *      rec;
+   netcalc_buff_t       nbuff;
+
+   assert(ns   != NULL);
+   assert(net  != NULL);
+
+   if ((rc = netcalc_set_prepare(ns, &nbuff, net)) != 0)
+      return(rc);
+   net = &nbuff.buff_net;
+
+   // add information to record
+   if ((rc = netcalc_rec_alloc(ns, net, comment, data, flags, &rec)) != 0)
+      return(rc);
+
+   base = &ns->set_recs;
+   rc = netcalc_set_bindex(ns, net, &base, &wouldbe, NULL, 0);
+   if ( (rc == NETCALC_IDX_SAME) || (rc == NETCALC_IDX_ERROR) )
+   {  netcalc_rec_free(rec);
+      return( (rc == NETCALC_IDX_SAME) ? NETCALC_EEXISTS : NETCALC_ENOMEM );
+   };
+
+   return(netcalc_set_insert(ns, base, wouldbe, rc, rec));
+}
+
+
+int
+netcalc_set_add_str(
+         netcalc_set_t *               ns,
+         const char *                  address,
+         const char *                  comment,
+         void *                        data,
+         int                           flags )
+{
+   int                  rc;
+   netcalc_buff_t       b;
+
+   assert(ns      != NULL);
+   assert(address != NULL);
+
+   if ((rc = netcalc_net_parse(&b, address, ns->set_flags)) != 0)
+      return( ((strchr(address, '-'))) ? netcalc_set_add_range(ns, address, comment, data, flags, NULL) : rc );
+
+   return(netcalc_set_add(ns, &b.buff_net, comment, data, flags));
+}
+
+
+// adds the blocks which cover a range of addresses formatted as
+// "first-last", the last block of the range is returned by 'lastp'
+int
+netcalc_set_add_range(
+         netcalc_set_t *               ns,
+         const char *                  address,
+         const char *                  comment,
+         void *                        data,
+         int                           flags,
+         netcalc_net_t **              lastp )
+{
+   int                  rc;
+   int                  err;
+   size_t               idx;
+   netcalc_net_t **     nets;
+   netcalc_buff_t       first;
+   netcalc_buff_t       last;
+
+   assert(ns      != NULL);
+   assert(address != NULL);
+
+   if ((lastp))
+      *lastp = NULL;
+
+   if ((rc = netcalc_range_parse(address, (int)ns->set_flags, &first, &last)) != 0)
+      return(rc);
+
+   if ((rc = netcalc_range_to_cidrs(&first.buff_net, &last.buff_net, &nets, NULL)) != 0)
+      return(rc);
+
+   // range is either added in full or not at all, failed observers do not
+   // prevent the range from being added
+   for(idx = 0, err = 0; ((nets[idx])); idx++)
+   {  if ((rc = netcalc_set_add(ns, nets[idx], comment, data, flags)) == NETCALC_EOBSERVER)
+      {  err = rc;
+      } else if (rc != 0)
+      {  while(idx > 0)
+            netcalc_set_del(ns, nets[--idx]);
+         netcalc_range_free(nets);
+         return(rc);
+      };
+   };
+
+   if ((lastp))
+   {  *lastp      = nets[idx-1];
+      nets[idx-1] = NULL;
+   };
+   netcalc_range_free(nets);
+
+   return(err);
+}
+
+
+int
+netcalc_set_allocate(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         parent,
+         int                           cidr,
+         const char *                  comment,
+         void *                        data,
+         int                           flags,
+         netcalc_net_t **              netp )
+{
+   int                  rc;
+   int                  err;
+   uint8_t              prefix;
+   uint32_t             idx;
+   uint32_t             low;
+   uint32_t             high;
+   uint32_t             leaf;
+   netcalc_recs_t *     recs;
+   netcalc_rec_t *      rec;
+   netcalc_rec_t *      owner;
+   netcalc_addr_t       first;
+   netcalc_addr_t       last;
+   netcalc_buff_t       nbuff;
+   netcalc_net_t *      net;
+
+   assert(ns != NULL);
+
+   if ((netp))
+      *netp = NULL;
+
+   if (!(parent))
+      parent = ns->set_superblock;
+   if (!(parent))
+      return(NETCALC_EINVAL);
+
+   // adjust nbuff
+   memcpy(&nbuff.buff_net.net_addr, &parent->net_addr, sizeof(netcalc_addr_t));
+   nbuff.buff_net.net_cidr       = parent->net_cidr;
+   nbuff.buff_net.net_port       = 0;
+   nbuff.buff_net.net_flags      = parent->net_flags & NETCALC_AF;
+   nbuff.buff_net.net_scope_name = NULL;
+   net                           = &nbuff.buff_net;
+
+   if ((netcalc_net_verify(net, NETCALC_TYPE_NETWORK)))
+      return(NETCALC_EINVAL);
+   netcalc_addr_convert_inet6(&net->net_addr, (net->net_flags & NETCALC_AF));
+
+   // determine prefix length of allocation
+   if ( (cidr < 0) || (cidr > 128) )
+      return(NETCALC_EINVAL);
+   if ((net->net_flags & NETCALC_AF) == NETCALC_AF_INET)
+      cidr += 96;
+   if ( (cidr > 128) || (cidr < net->net_cidr) )
+      return(NETCALC_EINVAL);
+   prefix = (uint8_t)cidr;
+
+   // verify network is within superblock
+   if ((ns->set_superblock))
+   {  rc = netcalc_addr_cmp(&net->net_addr, net->net_cidr, &ns->set_superblock->net_addr, ns->set_superblock->net_cidr);
+      if ( (rc != NETCALC_CMP_SAME) && (rc != NETCALC_CMP_SUBNET) )
+         return(NETCALC_ERANGE);
+   };
+
+   // copy records referencing snapshot before modifying set
+   if ( ((ns->set_snap)) && ((rc = netcalc_snap_copy(ns)) != 0) )
+      return(rc);
+
+   // copy records shared with clones before modifying set
+   if ((rc = netcalc_set_unshare(ns, &net->net_addr, net->net_cidr)) != 0)
+      return(rc);
+
+   // locate records which are subnets of network
+   netcalc_set_subnets(ns, &net->net_addr, net->net_cidr, &recs, &low, &high, &owner);
+   if ( ((owner)) && ((ns->set_flags & NETCALC_FLG_UNIQ)) )
+      return(NETCALC_ESUBNET);
+
+   // block of a record is not available to subnets of the record
+   if ( ((owner)) && (owner->rec_cidr == net->net_cidr) && (prefix == net->net_cidr) )
+      return(NETCALC_ENOREC);
+
+   // check addresses before first subnet
+   rc  = NETCALC_ENOREC;
+   idx = low;
+   memcpy(&first, &net->net_addr, sizeof(netcalc_addr_t));
+   if (low == high)
+   {  netcalc_addr_last(&last, &net->net_addr, net->net_cidr);
+      rc = netcalc_set_allocate_fit(&first, &last, prefix);
+   } else if (memcmp(&first, &recs->list[low]->rec_addr, sizeof(netcalc_addr_t)) < 0)
+   {  memcpy(&last, &recs->list[low]->rec_addr, sizeof(netcalc_addr_t));
+      netcalc_addr_decr(&last);
+      rc = netcalc_set_allocate_fit(&first, &last, prefix);
+   };
+
+   // check addresses between subnets
+   if ( (rc != 0) && ((high - low) > 1) )
+   {  if (!(recs->gaps))
+         if ((rc = netcalc_recs_gaps(recs)) != 0)
+            return(rc);
+      leaf = netcalc_recs_gaps_find(recs->gaps, 1, 0, recs->gaps->gaps_leaves, low, high-1, prefix);
+      rc   = NETCALC_ENOREC;
+      if (leaf != UINT32_MAX)
+      {  idx = leaf + 1;
+         rec = recs->list[leaf];
+         netcalc_addr_last(&first, &rec->rec_addr, rec->rec_cidr);
+         netcalc_addr_incr(&first);
+         memcpy(&last, &recs->list[idx]->rec_addr, sizeof(netcalc_addr_t));
+         netcalc_addr_decr(&last);
+         rc = netcalc_set_allocate_fit(&first, &last, prefix);
+      };
+   };
+
+   // check addresses after last subnet
+   if ( (rc != 0) && (low < high) )
+   {  idx = high;
+      rec = recs->list[high-1];
+      netcalc_addr_last(&first, &rec->rec_addr, rec->rec_cidr);
+      if (!(netcalc_addr_incr(&first)))
+      {  netcalc_addr_last(&last, &net->net_addr, net->net_cidr);
+         rc = netcalc_set_allocate_fit(&first, &last, prefix);
+      };
+   };
+
+   if (rc != 0)
+      return(rc);
+
+   // add record
+   memcpy(&net->net_addr, &first, sizeof(netcalc_addr_t));
+   net->net_cidr = prefix;
+   if ((rc = netcalc_rec_alloc(ns, net, comment, data, flags, &rec)) != 0)
+      return(rc);
+   if ((rc = netcalc_jrnl_append(ns, NETCALC_MOD_ADD, rec)) != 0)
+   {  netcalc_rec_free(rec);
+      return(rc);
+   };
+   if ((rc = netcalc_recs_insert(recs, idx, rec)) != 0)
+   {  netcalc_jrnl_revert(ns);
+      netcalc_rec_free(rec);
+      return(rc);
+   };
+   rc = netcalc_set_modified(ns, NETCALC_MOD_ADD, rec);
+
+   if ( ((netp)) && ((err = netcalc_rec_get(rec, netp, NULL, NULL, NULL)) != 0) )
+      return(err);
+
+   return(rc);
+}
+
+
+// aligns start of range to prefix length and checks if block fits in range
+int
+netcalc_set_allocate_fit(
+         netcalc_addr_t *              first,
+         const netcalc_addr_t *        last,
+         uint8_t                       cidr )
+{
+   netcalc_addr_t       end;
+
+   if (memcmp(first, last, sizeof(netcalc_addr_t)) > 0)
+      return(NETCALC_ENOREC);
+   if ((netcalc_addr_ceil(first, cidr)))
+      return(NETCALC_ENOREC);
+   netcalc_addr_last(&end, first, cidr);
+   if (memcmp(&end, last, sizeof(netcalc_addr_t)) > 0)
+      return(NETCALC_ENOREC);
+
+   return(0);
+}
+
+
+// returns non-zero if records of set may be shared with clones of set
+int
+netcalc_set_cloned(
+         netcalc_set_t *               ns )
+{
+   assert(ns != NULL);
+
+   if (!(ns->set_clones))
+      return(0);
+   if (atomic_load(ns->set_clones) > 1)
+      return(1);
+
+   // remaining clones were freed
+   free(ns->set_clones);
+   ns->set_clones = NULL;
+
+   return(0);
+}
+
+
+int
+netcalc_set_clone(
+         netcalc_set_t **              nsp,
+         netcalc_set_t *               ns )
+{
+   int                  rc;
+   netcalc_set_t *      clone;
+
+   assert(nsp  != NULL);
+   assert(ns   != NULL);
+
+   // records referencing a snapshot are not reference counted
+   if ((ns->set_snap))
+      return(netcalc_set_dup(nsp, ns));
+
+   if ((rc = netcalc_set_init(&clone, ns->set_superblock, 0)) != 0)
+      return(rc);
+   clone->set_flags = ns->set_flags;
+
+   if (!(ns->set_shared))
+   {  if ((ns->set_shared = malloc(sizeof(atomic_uintmax_t))) == NULL)
+      {  netcalc_set_free(clone);
+         return(NETCALC_ENOMEM);
+      };
+      atomic_init(ns->set_shared, 1);
+   };
+   atomic_fetch_add(ns->set_shared, 1);
+
+   if (!(ns->set_clones))
+   {  if ((ns->set_clones = malloc(sizeof(atomic_uintmax_t))) == NULL)
+      {  netcalc_set_free(clone);
+         return(NETCALC_ENOMEM);
+      };
+      atomic_init(ns->set_clones, 1);
+   };
+   atomic_fetch_add(ns->set_clones, 1);
+
+   // records are copied when either set is modified
+   clone->set_recs.list    = ns->set_recs.list;
+   clone->set_recs.len     = ns->set_recs.len;
+   clone->set_recs.size    = ns->set_recs.size;
+   clone->set_shared       = ns->set_shared;
+   clone->set_clones       = ns->set_clones;
+
+   if ( ((ns->set_cache)) && ((rc = netcalc_set_cache(clone, ns->set_cache->cache_mask + 1)) != 0) )
+   {  netcalc_set_free(clone);
+      return(rc);
+   };
+   if ((rc = netcalc_hosts_copy(clone, ns)) != 0)
+   {  netcalc_set_free(clone);
+      return(rc);
+   };
+   if ((rc = netcalc_filter_copy(clone, ns)) != 0)
+   {  netcalc_set_free(clone);
+      return(rc);
+   };
+
+   *nsp = clone;
+
+   return(0);
+}
+
+
+void
+netcalc_set_debug(
+         netcalc_set_t *               ns,
+         const char *                  prefix )
+{
+   int               rc;
+   int               flags;
+   int               depth;
+   int               maxdepth;
+   uint32_t          count;
+   char *            comment;
+   netcalc_net_t *   net;
+   netcalc_cur_t *   cur;
+   netcalc_cur_t     cbuff;
+
+   assert(ns != NULL);
+
+   netcalc_cur_reset(ns, &cbuff);
+
+   cur   = &cbuff;
+   count = 0;
+
+   // determine max depth
+   if ((rc = netcalc_set_stats(ns, NULL, &maxdepth, NULL)) != 0)
+   {  fprintf(stderr, "netcalc_set_maxdepth(): %s\n", netcalc_strerror(rc));
+      return;
+   };
+
+   // print records
+   if ((rc = netcalc_cur_first(cur, &net, &comment, NULL, &flags, &depth)) != 0)
+   {  fprintf(stderr, "netcalc_cur_first(): %s\n", netcalc_strerror(rc));
+      return;
+   };
+   netcalc_set_debug_print(prefix, count++, depth, maxdepth, net, comment, flags);
+   if ((net))
+      netcalc_net_free(net);
+   if ((comment))
+      free(comment);
+   while((rc = netcalc_cur_next(cur, &net, &comment, NULL, &flags, &depth)) == 0)
+   {  netcalc_set_debug_print(prefix, count++, depth, maxdepth, net, comment, flags);
+      if ((net))
+         netcalc_net_free(net);
+      if ((comment))
+         free(comment);
+   };
+
+   if (rc != NETCALC_ENOREC)
+      fprintf(stderr, "netcalc_cur_next(): %s\n", netcalc_strerror(rc));
+
+   return;
+}
+
+
+void
+netcalc_set_debug_print(
+         const char *                  prefix,
+         int                           count,
+         int                           depth,
+         int                           maxdepth,
+         netcalc_net_t *               net,
+         const char *                  comment,
+         int                           flags )
+{
+   char        addr[NETCALC_ADDRESS_LENGTH];
+   char        str[NETCALC_ADDRESS_LENGTH*3];
+
+   if (!(net))
+      return;
+   netcalc_ntop(net, addr, sizeof(addr), NETCALC_TYPE_ADDRESS, NETCALC_FLG_CIDR);
+
+   prefix   = ((prefix))   ? prefix    : "";
+   comment  = ((comment))  ? comment   : "";
+   maxdepth = (maxdepth * 3) + 44;
+
+   snprintf(str, sizeof(str), "%*s%s", (depth*3), "", addr);
+
+   printf("%s%5i: %-*s 0x%x %s\n", prefix, count, maxdepth, str, flags, comment);
+
+   return;
+}
+
+
+int
+netcalc_set_del(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net )
+{
+   int                  rc;
+   uint32_t             idx;
+   uint32_t             pos;
+   uint32_t             count;
+   size_t               size;
+   void *               ptr;
+   netcalc_rec_t *      rec;
+   netcalc_recs_t *     recs;
+   netcalc_buff_t       nbuff;
+
+   assert(ns   != NULL);
+   assert(net  != NULL);
+
+   if ((rc = netcalc_set_find(ns, &nbuff, net, &recs, &idx)) != 0)
+      return(rc);
+   rec   = recs->list[idx];
+   count = rec->rec_children.len;
+
+   // allocate memory for subnets of record
+   if ((recs->len + count - 1) > recs->size)
+   {  size = ((size_t)recs->len + count) * sizeof(netcalc_rec_t *);
+      if ((ptr = realloc(recs->list, size)) == NULL)
+         return(NETCALC_ENOMEM);
+      recs->size  = recs->len + count - 1;
+      recs->list  = ptr;
+   };
+
+   if ((rc = netcalc_jrnl_append(ns, NETCALC_MOD_DEL, rec)) != 0)
+      return(rc);
+
+   // replace record with its subnets
+   if (count > 1)
+   {  for(pos = recs->len - 1; (pos > idx); pos--)
+         recs->list[pos+count-1] = recs->list[pos];
+   } else if (count == 0)
+   {  for(pos = idx; (pos < (recs->len - 1)); pos++)
+         recs->list[pos] = recs->list[pos+1];
+   };
+   for(pos = 0; (pos < count); pos++)
+      recs->list[idx+pos] = rec->rec_children.list[pos];
+   recs->len                  = recs->len + count - 1;
+   recs->list[recs->len]      = NULL;
+   rec->rec_children.len      = 0;
+   netcalc_recs_gaps_free(recs);
+   netcalc_keys_free(recs);
+   ns->set_handles++;
+
+   rc = netcalc_set_modified(ns, NETCALC_MOD_DEL, rec);
+
+   netcalc_rec_free(rec);
+
+   return(rc);
+}
+
+
+int
+netcalc_set_diff(
+         const netcalc_set_t *         ns1,
+         const netcalc_set_t *         ns2,
+         int (*func)(void * ctx, int op, const netcalc_net_t * net, const char * comment1, const char * comment2),
+         void *                        ctx )
+{
+   int                     rc;
+   int                     op;
+   int                     depth1;
+   int                     depth2;
+   const char *            comment1;
+   const char *            comment2;
+   const netcalc_rec_t *   rec;
+   const netcalc_rec_t *   rec1;
+   const netcalc_rec_t *   rec2;
+   const netcalc_recs_t *  list1[129];
+   const netcalc_recs_t *  list2[129];
+   uint32_t                idxs1[129];
+   uint32_t                idxs2[129];
+   netcalc_net_t           net;
+
+   assert(ns1  != NULL);
+   assert(ns2  != NULL);
+   assert(func != NULL);
+
+   depth1   = 0;
+   list1[0] = &ns1->set_recs;
+   idxs1[0] = 0;
+   rec1     = netcalc_set_diff_next(list1, idxs1, &depth1);
+
+   depth2   = 0;
+   list2[0] = &ns2->set_recs;
+   idxs2[0] = 0;
+   rec2     = netcalc_set_diff_next(list2, idxs2, &depth2);
+
+   // walk both sets in order, records of a set are ordered by address and
+   // then by increasing prefix length
+   while( ((rec1)) || ((rec2)) )
+   {  if (!(rec2))
+         rc = NETCALC_CMP_BEFORE;
+      else if (!(rec1))
+         rc = NETCALC_CMP_AFTER;
+      else
+         rc = netcalc_addr_cmp(&rec1->rec_addr, rec1->rec_cidr, &rec2->rec_addr, rec2->rec_cidr);
+
+      op       = 0;
+      rec      = NULL;
+      comment1 = NULL;
+      comment2 = NULL;
+      switch(rc)
+      {  case NETCALC_CMP_BEFORE:
+         case NETCALC_CMP_SUPERNET:
+            op       = NETCALC_MOD_DEL;
+            rec      = rec1;
+            comment1 = rec1->rec_comment;
+            rec1     = netcalc_set_diff_next(list1, idxs1, &depth1);
+            break;
+
+         case NETCALC_CMP_SAME:
+            comment1 = rec1->rec_comment;
+            comment2 = rec2->rec_comment;
+            if ( ((!(comment1)) != (!(comment2))) || ( ((comment1)) && ((strcmp(comment1, comment2))) ) )
+               op = NETCALC_MOD_UPDATE;
+            if ((rec1->rec_flags & NETCALC_USR) != (rec2->rec_flags & NETCALC_USR))
+               op = NETCALC_MOD_UPDATE;
+            rec      = rec2;
+            rec1     = netcalc_set_diff_next(list1, idxs1, &depth1);
+            rec2     = netcalc_set_diff_next(list2, idxs2, &depth2);
+            break;
+
+         default:
+            op       = NETCALC_MOD_ADD;
+            rec      = rec2;
+            comment2 = rec2->rec_comment;
+            rec2     = netcalc_set_diff_next(list2, idxs2, &depth2);
+            break;
+      };
+      if (!(op))
+         continue;
+
+      memset(&net, 0, sizeof(netcalc_net_t));
+      memcpy(&net.net_addr, &rec->rec_addr, sizeof(netcalc_addr_t));
+      net.net_cidr  = rec->rec_cidr;
+      net.net_flags = rec->rec_flags;
+      if ((rc = func(ctx, op, &net, comment1, comment2)) != 0)
+         return(rc);
+   };
+
+   return(0);
+}
+
+
+// returns next record of walk of set and advances walk
+const netcalc_rec_t *
+netcalc_set_diff_next(
+         const netcalc_recs_t **       list,
+         uint32_t *                    idxs,
+         int *                         depthp )
+{
+   int                     depth;
+   const netcalc_rec_t *   rec;
+
+   assert(list   != NULL);
+   assert(idxs   != NULL);
+   assert(depthp != NULL);
+
+   depth = *depthp;
+   while(idxs[depth] >= list[depth]->len)
+   {  if (!(depth))
+         return(NULL);
+      depth--;
+   };
+
+   rec = list[depth]->list[idxs[depth]++];
+   if ((rec->rec_children.len))
+   {  depth++;
+      list[depth] = &rec->rec_children;
+      idxs[depth] = 0;
+   };
+   *depthp = depth;
+
+   return(rec);
+}
+
+
+// copies records and superblock of set
+int
+netcalc_set_dup(
+         netcalc_set_t **              nsp,
+         const netcalc_set_t *         ns )
+{
+   int                  rc;
+   uint32_t             idx;
+   netcalc_set_t *      dup;
+
+   assert(nsp  != NULL);
+   assert(ns   != NULL);
+
+   if ((rc = netcalc_set_init(&dup, ns->set_superblock, 0)) != 0)
+      return(rc);
+   dup->set_flags = ns->set_flags;
+
+   if ((dup->set_recs.list = malloc(sizeof(netcalc_rec_t *) * ((size_t)ns->set_recs.len + 1))) == NULL)
+   {  netcalc_set_free(dup);
+      return(NETCALC_ENOMEM);
+   };
+   dup->set_recs.size      = ns->set_recs.len;
+   dup->set_recs.list[0]   = NULL;
+   for(idx = 0; (idx < ns->set_recs.len); idx++)
+   {  if ((rc = netcalc_rec_dup(ns->set_recs.list[idx], &dup->set_recs.list[idx])) != 0)
+      {  netcalc_set_free(dup);
+         return(rc);
+      };
+      dup->set_recs.len++;
+      dup->set_recs.list[dup->set_recs.len] = NULL;
+   };
+
+   if ( ((ns->set_cache)) && ((rc = netcalc_set_cache(dup, ns->set_cache->cache_mask + 1)) != 0) )
+   {  netcalc_set_free(dup);
+      return(rc);
+   };
+   if ((rc = netcalc_hosts_build(dup)) != 0)
+   {  netcalc_set_free(dup);
+      return(rc);
+   };
+   if ((rc = netcalc_filter_build(dup)) != 0)
+   {  netcalc_set_free(dup);
+      return(rc);
+   };
+
+   *nsp = dup;
+
+   return(0);
+}
+
+
+// locates record which exactly matches network
+int
+netcalc_set_find(
+         netcalc_set_t *               ns,
+         netcalc_buff_t *              nbuff,
+         const netcalc_net_t *         net,
+         netcalc_recs_t **             recsp,
+         uint32_t *                    idxp )
+{
+   int                  rc;
+
+   assert(ns     != NULL);
+   assert(nbuff  != NULL);
+   assert(net    != NULL);
+   assert(recsp  != NULL);
+   assert(idxp   != NULL);
+
+   // adjust nbuff
+   memcpy(&nbuff->buff_net.net_addr, &net->net_addr, sizeof(netcalc_addr_t));
+   nbuff->buff_net.net_cidr         = net->net_cidr;
+   nbuff->buff_net.net_port         = 0;
+   nbuff->buff_net.net_flags        = net->net_flags & NETCALC_AF;
+   nbuff->buff_net.net_scope_name   = NULL;
+
+   if ((netcalc_net_verify(&nbuff->buff_net, NETCALC_TYPE_NETWORK)))
+      return(NETCALC_EINVAL);
+   netcalc_addr_convert_inet6(&nbuff->buff_net.net_addr, (nbuff->buff_net.net_flags & NETCALC_AF));
+
+   // copy records referencing snapshot before modifying set
+   if ( ((ns->set_snap)) && ((rc = netcalc_snap_copy(ns)) != 0) )
+      return(rc);
+
+   // copy records shared with clones while locating record
+   *recsp = &ns->set_recs;
+   if ((rc = netcalc_set_bindex(ns, &nbuff->buff_net, recsp, idxp, NULL, 0)) != NETCALC_IDX_SAME)
+      return( (rc == NETCALC_IDX_ERROR) ? NETCALC_ENOMEM : NETCALC_ENOREC );
+
+   return(0);
+}
+
+
+void
+netcalc_set_free(
+         netcalc_set_t *               ns )
+{
+   int               shared;
+   uint32_t          idx;
+   netcalc_obs_t *   obs;
+
+   if (!(ns))
+      return;
+
+   if ((ns->set_superblock))
+      netcalc_net_free(ns->set_superblock);
+
+   netcalc_jrnl_close(ns);
+   netcalc_snap_free(ns);
+   netcalc_cache_free(ns->set_cache);
+   netcalc_hosts_free(ns);
+   netcalc_filter_free(ns);
+
+   while((obs = ns->set_obs) != NULL)
+   {  ns->set_obs = obs->obs_next;
+      free(obs);
+   };
+
+   // list of top level records is freed by last clone referencing list
+   shared = 0;
+   if ((ns->set_shared))
+   {  shared = (atomic_fetch_sub(ns->set_shared, 1) > 1) ? 1 : 0;
+      if (!(shared))
+         free(ns->set_shared);
+   };
+
+   for(idx = 0; ( (!(shared)) && (idx < ns->set_recs.len) ); idx++)
+      netcalc_rec_free(ns->set_recs.list[idx]);
+
+   if ( (!(shared)) && ((ns->set_recs.list)) )
+      free(ns->set_recs.list);
+
+   // remaining clones stop copying records once all records are released
+   if ( ((ns->set_clones)) && (atomic_fetch_sub(ns->set_clones, 1) == 1) )
+      free(ns->set_clones);
+
+   netcalc_recs_gaps_free(&ns->set_recs);
+   netcalc_keys_free(&ns->set_recs);
+
+   free(ns);
+
+   return;
+}
+
+
+int
+netcalc_set_free_blocks(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net,
+         netcalc_cur_t **              curp )
+{
+   int                  rc;
+   netcalc_cur_t *      cur;
+   netcalc_buff_t       nbuff;
+
+   assert(ns   != NULL);
+   assert(curp != NULL);
+
+   if (!(net))
+      net = ns->set_superblock;
+   if (!(net))
+      return(NETCALC_EINVAL);
+
+   // adjust nbuff
+   memcpy(&nbuff.buff_net.net_addr, &net->net_addr, sizeof(netcalc_addr_t));
+   nbuff.buff_net.net_cidr       = net->net_cidr;
+   nbuff.buff_net.net_port       = net->net_port;
+   nbuff.buff_net.net_flags      = net->net_flags;
+   nbuff.buff_net.net_scope_name = NULL;
+
+   if ((rc = netcalc_net_verify(&nbuff.buff_net, NETCALC_TYPE_NETWORK)) != 0)
+      return(NETCALC_EINVAL);
+   netcalc_addr_convert_inet6(&nbuff.buff_net.net_addr, (nbuff.buff_net.net_flags & NETCALC_AF));
+
+   if ((cur = malloc(sizeof(netcalc_cur_t))) == NULL)
+      return(NETCALC_ENOMEM);
+   netcalc_cur_reset(ns, cur);
+
+   memcpy(&cur->cur_addr, &nbuff.buff_net.net_addr, sizeof(netcalc_addr_t));
+   cur->cur_type     = NETCALC_CUR_BLOCKS;
+   cur->cur_cidr     = nbuff.buff_net.net_cidr;
+   cur->cur_flags    = nbuff.buff_net.net_flags & NETCALC_AF;
+   netcalc_cur_blocks_first(cur);
+
+   *curp = cur;
+
+   return(0);
+}
+
+
+// returns non-zero if first record has fewer hits than second record, records
+// with the same number of hits rank in the order of the records within set
+int
+netcalc_set_hits_less(
+         const netcalc_rec_t *         rec1,
+         const netcalc_rec_t *         rec2 )
+{
+   uintmax_t            hits1;
+   uintmax_t            hits2;
+
+   hits1 = atomic_load_explicit(&rec1->rec_hits, memory_order_relaxed);
+   hits2 = atomic_load_explicit(&rec2->rec_hits, memory_order_relaxed);
+   if (hits1 != hits2)
+      return( (hits1 < hits2) ? 1 : 0 );
+
+   return( (netcalc_addr_cmp(&rec1->rec_addr, rec1->rec_cidr, &rec2->rec_addr, rec2->rec_cidr) > 0) ? 1 : 0 );
+}
+
+
+void
+netcalc_set_hits_reset(
+         netcalc_set_t *               ns )
+{
+   netcalc_rec_t *      rec;
+   netcalc_cur_t        cur;
+   netcalc_recs_t *     list[129];
+
+   assert(ns != NULL);
+
+   netcalc_cur_reset(ns, &cur);
+   while((rec = netcalc_cur_rec(&cur, list)) != NULL)
+   {  atomic_store_explicit(&rec->rec_hits, 0, memory_order_relaxed);
+      netcalc_cur_advance(&cur, list);
+   };
+
+   return;
+}
+
+
+// moves record down min-heap of records ranked by hits
+void
+netcalc_set_hits_sift(
+         const netcalc_rec_t **        recs,
+         size_t                        len,
+         size_t                        pos )
+{
+   size_t                  child;
+   const netcalc_rec_t *   rec;
+
+   while((child = (pos * 2) + 1) < len)
+   {  if ( ((child + 1) < len) && ((netcalc_set_hits_less(recs[child+1], recs[child]))) )
+         child++;
+      if (!(netcalc_set_hits_less(recs[child], recs[pos])))
+         return;
+      rec         = recs[pos];
+      recs[pos]   = recs[child];
+      recs[child] = rec;
+      pos         = child;
+   };
+
+   return;
+}
+
+
+// stores records with the most hits in descending order of hits
+int
+netcalc_set_hits_top(
          netcalc_set_t *               ns,
-         const netcalc_net_t *         key,
-         netcalc_recs_t **             basep,
-         uint32_t *                    wouldbep,
-         netcalc_rec_t **              parentp )
+         const netcalc_rec_t **        recs,
+         size_t                        nel,
+         size_t *                      countp )
 {
-   int                  rc;
-   int32_t              low;
-   int32_t              mid;
-   int32_t              high;
-   netcalc_rec_t *      rec;
-   netcalc_recs_t *     base;
+   size_t                  len;
+   size_t                  idx;
+   const netcalc_rec_t *   rec;
+   netcalc_cur_t           cur;
+   netcalc_recs_t *        list[129];
 
-   assert(ns         != NULL);
-   assert(key        != NULL);
-   assert(basep      != NULL);
-   assert(*basep     != NULL);
-   assert(wouldbep   != NULL);
+   assert(ns     != NULL);
+   assert(countp != NULL);
 
-   if ((parentp))
-      *parentp = NULL;
+   *countp = 0;
 
-   base = *basep;
-   if (base->len == 0)
-   {  if ((wouldbep))
-         *wouldbep = 0;
-      return(NETCALC_IDX_INSERT);
+   if (!(nel))
+      return(0);
+   if (!(recs))
+      return(NETCALC_EINVAL);
+
+   // retain a min-heap of the records with the most hits
+   len = 0;
+   netcalc_cur_reset(ns, &cur);
+   while((rec = netcalc_cur_rec(&cur, list)) != NULL)
+   {  netcalc_cur_advance(&cur, list);
+      if (!(atomic_load_explicit(&rec->rec_hits, memory_order_relaxed)))
+         continue;
+      if (len < nel)
+      {  recs[len++] = rec;
+         if (len == nel)
+            for(idx = nel / 2; (idx > 0); idx--)
+               netcalc_set_hits_sift(recs, len, idx - 1);
+         continue;
+      };
+      if ((netcalc_set_hits_less(rec, recs[0])))
+         continue;
+      recs[0] = rec;
+      netcalc_set_hits_sift(recs, len, 0);
+   };
+   if (len < nel)
+      for(idx = len / 2; (idx > 0); idx--)
+         netcalc_set_hits_sift(recs, len, idx - 1);
+
+   // sort heap in descending order
+   for(idx = len; (idx > 1); idx--)
+   {  rec         = recs[0];
+      recs[0]     = recs[idx-1];
+      recs[idx-1] = rec;
+      netcalc_set_hits_sift(recs, idx - 1, 0);
    };
 
-   low  = 0;
-   high = (int32_t)(base->len - 1);
+   *countp = len;
 
-   rc = NETCALC_IDX_SAME;
-   while ( rc != NETCALC_IDX_ERROR )
-   {  mid   = (low+high) / 2;
-      rec   = base->list[mid];
-      rc    = netcalc_addr_cmp(&key->net_addr, key->net_cidr, &rec->rec_addr, rec->rec_cidr);
-      switch(rc)
-      {  case NETCALC_CMP_BEFORE:
-            if (low == mid)
-            {  *wouldbep = (uint32_t)mid;
-               return(NETCALC_CMP_BEFORE);
-            };
-            high = mid;
-            break;
+   return(0);
+}
 
-         case NETCALC_CMP_SUPERNET:
-            if (low == mid)
-            {  *wouldbep = (uint32_t)mid;
-               return(NETCALC_CMP_SUPERNET);
-            };
-            high = mid;
-            break;
 
-         case NETCALC_CMP_SAME:
-            *wouldbep = (uint32_t)mid;
-            return(NETCALC_IDX_SAME);
+int
+netcalc_set_init(
+         netcalc_set_t **              nsp,
+         netcalc_net_t *               superblock,
+         int                           flags )
+{
+   int                  rc;
+   netcalc_set_t *      ns;
 
-         case NETCALC_CMP_SUBNET:
-            if ((parentp))
-               *parentp = rec;
-            if (!(rec->rec_children.len))
-            {  *wouldbep = (uint32_t)mid;
-               return(NETCALC_IDX_SUBNET);
-            };
-            *basep   = &rec->rec_children;
-            base     = *basep;
-            low      = 0;
-            high     = (int32_t)(base->len - 1);
-            break;
+   assert(nsp != NULL);
+   assert((flags & ~NETCALC_FLGS_SET) == 0);
 
-         case NETCALC_CMP_AFTER:
-            if (high == mid)
-            {  *wouldbep = (uint32_t)mid;
-               return(NETCALC_CMP_AFTER);
-            };
-            low = (mid < high) ? mid + 1 : mid;
-            break;
+   if ((ns = malloc(sizeof(netcalc_set_t))) == NULL)
+      return(NETCALC_ENOMEM);
+   memset(ns, 0, sizeof(netcalc_set_t));
 
-         default:
-            break;
+   if ((superblock))
+   {  if ((rc = netcalc_net_dup(&ns->set_superblock, superblock)) != 0)
+      {  netcalc_set_free(ns);
+         return(rc);
       };
+      netcalc_addr_convert_inet6(&ns->set_superblock->net_addr, (ns->set_superblock->net_flags & NETCALC_AF));
    };
 
-   return(NETCALC_IDX_ERROR);
+   ns->set_flags      = flags;
+   ns->set_flags     |= ((flags & NETCALC_AF)) ? 0 : NETCALC_AF;
+
+   *nsp = ns;
+
+   return(0);
 }
 
 
+// inserts record at position within list of records located by
+// netcalc_set_bindex()
 int
-netcalc_set_add(
+netcalc_set_insert(
          netcalc_set_t *               ns,
-         netcalc_net_t *               net,
-         const char *                  comment,
-         void *                        data,
-         int                           flags )
+         netcalc_recs_t *              base,
+         uint32_t                      wouldbe,
+         int                           idx,
+         netcalc_rec_t *               rec )
 {
    int                  rc;
-   uint32_t             idx;
    uint32_t             count;
    uint32_t             off;
    size_t               size;
-   void *               ptr;
-   netcalc_recs_t *     base;
-   uint32_t             wouldbe;
-   netcalc_rec_t *      rec;
    netcalc_rec_t *      child;
-   netcalc_buff_t       nbuff;
 
    assert(ns   != NULL);
-   assert(net  != NULL);
-
-   if (!( (net->net_flags & NETCALC_AF) | (ns->set_flags & NETCALC_AF) ))
-      return(NETCALC_EBADFAM);
-
-   if ((netcalc_net_verify(net, NETCALC_TYPE_NETWORK)))
-      return(NETCALC_EINVAL);
-
-   if ((ns->set_superblock))
-   {  rc = netcalc_net_cmp(net, ns->set_superblock, ns->set_flags);
-      if ( (rc != NETCALC_CMP_SAME) && (rc != NETCALC_CMP_SUBNET) )
-         return(NETCALC_ERANGE);
-   };
-
-   // adjust nbuff
-   memcpy(&nbuff.buff_net.net_addr, &net->net_addr, sizeof(netcalc_addr_t));
-   nbuff.buff_net.net_cidr       = net->net_cidr;
-   nbuff.buff_net.net_port       = net->net_port;
-   nbuff.buff_net.net_flags      = net->net_flags;
-   nbuff.buff_net.net_scope_name = NULL;
-   net                           = &nbuff.buff_net;
-   netcalc_addr_convert_inet6(&nbuff.buff_net.net_addr, (nbuff.buff_net.net_flags & NETCALC_AF));
-
-   // add information to record
-   if ((rec = malloc(sizeof(netcalc_rec_t))) == NULL)
-      return(NETCALC_ENOMEM);
-   memset(rec, 0, sizeof(netcalc_rec_t));
-   memcpy(&rec->rec_addr.addr8, &net->net_addr.addr8, sizeof(netcalc_addr_t));
-   rec->rec_cidr   = net->net_cidr;
-   rec->rec_data   = data;
-   rec->rec_flags  = ns->set_flags & ~(NETCALC_AF | NETCALC_USR);
-   rec->rec_flags |= net->net_flags & NETCALC_AF;
-   rec->rec_flags |= flags & NETCALC_USR;
-   if ((comment))
-   {  if ((rec->rec_comment = strdup(comment)) == NULL)
-      {  netcalc_rec_free(rec);
-         return(NETCALC_ENOMEM);
-      };
-   };
+   assert(base != NULL);
+   assert(rec  != NULL);
 
-   base = &ns->set_recs;
-   rc = netcalc_set_bindex(ns, net, &base, &wouldbe, NULL);
-   switch(rc)
+   switch(idx)
    {  case NETCALC_IDX_AFTER:
          wouldbe++;
       case NETCALC_IDX_BEFORE:
       case NETCALC_IDX_INSERT:
-         // allocate memory for net record pointer
-         size = (base->size + 2) * sizeof(netcalc_rec_t *);
-         if ((ptr = realloc(base->list, size)) == NULL)
+         if ((rc = netcalc_jrnl_append(ns, NETCALC_MOD_ADD, rec)) != 0)
          {  netcalc_rec_free(rec);
-            return(NETCALC_ENOMEM);
+            return(rc);
          };
-         base->size++;
-         base->list              = ptr;
-         base->list[base->size]  = NULL;
-         // shift records down list
-         for(idx = base->len; (idx > wouldbe); idx--)
-            base->list[idx] = base->list[idx-1];
-         // record new record
-         base->list[wouldbe]  = rec;
-         base->len++;
-         ns->set_serial++;
-         return(NETCALC_SUCCESS);
-
-      case NETCALC_IDX_SAME:
-         netcalc_rec_free(rec);
-         return(NETCALC_EEXISTS);
+         if ((rc = netcalc_recs_insert(base, wouldbe, rec)) != 0)
+         {  netcalc_jrnl_revert(ns);
+            netcalc_rec_free(rec);
+            return(rc);
+         };
+         return(netcalc_set_modified(ns, NETCALC_MOD_ADD, rec));
 
       case NETCALC_IDX_SUBNET:
          // check if set allows supernets/subnets
@@ -533,18 +2722,17 @@ netcalc_set_add(
          {  netcalc_rec_free(rec);
             return(NETCALC_ESUBNET);
          };
-         // allocate memory for list of children of record
-         size = sizeof(netcalc_rec_t *) * 2;
-         if ((base->list[wouldbe]->rec_children.list = malloc(size)) == NULL)
+         // save record as subnet
+         if ((rc = netcalc_jrnl_append(ns, NETCALC_MOD_ADD, rec)) != 0)
          {  netcalc_rec_free(rec);
-            return(NETCALC_ENOMEM);
+            return(rc);
          };
-         // save record as subnet
-         base->list[wouldbe]->rec_children.size     = 1;
-         base->list[wouldbe]->rec_children.len      = 1;
-         base->list[wouldbe]->rec_children.list[0]  = rec;
-         base->list[wouldbe]->rec_children.list[1]  = NULL;
-         return(NETCALC_SUCCESS);
+         if ((rc = netcalc_recs_insert(&base->list[wouldbe]->rec_children, 0, rec)) != 0)
+         {  netcalc_jrnl_revert(ns);
+            netcalc_rec_free(rec);
+            return(rc);
+         };
+         return(netcalc_set_modified(ns, NETCALC_MOD_ADD, rec));
 
       case NETCALC_IDX_SUPERNET:
          // check if set allows supernets/subnets
@@ -566,6 +2754,10 @@ netcalc_set_add(
          {  netcalc_rec_free(rec);
             return(NETCALC_ENOMEM);
          };
+         if ((rc = netcalc_jrnl_append(ns, NETCALC_MOD_ADD, rec)) != 0)
+         {  netcalc_rec_free(rec);
+            return(rc);
+         };
          memset(rec->rec_children.list, 0, size);
          for(off = 0; (off < count); off++)
             rec->rec_children.list[off]   = base->list[wouldbe+off];
@@ -579,8 +2771,9 @@ netcalc_set_add(
                base->list[wouldbe+off] = base->list[wouldbe+off+count];
             base->len -= count;
          };
-         ns->set_serial++;
-         return(NETCALC_SUCCESS);
+         netcalc_recs_gaps_free(base);
+         netcalc_keys_free(base);
+         return(netcalc_set_modified(ns, NETCALC_MOD_ADD, rec));
 
       default:
          break;
@@ -592,160 +2785,173 @@ netcalc_set_add(
 }
 
 
+// records modification applied to set, modifications are journaled before
+// they are applied
 int
-netcalc_set_add_str(
+netcalc_set_modified(
          netcalc_set_t *               ns,
-         const char *                  address,
-         const char *                  comment,
-         void *                        data,
-         int                           flags )
+         int                           op,
+         const netcalc_rec_t *         rec )
 {
    int                  rc;
-   netcalc_buff_t       b;
-
-   assert(ns      != NULL);
-   assert(address != NULL);
-
-   if ((rc = netcalc_net_parse(&b, address, ns->set_flags)) != 0)
-      return(rc);
-
-   return(netcalc_set_add(ns, &b.buff_net, comment, data, flags));
-}
+   int                  err;
+   netcalc_obs_t *      obs;
+   netcalc_net_t        net;
 
+   assert(ns  != NULL);
+   assert(rec != NULL);
 
-void
-netcalc_set_debug(
-         netcalc_set_t *               ns,
-         const char *                  prefix )
-{
-   int               rc;
-   int               flags;
-   int               depth;
-   int               maxdepth;
-   uint32_t          count;
-   char *            comment;
-   netcalc_net_t *   net;
-   netcalc_cur_t *   cur;
-   netcalc_cur_t     cbuff;
-
-   assert(ns != NULL);
-
-   netcalc_cur_reset(ns, &cbuff);
-
-   cur   = &cbuff;
-   count = 0;
+   ns->set_serial++;
 
-   // determine max depth
-   if ((rc = netcalc_set_stats(ns, NULL, &maxdepth, NULL)) != 0)
-   {  fprintf(stderr, "netcalc_set_maxdepth(): %s\n", netcalc_strerror(rc));
-      return;
+   // queries of hosts missing from index fall back to searching records
+   if (rec->rec_cidr == 128)
+   {  if (op == NETCALC_MOD_ADD)
+         netcalc_hosts_insert(ns, (netcalc_rec_t *)rec);
+      else if (op == NETCALC_MOD_DEL)
+         netcalc_hosts_remove(ns, rec);
    };
 
-   // print records
-   if ((rc = netcalc_cur_first(cur, &net, &comment, NULL, &flags, &depth)) != 0)
-   {  fprintf(stderr, "netcalc_cur_first(): %s\n", netcalc_strerror(rc));
-      return;
-   };
-   netcalc_set_debug_print(prefix, count++, depth, maxdepth, net, comment, flags);
-   if ((net))
-      netcalc_net_free(net);
-   if ((comment))
-      free(comment);
-   while((rc = netcalc_cur_next(cur, &net, &comment, NULL, &flags, &depth)) == 0)
-   {  netcalc_set_debug_print(prefix, count++, depth, maxdepth, net, comment, flags);
-      if ((net))
-         netcalc_net_free(net);
-      if ((comment))
-         free(comment);
+   // queries are not filtered if the filter cannot be rebuilt
+   if (op == NETCALC_MOD_ADD)
+      netcalc_filter_insert(ns, rec);
+   else if (op == NETCALC_MOD_DEL)
+      netcalc_filter_remove(ns, rec);
+
+   if (!(ns->set_obs))
+      return(0);
+
+   // notify observers, modification is applied even if an observer fails
+   rc = 0;
+   memset(&net, 0, sizeof(netcalc_net_t));
+   memcpy(&net.net_addr, &rec->rec_addr, sizeof(netcalc_addr_t));
+   net.net_cidr  = rec->rec_cidr;
+   net.net_flags = rec->rec_flags;
+   for(obs = ns->set_obs; ((obs)); obs = obs->obs_next)
+   {  err = obs->obs_func(obs->obs_ctx, op, &net, rec->rec_comment, rec->rec_data, (int)rec->rec_flags, ns->set_serial);
+      if ((err))
+         rc = NETCALC_EOBSERVER;
    };
 
-   if (rc != NETCALC_ENOREC)
-      fprintf(stderr, "netcalc_cur_next(): %s\n", netcalc_strerror(rc));
-
-   return;
+   return(rc);
 }
 
 
-void
-netcalc_set_debug_print(
-         const char *                  prefix,
-         int                           count,
-         int                           depth,
-         int                           maxdepth,
-         netcalc_net_t *               net,
-         const char *                  comment,
-         int                           flags )
+int
+netcalc_set_neighbors(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net,
+         const netcalc_rec_t **        prevp,
+         const netcalc_rec_t **        nextp )
 {
-   char        addr[NETCALC_ADDRESS_LENGTH];
-   char        str[NETCALC_ADDRESS_LENGTH*3];
+   netcalc_rec_t *      rec;
+   netcalc_cur_t        cur;
+   netcalc_cur_t        pos;
+   netcalc_recs_t *     list[129];
 
-   if (!(net))
-      return;
-   netcalc_ntop(net, addr, sizeof(addr), NETCALC_TYPE_ADDRESS, NETCALC_FLG_CIDR);
+   assert(ns   != NULL);
+   assert(net  != NULL);
 
-   prefix   = ((prefix))   ? prefix    : "";
-   comment  = ((comment))  ? comment   : "";
-   maxdepth = (maxdepth * 3) + 44;
+   if ((prevp))
+      *prevp = NULL;
+   if ((nextp))
+      *nextp = NULL;
 
-   snprintf(str, sizeof(str), "%*s%s", (depth*3), "", addr);
+   netcalc_cur_reset(ns, &cur);
+   memcpy(&cur.cur_addr, &net->net_addr, sizeof(netcalc_addr_t));
+   netcalc_addr_convert_inet6(&cur.cur_addr, (int)(net->net_flags & NETCALC_AF));
+   cur.cur_cidr = net->net_cidr;
 
-   printf("%s%5i: %-*s 0x%x %s\n", prefix, count, maxdepth, str, flags, comment);
+   // position at first record which is not before the network
+   netcalc_cur_locate(&cur, &cur.cur_addr, cur.cur_cidr);
 
-   return;
-}
+   if ((prevp))
+   {  memcpy(&pos, &cur, sizeof(netcalc_cur_t));
+      *prevp = netcalc_cur_retreat(&pos);
+   };
 
+   if ((nextp))
+   {  // skip record which matches the network
+      if ((rec = netcalc_cur_rec(&cur, list)) != NULL)
+      {  if (netcalc_addr_cmp(&cur.cur_addr, cur.cur_cidr, &rec->rec_addr, rec->rec_cidr) == NETCALC_CMP_SAME)
+         {  netcalc_cur_advance(&cur, list);
+            rec = netcalc_cur_rec(&cur, list);
+         };
+      };
+      *nextp = rec;
+   };
 
-void
-netcalc_set_free(
-         netcalc_set_t *               ns )
-{
-   uint32_t       idx;
+   return(0);
+}
 
-   if (!(ns))
-      return;
 
-   if ((ns->set_superblock))
-      netcalc_net_free(ns->set_superblock);
+int
+netcalc_set_observe(
+         netcalc_set_t *               ns,
+         int (*func)(void * ctx, int op, const netcalc_net_t * net, const char * comment, void * data, int flags, uint32_t serial),
+         void *                        ctx )
+{
+   netcalc_obs_t *      obs;
+   netcalc_obs_t **     obsp;
 
-   for(idx = 0; (idx < ns->set_recs.len); idx++)
-      netcalc_rec_free(ns->set_recs.list[idx]);
+   assert(ns   != NULL);
+   assert(func != NULL);
 
-   if ((ns->set_recs.list))
-      free(ns->set_recs.list);
+   // observers are notified in order of registration
+   for(obsp = &ns->set_obs; ((*obsp)); obsp = &(*obsp)->obs_next)
+      if ( ((*obsp)->obs_func == func) && ((*obsp)->obs_ctx == ctx) )
+         return(NETCALC_EEXISTS);
 
-   free(ns);
+   if ((obs = malloc(sizeof(netcalc_obs_t))) == NULL)
+      return(NETCALC_ENOMEM);
+   memset(obs, 0, sizeof(netcalc_obs_t));
+   obs->obs_func  = func;
+   obs->obs_ctx   = ctx;
+   *obsp          = obs;
 
-   return;
+   return(0);
 }
 
 
+// normalizes network and copies records shared with snapshots or clones
+// before modifying set
 int
-netcalc_set_init(
-         netcalc_set_t **              nsp,
-         netcalc_net_t *               superblock,
-         int                           flags )
+netcalc_set_prepare(
+         netcalc_set_t *               ns,
+         netcalc_buff_t *              nbuff,
+         const netcalc_net_t *         net )
 {
    int                  rc;
-   netcalc_set_t *      ns;
 
-   assert(nsp != NULL);
-   assert((flags & ~NETCALC_FLGS_SET) == 0);
+   assert(ns    != NULL);
+   assert(nbuff != NULL);
+   assert(net   != NULL);
 
-   if ((ns = malloc(sizeof(netcalc_set_t))) == NULL)
-      return(NETCALC_ENOMEM);
-   memset(ns, 0, sizeof(netcalc_set_t));
+   if (!( (net->net_flags & NETCALC_AF) | (ns->set_flags & NETCALC_AF) ))
+      return(NETCALC_EBADFAM);
 
-   if ((superblock))
-   {  if ((rc = netcalc_net_dup(&ns->set_superblock, superblock)) != 0)
-      {  netcalc_set_free(ns);
-         return(rc);
-      };
-   };
+   // adjust nbuff
+   memcpy(&nbuff->buff_net.net_addr, &net->net_addr, sizeof(netcalc_addr_t));
+   nbuff->buff_net.net_cidr         = net->net_cidr;
+   nbuff->buff_net.net_port         = net->net_port;
+   nbuff->buff_net.net_flags        = net->net_flags;
+   nbuff->buff_net.net_scope_name   = NULL;
 
-   ns->set_flags      = flags;
-   ns->set_flags     |= ((flags & NETCALC_AF)) ? 0 : NETCALC_AF;
+   if ((netcalc_net_verify(&nbuff->buff_net, NETCALC_TYPE_NETWORK)))
+      return(NETCALC_EINVAL);
+   netcalc_addr_convert_inet6(&nbuff->buff_net.net_addr, (nbuff->buff_net.net_flags & NETCALC_AF));
+   net = &nbuff->buff_net;
 
-   *nsp = ns;
+   // verify network is within superblock
+   if ((ns->set_superblock))
+   {  rc = netcalc_addr_cmp(&net->net_addr, net->net_cidr, &ns->set_superblock->net_addr, ns->set_superblock->net_cidr);
+      if ( (rc != NETCALC_CMP_SAME) && (rc != NETCALC_CMP_SUBNET) )
+         return(NETCALC_ERANGE);
+   };
+
+   // copy records referencing snapshot before modifying set, records
+   // shared with clones are copied while locating the network
+   if ( ((ns->set_snap)) && ((rc = netcalc_snap_copy(ns)) != 0) )
+      return(rc);
 
    return(0);
 }
@@ -764,8 +2970,6 @@ netcalc_set_query(
    netcalc_buff_t       nbuff;
    netcalc_recs_t *     base;
    netcalc_rec_t *      rec;
-   netcalc_net_t *      res;
-   char *               comment;
    uint32_t             wouldbe;
 
    assert(ns  != NULL);
@@ -780,41 +2984,97 @@ netcalc_set_query(
    net                           = &nbuff.buff_net;
    netcalc_addr_convert_inet6(&nbuff.buff_net.net_addr, (nbuff.buff_net.net_flags & NETCALC_AF));
 
-   base = &ns->set_recs;
-   rc = netcalc_set_bindex(ns, net, &base, &wouldbe, &rec);
-   switch(rc)
-   {  case NETCALC_IDX_AFTER:
-         if (!(rec))
-            return(NETCALC_ENOREC);
-         break;
-
-      case NETCALC_IDX_BEFORE:
-         if (!(rec))
-            return(NETCALC_ENOREC);
-         break;
+   // consult results of previous queries
+   if ( ((ns->set_cache)) && ((netcalc_cache_get(ns, &net->net_addr, net->net_cidr, &rec))) )
+      return(netcalc_set_query_result(ns, rec, resp, commentp, datap, flagsp));
 
-      case NETCALC_IDX_SAME:
-         rec = base->list[wouldbe];
-         break;
+   // networks outside of the prefixes of records are rejected without searching records
+   if ( ((ns->set_filter)) && (!(netcalc_filter_test(ns, &net->net_addr, net->net_cidr))) )
+      return(NETCALC_ENOREC);
 
-      case NETCALC_IDX_SUBNET:
-         rec = base->list[wouldbe];
-         break;
+   // records of hosts are found without searching records
+   rec = NULL;
+   if ( ((ns->set_hosts)) && (net->net_cidr == 128) )
+      rec = netcalc_hosts_find(ns, &net->net_addr);
 
-      case NETCALC_IDX_SUPERNET:
-         if (!(rec))
-            return(NETCALC_ENOREC);
-         break;
+   if (!(rec))
+   {  base = &ns->set_recs;
+      rc = netcalc_set_bindex(ns, net, &base, &wouldbe, &rec, 1);
+      switch(rc)
+      {  case NETCALC_IDX_AFTER:
+         case NETCALC_IDX_BEFORE:
+         case NETCALC_IDX_SUPERNET:
+         case NETCALC_IDX_INSERT:
+            break;
 
-      case NETCALC_IDX_INSERT:
-         if (!(rec))
-            return(NETCALC_ENOREC);
-         break;
+         case NETCALC_IDX_SAME:
+         case NETCALC_IDX_SUBNET:
+            rec = base->list[wouldbe];
+            break;
 
-      default:
-         return(NETCALC_EUNKNOWN);
+         default:
+            return(NETCALC_EUNKNOWN);
+      };
    };
 
+   if ( ((ns->set_filter)) && (!(rec)) )
+      netcalc_stripes_add(ns->set_filter->filter_ctrs, NETCALC_CTR_FILTER_FALSE);
+
+   if ((ns->set_cache))
+      netcalc_cache_put(ns, &net->net_addr, net->net_cidr, rec);
+
+   return(netcalc_set_query_result(ns, rec, resp, commentp, datap, flagsp));
+}
+
+
+int
+netcalc_set_query_chain(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net,
+         netcalc_cur_t **              curp )
+{
+   assert(ns   != NULL);
+   assert(net  != NULL);
+   assert(curp != NULL);
+   return(netcalc_cur_query(ns, net, NETCALC_CUR_CHAIN, curp));
+}
+
+
+int
+netcalc_set_query_covered(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net,
+         netcalc_cur_t **              curp )
+{
+   assert(ns   != NULL);
+   assert(net  != NULL);
+   assert(curp != NULL);
+   return(netcalc_cur_query(ns, net, NETCALC_CUR_COVERED, curp));
+}
+
+
+// returns information of record matching query
+int
+netcalc_set_query_result(
+         netcalc_set_t *               ns,
+         netcalc_rec_t *               rec,
+         netcalc_net_t **              resp,
+         char **                       commentp,
+         void **                       datap,
+         int *                         flagsp )
+{
+   netcalc_net_t *      res;
+   char *               comment;
+
+   assert(ns != NULL);
+
+   if (!(rec))
+      return(NETCALC_ENOREC);
+
+   // counters are statistics and do not order other memory accesses
+   if ((ns->set_flags & NETCALC_FLG_COUNT))
+      atomic_fetch_add_explicit(&rec->rec_hits, 1, memory_order_relaxed);
+
    comment = NULL;
    res     = NULL;
 
@@ -926,4 +3186,304 @@ netcalc_set_stats(
 }
 
 
+// locates list of records, and range of indexes within the list, which are
+// subnets of the network
+void
+netcalc_set_subnets(
+         netcalc_set_t *               ns,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr,
+         netcalc_recs_t **             recsp,
+         uint32_t *                    lowp,
+         uint32_t *                    highp,
+         netcalc_rec_t **              parentp )
+{
+   int                  rc;
+   uint32_t             idx;
+   netcalc_rec_t *      rec;
+   netcalc_recs_t *     base;
+
+   assert(ns      != NULL);
+   assert(addr    != NULL);
+   assert(recsp   != NULL);
+   assert(lowp    != NULL);
+   assert(highp   != NULL);
+
+   if ((parentp))
+      *parentp = NULL;
+
+   base = &ns->set_recs;
+   while(1)
+   {  idx     = netcalc_recs_lbound(base, addr, cidr);
+      *recsp  = base;
+      *lowp   = idx;
+      *highp  = idx;
+      if (idx >= base->len)
+         return;
+      rec = base->list[idx];
+      rc  = netcalc_addr_cmp(addr, cidr, &rec->rec_addr, rec->rec_cidr);
+      switch(rc)
+      {  case NETCALC_CMP_SUBNET:
+            // network is within record, search record's subnets
+            if ((parentp))
+               *parentp = rec;
+            base = &rec->rec_children;
+            if (!(base->len))
+            {  *recsp = base;
+               *lowp  = 0;
+               *highp = 0;
+               return;
+            };
+            break;
+
+         case NETCALC_CMP_SAME:
+            // network is a record, use record's subnets
+            if ((parentp))
+               *parentp = rec;
+            *recsp  = &rec->rec_children;
+            *lowp   = 0;
+            *highp  = rec->rec_children.len;
+            return;
+
+         case NETCALC_CMP_SUPERNET:
+            *highp = netcalc_recs_ubound(base, idx, addr, cidr);
+            return;
+
+         default:
+            return;
+      };
+   };
+
+   return;
+}
+
+
+int
+netcalc_set_unobserve(
+         netcalc_set_t *               ns,
+         int (*func)(void * ctx, int op, const netcalc_net_t * net, const char * comment, void * data, int flags, uint32_t serial),
+         void *                        ctx )
+{
+   netcalc_obs_t *      obs;
+   netcalc_obs_t **     obsp;
+
+   assert(ns   != NULL);
+   assert(func != NULL);
+
+   for(obsp = &ns->set_obs; ((*obsp)); obsp = &(*obsp)->obs_next)
+   {  if ( ((*obsp)->obs_func != func) || ((*obsp)->obs_ctx != ctx) )
+         continue;
+      obs   = *obsp;
+      *obsp = obs->obs_next;
+      free(obs);
+      return(0);
+   };
+
+   return(NETCALC_ENOREC);
+}
+
+
+// copies list of top level records, and records which contain network, which
+// are shared with clones of set
+int
+netcalc_set_unshare(
+         netcalc_set_t *               ns,
+         const netcalc_addr_t *        addr,
+         uint8_t                       cidr )
+{
+   int                  rc;
+   int                  cmp;
+   uint32_t             low;
+   uint32_t             high;
+   uint32_t             mid;
+   netcalc_recs_t *     recs;
+
+   assert(ns   != NULL);
+   assert(addr != NULL);
+
+   if (!(netcalc_set_cloned(ns)))
+      return(0);
+
+   if ((rc = netcalc_set_unshare_list(ns)) != 0)
+      return(rc);
+
+   // copy records which contain network
+   recs = &ns->set_recs;
+   while((recs->len))
+   {  low  = 0;
+      high = recs->len;
+      mid  = 0;
+      cmp  = NETCALC_CMP_BEFORE;
+      while(low < high)
+      {  mid = low + ((high - low) / 2);
+         cmp = netcalc_addr_cmp(addr, cidr, &recs->list[mid]->rec_addr, recs->list[mid]->rec_cidr);
+         if (cmp == NETCALC_CMP_BEFORE)
+            high = mid;
+         else if (cmp == NETCALC_CMP_AFTER)
+            low = mid + 1;
+         else
+            break;
+      };
+      if ( (cmp != NETCALC_CMP_SAME) && (cmp != NETCALC_CMP_SUBNET) )
+         return(0);
+      if ((rc = netcalc_set_unshare_rec(ns, recs, mid)) != 0)
+         return(rc);
+      if (cmp == NETCALC_CMP_SAME)
+         return(0);
+      recs = &recs->list[mid]->rec_children;
+   };
+
+   return(0);
+}
+
+
+// copies list of top level records shared with clones of set
+int
+netcalc_set_unshare_list(
+         netcalc_set_t *               ns )
+{
+   uint32_t             idx;
+   netcalc_rec_t **     list;
+
+   assert(ns != NULL);
+
+   if (!(ns->set_shared))
+      return(0);
+
+   list = NULL;
+   if (atomic_load(ns->set_shared) > 1)
+   {  if ((list = malloc(sizeof(netcalc_rec_t *) * ((size_t)ns->set_recs.len + 1))) == NULL)
+         return(NETCALC_ENOMEM);
+      for(idx = 0; (idx < ns->set_recs.len); idx++)
+      {  list[idx] = ns->set_recs.list[idx];
+         atomic_fetch_add(&list[idx]->rec_refs, 1);
+      };
+      list[idx] = NULL;
+   };
+   if (atomic_fetch_sub(ns->set_shared, 1) == 1)
+   {  // remaining clones were freed, release original list
+      free(ns->set_shared);
+      if ((list))
+      {  for(idx = 0; (idx < ns->set_recs.len); idx++)
+            netcalc_rec_free(ns->set_recs.list[idx]);
+         free(ns->set_recs.list);
+      };
+   };
+   if ((list))
+   {  netcalc_recs_gaps_free(&ns->set_recs);
+      ns->set_recs.list = list;
+      ns->set_recs.size = ns->set_recs.len;
+   };
+   ns->set_shared = NULL;
+
+   return(0);
+}
+
+
+// copies record within list which is shared with clones of set
+int
+netcalc_set_unshare_rec(
+         netcalc_set_t *               ns,
+         netcalc_recs_t *              recs,
+         uint32_t                      idx )
+{
+   int                  rc;
+   netcalc_rec_t *      rec;
+
+   assert(ns   != NULL);
+   assert(recs != NULL);
+
+   rec = recs->list[idx];
+   if ((rc = netcalc_rec_unshare(&recs->list[idx])) != 0)
+      return(rc);
+   if (recs->list[idx] == rec)
+      return(0);
+   ns->set_handles++;
+
+   // cached results may reference records which are replaced
+   netcalc_cache_flush(ns);
+   if (rec->rec_cidr == 128)
+      netcalc_hosts_replace(ns, rec, recs->list[idx]);
+
+   return(0);
+}
+
+
+int
+netcalc_set_update(
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net,
+         const char *                  comment,
+         void *                        data,
+         int                           flags )
+{
+   int                  rc;
+   uint32_t             idx;
+   netcalc_recs_t *     recs;
+   netcalc_buff_t       nbuff;
+
+   assert(ns   != NULL);
+   assert(net  != NULL);
+
+   if ((rc = netcalc_set_find(ns, &nbuff, net, &recs, &idx)) != 0)
+      return(rc);
+
+   return(netcalc_rec_modify(ns, recs->list[idx], comment, data, flags));
+}
+
+
+int
+netcalc_set_upsert(
+         netcalc_set_t *               ns,
+         netcalc_net_t *               net,
+         const char *                  comment,
+         void *                        data,
+         int                           flags,
+         int (*merge)(void * ctx, const netcalc_rec_t * rec, const char ** commentp, void ** datap, int * flagsp),
+         void *                        ctx,
+         netcalc_rec_t **              recp )
+{
+   int                  rc;
+   int                  idx;
+   uint32_t             wouldbe;
+   netcalc_recs_t *     base;
+   netcalc_rec_t *      rec;
+   netcalc_buff_t       nbuff;
+
+   assert(ns   != NULL);
+   assert(net  != NULL);
+
+   if ((recp))
+      *recp = NULL;
+
+   if ((rc = netcalc_set_prepare(ns, &nbuff, net)) != 0)
+      return(rc);
+   net = &nbuff.buff_net;
+
+   // merge information into existing record
+   base = &ns->set_recs;
+   if ((idx = netcalc_set_bindex(ns, net, &base, &wouldbe, NULL, 0)) == NETCALC_IDX_ERROR)
+      return(NETCALC_ENOMEM);
+   if (idx == NETCALC_IDX_SAME)
+   {  rec = base->list[wouldbe];
+      if ( ((merge)) && ((rc = merge(ctx, rec, &comment, &data, &flags)) != 0) )
+         return(rc);
+      rc = netcalc_rec_modify(ns, rec, comment, data, flags);
+      if ( (rc == 0) && ((recp)) )
+         *recp = rec;
+      return(rc);
+   };
+
+   // insert new record
+   if ((rc = netcalc_rec_alloc(ns, net, comment, data, flags, &rec)) != 0)
+      return(rc);
+   if ((rc = netcalc_set_insert(ns, base, wouldbe, idx, rec)) != 0)
+      return(rc);
+   if ((recp))
+      *recp = rec;
+
+   return(0);
+}
+
+
 /* end of source */
@@ -0,0 +1,273 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __LIB_LIBNETCALC_LSMALLSETS_C 1
+#include "libnetcalc.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef NETCALC_SMALLSET_X86
+#   include <immintrin.h>
+#endif
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+void
+netcalc_smallset_free(
+         netcalc_smallset_t *          ss )
+{
+   if (!(ss))
+      return;
+   netcalc_aligned_free(ss);
+   return;
+}
+
+
+int
+netcalc_smallset_init(
+         netcalc_smallset_t **         ssp,
+         const netcalc_net_t * const * nets,
+         size_t                        nel )
+{
+   size_t                  pos;
+   size_t                  idx;
+   size_t                  word;
+   uint32_t                family;
+   void *                  ptr;
+   netcalc_smallset_t *    ss;
+   const netcalc_net_t *   net;
+
+   assert(ssp  != NULL);
+   assert(nets != NULL);
+
+   *ssp = NULL;
+
+   if ( (nel < 1) || (nel > NETCALC_SMALLSET_MAX) )
+      return(NETCALC_ERANGE);
+   for(pos = 0; (pos < nel); pos++)
+   {  family = nets[pos]->net_flags & NETCALC_AF;
+      if ( (family != NETCALC_AF_INET) && (family != NETCALC_AF_INET6) )
+         return(NETCALC_ENOTSUP);
+   };
+
+   if ((ptr = netcalc_aligned_alloc(64, sizeof(netcalc_smallset_t))) == NULL)
+      return(NETCALC_ENOMEM);
+   ss = ptr;
+   memset(ss, 0, sizeof(netcalc_smallset_t));
+
+   // order networks from most to least specific, networks of the same
+   // length retain the order of the list
+   for(pos = 0; (pos < nel); pos++)
+   {  for(idx = pos; ( (idx > 0) && (ss->ss_cidrs[idx-1] < nets[pos]->net_cidr) ); idx--)
+      {  ss->ss_cidrs[idx] = ss->ss_cidrs[idx-1];
+         ss->ss_index[idx] = ss->ss_index[idx-1];
+      };
+      ss->ss_cidrs[idx] = nets[pos]->net_cidr;
+      ss->ss_index[idx] = (uint8_t)pos;
+   };
+
+   for(pos = 0; (pos < nel); pos++)
+   {  net = nets[ss->ss_index[pos]];
+      for(word = 0; (word < 4); word++)
+      {  ss->ss_masks[word][pos] = _netcalc_netmasks[net->net_cidr].addr32[word];
+         ss->ss_keys[word][pos]  = net->net_addr.addr32[word] & ss->ss_masks[word][pos];
+      };
+   };
+   ss->ss_valid   = (nel < 64) ? ((UINT64_C(1) << nel) - 1) : UINT64_MAX;
+   ss->ss_len     = nel;
+
+   // select widest comparison supported by processor
+   ss->ss_match   = netcalc_smallset_match_scalar;
+#ifdef NETCALC_SMALLSET_X86
+   __builtin_cpu_init();
+   if ((__builtin_cpu_supports("sse2")))
+      ss->ss_match = netcalc_smallset_match_sse2;
+   if ((__builtin_cpu_supports("avx2")))
+      ss->ss_match = netcalc_smallset_match_avx2;
+#endif
+
+   *ssp = ss;
+
+   return(0);
+}
+
+
+#ifdef NETCALC_SMALLSET_X86
+// compares address with eight networks per instruction
+__attribute__((target("avx2")))
+uint64_t
+netcalc_smallset_match_avx2(
+         const netcalc_smallset_t *    ss,
+         const netcalc_addr_t *        addr )
+{
+   size_t            pos;
+   size_t            word;
+   uint64_t          hits;
+   __m256i           words[4];
+   __m256i           eq;
+   __m256i           cmp;
+
+   for(word = 0; (word < 4); word++)
+      words[word] = _mm256_set1_epi32((int)addr->addr32[word]);
+
+   hits = 0;
+   for(pos = 0; (pos < ss->ss_len); pos += 8)
+   {  eq = _mm256_set1_epi32(-1);
+      for(word = 0; (word < 4); word++)
+      {  cmp   = _mm256_and_si256(words[word], _mm256_load_si256((const __m256i *)&ss->ss_masks[word][pos]));
+         cmp   = _mm256_cmpeq_epi32(cmp, _mm256_load_si256((const __m256i *)&ss->ss_keys[word][pos]));
+         eq    = _mm256_and_si256(eq, cmp);
+      };
+      hits |= (uint64_t)(unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(eq)) << pos;
+   };
+
+   return(hits);
+}
+#endif
+
+
+// compares address with each network
+uint64_t
+netcalc_smallset_match_scalar(
+         const netcalc_smallset_t *    ss,
+         const netcalc_addr_t *        addr )
+{
+   size_t            pos;
+   uint64_t          hits;
+
+   hits = 0;
+   for(pos = 0; (pos < ss->ss_len); pos++)
+   {  if ((addr->addr32[0] & ss->ss_masks[0][pos]) != ss->ss_keys[0][pos])
+         continue;
+      if ((addr->addr32[1] & ss->ss_masks[1][pos]) != ss->ss_keys[1][pos])
+         continue;
+      if ((addr->addr32[2] & ss->ss_masks[2][pos]) != ss->ss_keys[2][pos])
+         continue;
+      if ((addr->addr32[3] & ss->ss_masks[3][pos]) != ss->ss_keys[3][pos])
+         continue;
+      hits |= UINT64_C(1) << pos;
+   };
+
+   return(hits);
+}
+
+
+#ifdef NETCALC_SMALLSET_X86
+// compares address with four networks per instruction
+__attribute__((target("sse2")))
+uint64_t
+netcalc_smallset_match_sse2(
+         const netcalc_smallset_t *    ss,
+         const netcalc_addr_t *        addr )
+{
+   size_t            pos;
+   size_t            word;
+   uint64_t          hits;
+   __m128i           words[4];
+   __m128i           eq;
+   __m128i           cmp;
+
+   for(word = 0; (word < 4); word++)
+      words[word] = _mm_set1_epi32((int)addr->addr32[word]);
+
+   hits = 0;
+   for(pos = 0; (pos < ss->ss_len); pos += 4)
+   {  eq = _mm_set1_epi32(-1);
+      for(word = 0; (word < 4); word++)
+      {  cmp   = _mm_and_si128(words[word], _mm_load_si128((const __m128i *)&ss->ss_masks[word][pos]));
+         cmp   = _mm_cmpeq_epi32(cmp, _mm_load_si128((const __m128i *)&ss->ss_keys[word][pos]));
+         eq    = _mm_and_si128(eq, cmp);
+      };
+      hits |= (uint64_t)(unsigned)_mm_movemask_ps(_mm_castsi128_ps(eq)) << pos;
+   };
+
+   return(hits);
+}
+#endif
+
+
+int
+netcalc_smallset_query(
+         const netcalc_smallset_t *    ss,
+         const netcalc_net_t *         net,
+         size_t *                      idxp )
+{
+   size_t            pos;
+   uint32_t          family;
+   uint64_t          hits;
+
+   assert(ss  != NULL);
+   assert(net != NULL);
+
+   family = net->net_flags & NETCALC_AF;
+   if ( (family != NETCALC_AF_INET) && (family != NETCALC_AF_INET6) )
+      return(NETCALC_ENOTSUP);
+
+   hits = ss->ss_match(ss, &net->net_addr) & ss->ss_valid;
+
+   // networks which are more specific than the queried network do not contain it
+   for(pos = 0; ( (pos < ss->ss_len) && (ss->ss_cidrs[pos] > net->net_cidr) ); pos++)
+      hits &= ~(UINT64_C(1) << pos);
+
+   if (!(hits))
+      return(NETCALC_ENOREC);
+
+#if defined(__GNUC__) || defined(__clang__)
+   pos = (size_t)__builtin_ctzll(hits);
+#else
+   for(pos = 0; (!(hits & 1)); pos++)
+      hits >>= 1;
+#endif
+   if ((idxp))
+      *idxp = ss->ss_index[pos];
+
+   return(0);
+}
+
+
+/* end of source */
@@ -0,0 +1,609 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __LIB_LIBNETCALC_LSNAP_C 1
+#include "libnetcalc.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef HAVE_SYS_MMAN_H
+#   include <sys/mman.h>
+#endif
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#define NETCALC_SNAP_MAGIC       "NCSET\0\r\n"
+#define NETCALC_SNAP_ORDER       0x01020304
+#define NETCALC_SNAP_VERSION     1
+
+
+//////////////////
+//              //
+//  Data Types  //
+//              //
+//////////////////
+// MARK: - Data Types
+
+typedef struct _libnetcalc_snap_header    netcalc_snap_hdr_t;
+typedef struct _libnetcalc_snap_record    netcalc_snap_rec_t;
+
+
+// snapshot image:  header, records in breadth first order, string table
+struct _libnetcalc_snap_header
+{  uint8_t                    hdr_magic[8];
+   uint32_t                   hdr_order;     // byte order of image
+   uint32_t                   hdr_version;
+   uint32_t                   hdr_flags;     // flags of set
+   uint32_t                   hdr_count;     // number of records
+   uint32_t                   hdr_top;       // number of records in top level list
+   uint32_t                   hdr_strs;      // length of string table
+   uint32_t                   hdr_sb_flags;  // flags of superblock, zero if set does not have a superblock
+   uint8_t                    hdr_sb_cidr;
+   uint8_t                    __pad[3];
+   uint8_t                    hdr_sb_addr[16];
+};
+
+
+// children of a record are contiguous and immediately follow the children
+// of the preceding record with children
+struct _libnetcalc_snap_record
+{  uint8_t                    srec_addr[16];
+   uint32_t                   srec_flags;
+   uint32_t                   srec_first;    // index of first child
+   uint32_t                   srec_count;    // number of children
+   uint32_t                   srec_comment;  // offset of comment in string table plus one, zero if no comment
+   uint8_t                    srec_cidr;
+   uint8_t                    __pad[3];
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+netcalc_snap_load(
+         netcalc_set_t *               ns,
+         netcalc_snap_t *              snap );
+
+
+static int
+netcalc_snap_write(
+         FILE *                        fs,
+         const netcalc_set_t *         ns );
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+// replaces records referencing the snapshot with allocated records so the
+// set may be modified
+int
+netcalc_snap_copy(
+         netcalc_set_t *               ns )
+{
+   int                  rc;
+   uint32_t             idx;
+   netcalc_recs_t       recs;
+
+   assert(ns            != NULL);
+   assert(ns->set_snap  != NULL);
+
+   memset(&recs, 0, sizeof(netcalc_recs_t));
+   if ((recs.list = malloc(sizeof(netcalc_rec_t *) * (ns->set_recs.len + 1))) == NULL)
+      return(NETCALC_ENOMEM);
+   recs.size = ns->set_recs.len;
+
+   for(idx = 0; (idx < ns->set_recs.len); idx++)
+   {  if ((rc = netcalc_rec_dup(ns->set_recs.list[idx], &recs.list[idx])) != 0)
+      {  while(idx > 0)
+            netcalc_rec_free(recs.list[--idx]);
+         free(recs.list);
+         return(rc);
+      };
+   };
+   recs.len             = ns->set_recs.len;
+   recs.list[recs.len]  = NULL;
+
+   netcalc_snap_free(ns);
+   memcpy(&ns->set_recs, &recs, sizeof(netcalc_recs_t));
+   netcalc_cache_flush(ns);
+   ns->set_handles++;
+
+   // queries of hosts missing from index fall back to searching records
+   netcalc_hosts_build(ns);
+
+   return(0);
+}
+
+
+// releases records and image of snapshot, leaving the set empty
+void
+netcalc_snap_free(
+         netcalc_set_t *               ns )
+{
+   uint32_t             idx;
+   netcalc_snap_t *     snap;
+
+   assert(ns != NULL);
+
+   if ((snap = ns->set_snap) == NULL)
+      return;
+
+   netcalc_hosts_free(ns);
+
+   // free lazily built indexes
+   for(idx = 0; (idx < snap->snap_count); idx++)
+   {  if ((snap->snap_recs[idx].rec_children.gaps))
+         free(snap->snap_recs[idx].rec_children.gaps);
+      netcalc_keys_free(&snap->snap_recs[idx].rec_children);
+   };
+   if ((ns->set_recs.gaps))
+      free(ns->set_recs.gaps);
+   netcalc_keys_free(&ns->set_recs);
+   memset(&ns->set_recs, 0, sizeof(netcalc_recs_t));
+
+   netcalc_snap_unmap(snap);
+   ns->set_snap = NULL;
+
+   return;
+}
+
+
+// validates image and points records at the keys and comments of the image
+int
+netcalc_snap_load(
+         netcalc_set_t *               ns,
+         netcalc_snap_t *              snap )
+{
+   int                           rc;
+   uint32_t                      idx;
+   uint32_t                      pos;
+   uint32_t                      next;
+   uint32_t                      lists;
+   uint64_t                      size;
+   const char *                  strs;
+   netcalc_rec_t *               rec;
+   const netcalc_snap_hdr_t *    hdr;
+   const netcalc_snap_rec_t *    srecs;
+   const netcalc_snap_rec_t *    srec;
+
+   assert(ns   != NULL);
+   assert(snap != NULL);
+
+   // verify header
+   hdr = snap->snap_map;
+   if (snap->snap_len < sizeof(netcalc_snap_hdr_t))
+      return(NETCALC_EBADFILE);
+   if ((memcmp(hdr->hdr_magic, NETCALC_SNAP_MAGIC, sizeof(hdr->hdr_magic))))
+      return(NETCALC_EBADFILE);
+   if ( (hdr->hdr_order != NETCALC_SNAP_ORDER) || (hdr->hdr_version != NETCALC_SNAP_VERSION) )
+      return(NETCALC_EBADFILE);
+   size  = sizeof(netcalc_snap_hdr_t);
+   size += (uint64_t)hdr->hdr_count * sizeof(netcalc_snap_rec_t);
+   size += hdr->hdr_strs;
+   if ( (size != snap->snap_len) || (hdr->hdr_top > hdr->hdr_count) || (hdr->hdr_sb_cidr > 128) )
+      return(NETCALC_EBADFILE);
+   srecs = (const netcalc_snap_rec_t *)&hdr[1];
+   strs  = (const char *)&srecs[hdr->hdr_count];
+   if ( ((hdr->hdr_strs)) && ((strs[hdr->hdr_strs-1])) )
+      return(NETCALC_EBADFILE);
+
+   // verify each record belongs to exactly one list
+   next  = hdr->hdr_top;
+   lists = 1;
+   for(idx = 0; (idx < hdr->hdr_count); idx++)
+   {  srec = &srecs[idx];
+      if ( (idx >= next) || (srec->srec_cidr > 128) || (srec->srec_comment > hdr->hdr_strs) )
+         return(NETCALC_EBADFILE);
+      if (!(srec->srec_count))
+         continue;
+      if ( (srec->srec_first != next) || (srec->srec_count > (hdr->hdr_count - next)) )
+         return(NETCALC_EBADFILE);
+      next += srec->srec_count;
+      lists++;
+   };
+   if (next != hdr->hdr_count)
+      return(NETCALC_EBADFILE);
+
+   if ((snap->snap_recs = calloc((size_t)hdr->hdr_count + 1, sizeof(netcalc_rec_t))) == NULL)
+      return(NETCALC_ENOMEM);
+   snap->snap_count = hdr->hdr_count;
+   if ((snap->snap_lists = malloc(sizeof(netcalc_rec_t *) * ((size_t)hdr->hdr_count + lists))) == NULL)
+      return(NETCALC_ENOMEM);
+
+   // top level list
+   pos                  = 0;
+   ns->set_recs.list    = &snap->snap_lists[pos];
+   ns->set_recs.len     = hdr->hdr_top;
+   ns->set_recs.size    = hdr->hdr_top;
+   for(idx = 0; (idx < hdr->hdr_top); idx++)
+      snap->snap_lists[pos++] = &snap->snap_recs[idx];
+   snap->snap_lists[pos++] = NULL;
+
+   // records and lists of children
+   for(idx = 0; (idx < hdr->hdr_count); idx++)
+   {  srec = &srecs[idx];
+      rec  = &snap->snap_recs[idx];
+      memcpy(&rec->rec_addr, srec->srec_addr, sizeof(netcalc_addr_t));
+      rec->rec_flags    = srec->srec_flags;
+      rec->rec_cidr     = srec->srec_cidr;
+      rec->rec_comment  = ((srec->srec_comment)) ? (char *)&strs[srec->srec_comment - 1] : NULL;
+      if (!(srec->srec_count))
+         continue;
+      rec->rec_children.list  = &snap->snap_lists[pos];
+      rec->rec_children.len   = srec->srec_count;
+      rec->rec_children.size  = srec->srec_count;
+      for(next = 0; (next < srec->srec_count); next++)
+         snap->snap_lists[pos++] = &snap->snap_recs[srec->srec_first + next];
+      snap->snap_lists[pos++] = NULL;
+   };
+
+   ns->set_flags = hdr->hdr_flags;
+
+   if ((rc = netcalc_hosts_build(ns)) != 0)
+      return(rc);
+
+   return(netcalc_filter_build(ns));
+}
+
+
+// maps image of file into memory, or reads image if unable to map image
+int
+netcalc_snap_map(
+         netcalc_snap_t **             snapp,
+         const char *                  path )
+{
+   int                  fd;
+   struct stat          sb;
+   netcalc_snap_t *     snap;
+
+   assert(snapp   != NULL);
+   assert(path    != NULL);
+
+   *snapp = NULL;
+
+   if ((fd = open(path, O_RDONLY)) == -1)
+      return(NETCALC_EIO);
+   if (fstat(fd, &sb) == -1)
+   {  close(fd);
+      return(NETCALC_EIO);
+   };
+   if ( (sb.st_size == 0) || ((uint64_t)sb.st_size > SIZE_MAX) )
+   {  close(fd);
+      return(NETCALC_EBADFILE);
+   };
+
+   if ((snap = malloc(sizeof(netcalc_snap_t))) == NULL)
+   {  close(fd);
+      return(NETCALC_ENOMEM);
+   };
+   memset(snap, 0, sizeof(netcalc_snap_t));
+   snap->snap_len = (size_t)sb.st_size;
+
+#ifdef HAVE_SYS_MMAN_H
+   if ((snap->snap_map = mmap(NULL, snap->snap_len, PROT_READ, MAP_PRIVATE, fd, 0)) != MAP_FAILED)
+      snap->snap_mmap = 1;
+   else
+      snap->snap_map = NULL;
+#endif
+   if (!(snap->snap_map))
+   {  if ((snap->snap_map = malloc(snap->snap_len)) == NULL)
+      {  close(fd);
+         free(snap);
+         return(NETCALC_ENOMEM);
+      };
+      if (read(fd, snap->snap_map, snap->snap_len) != (ssize_t)snap->snap_len)
+      {  close(fd);
+         free(snap->snap_map);
+         free(snap);
+         return(NETCALC_EIO);
+      };
+   };
+   close(fd);
+
+   *snapp = snap;
+
+   return(0);
+}
+
+
+void
+netcalc_snap_unmap(
+         netcalc_snap_t *              snap )
+{
+   assert(snap != NULL);
+
+   if ((snap->snap_recs))
+      free(snap->snap_recs);
+   if ((snap->snap_lists))
+      free(snap->snap_lists);
+
+#ifdef HAVE_SYS_MMAN_H
+   if ((snap->snap_mmap))
+      munmap(snap->snap_map, snap->snap_len);
+   else
+#endif
+      free(snap->snap_map);
+
+   free(snap);
+
+   return;
+}
+
+
+int
+netcalc_set_open_mmap(
+         netcalc_set_t **              nsp,
+         const char *                  path )
+{
+   int                           rc;
+   netcalc_set_t *               ns;
+   netcalc_snap_t *              snap;
+   const netcalc_snap_hdr_t *    hdr;
+   netcalc_buff_t                nbuff;
+
+   assert(nsp  != NULL);
+   assert(path != NULL);
+
+   *nsp = NULL;
+
+   if ((rc = netcalc_snap_map(&snap, path)) != 0)
+      return(rc);
+   if (snap->snap_len < sizeof(netcalc_snap_hdr_t))
+   {  netcalc_snap_unmap(snap);
+      return(NETCALC_EBADFILE);
+   };
+
+   // initialize set with superblock of image
+   hdr = snap->snap_map;
+   memset(&nbuff, 0, sizeof(netcalc_buff_t));
+   if (hdr->hdr_sb_flags != 0)
+   {  memcpy(&nbuff.buff_net.net_addr, hdr->hdr_sb_addr, sizeof(netcalc_addr_t));
+      nbuff.buff_net.net_cidr    = hdr->hdr_sb_cidr;
+      nbuff.buff_net.net_flags   = hdr->hdr_sb_flags;
+   };
+   if ((rc = netcalc_set_init(&ns, ((hdr->hdr_sb_flags)) ? &nbuff.buff_net : NULL, 0)) != 0)
+   {  netcalc_snap_unmap(snap);
+      return(rc);
+   };
+   ns->set_snap = snap;
+
+   if ((rc = netcalc_snap_load(ns, snap)) != 0)
+   {  netcalc_set_free(ns);
+      return(rc);
+   };
+
+   *nsp = ns;
+
+   return(0);
+}
+
+
+// writes snapshot to a temporary file which replaces the file on success,
+// so a mapped image of the previous snapshot remains valid
+int
+netcalc_set_save(
+         netcalc_set_t *               ns,
+         const char *                  path )
+{
+   assert(ns   != NULL);
+   assert(path != NULL);
+   return(netcalc_snap_save(ns, path, &netcalc_snap_write));
+}
+
+
+// writes image of set to temporary file which replaces the file at path so
+// that mapped images of the file are not modified
+int
+netcalc_snap_save(
+         netcalc_set_t *               ns,
+         const char *                  path,
+         int (*writer)(FILE *, const netcalc_set_t *) )
+{
+   int                  rc;
+   int                  fd;
+   size_t               len;
+   char *               tmp;
+   FILE *               fs;
+
+   assert(ns      != NULL);
+   assert(path    != NULL);
+   assert(writer  != NULL);
+
+   len = strlen(path) + 8;
+   if ((tmp = malloc(len)) == NULL)
+      return(NETCALC_ENOMEM);
+   snprintf(tmp, len, "%s.XXXXXX", path);
+
+   if ((fd = mkstemp(tmp)) == -1)
+   {  free(tmp);
+      return(NETCALC_EIO);
+   };
+   if ((fs = fdopen(fd, "wb")) == NULL)
+   {  close(fd);
+      unlink(tmp);
+      free(tmp);
+      return(NETCALC_EIO);
+   };
+
+   rc = writer(fs, ns);
+
+   if ( (fclose(fs) != 0) && (rc == 0) )
+      rc = NETCALC_EIO;
+   if ( (rc == 0) && (rename(tmp, path) != 0) )
+      rc = NETCALC_EIO;
+   if (rc != 0)
+      unlink(tmp);
+   free(tmp);
+
+   return(rc);
+}
+
+
+// writes records in breadth first order so the children of each record
+// are contiguous within the image
+int
+netcalc_snap_write(
+         FILE *                        fs,
+         const netcalc_set_t *         ns )
+{
+   size_t                  len;
+   uint32_t                idx;
+   uint32_t                child;
+   uint32_t                count;
+   uint32_t                next;
+   uint64_t                strs;
+   void *                  ptr;
+   netcalc_rec_t *         rec;
+   netcalc_rec_t **        order;
+   netcalc_snap_hdr_t      hdr;
+   netcalc_snap_rec_t      srec;
+
+   assert(fs != NULL);
+   assert(ns != NULL);
+
+   // determine order of records
+   next  = ns->set_recs.len;
+   count = (next > 1024) ? next : 1024;
+   if ((order = malloc(sizeof(netcalc_rec_t *) * count)) == NULL)
+      return(NETCALC_ENOMEM);
+   for(idx = 0; (idx < next); idx++)
+      order[idx] = ns->set_recs.list[idx];
+   strs  = 0;
+   for(idx = 0; (idx < next); idx++)
+   {  rec = order[idx];
+      if ((rec->rec_comment))
+         strs += strlen(rec->rec_comment) + 1;
+      if ((next + rec->rec_children.len) > count)
+      {  while ((next + rec->rec_children.len) > count)
+            count *= 2;
+         if ((ptr = realloc(order, sizeof(netcalc_rec_t *) * count)) == NULL)
+         {  free(order);
+            return(NETCALC_ENOMEM);
+         };
+         order = ptr;
+      };
+      for(child = 0; (child < rec->rec_children.len); child++)
+         order[next++] = rec->rec_children.list[child];
+   };
+   if (strs > UINT32_MAX)
+   {  free(order);
+      return(NETCALC_ERANGE);
+   };
+
+   // write header
+   memset(&hdr, 0, sizeof(hdr));
+   memcpy(hdr.hdr_magic, NETCALC_SNAP_MAGIC, sizeof(hdr.hdr_magic));
+   hdr.hdr_order     = NETCALC_SNAP_ORDER;
+   hdr.hdr_version   = NETCALC_SNAP_VERSION;
+   hdr.hdr_flags     = ns->set_flags;
+   hdr.hdr_count     = next;
+   hdr.hdr_top       = ns->set_recs.len;
+   hdr.hdr_strs      = (uint32_t)strs;
+   if ((ns->set_superblock))
+   {  memcpy(hdr.hdr_sb_addr, &ns->set_superblock->net_addr, sizeof(hdr.hdr_sb_addr));
+      hdr.hdr_sb_cidr   = ns->set_superblock->net_cidr;
+      hdr.hdr_sb_flags  = ns->set_superblock->net_flags;
+   };
+   if (fwrite(&hdr, sizeof(hdr), 1, fs) != 1)
+   {  free(order);
+      return(NETCALC_EIO);
+   };
+
+   // write records
+   strs  = 0;
+   child = ns->set_recs.len;
+   for(idx = 0; (idx < next); idx++)
+   {  rec = order[idx];
+      memset(&srec, 0, sizeof(srec));
+      memcpy(srec.srec_addr, &rec->rec_addr, sizeof(srec.srec_addr));
+      srec.srec_flags   = rec->rec_flags;
+      srec.srec_cidr    = rec->rec_cidr;
+      srec.srec_first   = ((rec->rec_children.len)) ? child : 0;
+      srec.srec_count   = rec->rec_children.len;
+      child            += rec->rec_children.len;
+      if ((rec->rec_comment))
+      {  srec.srec_comment = (uint32_t)(strs + 1);
+         strs             += strlen(rec->rec_comment) + 1;
+      };
+      if (fwrite(&srec, sizeof(srec), 1, fs) != 1)
+      {  free(order);
+         return(NETCALC_EIO);
+      };
+   };
+
+   // write string table
+   for(idx = 0; (idx < next); idx++)
+   {  rec = order[idx];
+      if (!(rec->rec_comment))
+         continue;
+      len = strlen(rec->rec_comment) + 1;
+      if (fwrite(rec->rec_comment, len, 1, fs) != 1)
+      {  free(order);
+         return(NETCALC_EIO);
+      };
+   };
+
+   free(order);
+
+   return(0);
+}
+
+
+/* end of source */
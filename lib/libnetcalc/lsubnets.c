@@ -0,0 +1,277 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __LIB_LIBNETCALC_LSUBNETS_C 1
+#include "libnetcalc.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+// determines the addresses of a range which starts at the network address
+// of the first network and ends at the broadcast address of the last network
+int
+netcalc_range_addrs(
+         const netcalc_net_t *         first,
+         const netcalc_net_t *         last,
+         netcalc_addr_t *              startp,
+         netcalc_addr_t *              endp )
+{
+   int                  idx;
+   uint32_t             family;
+
+   assert(first  != NULL);
+   assert(last   != NULL);
+   assert(startp != NULL);
+   assert(endp   != NULL);
+
+   family = first->net_flags & NETCALC_AF;
+   if ( (family != NETCALC_AF_INET) && (family != NETCALC_AF_INET6) )
+      return(NETCALC_ENOTSUP);
+   if ((last->net_flags & NETCALC_AF) != family)
+      return(NETCALC_EINVAL);
+
+   for(idx = 0; (idx < 4); idx++)
+      startp->addr32[idx] = first->net_addr.addr32[idx] & _netcalc_netmasks[first->net_cidr].addr32[idx];
+   netcalc_addr_last(endp, &last->net_addr, last->net_cidr);
+   if (netcalc_addr_cmp(startp, 128, endp, 128) == NETCALC_CMP_AFTER)
+      return(NETCALC_EINVAL);
+
+   return(0);
+}
+
+
+void
+netcalc_range_free(
+         netcalc_net_t **              nets )
+{
+   size_t               idx;
+
+   if (!(nets))
+      return;
+   for(idx = 0; ((nets[idx])); idx++)
+      netcalc_net_free(nets[idx]);
+   free(nets);
+   return;
+}
+
+
+// parses a range of addresses formatted as "first-last"
+int
+netcalc_range_parse(
+         const char *                  address,
+         int                           flags,
+         netcalc_buff_t *              firstp,
+         netcalc_buff_t *              lastp )
+{
+   int                  rc;
+   size_t               len;
+   char *               sep;
+   char                 sbuff[NETCALC_ADDRESS_LENGTH*2];
+
+   assert(address != NULL);
+   assert(firstp  != NULL);
+   assert(lastp   != NULL);
+
+   if ((len = strlen(address)) >= sizeof(sbuff))
+      return(NETCALC_EBUFFLEN);
+   memcpy(sbuff, address, (len+1));
+
+   // EUI addresses may contain hyphens, so each hyphen is tried as the
+   // separator of the range
+   rc = NETCALC_EBADADDR;
+   for(sep = strchr(sbuff, '-'); ((sep)); sep = strchr(&sep[1], '-'))
+   {  *sep = '\0';
+      if ((rc = netcalc_net_parse(firstp, sbuff, flags)) == 0)
+         rc = netcalc_net_parse(lastp, &sep[1], flags);
+      *sep = '-';
+      if (rc == 0)
+         return(0);
+   };
+
+   return(rc);
+}
+
+
+int
+netcalc_range_to_cidrs(
+         const netcalc_net_t *         first,
+         const netcalc_net_t *         last,
+         netcalc_net_t ***             netsp,
+         size_t *                      lenp )
+{
+   int                  rc;
+   size_t               len;
+   netcalc_net_t **     nets;
+   netcalc_net_t        nbuff;
+   netcalc_addr_t       end;
+
+   assert(first != NULL);
+   assert(last  != NULL);
+   assert(netsp != NULL);
+
+   *netsp = NULL;
+   if ((lenp))
+      *lenp = 0;
+
+   memset(&nbuff, 0, sizeof(netcalc_net_t));
+   if ((rc = netcalc_range_addrs(first, last, &nbuff.net_addr, &end)) != 0)
+      return(rc);
+   nbuff.net_flags = first->net_flags & NETCALC_AF;
+
+   // a range is covered by at most two blocks of each prefix length
+   if ((nets = malloc(sizeof(netcalc_net_t *) * 258)) == NULL)
+      return(NETCALC_ENOMEM);
+   memset(nets, 0, (sizeof(netcalc_net_t *) * 258));
+
+   // emits the largest aligned block at the start of the remaining range
+   for(len = 0; ; len++)
+   {  nbuff.net_cidr = netcalc_addr_block(&nbuff.net_addr, &end);
+      if ((rc = netcalc_net_dup(&nets[len], &nbuff)) != 0)
+      {  netcalc_range_free(nets);
+         return(rc);
+      };
+      netcalc_addr_last(&nbuff.net_addr, &nbuff.net_addr, nbuff.net_cidr);
+      if (!(memcmp(&nbuff.net_addr, &end, sizeof(netcalc_addr_t))))
+         break;
+      netcalc_addr_incr(&nbuff.net_addr);
+   };
+
+   *netsp = nets;
+   if ((lenp))
+      *lenp = len + 1;
+
+   return(0);
+}
+
+
+void
+netcalc_subnet_iter_free(
+         netcalc_subnet_iter_t *       iter )
+{
+   if ((iter))
+      free(iter);
+   return;
+}
+
+
+int
+netcalc_subnet_iter_init(
+         netcalc_subnet_iter_t **      iterp,
+         const netcalc_net_t *         net,
+         int                           cidr )
+{
+   int                        idx;
+   int                        family;
+   netcalc_subnet_iter_t *    iter;
+
+   assert(iterp != NULL);
+   assert(net   != NULL);
+
+   family = net->net_flags & NETCALC_AF;
+   if ( (family != NETCALC_AF_INET) && (family != NETCALC_AF_INET6) )
+      return(NETCALC_ENOTSUP);
+
+   // normalizes CIDR
+   if ( (cidr < 0) || (cidr > 128) )
+      return(NETCALC_EINVAL);
+   if (family == NETCALC_AF_INET)
+      cidr += 96;
+   if ( (cidr > 128) || (cidr < net->net_cidr) )
+      return(NETCALC_EINVAL);
+
+   if ((iter = malloc(sizeof(netcalc_subnet_iter_t))) == NULL)
+      return(NETCALC_ENOMEM);
+   memset(iter, 0, sizeof(netcalc_subnet_iter_t));
+
+   // first subnet is the network address of the network, last subnet
+   // contains the broadcast address of the network
+   iter->iter_net.net_flags   = (uint32_t)family;
+   iter->iter_net.net_cidr    = (uint8_t)cidr;
+   netcalc_addr_last(&iter->iter_last, &net->net_addr, net->net_cidr);
+   for(idx = 0; (idx < 4); idx++)
+   {  iter->iter_net.net_addr.addr32[idx]  = net->net_addr.addr32[idx] & _netcalc_netmasks[net->net_cidr].addr32[idx];
+      iter->iter_last.addr32[idx]         &= _netcalc_netmasks[cidr].addr32[idx];
+   };
+
+   *iterp = iter;
+
+   return(0);
+}
+
+
+int
+netcalc_subnet_iter_next(
+         netcalc_subnet_iter_t *       iter,
+         netcalc_net_t **              netp )
+{
+   int               rc;
+
+   assert(iter != NULL);
+   assert(netp != NULL);
+
+   *netp = NULL;
+
+   if ((iter->iter_done))
+      return(NETCALC_ENOREC);
+
+   if ((rc = netcalc_net_dup(netp, &iter->iter_net)) != 0)
+      return(rc);
+
+   // the last subnet may end at the end of the address space, so the
+   // address is not advanced past the last subnet
+   if (!(memcmp(&iter->iter_net.net_addr, &iter->iter_last, sizeof(netcalc_addr_t))))
+      iter->iter_done = 1;
+   else
+      netcalc_net_add(&iter->iter_net, 1);
+
+   return(0);
+}
+
+
+/* end of source */
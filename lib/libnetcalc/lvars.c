@@ -51,6 +51,55 @@
 /////////////////
 // MARK: - Variables
 
+// IANA IPv4 and IPv6 Special-Purpose Address Registries [RFC6890]
+// MARK: _netcalc_class_registry[]
+const netcalc_class_pfx_t _netcalc_class_registry[] =
+{  {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_UNSPECIFIED,   .pfx_cidr =   8, .pfx_addr = { 0x00, 0x00, 0x00, 0x00 } },  // 0.0.0.0/8
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_PRIVATE,       .pfx_cidr =   8, .pfx_addr = { 0x0a, 0x00, 0x00, 0x00 } },  // 10.0.0.0/8
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_SHARED,        .pfx_cidr =  10, .pfx_addr = { 0x64, 0x40, 0x00, 0x00 } },  // 100.64.0.0/10
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_LOOPBACK,      .pfx_cidr =   8, .pfx_addr = { 0x7f, 0x00, 0x00, 0x00 } },  // 127.0.0.0/8
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_LINK_LOCAL,    .pfx_cidr =  16, .pfx_addr = { 0xa9, 0xfe, 0x00, 0x00 } },  // 169.254.0.0/16
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_PRIVATE,       .pfx_cidr =  12, .pfx_addr = { 0xac, 0x10, 0x00, 0x00 } },  // 172.16.0.0/12
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_PROTOCOL,      .pfx_cidr =  24, .pfx_addr = { 0xc0, 0x00, 0x00, 0x00 } },  // 192.0.0.0/24
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_TRANSITION,    .pfx_cidr =  29, .pfx_addr = { 0xc0, 0x00, 0x00, 0x00 } },  // 192.0.0.0/29
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_DOCUMENTATION, .pfx_cidr =  24, .pfx_addr = { 0xc0, 0x00, 0x02, 0x00 } },  // 192.0.2.0/24
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_AS112,         .pfx_cidr =  24, .pfx_addr = { 0xc0, 0x1f, 0xc4, 0x00 } },  // 192.31.196.0/24
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_TRANSITION,    .pfx_cidr =  24, .pfx_addr = { 0xc0, 0x58, 0x63, 0x00 } },  // 192.88.99.0/24
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_PRIVATE,       .pfx_cidr =  16, .pfx_addr = { 0xc0, 0xa8, 0x00, 0x00 } },  // 192.168.0.0/16
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_AS112,         .pfx_cidr =  24, .pfx_addr = { 0xc0, 0xaf, 0x30, 0x00 } },  // 192.175.48.0/24
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_BENCHMARK,     .pfx_cidr =  15, .pfx_addr = { 0xc6, 0x12, 0x00, 0x00 } },  // 198.18.0.0/15
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_DOCUMENTATION, .pfx_cidr =  24, .pfx_addr = { 0xc6, 0x33, 0x64, 0x00 } },  // 198.51.100.0/24
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_DOCUMENTATION, .pfx_cidr =  24, .pfx_addr = { 0xcb, 0x00, 0x71, 0x00 } },  // 203.0.113.0/24
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_MULTICAST,     .pfx_cidr =   4, .pfx_addr = { 0xe0, 0x00, 0x00, 0x00 } },  // 224.0.0.0/4
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_RESERVED,      .pfx_cidr =   4, .pfx_addr = { 0xf0, 0x00, 0x00, 0x00 } },  // 240.0.0.0/4
+   {  .pfx_family = NETCALC_AF_INET,  .pfx_class = NETCALC_CLASS_BROADCAST,     .pfx_cidr =  32, .pfx_addr = { 0xff, 0xff, 0xff, 0xff } },  // 255.255.255.255/32
+   {  .pfx_family = NETCALC_AF_INET6, .pfx_class = NETCALC_CLASS_UNSPECIFIED,   .pfx_cidr = 128, .pfx_addr = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },  // ::/128
+   {  .pfx_family = NETCALC_AF_INET6, .pfx_class = NETCALC_CLASS_LOOPBACK,      .pfx_cidr = 128, .pfx_addr = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 } },  // ::1/128
+   {  .pfx_family = NETCALC_AF_INET6, .pfx_class = NETCALC_CLASS_IPV4_MAPPED,   .pfx_cidr =  96, .pfx_addr = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00 } },  // ::ffff:0:0/96
+   {  .pfx_family = NETCALC_AF_INET6, .pfx_class = NETCALC_CLASS_TRANSITION,    .pfx_cidr =  96, .pfx_addr = { 0x00, 0x64, 0xff, 0x9b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },  // 64:ff9b::/96
+   {  .pfx_family = NETCALC_AF_INET6, .pfx_class = NETCALC_CLASS_TRANSITION,    .pfx_cidr =  48, .pfx_addr = { 0x00, 0x64, 0xff, 0x9b, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },  // 64:ff9b:1::/48
+   {  .pfx_family = NETCALC_AF_INET6, .pfx_class = NETCALC_CLASS_DISCARD,       .pfx_cidr =  64, .pfx_addr = { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },  // 100::/64
+   {  .pfx_family = NETCALC_AF_INET6, .pfx_class = NETCALC_CLASS_PROTOCOL,      .pfx_cidr =  23, .pfx_addr = { 0x20, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },  // 2001::/23
+   {  .pfx_family = NETCALC_AF_INET6, .pfx_class = NETCALC_CLASS_TRANSITION,    .pfx_cidr =  32, .pfx_addr = { 0x20, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },  // 2001::/32
+   {  .pfx_family = NETCALC_AF_INET6, .pfx_class = NETCALC_CLASS_BENCHMARK,     .pfx_cidr =  48, .pfx_addr = { 0x20, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },  // 2001:2::/48
+   {  .pfx_family = NETCALC_AF_INET6, .pfx_class = NETCALC_CLASS_AS112,         .pfx_cidr =  48, .pfx_addr = { 0x20, 0x01, 0x00, 0x04, 0x01, 0x12, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },  // 2001:4:112::/48
+   {  .pfx_family = NETCALC_AF_INET6, .pfx_class = NETCALC_CLASS_DOCUMENTATION, .pfx_cidr =  32, .pfx_addr = { 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },  // 2001:db8::/32
+   {  .pfx_family = NETCALC_AF_INET6, .pfx_class = NETCALC_CLASS_TRANSITION,    .pfx_cidr =  16, .pfx_addr = { 0x20, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },  // 2002::/16
+   {  .pfx_family = NETCALC_AF_INET6, .pfx_class = NETCALC_CLASS_AS112,         .pfx_cidr =  48, .pfx_addr = { 0x26, 0x20, 0x00, 0x4f, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },  // 2620:4f:8000::/48
+   {  .pfx_family = NETCALC_AF_INET6, .pfx_class = NETCALC_CLASS_DOCUMENTATION, .pfx_cidr =  20, .pfx_addr = { 0x3f, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },  // 3fff::/20
+   {  .pfx_family = NETCALC_AF_INET6, .pfx_class = NETCALC_CLASS_UNIQUE_LOCAL,  .pfx_cidr =   7, .pfx_addr = { 0xfc, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },  // fc00::/7
+   {  .pfx_family = NETCALC_AF_INET6, .pfx_class = NETCALC_CLASS_LINK_LOCAL,    .pfx_cidr =  10, .pfx_addr = { 0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },  // fe80::/10
+   {  .pfx_family = NETCALC_AF_INET6, .pfx_class = NETCALC_CLASS_MULTICAST,     .pfx_cidr =   8, .pfx_addr = { 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },  // ff00::/8
+   {  .pfx_family = 0 }
+};
+
+
+// registry compiled into trie by netcalc_class_compile(), NULL until the
+// first trie is published
+// MARK: _netcalc_class_trie
+_Atomic(netcalc_class_node_t *) _netcalc_class_trie = NULL;
+
+
 // IPv6 Prefix for IPv4 addresses: ::ffff:0000:0000/96
 // MARK: _netcalc_ipv4_mapped_ipv6
 const netcalc_net_t _netcalc_ipv4_mapped_ipv6  =
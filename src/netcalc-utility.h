@@ -290,11 +290,26 @@ my_widget_test_usage(
          my_config_t *                 cnf );
 
 
+extern int
+my_widget_allocate(
+         my_config_t *                 cnf );
+
+
 extern int
 my_widget_debug(
          my_config_t *                 cnf );
 
 
+extern int
+my_widget_diff(
+         my_config_t *                 cnf );
+
+
+extern int
+my_widget_free(
+         my_config_t *                 cnf );
+
+
 extern int
 my_widget_info(
          my_config_t *                 cnf );
@@ -320,6 +335,11 @@ my_widget_sort(
          my_config_t *                 cnf );
 
 
+extern int
+my_widget_subnet(
+         my_config_t *                 cnf );
+
+
 extern int
 my_widget_superblock(
          my_config_t *                 cnf );
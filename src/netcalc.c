@@ -51,6 +51,7 @@
 #include <strings.h>
 #include <stdlib.h>
 #include <getopt.h>
+#include <inttypes.h>
 
 
 ///////////////////
@@ -148,6 +149,15 @@ my_free(
          my_config_t *                 cnf );
 
 
+static int
+my_rec_subnets(
+         const netcalc_net_t *         net,
+         int                           family,
+         int                           cidr,
+         char *                        str,
+         size_t                        size );
+
+
 static int
 my_usage(
          my_config_t *                 cnf );
@@ -204,6 +214,19 @@ my_widget_version(
 #pragma mark netcalc_widget_map[]
 static my_widget_t my_widget_map[] =
 {
+   // allocate widget
+   {  .name       = "allocate",
+      .desc       = "allocates unused blocks within a network",
+      .usage      = "[OPTIONS] <network> <cidr> [ <cidr> [ ... <cidr> ] ]",
+      .short_opt  = NETCALC_SHORT_OPT NETCALC_SHORT_FILE NETCALC_SHORT_FORMAT,
+      .long_opt   = NETCALC_LONG( NETCALC_LONG_FILE NETCALC_LONG_FORMAT ),
+      .arg_min    = 2,
+      .arg_max    = -1,
+      .aliases    = (const char * const[]) { "alloc", NULL },
+      .func_exec  = &my_widget_allocate,
+      .func_usage = &my_usage_import,
+   },
+
    // copyright widget
    {  .name       = "copyright",
       .desc       = "display copyright",
@@ -243,6 +266,32 @@ static my_widget_t my_widget_map[] =
       .func_usage = &my_widget_null,
    },
 
+   // diff widget
+   {  .name       = "diff",
+      .desc       = "display differences between network sets",
+      .usage      = "[OPTIONS] <file> <file>",
+      .short_opt  = NETCALC_SHORT_OPT "B:cO" NETCALC_SHORT_FORMAT,
+      .long_opt   = NETCALC_LONG( NETCALC_LONG_FILE NETCALC_LONG_FORMAT ),
+      .arg_min    = 2,
+      .arg_max    = 2,
+      .aliases    = NULL,
+      .func_exec  = &my_widget_diff,
+      .func_usage = &my_usage_import,
+   },
+
+   // free widget
+   {  .name       = "free",
+      .desc       = "display unallocated blocks within networks",
+      .usage      = "[OPTIONS] [ <network> [ <network> [ ... <network> ] ] ]",
+      .short_opt  = NETCALC_SHORT_OPT NETCALC_SHORT_FILE NETCALC_SHORT_FORMAT,
+      .long_opt   = NETCALC_LONG( NETCALC_LONG_FILE NETCALC_LONG_FORMAT ),
+      .arg_min    = 0,
+      .arg_max    = -1,
+      .aliases    = (const char * const[]) { "unallocated", NULL },
+      .func_exec  = &my_widget_free,
+      .func_usage = &my_usage_import,
+   },
+
    // help widget
    {  .name       = "help",
       .desc       = "display help",
@@ -295,17 +344,30 @@ static my_widget_t my_widget_map[] =
       .func_usage = &my_widget_printf_usage,
    },
 
+   // subnet widget
+   {  .name       = "subnet",
+      .desc       = "divides network into subnets",
+      .usage      = "[OPTIONS] <network> <cidr>",
+      .short_opt  = NETCALC_SHORT_OPT NETCALC_SHORT_FORMAT,
+      .long_opt   = NETCALC_LONG( NETCALC_LONG_FORMAT ),
+      .arg_min    = 2,
+      .arg_max    = 2,
+      .aliases    = (const char * const[]) { "split", NULL },
+      .func_exec  = &my_widget_subnet,
+      .func_usage = &my_widget_null,
+   },
+
    // superblock widget
    {  .name       = "superblock",
       .desc       = "display superblocks containing IP addresses",
-      .usage      = "[OPTIONS] <address> [ <address> [ ... <address> ] ]",
-      .short_opt  = NETCALC_SHORT_OPT NETCALC_SHORT_FORMAT,
-      .long_opt   = NETCALC_LONG( NETCALC_LONG_FORMAT ),
-      .arg_min    = 1,
+      .usage      = "[OPTIONS] [ <address> [ ... <address> ] ]",
+      .short_opt  = NETCALC_SHORT_OPT "cf:" NETCALC_SHORT_FORMAT,
+      .long_opt   = NETCALC_LONG( { "continue", no_argument, NULL, 'c' }, NETCALC_LONG_FORMAT ),
+      .arg_min    = 0,
       .arg_max    = -1,
       .aliases    = (const char * const[]) { "super", "supernet", NULL },
       .func_exec  = &my_widget_superblock,
-      .func_usage = &my_widget_null,
+      .func_usage = &my_usage_import,
    },
 
    // sort widget
@@ -898,6 +960,8 @@ my_set_import(
       if (address[0] != '\0')
       {  if ((rc = my_netcalc_init(cnf, &net, address)) == NETCALC_SUCCESS)
             rc = netcalc_set_add(ns, net, comment, NULL, 0);
+         else if ((strchr(address, '-')))
+            rc = netcalc_set_add_range(ns, address, comment, NULL, 0, &net);
          if (rc != 0)
          {  if ( (!(cnf->cont)) || (!(cnf->quiet)) )
                fprintf(stderr, "%s: %s%zu: %s: %s\n", my_prog_name(cnf), filename, line, address, netcalc_strerror(rc));
@@ -1181,7 +1245,6 @@ my_rec_process(
          my_rec_t *                    rec )
 {
    int                  ip_superblock;
-   long long unsigned   lluval;
    netcalc_net_t *      n;
 
    assert(cnf != NULL);
@@ -1211,26 +1274,75 @@ my_rec_process(
       netcalc_net_field(n, NETCALC_FLD_CIDR, &rec->ip_cidr);
       snprintf(rec->ip_cidr_str, sizeof(((my_rec_t *)0)->ip_cidr_str), "%i", rec->ip_cidr);
 
-      // calculate subnets
-      if (rec->family == NETCALC_AF_INET6)
-      {  if (!(rec->ip_cidr))
-         {  netcalc_strlcat(rec->ip_subnets, "18446744073709551616", sizeof(((my_rec_t *)0)->ip_subnets));
-         } else if (rec->ip_cidr <= 64)
-         {  lluval =  0x8000000000000000LLU >> (rec->ip_cidr - 1);
-            snprintf(rec->ip_subnets, sizeof(((my_rec_t *)0)->ip_subnets), "%llu", lluval);
-         } else
-         {  snprintf(rec->ip_subnets, sizeof(((my_rec_t *)0)->ip_subnets), "n/a");
-         };
-      } else if (rec->family == NETCALC_AF_INET)
-      {  lluval =  0x100000000LLU >> rec->ip_cidr;
-         snprintf(rec->ip_subnets, sizeof(((my_rec_t *)0)->ip_subnets), "%llu", lluval);
-      };
+      // calculate number of /64 subnets of IPv6 networks and number of
+      // addresses of IPv4 networks
+      if ((my_rec_subnets(n, rec->family, ((rec->family == NETCALC_AF_INET6) ? 64 : 32), rec->ip_subnets, sizeof(((my_rec_t *)0)->ip_subnets))))
+         snprintf(rec->ip_subnets, sizeof(((my_rec_t *)0)->ip_subnets), "n/a");
    };
 
    return;
 }
 
 
+// formats number of blocks of prefix length 'cidr' within network, the
+// number of blocks is one more than the distance between the first and
+// last blocks and is incremented within the string since the number of /64
+// subnets of ::/0 exceeds 64 bits
+int
+my_rec_subnets(
+         const netcalc_net_t *         net,
+         int                           family,
+         int                           cidr,
+         char *                        str,
+         size_t                        size )
+{
+   int               rc;
+   int               net_cidr;
+   size_t            len;
+   size_t            pos;
+   uint64_t          dist;
+   netcalc_net_t *   first;
+   netcalc_net_t *   last;
+
+   assert(net  != NULL);
+   assert(str  != NULL);
+
+   netcalc_net_field(net, NETCALC_FLD_CIDR, &net_cidr);
+   if (net_cidr > cidr)
+      return(NETCALC_ERANGE);
+
+   if ((rc = netcalc_net_range(net, &first, &last)) != 0)
+      return(rc);
+
+   // range excludes network and broadcast addresses of larger networks
+   if (net_cidr < (((family == NETCALC_AF_INET) ? 32 : 128) - 1))
+   {  netcalc_net_sub(first, 1);
+      netcalc_net_add(last,  1);
+   };
+
+   if ((rc = netcalc_net_mask(first, NULL, cidr)) == 0)
+      rc = netcalc_net_distance(first, last, &dist);
+   netcalc_net_free(first);
+   netcalc_net_free(last);
+   if (rc != 0)
+      return(rc);
+
+   if ((len = (size_t)snprintf(str, size, "%" PRIu64, dist)) >= (size - 1))
+      return(NETCALC_EBUFFLEN);
+   for(pos = len; (pos > 0); pos--)
+   {  if (str[pos-1] != '9')
+      {  str[pos-1]++;
+         return(0);
+      };
+      str[pos-1] = '0';
+   };
+   memmove(&str[1], str, len + 1);
+   str[0] = '1';
+
+   return(0);
+}
+
+
 my_rec_t **
 my_recs_alloc(
          my_config_t *                 cnf,
@@ -0,0 +1,207 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_WIDGET_DIFF_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "netcalc-utility.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <getopt.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+
+//////////////////
+//              //
+//  Data Types  //
+//              //
+//////////////////
+// MARK: - Data Types
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+my_widget_diff_import(
+         my_config_t *                 cnf,
+         netcalc_set_t *               ns,
+         const char *                  filename );
+
+
+static int
+my_widget_diff_print(
+         void *                        ctx,
+         int                           op,
+         const netcalc_net_t *         net,
+         const char *                  comment1,
+         const char *                  comment2 );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+// MARK: - Variables
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+my_widget_diff(
+         my_config_t *                 cnf )
+{
+   int                  rc;
+   int                  idx;
+   netcalc_set_t *      ns[2];
+
+   ns[0] = NULL;
+   ns[1] = NULL;
+
+   // import sets from files
+   for(idx = 0; (idx < 2); idx++)
+   {  if ((rc = netcalc_set_init(&ns[idx], cnf->net_super, 0)) != 0)
+      {  fprintf(stderr, "%s: %s\n", my_prog_name(cnf), netcalc_strerror(rc));
+         netcalc_set_free(ns[0]);
+         return(1);
+      };
+      if ((my_widget_diff_import(cnf, ns[idx], cnf->argv[idx])))
+      {  netcalc_set_free(ns[0]);
+         netcalc_set_free(ns[1]);
+         return(1);
+      };
+   };
+
+   // display records removed from first set and added to second set
+   rc = netcalc_set_diff(ns[0], ns[1], &my_widget_diff_print, cnf);
+   netcalc_set_free(ns[0]);
+   netcalc_set_free(ns[1]);
+   if (rc != 0)
+   {  fprintf(stderr, "%s: %s\n", my_prog_name(cnf), netcalc_strerror(rc));
+      return(1);
+   };
+
+   return(0);
+}
+
+
+int
+my_widget_diff_import(
+         my_config_t *                 cnf,
+         netcalc_set_t *               ns,
+         const char *                  filename )
+{
+   int                  rc;
+   int                  in_fd;
+   const char *         in_filename;
+
+   in_fd             = cnf->in_fd;
+   in_filename       = cnf->in_filename;
+
+   cnf->in_fd        = STDIN_FILENO;
+   cnf->in_filename  = filename;
+   if ((strcmp("-", filename)))
+   {  if ((cnf->in_fd = open(filename, O_RDONLY)) == -1)
+      {  fprintf(stderr, "%s: %s: %s\n", my_prog_name(cnf), filename, strerror(errno));
+         cnf->in_fd        = in_fd;
+         cnf->in_filename  = in_filename;
+         return(1);
+      };
+   };
+
+   rc = my_set_import(cnf, ns);
+
+   if (cnf->in_fd != STDIN_FILENO)
+      close(cnf->in_fd);
+   cnf->in_fd        = in_fd;
+   cnf->in_filename  = in_filename;
+
+   return(rc);
+}
+
+
+int
+my_widget_diff_print(
+         void *                        ctx,
+         int                           op,
+         const netcalc_net_t *         net,
+         const char *                  comment1,
+         const char *                  comment2 )
+{
+   my_config_t *        cnf;
+   char                 str[NETCALC_ADDRESS_LENGTH];
+
+   cnf = ctx;
+
+   netcalc_ntop(net, str, sizeof(str), NETCALC_TYPE_ADDRESS, cnf->flags);
+
+   if (op != NETCALC_MOD_ADD)
+      printf("-%s%s%s\n", str, ((comment1)) ? " " : "", ((comment1)) ? comment1 : "");
+   if (op != NETCALC_MOD_DEL)
+      printf("+%s%s%s\n", str, ((comment2)) ? " " : "", ((comment2)) ? comment2 : "");
+
+   return(0);
+}
+
+
+/* end of source */
@@ -0,0 +1,184 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_WIDGET_FREE_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "netcalc-utility.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <getopt.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+
+//////////////////
+//              //
+//  Data Types  //
+//              //
+//////////////////
+// MARK: - Data Types
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+my_widget_free_print(
+         my_config_t *                 cnf,
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+// MARK: - Variables
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+my_widget_free(
+         my_config_t *                 cnf )
+{
+   int                  rc;
+   int                  idx;
+   netcalc_set_t *      ns;
+   netcalc_net_t *      net;
+
+   if ( (!(cnf->argc)) && (!(cnf->net_super)) )
+   {  fprintf(stderr, "%s: missing network or superblock\n", my_prog_name(cnf));
+      fprintf(stderr, "Try `%s --help' for more information.\n", my_prog_name(cnf));
+      return(1);
+   };
+
+   // initializes set
+   if ((rc = netcalc_set_init(&ns, cnf->net_super, 0)) != 0)
+   {  fprintf(stderr, "%s: %s\n", my_prog_name(cnf), netcalc_strerror(rc));
+      return(1);
+   };
+
+   // import set from file and cli arguments
+   if ((my_set_import(cnf, ns)))
+   {  netcalc_set_free(ns);
+      return(1);
+   };
+
+   // display unallocated blocks within superblock
+   if (!(cnf->argc))
+   {  rc = my_widget_free_print(cnf, ns, NULL);
+      netcalc_set_free(ns);
+      return(rc);
+   };
+
+   // display unallocated blocks within networks
+   for(idx = 0; (idx < cnf->argc); idx++)
+   {  if ((rc = netcalc_net_init(&net, cnf->argv[idx], cnf->flags)) != 0)
+      {  fprintf(stderr, "%s: %s: %s\n", my_prog_name(cnf), cnf->argv[idx], netcalc_strerror(rc));
+         netcalc_set_free(ns);
+         return(1);
+      };
+      rc = my_widget_free_print(cnf, ns, net);
+      netcalc_net_free(net);
+      if ((rc))
+      {  netcalc_set_free(ns);
+         return(1);
+      };
+   };
+
+   netcalc_set_free(ns);
+
+   return(0);
+}
+
+
+int
+my_widget_free_print(
+         my_config_t *                 cnf,
+         netcalc_set_t *               ns,
+         const netcalc_net_t *         net )
+{
+   int                  rc;
+   netcalc_cur_t *      cur;
+   netcalc_net_t *      blk;
+
+   if ((rc = netcalc_set_free_blocks(ns, net, &cur)) != 0)
+   {  fprintf(stderr, "%s: %s\n", my_prog_name(cnf), netcalc_strerror(rc));
+      return(1);
+   };
+
+   while((rc = netcalc_cur_next(cur, &blk, NULL, NULL, NULL, NULL)) == 0)
+   {  printf("%s\n", netcalc_ntop(blk, NULL, 0, NETCALC_TYPE_ADDRESS, cnf->flags));
+      netcalc_net_free(blk);
+   };
+   netcalc_cur_free(cur);
+
+   if (rc != NETCALC_ENOREC)
+   {  fprintf(stderr, "%s: %s\n", my_prog_name(cnf), netcalc_strerror(rc));
+      return(1);
+   };
+
+   return(0);
+}
+
+
+/* end of source */
@@ -0,0 +1,144 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_WIDGET_SUBNET_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "netcalc-utility.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <getopt.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+
+//////////////////
+//              //
+//  Data Types  //
+//              //
+//////////////////
+// MARK: - Data Types
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+// MARK: - Variables
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+my_widget_subnet(
+         my_config_t *                 cnf )
+{
+   int                        rc;
+   int                        cidr;
+   char *                     ptr;
+   netcalc_net_t *            parent;
+   netcalc_net_t *            net;
+   netcalc_subnet_iter_t *    iter;
+
+   // parse parent network
+   if ((rc = netcalc_net_init(&parent, cnf->argv[0], cnf->flags)) != 0)
+   {  fprintf(stderr, "%s: %s: %s\n", my_prog_name(cnf), cnf->argv[0], netcalc_strerror(rc));
+      return(1);
+   };
+
+   // parse prefix length of subnets
+   ptr  = cnf->argv[1];
+   ptr += (ptr[0] == '/') ? 1 : 0;
+   cidr = (int)strtol(ptr, &ptr, 10);
+   if ( (ptr[0] != '\0') || (ptr == cnf->argv[1]) )
+   {  fprintf(stderr, "%s: %s: invalid prefix length\n", my_prog_name(cnf), cnf->argv[1]);
+      netcalc_net_free(parent);
+      return(1);
+   };
+
+   rc = netcalc_subnet_iter_init(&iter, parent, cidr);
+   netcalc_net_free(parent);
+   if (rc != 0)
+   {  fprintf(stderr, "%s: %s: %s\n", my_prog_name(cnf), cnf->argv[1], netcalc_strerror(rc));
+      return(1);
+   };
+
+   // subnets are printed as generated, so large networks may be divided
+   // without storing the subnets
+   while((rc = netcalc_subnet_iter_next(iter, &net)) == 0)
+   {  printf("%s\n", netcalc_ntop(net, NULL, 0, NETCALC_TYPE_ADDRESS, (cnf->flags | NETCALC_FLG_CIDR_ALWAYS)));
+      netcalc_net_free(net);
+   };
+   netcalc_subnet_iter_free(iter);
+
+   if (rc != NETCALC_ENOREC)
+   {  fprintf(stderr, "%s: %s\n", my_prog_name(cnf), netcalc_strerror(rc));
+      return(1);
+   };
+
+   return(0);
+}
+
+
+/* end of source */
@@ -43,11 +43,13 @@
 #include "netcalc-utility.h"
 
 #include <assert.h>
+#include <errno.h>
 #include <stdio.h>
 #include <string.h>
 #include <strings.h>
 #include <stdlib.h>
 #include <getopt.h>
+#include <unistd.h>
 
 
 ///////////////////
@@ -74,6 +76,20 @@
 //////////////////
 // MARK: - Prototypes
 
+static int
+my_widget_superblock_add(
+         my_config_t *                 cnf,
+         netcalc_superblock_acc_t *    acc,
+         const char *                  address,
+         const char *                  filename,
+         size_t                        line );
+
+
+static int
+my_widget_superblock_import(
+         my_config_t *                 cnf,
+         netcalc_superblock_acc_t *    acc );
+
 
 /////////////////
 //             //
@@ -94,67 +110,43 @@ int
 my_widget_superblock(
          my_config_t *                 cnf )
 {
-   int                  idx;
-   int                  rc;
-   int                  family;
-   int                  af_ipv6;
-   int                  af_other;
-   int                  cidr;
-   int                  flags;
-   size_t               size;
-   netcalc_net_t *      superblock;
-   netcalc_net_t **     nets;
-   my_rec_t **          recs;
-   my_len_t             lens;
+   int                           idx;
+   int                           rc;
+   int                           cidr;
+   int                           flags;
+   netcalc_net_t *               superblock;
+   netcalc_superblock_acc_t *    acc;
+   my_rec_t **                   recs;
+   my_len_t                      lens;
 
    cnf->flags &= ~cnf->flags_negate;
-   family      = 0;
-   af_ipv6     = 0;
-   af_other    = 0;
-
-   // allocates memory
-   size = sizeof(netcalc_net_t *) * ((size_t)cnf->argc + 2);
-   if ((nets = malloc(size)) == NULL)
-   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+
+   if ((rc = netcalc_superblock_acc_init(&acc)) != NETCALC_SUCCESS)
+   {  fprintf(stderr, "%s: %s\n", my_prog_name(cnf), netcalc_strerror(rc));
       return(1);
    };
-   memset(nets, 0, size);
 
    // process network arguments
    for(idx = 0; (idx < cnf->argc); idx++)
-   {  if ((rc = my_netcalc_init(cnf, &nets[idx], cnf->argv[idx])) != NETCALC_SUCCESS)
-      {  fprintf(stderr, "%s: %s: %s\n", my_prog_name(cnf), cnf->argv[idx], netcalc_strerror(rc));
-         my_nets_free(nets);
+   {  if ((my_widget_superblock_add(cnf, acc, cnf->argv[idx], NULL, 0)))
+      {  netcalc_superblock_acc_free(acc);
          return(1);
       };
-      netcalc_net_field(nets[idx], NETCALC_FLD_FAMILY, &family);
-
-      if (family == NETCALC_AF_INET6)
-         af_ipv6 = family;
-      else if (family != NETCALC_AF_INET)
-         af_other = family;
    };
 
-   // normalize address families
-   if ((af_ipv6))
-   {  af_other = 0;
-      for(idx = 0; (idx < cnf->argc); idx++)
-         netcalc_net_convert(nets[idx], NETCALC_AF_INET6, NULL);
-   };
-   if ((af_other))
-   {  my_nets_free(nets);
-      fprintf(stderr, "%s: %s: unsupported address families\n", my_prog_name(cnf), cnf->argv[idx]);
-      return(1);
+   // process networks from input file, or from stdin if no arguments are given
+   if ( (!(cnf->argc)) || (cnf->in_fd != STDIN_FILENO) )
+   {  if ((my_widget_superblock_import(cnf, acc)))
+      {  netcalc_superblock_acc_free(acc);
+         return(1);
+      };
    };
 
-   // calculate superblock and free networks
-   rc = netcalc_net_superblock(&superblock, (const netcalc_net_t * const *)nets, cnf->argc);
-   for(idx = 0; ((nets[idx])); idx++)
-      netcalc_net_free(nets[idx]);
-   free(nets);
-   nets = NULL;
+   // calculate superblock, IPv4 networks are converted to IPv6 if IPv6 networks are present
+   rc = netcalc_superblock_acc_finish(acc, &superblock);
+   netcalc_superblock_acc_free(acc);
    if (rc != NETCALC_SUCCESS)
-   {  fprintf(stderr, "%s: netcalc_net_superblock(): %s\n", my_prog_name(cnf), netcalc_strerror(rc));
+   {  fprintf(stderr, "%s: netcalc_superblock_acc_finish(): %s\n", my_prog_name(cnf), netcalc_strerror(rc));
       return(1);
    };
    netcalc_net_field(superblock, NETCALC_FLD_CIDR, &cidr);
@@ -193,4 +185,111 @@ my_widget_superblock(
 }
 
 
+// adds network to superblock
+int
+my_widget_superblock_add(
+         my_config_t *                 cnf,
+         netcalc_superblock_acc_t *    acc,
+         const char *                  address,
+         const char *                  filename,
+         size_t                        line )
+{
+   int                  rc;
+   int                  family;
+   netcalc_net_t *      net;
+   char                 location[1048];
+
+   location[0] = '\0';
+   if ((filename))
+      snprintf(location, sizeof(location), "%s%zu: ", filename, line);
+
+   if ((rc = my_netcalc_init(cnf, &net, address)) != NETCALC_SUCCESS)
+   {  if ( (!(cnf->cont)) || (!(cnf->quiet)) )
+         fprintf(stderr, "%s: %s%s: %s\n", my_prog_name(cnf), location, address, netcalc_strerror(rc));
+      return( ((cnf->cont)) ? 0 : 1 );
+   };
+
+   netcalc_net_field(net, NETCALC_FLD_FAMILY, &family);
+   if ( (family != NETCALC_AF_INET) && (family != NETCALC_AF_INET6) )
+   {  fprintf(stderr, "%s: %s%s: unsupported address family\n", my_prog_name(cnf), location, address);
+      netcalc_net_free(net);
+      return(1);
+   };
+
+   rc = netcalc_superblock_acc_add(acc, net);
+   netcalc_net_free(net);
+   if (rc != NETCALC_SUCCESS)
+   {  fprintf(stderr, "%s: %s%s: %s\n", my_prog_name(cnf), location, address, netcalc_strerror(rc));
+      return(1);
+   };
+
+   return(0);
+}
+
+
+// reads one network per line from input, networks are added to the
+// superblock as read so that memory does not grow with the input
+int
+my_widget_superblock_import(
+         my_config_t *                 cnf,
+         netcalc_superblock_acc_t *    acc )
+{
+   static char          buff[256];
+   ssize_t              len;
+   size_t               buff_len;
+   size_t               bol;        // beginning of line
+   size_t               eoa;        // end of address
+   size_t               eol;        // end of line
+   size_t               pos;
+   size_t               line;
+   char                 filename[1024];
+
+   assert(cnf != NULL);
+   assert(acc != NULL);
+
+   if (cnf->in_fd == -1)
+      return(0);
+
+   // generate filename for warnings and errors
+   filename[0] = '\0';
+   if ( (cnf->in_fd != STDIN_FILENO) && ((cnf->in_filename)) )
+      snprintf(filename, sizeof(filename), "%s: ", cnf->in_filename);
+
+   if ((len = read(cnf->in_fd, buff, (sizeof(buff)-1))) == -1)
+   {  fprintf(stderr, "%s: %sread(): %s\n", my_prog_name(cnf), filename, strerror(errno));
+      return(1);
+   };
+   buff[len]   = '\0';
+   buff_len    = (size_t)len;
+   line        = 0;
+
+   // process input file
+   while(buff_len > 0)
+   {  line++;
+      for(bol = 0;   ((buff[bol] == ' ')  || (buff[bol] == '\t')); bol++);
+      for(eoa = bol; ((buff[eoa] != '\n') && (buff[eoa] != '\0') && (buff[eoa] != ' ') && (buff[eoa] != '\t')); eoa++);
+      for(eol = eoa; ((buff[eol] != '\n') && (buff[eol] != '\0')); eol++);
+      buff[eoa]   = '\0';
+
+      if (buff[bol] != '\0')
+         if ((my_widget_superblock_add(cnf, acc, &buff[bol], filename, line)))
+            return(1);
+
+      // shift buffer
+      for(pos = 0; ((pos+eol+1) < buff_len); pos++)
+         buff[pos] = buff[pos+eol+1];
+      buff_len -= ((eol+1) < buff_len) ? (eol+1) : buff_len;
+
+      // fill buffer
+      if ((len = read(cnf->in_fd, &buff[buff_len], (sizeof(buff)-1-buff_len))) == -1)
+      {  fprintf(stderr, "%s: %sread(): %s\n", my_prog_name(cnf), filename, strerror(errno));
+         return(1);
+      };
+      buff_len += (size_t)len;
+      buff[buff_len] = '\0';
+   };
+
+   return(0);
+}
+
 /* end of source */
@@ -0,0 +1,378 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_BENCH_ADDR_CMP_C 1
+#include "libnetcalc-tests.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <arpa/inet.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "libnetcalc.h"
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-bench-addr-cmp"
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+// MARK: - Datatypes
+
+typedef int (*my_cmp_t)(const netcalc_addr_t * a1, uint8_t c1, const netcalc_addr_t * a2, uint8_t c2);
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+void
+my_fill(
+         uint64_t *                    statep,
+         netcalc_addr_t *              addrs,
+         uint8_t *                     cidrs,
+         long                          count,
+         int                           kind );
+
+
+int
+my_ref_cmp(
+         const netcalc_addr_t *        a1,
+         uint8_t                       c1,
+         const netcalc_addr_t *        a2,
+         uint8_t                       c2 );
+
+
+double
+my_run(
+         my_cmp_t                      cmp,
+         const netcalc_addr_t *        addrs,
+         const uint8_t *               cidrs,
+         long                          count,
+         long                          rounds );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   int               kind;
+   long              count;
+   long              rounds;
+   double            base;
+   double            rate;
+   uint64_t          state;
+   netcalc_addr_t *  addrs;
+   uint8_t *         cidrs;
+
+   static const char * const kinds[] =
+   {  "random", "same /64", "same /112", "ipv4"  };
+
+   // getopt options
+   static const char *  short_opt = "hn:qr:Vv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   count    = 4096;
+   rounds   = 2000;
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -n num                    number of addresses compared (default: 4096)\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -r num                    number of passes over addresses (default: 2000)\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'n':
+            count = strtol(optarg, NULL, 0);
+            break;
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'r':
+            rounds = strtol(optarg, NULL, 0);
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+   if ( (count < 2) || (rounds < 1) )
+   {  fprintf(stderr, "%s: invalid option value\n", PROGRAM_NAME);
+      return(1);
+   };
+
+   if ((addrs = calloc((size_t)count, sizeof(netcalc_addr_t))) == NULL)
+      return(1);
+   if ((cidrs = calloc((size_t)count, sizeof(uint8_t))) == NULL)
+      return(1);
+
+   if (!(quiet))
+   {  printf("%-10s %16s %16s %8s\n", "addresses", "reference/sec", "compares/sec", "speedup");
+      fflush(stdout);
+   };
+
+   for(kind = 0; (kind < 4); kind++)
+   {  state = 0x9e3779b97f4a7c15ULL;
+      my_fill(&state, addrs, cidrs, count, kind);
+      base = my_run(my_ref_cmp,       addrs, cidrs, count, rounds);
+      rate = my_run(netcalc_addr_cmp, addrs, cidrs, count, rounds);
+      if (!(quiet))
+      {  printf("%-10s %16.0f %16.0f %7.2fx\n", kinds[kind], base, rate, ((base > 0)) ? rate / base : 0.0);
+         fflush(stdout);
+      };
+   };
+
+   free(addrs);
+   free(cidrs);
+
+   return(0);
+}
+
+
+// generates addresses of kind of comparison, addresses of later kinds share
+// more leading bits as occurs when searching sorted records
+void
+my_fill(
+         uint64_t *                    statep,
+         netcalc_addr_t *              addrs,
+         uint8_t *                     cidrs,
+         long                          count,
+         int                           kind )
+{
+   long              idx;
+   uint64_t          r;
+
+   for(idx = 0; (idx < count); idx++)
+   {  *statep ^= *statep << 13;
+      *statep ^= *statep >> 7;
+      *statep ^= *statep << 17;
+      r = *statep;
+      switch(kind)
+      {  case 1:
+         memset(&addrs[idx], 0, sizeof(netcalc_addr_t));
+         addrs[idx].addr16[0] = htons(0x2001);
+         addrs[idx].addr16[1] = htons(0x0db8);
+         addrs[idx].addr64[1] = r;
+         cidrs[idx]           = (uint8_t)(64 + (r >> 58));
+         break;
+
+         case 2:
+         memset(&addrs[idx], 0, sizeof(netcalc_addr_t));
+         addrs[idx].addr16[0] = htons(0x2001);
+         addrs[idx].addr16[1] = htons(0x0db8);
+         addrs[idx].addr16[7] = (uint16_t)r;
+         cidrs[idx]           = (uint8_t)(112 + ((r >> 16) % 17));
+         break;
+
+         case 3:
+         memset(&addrs[idx], 0, sizeof(netcalc_addr_t));
+         addrs[idx].addr16[5] = 0xffff;
+         addrs[idx].addr32[3] = (uint32_t)r;
+         cidrs[idx]           = (uint8_t)(104 + ((r >> 32) % 25));
+         break;
+
+         default:
+         addrs[idx].addr64[0] = r;
+         addrs[idx].addr64[1] = r * 0x2545f4914f6cdd1dULL;
+         cidrs[idx]           = (uint8_t)((r >> 32) % 129);
+         break;
+      };
+   };
+
+   return;
+}
+
+
+// returns comparisons per second of comparing each address with the next address
+double
+my_run(
+         my_cmp_t                      cmp,
+         const netcalc_addr_t *        addrs,
+         const uint8_t *               cidrs,
+         long                          count,
+         long                          rounds )
+{
+   long              idx;
+   long              round;
+   long              sum;
+   double            elapsed;
+   struct timespec   start;
+   struct timespec   end;
+
+   sum = 0;
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   for(round = 0; (round < rounds); round++)
+      for(idx = 1; (idx < count); idx++)
+         sum += cmp(&addrs[idx-1], cidrs[idx-1], &addrs[idx], cidrs[idx]);
+   clock_gettime(CLOCK_MONOTONIC, &end);
+
+   // result is used so that the comparisons are not removed
+   if ((verbose))
+      printf("   sum of results: %li\n", sum);
+
+   elapsed = (double)(end.tv_sec - start.tv_sec) + ((double)(end.tv_nsec - start.tv_nsec) / 1000000000.0);
+
+   return( (elapsed > 0) ? (double)(rounds * (count - 1)) / elapsed : 0.0 );
+}
+
+
+// previous comparison of addresses, retained as reference
+int
+my_ref_cmp(
+         const netcalc_addr_t *        a1,
+         uint8_t                       c1,
+         const netcalc_addr_t *        a2,
+         uint8_t                       c2 )
+{
+   uint8_t                 cidr;
+   uint32_t                idx8;
+   uint32_t                idx32;
+   uint8_t                 b1;   // byte 1 (32 bits)
+   uint8_t                 b2;   // byte 2 (32 bits)
+   uint32_t                t1;   // tetra 1 (32 bits)
+   uint32_t                t2;   // tetra 2 (32 bits)
+   const netcalc_addr_t *  mask;
+
+   cidr = (c1 < c2) ? c1 : c2;
+   mask = &_netcalc_netmasks[cidr];
+
+   for(idx32 = 0; (idx32 < 4); idx32++)
+   {  t1 = mask->addr32[idx32] & a1->addr32[idx32];
+      t2 = mask->addr32[idx32] & a2->addr32[idx32];
+      if ( t1 != t2 )
+      {  for(idx8 = (idx32*4); (idx8 < ((idx32*4)+4)); idx8++)
+         {  b1 = mask->addr8[idx8] & a1->addr8[idx8];
+            b2 = mask->addr8[idx8] & a2->addr8[idx8];
+            if (b1 < b2)
+               return(NETCALC_CMP_BEFORE);
+            if (b1 > b2)
+               return(NETCALC_CMP_AFTER);
+         };
+      };
+   };
+
+   if (c1 < c2)
+      return(NETCALC_CMP_SUPERNET);
+   if (c2 < c1)
+      return(NETCALC_CMP_SUBNET);
+   return(NETCALC_CMP_SAME);
+}
+
+
+/* end of source */
@@ -0,0 +1,294 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_BENCH_NET_CLASSIFY_C 1
+#include "libnetcalc-tests.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "libnetcalc.h"
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-bench-net-classify"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+double
+my_elapsed(
+         const struct timespec *       start );
+
+
+uint32_t
+my_scan(
+         const netcalc_net_t *         net );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int                     c;
+   int                     opt_index;
+   long                    count;
+   long                    idx;
+   uint32_t                cls;
+   uint64_t                sum;
+   uint64_t                state;
+   double                  elapsed;
+   netcalc_net_t *         hosts;
+   const netcalc_net_t **  ptrs;
+   uint32_t *              classes;
+   struct timespec         start;
+
+   // getopt options
+   static const char *  short_opt = "hn:qVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   count    = 2000000;
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -n num                    number of addresses (default: 2000000)\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'n':
+            count = strtol(optarg, NULL, 0);
+            break;
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+   if (count < 1)
+   {  fprintf(stderr, "%s: invalid option value\n", PROGRAM_NAME);
+      return(1);
+   };
+
+   hosts    = calloc((size_t)count, sizeof(netcalc_net_t));
+   ptrs     = calloc((size_t)count, sizeof(netcalc_net_t *));
+   classes  = calloc((size_t)count, sizeof(uint32_t));
+   if ( (!(hosts)) || (!(ptrs)) || (!(classes)) )
+      return(1);
+
+   // random IPv4 and IPv6 hosts, similar to source addresses of flow records
+   state = 0x9e3779b97f4a7c15ULL;
+   for(idx = 0; (idx < count); idx++)
+   {  state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      hosts[idx].net_cidr = 128;
+      if ((state & 1))
+      {  hosts[idx].net_flags          = NETCALC_AF_INET;
+         hosts[idx].net_addr.addr16[5] = 0xffff;
+         hosts[idx].net_addr.addr32[3] = (uint32_t)(state >> 32);
+      } else
+      {  hosts[idx].net_flags          = NETCALC_AF_INET6;
+         hosts[idx].net_addr.addr64[0] = state;
+         state ^= state << 13;
+         state ^= state >> 7;
+         state ^= state << 17;
+         hosts[idx].net_addr.addr64[1] = state;
+      };
+      ptrs[idx] = &hosts[idx];
+   };
+
+   sum = 0;
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   for(idx = 0; (idx < count); idx++)
+      sum += my_scan(&hosts[idx]);
+   elapsed = my_elapsed(&start);
+   if (!(quiet))
+      printf("%-26s %12.0f  (sum %" PRIu64 ")\n", "registry scan/sec:", (elapsed > 0) ? (double)count / elapsed : 0.0, sum);
+
+   sum = 0;
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   for(idx = 0; (idx < count); idx++)
+   {  netcalc_net_classify(&hosts[idx], &cls);
+      sum += cls;
+   };
+   elapsed = my_elapsed(&start);
+   if (!(quiet))
+      printf("%-26s %12.0f  (sum %" PRIu64 ")\n", "netcalc_net_classify/sec:", (elapsed > 0) ? (double)count / elapsed : 0.0, sum);
+
+   sum = 0;
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   netcalc_net_classify_batch(ptrs, classes, (size_t)count);
+   for(idx = 0; (idx < count); idx++)
+      sum += classes[idx];
+   elapsed = my_elapsed(&start);
+   if (!(quiet))
+      printf("%-26s %12.0f  (sum %" PRIu64 ")\n", "batch classify/sec:", (elapsed > 0) ? (double)count / elapsed : 0.0, sum);
+
+   free(hosts);
+   free(ptrs);
+   free(classes);
+
+   return(0);
+}
+
+
+// returns seconds since start
+double
+my_elapsed(
+         const struct timespec *       start )
+{
+   struct timespec   end;
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   return( (double)(end.tv_sec - start->tv_sec) + ((double)(end.tv_nsec - start->tv_nsec) / 1000000000.0) );
+}
+
+
+// returns categories of address by comparing address with each prefix of registry
+uint32_t
+my_scan(
+         const netcalc_net_t *         net )
+{
+   int                           idx;
+   uint32_t                      cls;
+   netcalc_addr_t                addr;
+   const netcalc_class_pfx_t *   pfx;
+
+   cls = 0;
+   for(pfx = _netcalc_class_registry; ((pfx->pfx_family)); pfx++)
+   {  memset(&addr, 0, sizeof(addr));
+      if (pfx->pfx_family == NETCALC_AF_INET)
+      {  if ((memcmp(net->net_addr.addr8, _netcalc_ipv4_mapped_ipv6.net_addr.addr8, 12)))
+            continue;
+         memcpy(&addr.addr8[12], pfx->pfx_addr, 4);
+         addr.addr16[5] = 0xffff;
+      } else
+      {  if ((net->net_flags & NETCALC_AF) == NETCALC_AF_INET)
+            continue;
+         memcpy(&addr, pfx->pfx_addr, sizeof(addr));
+      };
+      idx = (pfx->pfx_family == NETCALC_AF_INET) ? (pfx->pfx_cidr + 96) : pfx->pfx_cidr;
+      if ( ((net->net_addr.addr64[0] & _netcalc_netmasks[idx].addr64[0]) == addr.addr64[0]) &&
+           ((net->net_addr.addr64[1] & _netcalc_netmasks[idx].addr64[1]) == addr.addr64[1]) )
+         cls |= pfx->pfx_class;
+   };
+
+   return(cls);
+}
+
+
+/* end of source */
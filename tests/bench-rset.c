@@ -0,0 +1,296 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_BENCH_RSET_C 1
+#include "libnetcalc-tests.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <arpa/inet.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "libnetcalc.h"
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-bench-rset"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+double
+my_elapsed(
+         const struct timespec *       start );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               rc;
+   int               opt_index;
+   long              count;
+   long              queries;
+   long              idx;
+   long              hits;
+   size_t            blocks;
+   size_t            len;
+   size_t            size;
+   uint32_t          addr;
+   uint32_t          stride;
+   uint64_t          state;
+   double            elapsed;
+   netcalc_net_t     first;
+   netcalc_net_t     last;
+   netcalc_net_t *   hosts;
+   netcalc_net_t **  nets;
+   netcalc_rset_t *  rs;
+   netcalc_set_t *   ns;
+   struct timespec   start;
+
+   // getopt options
+   static const char *  short_opt = "hn:qr:Vv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   count    = 200000;
+   queries  = 2000000;
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -n num                    number of ranges (default: 200000)\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -r num                    number of queries (default: 2000000)\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'n':
+            count = strtol(optarg, NULL, 0);
+            break;
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'r':
+            queries = strtol(optarg, NULL, 0);
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+   if ( (count < 1) || (count > 0x10000000L) || (queries < 1) )
+   {  fprintf(stderr, "%s: invalid option value\n", PROGRAM_NAME);
+      return(1);
+   };
+
+   if ((rc = netcalc_rset_init(&rs)) != 0)
+   {  fprintf(stderr, "%s: netcalc_rset_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   if ((rc = netcalc_set_init(&ns, NULL, 0)) != 0)
+   {  fprintf(stderr, "%s: netcalc_set_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   if ((hosts = calloc((size_t)queries, sizeof(netcalc_net_t))) == NULL)
+      return(1);
+
+   // sorted ranges of arbitrary length with gaps between ranges, similar to
+   // geolocation data sets of IPv4 addresses
+   memset(&first, 0, sizeof(first));
+   first.net_flags   = NETCALC_AF_INET;
+   first.net_cidr    = 128;
+   first.net_addr.addr16[5] = 0xffff;
+   memcpy(&last, &first, sizeof(last));
+   stride   = (uint32_t)(0xffffffffUL / (unsigned long)count);
+   state    = 0x9e3779b97f4a7c15ULL;
+   addr     = 0;
+   blocks   = 0;
+   for(idx = 0; (idx < count); idx++)
+   {  state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      first.net_addr.addr32[3]   = htonl(addr + (uint32_t)(state % (stride / 4 + 1)));
+      last.net_addr.addr32[3]    = htonl(ntohl(first.net_addr.addr32[3]) + (uint32_t)((state >> 32) % (stride / 2 + 1)));
+      addr                       = ntohl(last.net_addr.addr32[3]) + 1;
+      if ((rc = netcalc_rset_add(rs, &first, &last, NULL, NULL)) != 0)
+      {  fprintf(stderr, "%s: netcalc_rset_add(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         return(1);
+      };
+      if ((rc = netcalc_range_to_cidrs(&first, &last, &nets, &len)) != 0)
+      {  fprintf(stderr, "%s: netcalc_range_to_cidrs(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         return(1);
+      };
+      for(len = 0; ((nets[len])); len++)
+         netcalc_set_add(ns, nets[len], NULL, NULL, 0);
+      blocks += len;
+      netcalc_range_free(nets);
+   };
+
+   // random hosts within the span of the ranges
+   for(idx = 0; (idx < queries); idx++)
+   {  state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      hosts[idx].net_flags          = NETCALC_AF_INET;
+      hosts[idx].net_cidr           = 128;
+      hosts[idx].net_addr.addr16[5] = 0xffff;
+      hosts[idx].net_addr.addr32[3] = htonl((uint32_t)(state % addr));
+   };
+
+   netcalc_rset_stats(rs, &len, &size);
+   if (!(quiet))
+   {  printf("%-22s %12zu\n",  "ranges:",               len);
+      printf("%-22s %12zu\n",  "CIDR blocks:",          blocks);
+      printf("%-22s %11.2fx\n", "blocks per range:",     (double)blocks / (double)len);
+      printf("%-22s %12zu\n",  "range set bytes:",      size);
+      printf("%-22s %12zu\n",  "range set bytes/range:", size / len);
+      fflush(stdout);
+   };
+
+   hits = 0;
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   for(idx = 0; (idx < queries); idx++)
+      hits += (netcalc_rset_query(rs, &hosts[idx], NULL, NULL, NULL, NULL) == 0) ? 1 : 0;
+   elapsed = my_elapsed(&start);
+   if (!(quiet))
+      printf("%-22s %12.0f  (%li hits)\n", "range set queries/sec:", (elapsed > 0) ? (double)queries / elapsed : 0.0, hits);
+
+   hits = 0;
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   for(idx = 0; (idx < queries); idx++)
+      hits += (netcalc_set_query(ns, &hosts[idx], NULL, NULL, NULL, NULL) == 0) ? 1 : 0;
+   elapsed = my_elapsed(&start);
+   if (!(quiet))
+      printf("%-22s %12.0f  (%li hits)\n", "CIDR set queries/sec:", (elapsed > 0) ? (double)queries / elapsed : 0.0, hits);
+
+   netcalc_rset_free(rs);
+   netcalc_set_free(ns);
+   free(hosts);
+
+   return(0);
+}
+
+
+// returns seconds since start
+double
+my_elapsed(
+         const struct timespec *       start )
+{
+   struct timespec   end;
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   return( (double)(end.tv_sec - start->tv_sec) + ((double)(end.tv_nsec - start->tv_nsec) / 1000000000.0) );
+}
+
+
+/* end of source */
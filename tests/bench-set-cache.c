@@ -0,0 +1,383 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_BENCH_SET_CACHE_C 1
+#include "libnetcalc-tests.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-bench-set-cache"
+
+#define MY_KEYS         65536
+#define MY_STREAM       1048576
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+netcalc_net_t *
+my_net(
+         unsigned *                    seedp,
+         int                           prefix );
+
+
+double
+my_run(
+         netcalc_set_t *               ns,
+         netcalc_net_t **              keys,
+         const size_t *                stream,
+         long                          queries );
+
+
+int
+my_zipf(
+         size_t *                      stream,
+         size_t                        nkeys,
+         double                        exponent );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               rc;
+   int               opt_index;
+   long              idx;
+   long              count;
+   long              nkeys;
+   long              queries;
+   long              maxsize;
+   long              size;
+   unsigned          seed;
+   double            exponent;
+   double            rate;
+   double            base;
+   uintmax_t         hits;
+   uintmax_t         misses;
+   size_t *          stream;
+   netcalc_set_t *   ns;
+   netcalc_net_t *   net;
+   netcalc_net_t **  keys;
+
+   // getopt options
+   static const char *  short_opt = "c:hk:n:Q:qs:Vv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   count       = 100000;
+   nkeys       = MY_KEYS;
+   queries     = 4000000;
+   maxsize     = 65536;
+   exponent    = 1.0;
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'c':
+            maxsize = strtol(optarg, NULL, 0);
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -c num                    maximum number of cache entries (default: 65536)\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -k num                    number of distinct networks queried (default: %i)\n", MY_KEYS);
+            printf("  -n num                    number of records in set (default: 100000)\n");
+            printf("  -Q num                    number of queries of each run (default: 4000000)\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -s num                    exponent of Zipf distribution of queries (default: 1.0)\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'k':
+            nkeys = strtol(optarg, NULL, 0);
+            break;
+
+         case 'n':
+            count = strtol(optarg, NULL, 0);
+            break;
+
+         case 'Q':
+            queries = strtol(optarg, NULL, 0);
+            break;
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 's':
+            exponent = strtod(optarg, NULL);
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+   if ( (count < 1) || (nkeys < 1) || (nkeys > MY_KEYS) || (queries < 1) || (maxsize < 0) || (exponent < 0) )
+   {  fprintf(stderr, "%s: invalid option value\n", PROGRAM_NAME);
+      return(1);
+   };
+
+   // build set of random networks
+   seed = 1;
+   if ((rc = netcalc_set_init(&ns, NULL, 0)) != 0)
+   {  fprintf(stderr, "%s: netcalc_set_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   for(idx = 0; (idx < count); idx++)
+   {  if ((net = my_net(&seed, 1)) == NULL)
+         continue;
+      netcalc_set_add(ns, net, NULL, NULL, 0);
+      netcalc_net_free(net);
+   };
+
+   // generate query keys which match records of the set
+   if ((keys = calloc((size_t)nkeys, sizeof(netcalc_net_t *))) == NULL)
+      return(1);
+   for(idx = 0; (idx < nkeys); idx++)
+   {  if ((idx % count) == 0)
+         seed = 1;
+      if ((keys[idx] = my_net(&seed, 1)) == NULL)
+      {  fprintf(stderr, "%s: unable to generate query keys\n", PROGRAM_NAME);
+         return(1);
+      };
+   };
+
+   // generate stream of queries in which the popularity of keys follows Zipf's law
+   if ((stream = calloc(MY_STREAM, sizeof(size_t))) == NULL)
+      return(1);
+   if ((my_zipf(stream, (size_t)nkeys, exponent)))
+      return(1);
+
+   if (!(quiet))
+   {  printf("%-8s %14s %9s %8s\n", "entries", "queries/sec", "hit ratio", "speedup");
+      fflush(stdout);
+   };
+
+   // run benchmark without cache and with quadrupling number of entries
+   base = 0;
+   for(size = 0; (size <= maxsize); size = ((size)) ? size * 4 : 1024)
+   {  if ((rc = netcalc_set_cache(ns, (size_t)size)) != 0)
+      {  fprintf(stderr, "%s: netcalc_set_cache(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         return(1);
+      };
+      rate = my_run(ns, keys, stream, queries);
+      base = ((base > 0)) ? base : rate;
+      netcalc_set_cache_stats(ns, NULL, &hits, &misses);
+      if (!(quiet))
+      {  printf("%-8li %14.0f %8.1f%% %7.2fx\n", size, rate, ((hits + misses)) ? (double)hits * 100.0 / (double)(hits + misses) : 0.0, rate / base);
+         fflush(stdout);
+      };
+   };
+
+   free(stream);
+   for(idx = 0; (idx < nkeys); idx++)
+      netcalc_net_free(keys[idx]);
+   free(keys);
+   netcalc_set_free(ns);
+
+   return(0);
+}
+
+
+// generates random IPv4 or IPv6 network or address
+netcalc_net_t *
+my_net(
+         unsigned *                    seedp,
+         int                           prefix )
+{
+   unsigned          r;
+   netcalc_net_t *   net;
+   char              str[64];
+
+   r = (unsigned)rand_r(seedp);
+   if ((r & 1))
+      snprintf(str, sizeof(str), "%u.%u.%u.%u%s", (r >> 1) & 0xff, (r >> 9) & 0xff, (r >> 17) & 0xff, ((prefix)) ? 0 : ((unsigned)rand_r(seedp) & 0xff), ((prefix)) ? "/24" : "");
+   else
+      snprintf(str, sizeof(str), "2001:db8:%x:%x::%x%s", (r >> 1) & 0xffff, (unsigned)rand_r(seedp) & 0xffff, ((prefix)) ? 0 : ((unsigned)rand_r(seedp) & 0xffff), ((prefix)) ? "/64" : "");
+
+   if (netcalc_net_init(&net, str, 0) != 0)
+      return(NULL);
+
+   return(net);
+}
+
+
+// returns queries per second of querying the set
+double
+my_run(
+         netcalc_set_t *               ns,
+         netcalc_net_t **              keys,
+         const size_t *                stream,
+         long                          queries )
+{
+   long              idx;
+   double            elapsed;
+   struct timespec   start;
+   struct timespec   end;
+
+   clock_gettime(CLOCK_MONOTONIC, &start);
+   for(idx = 0; (idx < queries); idx++)
+      netcalc_set_query(ns, keys[stream[idx % MY_STREAM]], NULL, NULL, NULL, NULL);
+   clock_gettime(CLOCK_MONOTONIC, &end);
+
+   elapsed = (double)(end.tv_sec - start.tv_sec) + ((double)(end.tv_nsec - start.tv_nsec) / 1000000000.0);
+
+   return( (elapsed > 0) ? (double)queries / elapsed : 0.0 );
+}
+
+
+// fills stream with indexes of keys drawn from a Zipf distribution
+int
+my_zipf(
+         size_t *                      stream,
+         size_t                        nkeys,
+         double                        exponent )
+{
+   size_t            idx;
+   size_t            low;
+   size_t            high;
+   size_t            mid;
+   unsigned          seed;
+   double            r;
+   double *          cdf;
+
+   if ((cdf = malloc(sizeof(double) * nkeys)) == NULL)
+      return(1);
+   cdf[0] = 1.0;
+   for(idx = 1; (idx < nkeys); idx++)
+      cdf[idx] = cdf[idx-1] + (1.0 / pow((double)(idx + 1), exponent));
+
+   seed = 3;
+   for(idx = 0; (idx < MY_STREAM); idx++)
+   {  r     = ((double)rand_r(&seed) / (double)RAND_MAX) * cdf[nkeys-1];
+      low   = 0;
+      high  = nkeys - 1;
+      while(low < high)
+      {  mid = low + ((high - low) / 2);
+         if (cdf[mid] < r)
+            low = mid + 1;
+         else
+            high = mid;
+      };
+      stream[idx] = low;
+   };
+
+   free(cdf);
+
+   return(0);
+}
+
+
+/* end of source */
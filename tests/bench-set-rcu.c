@@ -0,0 +1,401 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_BENCH_SET_RCU_C 1
+#include "libnetcalc-tests.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-bench-set-rcu"
+
+#define MY_KEYS         65536
+
+
+//////////////////
+//              //
+//  Data Types  //
+//              //
+//////////////////
+// MARK: - Data Types
+
+typedef struct _my_bench my_bench_t;
+struct _my_bench
+{  netcalc_rcu_t *      rcu;
+   netcalc_net_t **     keys;
+   atomic_int           stop;
+   int                  __pad;
+   atomic_size_t        queries;
+   atomic_size_t        commits;
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+netcalc_net_t *
+my_net(
+         unsigned *                    seedp,
+         int                           prefix );
+
+
+void *
+my_reader(
+         void *                        arg );
+
+
+void *
+my_writer(
+         void *                        arg );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               rc;
+   int               opt_index;
+   int               idx;
+   int               readers;
+   int               maxreaders;
+   long              duration;
+   long              count;
+   unsigned          seed;
+   double            rate;
+   double            base;
+   netcalc_set_t *   ns;
+   netcalc_net_t *   net;
+   pthread_t         writer;
+   pthread_t *       threads;
+   my_bench_t        bench;
+   struct timespec   ts;
+
+   // getopt options
+   static const char *  short_opt = "d:hn:qr:Vv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   duration    = 1000;
+   count       = 100000;
+   maxreaders  = 8;
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'd':
+            duration = strtol(optarg, NULL, 0);
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -d msec                   duration of each run (default: 1000)\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -n num                    number of records in set (default: 100000)\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -r num                    maximum number of reader threads (default: 8)\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'n':
+            count = strtol(optarg, NULL, 0);
+            break;
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'r':
+            maxreaders = (int)strtol(optarg, NULL, 0);
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+   if ( (duration < 1) || (count < 1) || (maxreaders < 1) )
+   {  fprintf(stderr, "%s: invalid option value\n", PROGRAM_NAME);
+      return(1);
+   };
+
+   // build set of random networks
+   seed = 1;
+   if ((rc = netcalc_set_init(&ns, NULL, 0)) != 0)
+   {  fprintf(stderr, "%s: netcalc_set_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   for(idx = 0; (idx < count); idx++)
+   {  if ((net = my_net(&seed, 1)) == NULL)
+         continue;
+      netcalc_set_add(ns, net, NULL, NULL, 0);
+      netcalc_net_free(net);
+   };
+
+   // generate query keys
+   memset(&bench, 0, sizeof(bench));
+   if ((bench.keys = calloc(MY_KEYS, sizeof(netcalc_net_t *))) == NULL)
+   {  netcalc_set_free(ns);
+      return(1);
+   };
+   for(idx = 0; (idx < MY_KEYS); idx++)
+   {  if ((bench.keys[idx] = my_net(&seed, 0)) == NULL)
+      {  fprintf(stderr, "%s: unable to generate query keys\n", PROGRAM_NAME);
+         return(1);
+      };
+   };
+
+   if ((rc = netcalc_rcu_init(&bench.rcu, ns, maxreaders)) != 0)
+   {  fprintf(stderr, "%s: netcalc_rcu_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      return(1);
+   };
+   if ((threads = calloc((size_t)maxreaders, sizeof(pthread_t))) == NULL)
+   {  netcalc_rcu_free(bench.rcu);
+      return(1);
+   };
+
+   if (!(quiet))
+   {  printf("%-8s %14s %8s %8s\n", "readers", "queries/sec", "scaling", "commits");
+      fflush(stdout);
+   };
+
+   // run benchmark with doubling number of readers while writer publishes versions
+   base = 0;
+   for(readers = 1; (readers <= maxreaders); readers *= 2)
+   {  atomic_store(&bench.stop, 0);
+      atomic_store(&bench.queries, 0);
+      atomic_store(&bench.commits, 0);
+
+      pthread_create(&writer, NULL, &my_writer, &bench);
+      for(idx = 0; (idx < readers); idx++)
+         pthread_create(&threads[idx], NULL, &my_reader, &bench);
+
+      ts.tv_sec  = duration / 1000;
+      ts.tv_nsec = (duration % 1000) * 1000000;
+      nanosleep(&ts, NULL);
+      atomic_store(&bench.stop, 1);
+
+      for(idx = 0; (idx < readers); idx++)
+         pthread_join(threads[idx], NULL);
+      pthread_join(writer, NULL);
+
+      rate = (double)atomic_load(&bench.queries) * 1000.0 / (double)duration;
+      base = ((base > 0)) ? base : rate;
+      if (!(quiet))
+      {  printf("%-8i %14.0f %7.2fx %8zu\n", readers, rate, rate / base, atomic_load(&bench.commits));
+         fflush(stdout);
+      };
+   };
+
+   free(threads);
+   for(idx = 0; (idx < MY_KEYS); idx++)
+      netcalc_net_free(bench.keys[idx]);
+   free(bench.keys);
+   netcalc_rcu_free(bench.rcu);
+
+   return(0);
+}
+
+
+// generates random IPv4 or IPv6 network or address
+netcalc_net_t *
+my_net(
+         unsigned *                    seedp,
+         int                           prefix )
+{
+   unsigned          r;
+   netcalc_net_t *   net;
+   char              str[64];
+
+   r = (unsigned)rand_r(seedp);
+   if ((r & 1))
+      snprintf(str, sizeof(str), "%u.%u.%u.%u%s", (r >> 1) & 0xff, (r >> 9) & 0xff, (r >> 17) & 0xff, ((prefix)) ? 0 : ((unsigned)rand_r(seedp) & 0xff), ((prefix)) ? "/24" : "");
+   else
+      snprintf(str, sizeof(str), "2001:db8:%x:%x::%x%s", (r >> 1) & 0xffff, (unsigned)rand_r(seedp) & 0xffff, ((prefix)) ? 0 : ((unsigned)rand_r(seedp) & 0xffff), ((prefix)) ? "/64" : "");
+
+   if (netcalc_net_init(&net, str, 0) != 0)
+      return(NULL);
+
+   return(net);
+}
+
+
+void *
+my_reader(
+         void *                        arg )
+{
+   int               id;
+   size_t            idx;
+   size_t            queries;
+   netcalc_set_t *   ns;
+   my_bench_t *      bench;
+
+   bench = arg;
+   if (netcalc_rcu_register(bench->rcu, &id) != 0)
+      return(NULL);
+
+   queries = 0;
+   for(idx = (size_t)id * 7919; (!(atomic_load_explicit(&bench->stop, memory_order_relaxed))); idx++)
+   {  ns = netcalc_rcu_read_lock(bench->rcu, id);
+      netcalc_set_query(ns, bench->keys[idx % MY_KEYS], NULL, NULL, NULL, NULL);
+      netcalc_rcu_read_unlock(bench->rcu, id);
+      queries++;
+   };
+   atomic_fetch_add(&bench->queries, queries);
+
+   netcalc_rcu_unregister(bench->rcu, id);
+
+   return(NULL);
+}
+
+
+// continuously publishes versions alternately adding and deleting a network
+void *
+my_writer(
+         void *                        arg )
+{
+   int               add;
+   unsigned          seed;
+   netcalc_set_t *   ns;
+   netcalc_net_t *   net;
+   my_bench_t *      bench;
+
+   bench = arg;
+   seed  = 2;
+   net   = NULL;
+   for(add = 1; (!(atomic_load(&bench->stop))); add = !(add))
+   {  if ( ((add)) && ((net = my_net(&seed, 1)) == NULL) )
+         continue;
+      if (netcalc_rcu_begin(bench->rcu, &ns) != 0)
+         continue;
+      if ((add))
+         netcalc_set_add(ns, net, NULL, NULL, 0);
+      else
+         netcalc_set_del(ns, net);
+      if (netcalc_rcu_commit(bench->rcu, ns) != 0)
+         netcalc_rcu_abort(bench->rcu, ns);
+      else
+         atomic_fetch_add(&bench->commits, 1);
+      if (!(add))
+      {  netcalc_net_free(net);
+         net = NULL;
+      };
+   };
+   if ((net))
+      netcalc_net_free(net);
+
+   return(NULL);
+}
+
+
+/* end of source */
@@ -0,0 +1,301 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_BENCH_SMALLSET_C 1
+#include "libnetcalc-tests.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "libnetcalc.h"
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-bench-smallset"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+double
+my_elapsed(
+         const struct timespec *       start );
+
+
+double
+my_rate(
+         long                          queries,
+         double                        elapsed );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int                     c;
+   int                     rc;
+   int                     opt_index;
+   long                    queries;
+   long                    idx;
+   long                    hits[3];
+   size_t                  pos;
+   size_t                  nel;
+   size_t                  match;
+   uint64_t                state;
+   uint32_t                bases[4];
+   double                  elapsed[3];
+   netcalc_net_t           nets[NETCALC_SMALLSET_MAX];
+   const netcalc_net_t *   ptrs[NETCALC_SMALLSET_MAX];
+   netcalc_net_t *         hosts;
+   netcalc_set_t *         ns;
+   netcalc_smallset_t *    ss;
+   struct timespec         start;
+
+   // getopt options
+   static const char *  short_opt = "hqr:Vv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   queries  = 2000000;
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -r num                    number of queries (default: 2000000)\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'r':
+            queries = strtol(optarg, NULL, 0);
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+   if (queries < 1)
+   {  fprintf(stderr, "%s: invalid option value\n", PROGRAM_NAME);
+      return(1);
+   };
+
+   if ((hosts = calloc((size_t)queries, sizeof(netcalc_net_t))) == NULL)
+      return(1);
+
+   // policies of IPv4 prefixes within a few address blocks, similar to
+   // access lists applied to each packet
+   state = 0x9e3779b97f4a7c15ULL;
+   for(pos = 0; (pos < 4); pos++)
+   {  state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      bases[pos] = (uint32_t)state;
+   };
+
+   // random hosts, most of which are within the address blocks of policies
+   memset(nets, 0, sizeof(nets));
+   for(idx = 0; (idx < queries); idx++)
+   {  state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      hosts[idx].net_flags          = NETCALC_AF_INET;
+      hosts[idx].net_cidr           = 128;
+      hosts[idx].net_addr.addr16[5] = 0xffff;
+      hosts[idx].net_addr.addr32[3] = ((state & 3) != 0) ? (bases[(state >> 2) & 3] ^ (uint32_t)((state >> 32) & 0xfffff)) : (uint32_t)(state >> 32);
+   };
+
+   if (!(quiet))
+   {  printf("%-9s %16s %16s %16s\n", "networks", "smallset/sec", "scalar/sec", "set/sec");
+      fflush(stdout);
+   };
+
+   for(nel = 8; (nel <= NETCALC_SMALLSET_MAX); nel *= 2)
+   {  if ((rc = netcalc_set_init(&ns, NULL, 0)) != 0)
+      {  fprintf(stderr, "%s: netcalc_set_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         return(1);
+      };
+      for(pos = 0; (pos < nel); pos++)
+      {  state ^= state << 13;
+         state ^= state >> 7;
+         state ^= state << 17;
+         nets[pos].net_flags          = NETCALC_AF_INET;
+         nets[pos].net_cidr           = (uint8_t)(104 + (state >> 8) % 25);
+         nets[pos].net_addr.addr16[5] = 0xffff;
+         nets[pos].net_addr.addr32[3] = (bases[state & 3] ^ (uint32_t)((state >> 32) & 0xfffff)) & _netcalc_netmasks[nets[pos].net_cidr].addr32[3];
+         ptrs[pos]                    = &nets[pos];
+         netcalc_set_add(ns, &nets[pos], NULL, NULL, 0);
+      };
+      if ((rc = netcalc_smallset_init(&ss, ptrs, nel)) != 0)
+      {  fprintf(stderr, "%s: netcalc_smallset_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         return(1);
+      };
+
+      hits[0] = 0;
+      clock_gettime(CLOCK_MONOTONIC, &start);
+      for(idx = 0; (idx < queries); idx++)
+         hits[0] += (netcalc_smallset_query(ss, &hosts[idx], &match) == 0) ? 1 : 0;
+      elapsed[0] = my_elapsed(&start);
+
+      hits[1] = 0;
+      ss->ss_match = netcalc_smallset_match_scalar;
+      clock_gettime(CLOCK_MONOTONIC, &start);
+      for(idx = 0; (idx < queries); idx++)
+         hits[1] += (netcalc_smallset_query(ss, &hosts[idx], &match) == 0) ? 1 : 0;
+      elapsed[1] = my_elapsed(&start);
+
+      hits[2] = 0;
+      clock_gettime(CLOCK_MONOTONIC, &start);
+      for(idx = 0; (idx < queries); idx++)
+         hits[2] += (netcalc_set_query(ns, &hosts[idx], NULL, NULL, NULL, NULL) == 0) ? 1 : 0;
+      elapsed[2] = my_elapsed(&start);
+
+      if (!(quiet))
+      {  printf("%-9zu %16.0f %16.0f %16.0f", nel, my_rate(queries, elapsed[0]), my_rate(queries, elapsed[1]), my_rate(queries, elapsed[2]));
+         if ( (hits[0] != hits[1]) || (hits[0] != hits[2]) )
+            printf("  (hits %li/%li/%li)", hits[0], hits[1], hits[2]);
+         printf("\n");
+      };
+
+      netcalc_smallset_free(ss);
+      netcalc_set_free(ns);
+   };
+
+   free(hosts);
+
+   return(0);
+}
+
+
+// returns seconds since start
+double
+my_elapsed(
+         const struct timespec *       start )
+{
+   struct timespec   end;
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   return( (double)(end.tv_sec - start->tv_sec) + ((double)(end.tv_nsec - start->tv_nsec) / 1000000000.0) );
+}
+
+
+// returns queries per second
+double
+my_rate(
+         long                          queries,
+         double                        elapsed )
+{
+   return( (elapsed > 0) ? (double)queries / elapsed : 0.0 );
+}
+
+
+/* end of source */
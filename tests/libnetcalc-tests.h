@@ -85,6 +85,13 @@
 /////////////////
 #pragma mark - Datatypes
 
+typedef struct _test_free testfree_t;
+struct _test_free
+{  const char *      free_net;
+   const char **     free_exp;
+};
+
+
 typedef struct _test_query testquery_t;
 struct _test_query
 {  const char *      query_addr;
@@ -128,6 +135,7 @@ extern testdata_t             test_data[];
 extern const char *           test_set1[];
 
 extern const char *           test_set2[];
+extern const testfree_t       test_free2[];
 extern const testquery_t      test_query2[];
 
 #endif /* end of header */
@@ -0,0 +1,344 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_ADDR_CMP_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libnetcalc.h"
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-addr-cmp"
+
+#define MY_BASES        8
+#define MY_RANDOM       2000000
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_check(
+         const netcalc_addr_t *        a1,
+         uint8_t                       c1,
+         const netcalc_addr_t *        a2,
+         uint8_t                       c2 );
+
+
+void
+my_random(
+         uint64_t *                    statep,
+         netcalc_addr_t *              addr );
+
+
+int
+my_ref_cmp(
+         const netcalc_addr_t *        a1,
+         uint8_t                       c1,
+         const netcalc_addr_t *        a2,
+         uint8_t                       c2 );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   int               base;
+   int               bit;
+   int               pos;
+   unsigned          c1;
+   unsigned          c2;
+   long              idx;
+   size_t            errs;
+   size_t            checks;
+   uint64_t          state;
+   netcalc_addr_t    a1;
+   netcalc_addr_t    a2;
+   netcalc_addr_t    noise;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs   = 0;
+   checks = 0;
+   state  = 0x9e3779b97f4a7c15ULL;
+
+   // exhaustively compares addresses which first differ at each bit with
+   // each pair of prefix lengths, bits after the first difference are random
+   if (!(quiet))
+      printf("comparing addresses differing at each bit with each prefix length ...\n");
+   for(base = 0; (base < MY_BASES); base++)
+   {  if ((verbose))
+         printf("   base pattern %i ...\n", base);
+      switch(base)
+      {  case 0:  memset(&a1, 0x00, sizeof(a1)); break;
+         case 1:  memset(&a1, 0xff, sizeof(a1)); break;
+         case 2:  memset(&a1, 0xaa, sizeof(a1)); break;
+         case 3:  memset(&a1, 0x55, sizeof(a1)); break;
+         default: my_random(&state, &a1); break;
+      };
+      for(bit = 0; (bit <= 128); bit++)
+      {  a2 = a1;
+         if (bit < 128)
+         {  my_random(&state, &noise);
+            a2.addr8[bit/8] ^= (uint8_t)(0x80 >> (bit%8));
+            for(pos = bit + 1; (pos < 128); pos++)
+               if ((noise.addr8[pos/8] & (0x80 >> (pos%8))))
+                  a2.addr8[pos/8] ^= (uint8_t)(0x80 >> (pos%8));
+         };
+         for(c1 = 0; (c1 <= 128); c1++)
+         {  for(c2 = 0; (c2 <= 128); c2++)
+            {  checks++;
+               if ((my_check(&a1, (uint8_t)c1, &a2, (uint8_t)c2)))
+                  errs++;
+               if (errs > 10)
+                  return(1);
+            };
+         };
+      };
+   };
+
+   // compares random pairs of addresses with random prefix lengths
+   if (!(quiet))
+      printf("comparing random addresses ...\n");
+   for(idx = 0; (idx < MY_RANDOM); idx++)
+   {  my_random(&state, &a1);
+      my_random(&state, &a2);
+      if ((idx & 1))
+         memcpy(a2.addr8, a1.addr8, (size_t)(state % 16));
+      c1 = (unsigned)((state >> 8)  % 129);
+      c2 = (unsigned)((state >> 24) % 129);
+      checks++;
+      if ((my_check(&a1, (uint8_t)c1, &a2, (uint8_t)c2)))
+         errs++;
+      if (errs > 10)
+         return(1);
+   };
+
+   if (!(quiet))
+      printf("%zu comparisons, %zu errors\n", checks, errs);
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// compares result of both argument orders against reference comparison
+int
+my_check(
+         const netcalc_addr_t *        a1,
+         uint8_t                       c1,
+         const netcalc_addr_t *        a2,
+         uint8_t                       c2 )
+{
+   int               rc;
+   int               ref;
+   int               pos;
+   char              s1[40];
+   char              s2[40];
+
+   rc  = netcalc_addr_cmp(a1, c1, a2, c2);
+   ref = my_ref_cmp(a1, c1, a2, c2);
+   if ( (rc == ref) && (netcalc_addr_cmp(a2, c2, a1, c1) == -ref) )
+      return(0);
+
+   if (!(quiet))
+   {  for(pos = 0; (pos < 16); pos++)
+      {  snprintf(&s1[pos*2], sizeof(s1) - (size_t)(pos*2), "%02x", a1->addr8[pos]);
+         snprintf(&s2[pos*2], sizeof(s2) - (size_t)(pos*2), "%02x", a2->addr8[pos]);
+      };
+      printf("   %s/%u <=> %s/%u: returned %i %i; expected %i %i\n", s1, c1, s2, c2, netcalc_addr_cmp(a1, c1, a2, c2), netcalc_addr_cmp(a2, c2, a1, c1), ref, -ref);
+   };
+
+   return(1);
+}
+
+
+// fills address with random bytes
+void
+my_random(
+         uint64_t *                    statep,
+         netcalc_addr_t *              addr )
+{
+   int               idx;
+   for(idx = 0; (idx < 2); idx++)
+   {  *statep ^= *statep << 13;
+      *statep ^= *statep >> 7;
+      *statep ^= *statep << 17;
+      addr->addr64[idx] = *statep;
+   };
+   return;
+}
+
+
+// previous comparison of addresses, retained as reference
+int
+my_ref_cmp(
+         const netcalc_addr_t *        a1,
+         uint8_t                       c1,
+         const netcalc_addr_t *        a2,
+         uint8_t                       c2 )
+{
+   uint8_t                 cidr;
+   uint32_t                idx8;
+   uint32_t                idx32;
+   uint8_t                 b1;   // byte 1 (32 bits)
+   uint8_t                 b2;   // byte 2 (32 bits)
+   uint32_t                t1;   // tetra 1 (32 bits)
+   uint32_t                t2;   // tetra 2 (32 bits)
+   const netcalc_addr_t *  mask;
+
+   cidr = (c1 < c2) ? c1 : c2;
+   mask = &_netcalc_netmasks[cidr];
+
+   for(idx32 = 0; (idx32 < 4); idx32++)
+   {  t1 = mask->addr32[idx32] & a1->addr32[idx32];
+      t2 = mask->addr32[idx32] & a2->addr32[idx32];
+      if ( t1 != t2 )
+      {  for(idx8 = (idx32*4); (idx8 < ((idx32*4)+4)); idx8++)
+         {  b1 = mask->addr8[idx8] & a1->addr8[idx8];
+            b2 = mask->addr8[idx8] & a2->addr8[idx8];
+            if (b1 < b2)
+               return(NETCALC_CMP_BEFORE);
+            if (b1 > b2)
+               return(NETCALC_CMP_AFTER);
+         };
+      };
+   };
+
+   if (c1 < c2)
+      return(NETCALC_CMP_SUPERNET);
+   if (c2 < c1)
+      return(NETCALC_CMP_SUBNET);
+   return(NETCALC_CMP_SAME);
+}
+
+
+/* end of source */
@@ -0,0 +1,429 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_NET_CLASSIFY_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libnetcalc.h"
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-net-classify"
+
+#define MY_BATCH     1024
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+// MARK: - Datatypes
+
+typedef struct _my_test my_test_t;
+
+
+struct _my_test
+{  const char *            address;
+   int                     rc;
+   uint32_t                cls;
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_random(
+         size_t                        count );
+
+
+uint32_t
+my_reference(
+         const netcalc_net_t *         net );
+
+
+int
+my_test(
+         const my_test_t *             test );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+static const my_test_t my_tests[] =
+{  { "0.0.0.0",                  0,                NETCALC_CLASS_UNSPECIFIED },
+   { "0.255.255.255",            0,                NETCALC_CLASS_UNSPECIFIED },
+   { "1.0.0.0",                  0,                0 },
+   { "8.8.8.8",                  0,                0 },
+   { "10.20.30.40",              0,                NETCALC_CLASS_PRIVATE },
+   { "100.63.255.255",           0,                0 },
+   { "100.64.0.0",               0,                NETCALC_CLASS_SHARED },
+   { "100.127.255.255",          0,                NETCALC_CLASS_SHARED },
+   { "100.128.0.0",              0,                0 },
+   { "127.0.0.1",                0,                NETCALC_CLASS_LOOPBACK },
+   { "169.254.1.1",              0,                NETCALC_CLASS_LINK_LOCAL },
+   { "172.15.255.255",           0,                0 },
+   { "172.16.0.0",               0,                NETCALC_CLASS_PRIVATE },
+   { "172.31.255.255",           0,                NETCALC_CLASS_PRIVATE },
+   { "172.32.0.0",               0,                0 },
+   { "192.0.0.1",                0,                NETCALC_CLASS_PROTOCOL | NETCALC_CLASS_TRANSITION },
+   { "192.0.0.8",                0,                NETCALC_CLASS_PROTOCOL },
+   { "192.0.1.1",                0,                0 },
+   { "192.0.2.1",                0,                NETCALC_CLASS_DOCUMENTATION },
+   { "192.31.196.1",             0,                NETCALC_CLASS_AS112 },
+   { "192.88.99.1",              0,                NETCALC_CLASS_TRANSITION },
+   { "192.168.1.1/24",           0,                NETCALC_CLASS_PRIVATE },
+   { "192.175.48.6",             0,                NETCALC_CLASS_AS112 },
+   { "198.17.255.255",           0,                0 },
+   { "198.19.255.255",           0,                NETCALC_CLASS_BENCHMARK },
+   { "198.20.0.0",               0,                0 },
+   { "198.51.100.7",             0,                NETCALC_CLASS_DOCUMENTATION },
+   { "203.0.113.9",              0,                NETCALC_CLASS_DOCUMENTATION },
+   { "224.0.0.251",              0,                NETCALC_CLASS_MULTICAST },
+   { "239.255.255.255",          0,                NETCALC_CLASS_MULTICAST },
+   { "240.0.0.1",                0,                NETCALC_CLASS_RESERVED },
+   { "255.255.255.254",          0,                NETCALC_CLASS_RESERVED },
+   { "255.255.255.255",          0,                NETCALC_CLASS_RESERVED | NETCALC_CLASS_BROADCAST },
+   { "::",                       0,                NETCALC_CLASS_UNSPECIFIED },
+   { "::1",                      0,                NETCALC_CLASS_LOOPBACK },
+   { "::2",                      0,                0 },
+   { "::ffff:8.8.8.8",           0,                NETCALC_CLASS_IPV4_MAPPED },
+   { "::ffff:10.0.0.1",          0,                NETCALC_CLASS_IPV4_MAPPED | NETCALC_CLASS_PRIVATE },
+   { "::ffff:255.255.255.255",   0,                NETCALC_CLASS_IPV4_MAPPED | NETCALC_CLASS_RESERVED | NETCALC_CLASS_BROADCAST },
+   { "::fffe:10.0.0.1",          0,                0 },
+   { "64:ff9b::8.8.8.8",         0,                NETCALC_CLASS_TRANSITION },
+   { "64:ff9b:1::1",             0,                NETCALC_CLASS_TRANSITION },
+   { "64:ff9b:2::1",             0,                0 },
+   { "100::1",                   0,                NETCALC_CLASS_DISCARD },
+   { "100:0:0:1::1",             0,                0 },
+   { "2001::1",                  0,                NETCALC_CLASS_PROTOCOL | NETCALC_CLASS_TRANSITION },
+   { "2001:2::1",                0,                NETCALC_CLASS_PROTOCOL | NETCALC_CLASS_BENCHMARK },
+   { "2001:4:112::1",            0,                NETCALC_CLASS_PROTOCOL | NETCALC_CLASS_AS112 },
+   { "2001:1ff::1",              0,                NETCALC_CLASS_PROTOCOL },
+   { "2001:200::1",              0,                0 },
+   { "2001:db8::1",              0,                NETCALC_CLASS_DOCUMENTATION },
+   { "2001:db9::1",              0,                0 },
+   { "2002:c000:0204::1",        0,                NETCALC_CLASS_TRANSITION },
+   { "2606:4700::1111",          0,                0 },
+   { "2620:4f:8000::1",          0,                NETCALC_CLASS_AS112 },
+   { "3fff::1",                  0,                NETCALC_CLASS_DOCUMENTATION },
+   { "3fff:fff:ffff::1",         0,                NETCALC_CLASS_DOCUMENTATION },
+   { "3fff:1000::1",             0,                0 },
+   { "fbff::1",                  0,                0 },
+   { "fc00::1",                  0,                NETCALC_CLASS_UNIQUE_LOCAL },
+   { "fdff:ffff::1",             0,                NETCALC_CLASS_UNIQUE_LOCAL },
+   { "fe80::1%eth0",             0,                NETCALC_CLASS_LINK_LOCAL },
+   { "febf::1",                  0,                NETCALC_CLASS_LINK_LOCAL },
+   { "fec0::1",                  0,                0 },
+   { "ff02::1",                  0,                NETCALC_CLASS_MULTICAST },
+   { "00:00:5e:00:53:01",        NETCALC_ENOTSUP,  0 },
+   { NULL,                       0,                0 }
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   size_t            idx;
+   size_t            errs;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   // categories of known addresses
+   for(idx = 0; ((my_tests[idx].address)); idx++)
+      errs += (size_t)my_test(&my_tests[idx]);
+
+   // categories of random addresses near special-purpose prefixes
+   errs += (size_t)my_random(200000);
+
+   if (!(quiet))
+      printf("%zu errors\n", errs);
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// compares single and batch classification with scan of registry
+int
+my_random(
+         size_t                        count )
+{
+   int                           rc;
+   size_t                        num;
+   size_t                        len;
+   size_t                        pos;
+   size_t                        bit;
+   size_t                        width;
+   size_t                        offset;
+   uint32_t                      cls;
+   uint64_t                      state;
+   const netcalc_class_pfx_t *   pfx;
+   netcalc_net_t                 nets[MY_BATCH];
+   const netcalc_net_t *         ptrs[MY_BATCH];
+   uint32_t                      classes[MY_BATCH];
+
+   if ((verbose))
+      printf("classifying %zu random addresses ...\n", count);
+
+   for(len = 0; ((_netcalc_class_registry[len].pfx_family)); len++);
+
+   memset(nets, 0, sizeof(nets));
+   state = 0x9e3779b97f4a7c15ULL;
+
+   for(num = 0; (num < count); num += MY_BATCH)
+   {  for(pos = 0; (pos < MY_BATCH); pos++)
+      {  state ^= state << 13;
+         state ^= state >> 7;
+         state ^= state << 17;
+         ptrs[pos] = &nets[pos];
+         memset(&nets[pos], 0, sizeof(netcalc_net_t));
+         nets[pos].net_cidr = 128;
+
+         // random bits follow a prefix of the registry shortened by up to
+         // three bits, addresses fall inside and just outside of prefixes
+         pfx = &_netcalc_class_registry[state % len];
+         if (pfx->pfx_family == NETCALC_AF_INET)
+         {  nets[pos].net_flags           = ((state >> 8) & 1) ? NETCALC_AF_INET : NETCALC_AF_INET6;
+            nets[pos].net_addr.addr16[5]  = 0xffff;
+            offset                        = 12;
+            width                         = 32;
+         } else
+         {  nets[pos].net_flags           = NETCALC_AF_INET6;
+            offset                        = 0;
+            width                         = 128;
+         };
+         memcpy(&nets[pos].net_addr.addr8[offset], pfx->pfx_addr, width / 8);
+         bit = (pfx->pfx_cidr > ((state >> 9) % 4)) ? (pfx->pfx_cidr - ((state >> 9) % 4)) : 0;
+         for(; (bit < width); bit++)
+         {  state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            if ((state & 1))
+               nets[pos].net_addr.addr8[offset + bit/8] ^= (uint8_t)(0x80 >> (bit % 8));
+         };
+
+         // unsupported families are classified as zero
+         if ((state % 97) == 0)
+            nets[pos].net_flags = NETCALC_AF_EUI48;
+      };
+
+      rc = netcalc_net_classify_batch(ptrs, classes, MY_BATCH);
+      for(pos = 0; (pos < MY_BATCH); pos++)
+      {  if ((nets[pos].net_flags & NETCALC_AF) == NETCALC_AF_EUI48)
+         {  if ( (rc != NETCALC_ENOTSUP) || (classes[pos] != 0) )
+            {  if (!(quiet))
+                  printf("random address %zu: unsupported family was classified\n", num + pos);
+               return(1);
+            };
+            if (netcalc_net_classify(&nets[pos], &cls) != NETCALC_ENOTSUP)
+               return(1);
+            continue;
+         };
+         if ((netcalc_net_classify(&nets[pos], &cls)))
+            return(1);
+         if ( (cls != my_reference(&nets[pos])) || (cls != classes[pos]) )
+         {  if (!(quiet))
+               printf("random address %zu: returned 0x%04x (batch 0x%04x); expected 0x%04x\n", num + pos, cls, classes[pos], my_reference(&nets[pos]));
+            return(1);
+         };
+      };
+   };
+
+   return(0);
+}
+
+
+// returns union of categories of prefixes of registry containing address
+uint32_t
+my_reference(
+         const netcalc_net_t *         net )
+{
+   int                           mapped;
+   size_t                        bit;
+   uint32_t                      cls;
+   const uint8_t *               addr;
+   const netcalc_class_pfx_t *   pfx;
+
+   mapped = (memcmp(net->net_addr.addr8, _netcalc_ipv4_mapped_ipv6.net_addr.addr8, 12)) ? 0 : 1;
+
+   cls = 0;
+   for(pfx = _netcalc_class_registry; ((pfx->pfx_family)); pfx++)
+   {  if (pfx->pfx_family == NETCALC_AF_INET)
+      {  if (!(mapped))
+            continue;
+         addr = &net->net_addr.addr8[12];
+      } else
+      {  if ((net->net_flags & NETCALC_AF) == NETCALC_AF_INET)
+            continue;
+         addr = net->net_addr.addr8;
+      };
+      for(bit = 0; (bit < pfx->pfx_cidr); bit++)
+         if ( ((addr[bit/8] ^ pfx->pfx_addr[bit/8]) & (0x80 >> (bit % 8))) )
+            break;
+      if (bit == pfx->pfx_cidr)
+         cls |= pfx->pfx_class;
+   };
+
+   return(cls);
+}
+
+
+// compares categories of address with expected categories
+int
+my_test(
+         const my_test_t *             test )
+{
+   int                  rc;
+   uint32_t             cls;
+   netcalc_net_t *      net;
+
+   if ((rc = netcalc_net_init(&net, test->address, 0)) != 0)
+   {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, test->address, netcalc_strerror(rc));
+      return(1);
+   };
+   rc = netcalc_net_classify(net, &cls);
+   netcalc_net_free(net);
+
+   if ( (rc != test->rc) || (cls != test->cls) )
+   {  if (!(quiet))
+         printf("%s: returned %s 0x%04x; expected %s 0x%04x\n", test->address, netcalc_strerror(rc), cls, netcalc_strerror(test->rc), test->cls);
+      return(1);
+   };
+   if ((verbose))
+      printf("%s: 0x%04x\n", test->address, cls);
+
+   return(0);
+}
+
+
+/* end of source */
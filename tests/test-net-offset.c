@@ -0,0 +1,355 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_NET_OFFSET_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-net-offset"
+
+#define MY_RUNS         10000
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+// MARK: - Datatypes
+
+typedef struct _my_test my_test_t;
+
+
+struct _my_test
+{  const char *            net;
+   const char *            result;     // resulting network or second network of distance
+   int                     op;         // '+', '-', or 'd'
+   int                     rc;
+   uint64_t                offset;     // offset or expected distance
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+
+int
+my_random(
+         unsigned *                    seedp );
+
+
+int
+my_test(
+         const my_test_t *             test );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+static const my_test_t my_tests[] =
+{  { "10.0.0.0/24",                              "10.0.1.0/24",                            '+', 0,                 1 },
+   { "10.0.0.5",                                 "10.0.0.255",                             '+', 0,                 250 },
+   { "10.0.0.5",                                 "10.0.1.0",                               '+', 0,                 251 },
+   { "10.0.0.0/8",                               "255.0.0.0/8",                            '+', 0,                 245 },
+   { "10.0.0.0/8",                               NULL,                                     '+', NETCALC_ERANGE,    246 },
+   { "255.255.255.0/24",                         NULL,                                     '+', NETCALC_ERANGE,    1 },
+   { "0.0.0.0/0",                                "0.0.0.0/0",                              '+', 0,                 0 },
+   { "0.0.0.0/0",                                NULL,                                     '+', NETCALC_ERANGE,    1 },
+   { "10.0.1.0/24",                              "10.0.0.0/24",                            '-', 0,                 1 },
+   { "10.0.1.0/24",                              "0.0.0.0/24",                             '-', 0,                 655361 },
+   { "10.0.1.0/24",                              NULL,                                     '-', NETCALC_ERANGE,    655362 },
+   { "0.0.0.0",                                  NULL,                                     '-', NETCALC_ERANGE,    1 },
+   { "2001:db8::/64",                            "2001:db8:0:1::/64",                      '+', 0,                 1 },
+   { "2001:db8:0:ffff:ffff:ffff:ffff:ffff",      "2001:db8:1::",                           '+', 0,                 1 },
+   { "2001:db8:1::",                             "2001:db8:0:ffff:ffff:ffff:ffff:ffff",    '-', 0,                 1 },
+   { "::ffff:255.255.255.255",                   "::1:0:0:0",                              '+', 0,                 1 },
+   { "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff",  NULL,                                     '+', NETCALC_ERANGE,    1 },
+   { "::",                                       NULL,                                     '-', NETCALC_ERANGE,    1 },
+   { "::/1",                                     "8000::/1",                               '+', 0,                 1 },
+   { "8000::/1",                                 NULL,                                     '+', NETCALC_ERANGE,    1 },
+   { "::/0",                                     NULL,                                     '+', NETCALC_ERANGE,    1 },
+   { "::/32",                                    "ffff:ffff::/32",                         '+', 0,                 0xffffffffULL },
+   { "::/32",                                    NULL,                                     '+', NETCALC_ERANGE,    0x100000000ULL },
+   { "::/64",                                    "ffff:ffff:ffff:ffff::/64",               '+', 0,                 0xffffffffffffffffULL },
+   { "::/96",                                    "0:0:ffff:ffff::/96",                     '+', 0,                 0xffffffff00000000ULL },
+   { "::/96",                                    "0:0:0:1::/96",                           '+', 0,                 0x100000000ULL },
+   { "ffff:ffff:ffff:ffff::/64",                 "::/64",                                  '-', 0,                 0xffffffffffffffffULL },
+   { "::1:0:0:0:0",                              "::ffff:ffff:ffff:ffff",                  '-', 0,                 1 },
+   { "10.0.0.0/24",                              "10.0.5.0/24",                            'd', 0,                 5 },
+   { "10.0.5.0/24",                              "10.0.0.0/24",                            'd', 0,                 5 },
+   { "10.0.0.0/24",                              "10.0.5.7",                               'd', 0,                 5 },
+   { "10.0.0.0",                                 "10.0.0.0",                               'd', 0,                 0 },
+   { "0.0.0.0",                                  "255.255.255.255",                        'd', 0,                 0xffffffffULL },
+   { "::/64",                                    "ffff:ffff:ffff:ffff::/64",               'd', 0,                 0xffffffffffffffffULL },
+   { "::",                                       "::1:0:0:0:0",                            'd', NETCALC_ERANGE,    0 },
+   { "::",                                       "::ffff:ffff:ffff:ffff",                  'd', 0,                 0xffffffffffffffffULL },
+   { "::ffff:ffff:ffff:ffff",                    "::1:0:0:0:0",                            'd', 0,                 1 },
+   { "::1:0:0:0:0",                              "::ffff:ffff:ffff:ffff",                  'd', 0,                 1 },
+   { "::/0",                                     "ffff::",                                 'd', 0,                 0 },
+   { "2001:db8::/126",                           "2001:db8::1:0",                          'd', 0,                 0x4000 },
+   { "00:00:5e:00:53:01",                        "10.0.0.0",                               'd', NETCALC_ENOTSUP,   0 },
+   { "00:00:5e:00:53:01",                        NULL,                                     '+', NETCALC_ENOTSUP,   1 },
+   { NULL,                                       NULL,                                     0,   0,                 0 }
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   size_t            idx;
+   size_t            errs;
+   unsigned          seed;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   // offsets and distances of known networks
+   for(idx = 0; ((my_tests[idx].net)); idx++)
+      if ((my_test(&my_tests[idx])))
+         errs++;
+
+   // offsets of random networks are reversed by subtraction and by distance
+   seed = 1;
+   for(idx = 0; (idx < MY_RUNS); idx++)
+      if ((my_random(&seed)))
+         errs++;
+
+   if (!(quiet))
+      printf("%zu errors\n", errs);
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// adds random offset to random network and verifies the offset is recovered
+int
+my_random(
+         unsigned *                    seedp )
+{
+   int               rc;
+   int               cidr;
+   uint64_t          offset;
+   uint64_t          dist;
+   netcalc_net_t *   net;
+   netcalc_net_t *   moved;
+   char              str[128];
+
+   cidr   = 1 + (rand_r(seedp) % 128);
+   offset = ((uint64_t)rand_r(seedp) << 33) ^ ((uint64_t)rand_r(seedp) << 11) ^ (uint64_t)rand_r(seedp);
+   offset = (cidr < 64) ? (offset >> (64 - cidr)) : offset;
+   snprintf(str, sizeof(str), "%x:%x::%x:%x/%i", rand_r(seedp) & 0x7fff, rand_r(seedp) & 0xffff, rand_r(seedp) & 0xffff, rand_r(seedp) & 0xffff, cidr);
+
+   if ((rc = netcalc_net_init(&net, str, 0)) != 0)
+   {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, str, netcalc_strerror(rc));
+      return(1);
+   };
+   netcalc_net_dup(&moved, net);
+
+   rc = netcalc_net_add(moved, offset);
+   if (rc == NETCALC_ERANGE)
+   {  netcalc_net_free(net);
+      netcalc_net_free(moved);
+      return(0);
+   };
+   if ( (rc == 0) && ((rc = netcalc_net_distance(net, moved, &dist)) == 0) )
+      rc = (dist == offset) ? 0 : 1;
+   if ( (rc == 0) && ((rc = netcalc_net_distance(moved, net, &dist)) == 0) )
+      rc = (dist == offset) ? 0 : 1;
+   if ( (rc == 0) && ((rc = netcalc_net_sub(moved, offset)) == 0) )
+      rc = (netcalc_net_cmp(moved, net, NETCALC_FLG_NETWORK) == NETCALC_CMP_SAME) ? 0 : 1;
+
+   if ( ((rc)) && (!(quiet)) )
+      printf("%s + %llu: offset not recovered\n", str, (unsigned long long)offset);
+
+   netcalc_net_free(net);
+   netcalc_net_free(moved);
+
+   return( ((rc)) ? 1 : 0 );
+}
+
+
+// runs test of offset or distance
+int
+my_test(
+         const my_test_t *             test )
+{
+   int               rc;
+   int               err;
+   uint64_t          dist;
+   netcalc_net_t *   net;
+   netcalc_net_t *   result;
+   char              str[128];
+
+   if ((rc = netcalc_net_init(&net, test->net, 0)) != 0)
+   {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, test->net, netcalc_strerror(rc));
+      return(1);
+   };
+   result = NULL;
+   if ( ((test->result)) && ((rc = netcalc_net_init(&result, test->result, 0)) != 0) )
+   {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, test->result, netcalc_strerror(rc));
+      netcalc_net_free(net);
+      return(1);
+   };
+
+   err   = 0;
+   dist  = 0;
+   switch(test->op)
+   {  case '+': rc = netcalc_net_add(net, test->offset); break;
+      case '-': rc = netcalc_net_sub(net, test->offset); break;
+      default:  rc = netcalc_net_distance(net, result, &dist); break;
+   };
+
+   if (rc != test->rc)
+      err = 1;
+   else if ( (test->op == 'd') && (dist != test->offset) )
+      err = 1;
+   else if ( (test->op != 'd') && ((result)) && (netcalc_net_cmp(net, result, NETCALC_FLG_NETWORK) != NETCALC_CMP_SAME) )
+      err = 1;
+
+   if ( ((err)) && (!(quiet)) )
+   {  netcalc_strfnet(net, str, sizeof(str), "%A", 0);
+      printf("%s %c %llu: returned %s, %llu (%s); expected %s (%s)\n", test->net, test->op, (unsigned long long)test->offset, str, (unsigned long long)dist, netcalc_strerror(rc), ((test->result)) ? test->result : "", netcalc_strerror(test->rc));
+   };
+   if ( (!(err)) && ((verbose)) )
+      printf("%s %c %llu: %s\n", test->net, test->op, (unsigned long long)test->offset, netcalc_strerror(rc));
+
+   netcalc_net_free(net);
+   if ((result))
+      netcalc_net_free(result);
+
+   return(err);
+}
+
+
+/* end of source */
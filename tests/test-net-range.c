@@ -0,0 +1,537 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_NET_RANGE_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libnetcalc.h"
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-net-range"
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+// MARK: - Datatypes
+
+typedef struct _my_test my_test_t;
+
+
+struct _my_test
+{  const char *            first;
+   const char *            last;
+   int                     rc;
+   int                     __pad;
+   const char *            blocks[5];
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_random(
+         size_t                        count );
+
+
+int
+my_range(
+         const char *                  address );
+
+
+int
+my_set(
+         void );
+
+
+int
+my_test(
+         const my_test_t *             test );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+static const my_test_t my_tests[] =
+{  { "10.0.0.1",            "10.0.0.6",          0,                0, { "10.0.0.1/32", "10.0.0.2/31", "10.0.0.4/31", "10.0.0.6/32", NULL } },
+   { "10.0.0.0",            "10.0.0.255",        0,                0, { "10.0.0.0/24", NULL } },
+   { "10.0.0.0/24",         "10.0.3.0/24",       0,                0, { "10.0.0.0/22", NULL } },
+   { "10.0.0.255",          "10.0.1.0",          0,                0, { "10.0.0.255/32", "10.0.1.0/32", NULL } },
+   { "192.168.0.7",         "192.168.0.7",       0,                0, { "192.168.0.7/32", NULL } },
+   { "0.0.0.0",             "255.255.255.255",   0,                0, { "0.0.0.0/0", NULL } },
+   { "10.0.0.0",            "10.0.1.255",        0,                0, { "10.0.0.0/23", NULL } },
+   { "2001:db8::1",         "2001:db8::7",       0,                0, { "2001:db8::1/128", "2001:db8::2/127", "2001:db8::4/126", NULL } },
+   { "2001:db8::",          "2001:db9::ffff",    0,                0, { "2001:db8::/32", "2001:db9::/112", NULL } },
+   { "::",                  "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff", 0, 0, { "::/0", NULL } },
+   { "10.0.0.6",            "10.0.0.1",          NETCALC_EINVAL,   0, { NULL } },
+   { "10.0.0.1",            "2001:db8::1",       NETCALC_EINVAL,   0, { NULL } },
+   { "00:00:5e:00:53:01",   "00:00:5e:00:53:ff", NETCALC_ENOTSUP,  0, { NULL } },
+   { NULL,                  NULL,                0,                0, { NULL } }
+};
+
+
+static const char * my_ranges[] =
+{  "10.0.0.0/24",
+   "10.0.0.0/31",
+   "10.0.0.1/32",
+   "0.0.0.0/0",
+   "2001:db8::/64",
+   "2001:db8::/127",
+   "2001:db8::1/128",
+   "::/0",
+   NULL
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   size_t            idx;
+   size_t            errs;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   // first and last hosts of networks
+   for(idx = 0; ((my_ranges[idx])); idx++)
+      errs += (size_t)my_range(my_ranges[idx]);
+
+   // blocks of known ranges
+   for(idx = 0; ((my_tests[idx].first)); idx++)
+      errs += (size_t)my_test(&my_tests[idx]);
+
+   // blocks of random ranges
+   errs += (size_t)my_random(100000);
+
+   // ranges added to sets
+   errs += (size_t)my_set();
+
+   if (!(quiet))
+      printf("%zu errors\n", errs);
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// verifies blocks of random ranges are aligned, contiguous, and minimal
+int
+my_random(
+         size_t                        count )
+{
+   int                  rc;
+   int                  bits;
+   int                  idx;
+   size_t               num;
+   size_t               len;
+   size_t               pos;
+   uint64_t             state;
+   netcalc_addr_t       end;
+   netcalc_addr_t       next;
+   netcalc_addr_t       noise;
+   netcalc_net_t        first;
+   netcalc_net_t        last;
+   netcalc_net_t **     nets;
+   const netcalc_net_t * net;
+
+   if ((verbose))
+      printf("decomposing %zu random ranges ...\n", count);
+
+   memset(&first, 0, sizeof(first));
+   memset(&last,  0, sizeof(last));
+   first.net_flags   = NETCALC_AF_INET6;
+   first.net_cidr    = 128;
+   last.net_flags    = NETCALC_AF_INET6;
+   last.net_cidr     = 128;
+   state             = 0x9e3779b97f4a7c15ULL;
+
+   for(num = 0; (num < count); num++)
+   {  // ranges share a random number of leading bits
+      for(idx = 0; (idx < 2); idx++)
+      {  state ^= state << 13;
+         state ^= state >> 7;
+         state ^= state << 17;
+         first.net_addr.addr64[idx] = state;
+         state ^= state << 13;
+         state ^= state >> 7;
+         state ^= state << 17;
+         noise.addr64[idx] = state;
+      };
+      bits = (int)(state % 129);
+      for(idx = 0; (idx < 4); idx++)
+         last.net_addr.addr32[idx] = (first.net_addr.addr32[idx] & _netcalc_netmasks[128-bits].addr32[idx]) | (noise.addr32[idx] & ~_netcalc_netmasks[128-bits].addr32[idx]);
+      if (netcalc_addr_cmp(&first.net_addr, 128, &last.net_addr, 128) == NETCALC_CMP_AFTER)
+      {  end              = first.net_addr;
+         first.net_addr   = last.net_addr;
+         last.net_addr    = end;
+      };
+
+      if ((rc = netcalc_range_to_cidrs(&first, &last, &nets, &len)) != 0)
+      {  if (!(quiet))
+            printf("random range %zu: %s\n", num, netcalc_strerror(rc));
+         return(1);
+      };
+
+      rc = 0;
+      if (len > 254)
+         rc = 1;
+      next = first.net_addr;
+      for(pos = 0; ( (!(rc)) && (pos < len) ); pos++)
+      {  net = nets[pos];
+         // block starts where previous block ended
+         if ((memcmp(&net->net_addr, &next, sizeof(netcalc_addr_t))))
+            rc = 1;
+         // block is aligned to prefix length
+         for(idx = 0; (idx < 4); idx++)
+            if ((net->net_addr.addr32[idx] & ~_netcalc_netmasks[net->net_cidr].addr32[idx]))
+               rc = 1;
+         // adjacent blocks of the same size are not merged into a larger block
+         if ( (pos > 0) && (nets[pos-1]->net_cidr == net->net_cidr) && (net->net_cidr > 0) )
+         {  for(idx = 0; (idx < 4); idx++)
+               if ((nets[pos-1]->net_addr.addr32[idx] & ~_netcalc_netmasks[net->net_cidr-1].addr32[idx]))
+                  break;
+            if (idx == 4)
+               rc = 1;
+         };
+         netcalc_addr_last(&end, &net->net_addr, net->net_cidr);
+         next = end;
+         netcalc_addr_incr(&next);
+      };
+      if ( (!(rc)) && ((memcmp(&end, &last.net_addr, sizeof(netcalc_addr_t)))) )
+         rc = 1;
+      if ( (!(rc)) && ((nets[len])) )
+         rc = 1;
+      netcalc_range_free(nets);
+
+      if ((rc))
+      {  if (!(quiet))
+            printf("random range %zu: blocks do not cover range\n", num);
+         return(1);
+      };
+   };
+
+   return(0);
+}
+
+
+// compares first and last hosts of network with text formats
+int
+my_range(
+         const char *                  address )
+{
+   int                  rc;
+   int                  err;
+   netcalc_net_t *      net;
+   netcalc_net_t *      first;
+   netcalc_net_t *      last;
+   char                 str1[128];
+   char                 str2[128];
+   char                 str3[128];
+   char                 str4[128];
+
+   if ((rc = netcalc_net_init(&net, address, 0)) != 0)
+   {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, address, netcalc_strerror(rc));
+      return(1);
+   };
+   if ((rc = netcalc_net_range(net, &first, &last)) != 0)
+   {  if (!(quiet))
+         printf("%s: netcalc_net_range(): %s\n", address, netcalc_strerror(rc));
+      netcalc_net_free(net);
+      return(1);
+   };
+
+   netcalc_ntop(net,   str1, sizeof(str1), NETCALC_TYPE_FIRST,   0);
+   netcalc_ntop(first, str2, sizeof(str2), NETCALC_TYPE_ADDRESS, 0);
+   netcalc_ntop(net,   str3, sizeof(str3), NETCALC_TYPE_LAST,    0);
+   netcalc_ntop(last,  str4, sizeof(str4), NETCALC_TYPE_ADDRESS, 0);
+   err = 0;
+   if ((strcmp(str1, str2)))
+      err = 1;
+   if ((strcmp(str3, str4)))
+      err = 1;
+   if ( ((err)) && (!(quiet)) )
+      printf("%s: returned %s - %s; expected %s - %s\n", address, str2, str4, str1, str3);
+   if ( (!(err)) && ((verbose)) )
+      printf("%s: %s - %s\n", address, str2, str4);
+
+   netcalc_net_free(net);
+   netcalc_net_free(first);
+   netcalc_net_free(last);
+
+   // only requested hosts are returned
+   if ( (!(err)) && ((rc = netcalc_net_init(&net, address, 0)) == 0) )
+   {  last = NULL;
+      if ( ((netcalc_net_range(net, NULL, &last))) || (!(last)) )
+         err = 1;
+      netcalc_net_free(last);
+      netcalc_net_free(net);
+   };
+
+   return(err);
+}
+
+
+// verifies ranges are added to sets in full or not at all
+int
+my_set(
+         void )
+{
+   int                  rc;
+   int                  err;
+   size_t               len;
+   netcalc_set_t *      ns;
+   netcalc_net_t *      net;
+   netcalc_net_t *      last;
+
+   if ((rc = netcalc_set_init(&ns, NULL, 0)) != 0)
+   {  fprintf(stderr, "%s: netcalc_set_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   err = 0;
+   if ((rc = netcalc_set_add_str(ns, "10.0.0.1-10.0.0.6", "range", NULL, 0)) != 0)
+   {  if (!(quiet))
+         printf("10.0.0.1-10.0.0.6: netcalc_set_add_str(): %s\n", netcalc_strerror(rc));
+      err = 1;
+   };
+   if ( ((netcalc_set_stats(ns, &len, NULL, NULL))) || (len != 4) )
+      err = 1;
+   if (netcalc_set_query_str(ns, "10.0.0.5", NULL, NULL, NULL, NULL) != 0)
+      err = 1;
+   if (netcalc_set_query_str(ns, "10.0.0.7", NULL, NULL, NULL, NULL) != NETCALC_ENOREC)
+      err = 1;
+
+   // blocks which would be added before a duplicate block are removed
+   if (netcalc_set_add_str(ns, "10.0.0.8/32", NULL, NULL, 0) != 0)
+      err = 1;
+   if (netcalc_set_add_str(ns, "10.0.0.16-10.0.0.8", NULL, NULL, 0) != NETCALC_EINVAL)
+      err = 1;
+   if (netcalc_set_add_str(ns, "10.0.0.7-10.0.0.8", NULL, NULL, 0) != NETCALC_EEXISTS)
+      err = 1;
+   if (netcalc_set_query_str(ns, "10.0.0.7", NULL, NULL, NULL, NULL) != NETCALC_ENOREC)
+      err = 1;
+   if ( ((netcalc_set_stats(ns, &len, NULL, NULL))) || (len != 5) )
+      err = 1;
+
+   // ranges of IPv6 addresses return the last block added
+   if (netcalc_set_add_range(ns, "2001:db8::-2001:db8::1:0", NULL, NULL, 0, &last) != 0)
+      err = 1;
+   else if (netcalc_net_init(&net, "2001:db8::1:0/128", 0) != 0)
+      err = 1;
+   else
+   {  if ( (!(last)) || (netcalc_net_cmp(last, net, NETCALC_FLG_NETWORK) != NETCALC_CMP_SAME) )
+         err = 1;
+      netcalc_net_free(net);
+   };
+   netcalc_net_free(last);
+   if ( ((netcalc_set_stats(ns, &len, NULL, NULL))) || (len != 7) )
+      err = 1;
+
+   if ( ((err)) && (!(quiet)) )
+      printf("ranges of addresses were not added to set\n");
+
+   netcalc_set_free(ns);
+
+   return(err);
+}
+
+
+// compares blocks of range with expected blocks
+int
+my_test(
+         const my_test_t *             test )
+{
+   int                  rc;
+   int                  err;
+   size_t               idx;
+   size_t               len;
+   netcalc_net_t *      first;
+   netcalc_net_t *      last;
+   netcalc_net_t *      net;
+   netcalc_net_t **     nets;
+   char                 str[128];
+
+   if ((rc = netcalc_net_init(&first, test->first, 0)) != 0)
+   {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, test->first, netcalc_strerror(rc));
+      return(1);
+   };
+   if ((rc = netcalc_net_init(&last, test->last, 0)) != 0)
+   {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, test->last, netcalc_strerror(rc));
+      netcalc_net_free(first);
+      return(1);
+   };
+   rc = netcalc_range_to_cidrs(first, last, &nets, &len);
+   netcalc_net_free(first);
+   netcalc_net_free(last);
+   if (rc != test->rc)
+   {  if (!(quiet))
+         printf("%s - %s: returned %s; expected %s\n", test->first, test->last, netcalc_strerror(rc), netcalc_strerror(test->rc));
+      if (rc == 0)
+         netcalc_range_free(nets);
+      return(1);
+   };
+   if (rc != 0)
+      return(0);
+
+   err = 0;
+   for(idx = 0; ( (!(err)) && ((nets[idx])) ); idx++)
+   {  netcalc_strfnet(nets[idx], str, sizeof(str), "%A", 0);
+      if (!(test->blocks[idx]))
+         err = 1;
+      else if ((rc = netcalc_net_init(&net, test->blocks[idx], 0)) != 0)
+         err = 1;
+      else
+      {  err = (netcalc_net_cmp(nets[idx], net, NETCALC_FLG_NETWORK) == NETCALC_CMP_SAME) ? 0 : 1;
+         netcalc_net_free(net);
+      };
+      if ( ((err)) && (!(quiet)) )
+         printf("%s - %s: block %zu: returned %s; expected %s\n", test->first, test->last, idx, str, ((test->blocks[idx])) ? test->blocks[idx] : "end of blocks");
+      if ( (!(err)) && ((verbose)) )
+         printf("%s - %s: block %zu: %s\n", test->first, test->last, idx, str);
+   };
+   if ( (!(err)) && ((test->blocks[idx])) )
+   {  if (!(quiet))
+         printf("%s - %s: returned %zu blocks; expected %s\n", test->first, test->last, idx, test->blocks[idx]);
+      err = 1;
+   };
+   if ( (!(err)) && (len != idx) )
+      err = 1;
+
+   netcalc_range_free(nets);
+
+   return(err);
+}
+
+
+/* end of source */
@@ -0,0 +1,376 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_NET_SUPERBLOCK_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-net-superblock"
+
+#define MY_RUNS         2000
+#define MY_NETS         64
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+// MARK: - Datatypes
+
+typedef struct _my_test my_test_t;
+
+
+struct _my_test
+{  const char *            superblock;
+   const char *            nets[5];
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_check(
+         netcalc_net_t **              nets,
+         size_t                        nel,
+         const char *                  expected );
+
+
+int
+my_random(
+         unsigned *                    seedp,
+         int                           inet );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+static const my_test_t my_tests[] =
+{  { "10.0.0.0/8",         { "10.0.0.0/8",      "10.0.0.0/24",       NULL } },
+   { "10.0.0.0/8",         { "10.0.0.0/24",     "10.0.0.0/8",        NULL } },
+   { "192.168.0.0/22",     { "192.168.1.0/24",  "192.168.2.0/24",    NULL } },
+   { "192.168.1.5/32",     { "192.168.1.5",     "192.168.1.5",       NULL } },
+   { "0.0.0.0/0",          { "0.0.0.0/1",       "128.0.0.0/1",       NULL } },
+   { "2001:db8::/32",      { "2001:db8::/48",   "2001:db8:ffff::/48", "2001:db8:8000::/33", NULL } },
+   { "2001:db8::8/125",    { "2001:db8::8",     "2001:db8::f",       "2001:db8::c/126", NULL } },
+   { "::ffff:0:0/96",      { "10.0.0.0/8",      "192.168.0.0/16",    "::ffff:0.0.0.0/104", NULL } },
+   { "::/2",               { "10.0.0.0/8",      "2001:db8::/32",     NULL } },
+   { NULL,                 { NULL } }
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int                           c;
+   int                           rc;
+   int                           opt_index;
+   size_t                        errs;
+   size_t                        idx;
+   size_t                        nel;
+   unsigned                      seed;
+   netcalc_net_t *               nets[MY_NETS];
+   netcalc_net_t *               net;
+   netcalc_superblock_acc_t *    acc;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   // accumulator without networks
+   if ((rc = netcalc_superblock_acc_init(&acc)) != 0)
+   {  fprintf(stderr, "%s: netcalc_superblock_acc_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   if ((rc = netcalc_superblock_acc_finish(acc, &net)) != NETCALC_ENOREC)
+   {  if (!(quiet))
+         printf("superblock of no networks: returned %i; expected %i\n", rc, NETCALC_ENOREC);
+      errs++;
+   };
+   netcalc_superblock_acc_free(acc);
+
+   // superblocks of known networks
+   for(idx = 0; ((my_tests[idx].superblock)); idx++)
+   {  for(nel = 0; ((my_tests[idx].nets[nel])); nel++)
+      {  if ((rc = netcalc_net_init(&nets[nel], my_tests[idx].nets[nel], 0)) != 0)
+         {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, my_tests[idx].nets[nel], netcalc_strerror(rc));
+            return(1);
+         };
+      };
+      if ((my_check(nets, nel, my_tests[idx].superblock)))
+         errs++;
+      while(nel > 0)
+         netcalc_net_free(nets[--nel]);
+   };
+
+   // superblocks of random networks
+   seed = 1;
+   for(idx = 0; (idx < MY_RUNS); idx++)
+      if ((my_random(&seed, (int)(idx & 1))))
+         errs++;
+
+   if (!(quiet))
+      printf("%zu errors\n", errs);
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// compares superblock of array and accumulator with expected superblock
+int
+my_check(
+         netcalc_net_t **              nets,
+         size_t                        nel,
+         const char *                  expected )
+{
+   int                           rc;
+   int                           fam1;
+   int                           fam2;
+   size_t                        idx;
+   netcalc_net_t *               ref;
+   netcalc_net_t *               net;
+   netcalc_net_t *               streamed;
+   netcalc_superblock_acc_t *    acc;
+   char                          str1[128];
+   char                          str2[128];
+
+   if ((rc = netcalc_net_init(&ref, expected, 0)) != 0)
+   {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, expected, netcalc_strerror(rc));
+      return(1);
+   };
+   if ((rc = netcalc_net_superblock(&net, (const netcalc_net_t * const *)nets, nel)) != 0)
+   {  fprintf(stderr, "%s: netcalc_net_superblock(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_net_free(ref);
+      return(1);
+   };
+
+   // accumulate networks in reverse order
+   if ((rc = netcalc_superblock_acc_init(&acc)) != 0)
+   {  fprintf(stderr, "%s: netcalc_superblock_acc_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   for(idx = nel; (idx > 0); idx--)
+      netcalc_superblock_acc_add(acc, nets[idx-1]);
+   rc = netcalc_superblock_acc_finish(acc, &streamed);
+   netcalc_superblock_acc_free(acc);
+   if (rc != 0)
+   {  fprintf(stderr, "%s: netcalc_superblock_acc_finish(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   netcalc_net_field(ref, NETCALC_FLD_FAMILY, &fam1);
+   netcalc_net_field(net, NETCALC_FLD_FAMILY, &fam2);
+   rc = ( (netcalc_net_cmp(net, ref, NETCALC_FLG_NETWORK) != NETCALC_CMP_SAME) || (fam1 != fam2) ) ? 1 : 0;
+   netcalc_net_field(streamed, NETCALC_FLD_FAMILY, &fam2);
+   rc = ( (netcalc_net_cmp(streamed, ref, NETCALC_FLG_NETWORK) != NETCALC_CMP_SAME) || (fam1 != fam2) ) ? 1 : rc;
+
+   if ( ((rc)) && (!(quiet)) )
+   {  netcalc_strfnet(net,      str1, sizeof(str1), "%A", 0);
+      netcalc_strfnet(streamed, str2, sizeof(str2), "%A", 0);
+      printf("superblock: returned %s and %s; expected %s\n", str1, str2, expected);
+   };
+   if ( (!(rc)) && ((verbose)) )
+      printf("superblock: %s\n", expected);
+
+   netcalc_net_free(ref);
+   netcalc_net_free(net);
+   netcalc_net_free(streamed);
+
+   return(rc);
+}
+
+
+// generates networks which share a random number of leading bits
+int
+my_random(
+         unsigned *                    seedp,
+         int                           inet )
+{
+   int               rc;
+   size_t            idx;
+   size_t            nel;
+   unsigned          bits;
+   unsigned          cidr;
+   unsigned          shortest;
+   uint32_t          base;
+   uint32_t          first;
+   uint32_t          diff;
+   uint32_t          val;
+   uint32_t          mask;
+   netcalc_net_t *   nets[MY_NETS];
+   char              str[128];
+
+   nel      = 2 + ((unsigned)rand_r(seedp) % (MY_NETS - 2));
+   base     = ((uint32_t)rand_r(seedp) << 16) ^ (uint32_t)rand_r(seedp);
+   bits     = (unsigned)rand_r(seedp) % 33;     // leading bits shared by networks
+   shortest = 32;
+   first    = 0;
+   diff     = 0;
+
+   for(idx = 0; (idx < nel); idx++)
+   {  cidr     = (unsigned)rand_r(seedp) % 33;
+      cidr     = (cidr < bits) ? bits + (cidr % (33 - bits)) : cidr;
+      mask     = ((cidr)) ? (uint32_t)(0xffffffffULL << (32 - cidr)) : 0;
+      val      = base;
+      if (bits < 32)
+         val ^= ((uint32_t)rand_r(seedp) ^ ((uint32_t)rand_r(seedp) << 16)) & (uint32_t)(0xffffffffULL >> bits);
+      val     &= mask;
+      first    = ((idx)) ? first : val;
+      diff    |= val ^ first;
+      shortest = (cidr < shortest) ? cidr : shortest;
+      if ((inet))
+         snprintf(str, sizeof(str), "%u.%u.%u.%u/%u", val >> 24, (val >> 16) & 0xff, (val >> 8) & 0xff, val & 0xff, cidr);
+      else
+         snprintf(str, sizeof(str), "2001:db8:%x:%x::/%u", val >> 16, val & 0xffff, cidr + 32);
+      if ((rc = netcalc_net_init(&nets[idx], str, 0)) != 0)
+      {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, str, netcalc_strerror(rc));
+         return(1);
+      };
+   };
+
+   // the first network of the set is not required to be the shortest
+   for(cidr = 0; ( (cidr < shortest) && (!(diff & (0x80000000U >> cidr))) ); cidr++);
+   val = first & (((cidr)) ? (uint32_t)(0xffffffffULL << (32 - cidr)) : 0);
+   if ((inet))
+      snprintf(str, sizeof(str), "%u.%u.%u.%u/%u", val >> 24, (val >> 16) & 0xff, (val >> 8) & 0xff, val & 0xff, cidr);
+   else
+      snprintf(str, sizeof(str), "2001:db8:%x:%x::/%u", val >> 16, val & 0xffff, cidr + 32);
+
+   rc = my_check(nets, nel, str);
+   for(idx = 0; (idx < nel); idx++)
+      netcalc_net_free(nets[idx]);
+
+   return(rc);
+}
+
+
+/* end of source */
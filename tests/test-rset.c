@@ -0,0 +1,452 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_RSET_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libnetcalc.h"
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-rset"
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+// MARK: - Datatypes
+
+typedef struct _my_add my_add_t;
+typedef struct _my_query my_query_t;
+
+
+struct _my_add
+{  const char *            range;
+   const char *            comment;
+   int                     rc;
+   int                     __pad;
+};
+
+
+struct _my_query
+{  const char *            address;
+   const char *            first;      // NULL if address is not within a range
+   const char *            last;
+   const char *            comment;
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_query(
+         netcalc_rset_t *              rs,
+         const my_query_t *            query );
+
+
+int
+my_random(
+         size_t                        count );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+static const my_add_t my_adds[] =
+{  { "10.0.0.0-10.0.0.255",         "a",  0,                0 },
+   { "10.0.1.5-10.0.2.7",           "b",  0,                0 },
+   { "192.168.0.0/16",              "c",  0,                0 },
+   { "2001:db8::-2001:db8::ffff",   "d",  0,                0 },
+   { "10.0.1.0-10.0.1.4",           "e",  0,                0 },
+   { "172.16.0.1",                  NULL, 0,                0 },
+   { "10.0.0.200-10.0.1.0",         NULL, NETCALC_EEXISTS,  0 },
+   { "10.0.2.7",                    NULL, NETCALC_EEXISTS,  0 },
+   { "10.0.0.0/8",                  NULL, NETCALC_EEXISTS,  0 },
+   { "192.168.255.255-192.169.0.0", NULL, NETCALC_EEXISTS,  0 },
+   { "9.255.255.0-10.0.0.0",        NULL, NETCALC_EEXISTS,  0 },
+   { "172.15.0.0-172.16.0.1",       NULL, NETCALC_EEXISTS,  0 },
+   { "10.0.0.6-10.0.0.1",           NULL, NETCALC_EINVAL,   0 },
+   { "10.0.0.1-2001:db8::1",        NULL, NETCALC_EINVAL,   0 },
+   { "00:00:5e:00:53:01",           NULL, NETCALC_ENOTSUP,  0 },
+   { NULL,                          NULL, 0,                0 }
+};
+
+
+static const my_query_t my_queries[] =
+{  { "10.0.0.0",            "10.0.0.0",       "10.0.0.255",        "a" },
+   { "10.0.0.255",          "10.0.0.0",       "10.0.0.255",        "a" },
+   { "10.0.0.128/25",       "10.0.0.0",       "10.0.0.255",        "a" },
+   { "10.0.1.0",            "10.0.1.0",       "10.0.1.4",          "e" },
+   { "10.0.1.4",            "10.0.1.0",       "10.0.1.4",          "e" },
+   { "10.0.1.5",            "10.0.1.5",       "10.0.2.7",          "b" },
+   { "10.0.2.7",            "10.0.1.5",       "10.0.2.7",          "b" },
+   { "192.168.100.1",       "192.168.0.0",    "192.168.255.255",   "c" },
+   { "172.16.0.1",          "172.16.0.1",     "172.16.0.1",        NULL },
+   { "2001:db8::abcd",      "2001:db8::",     "2001:db8::ffff",    "d" },
+   { "9.255.255.255",       NULL,             NULL,                NULL },
+   { "10.0.2.8",            NULL,             NULL,                NULL },
+   { "10.0.0.0/23",         NULL,             NULL,                NULL },
+   { "172.16.0.0",          NULL,             NULL,                NULL },
+   { "2001:db8::1:0",       NULL,             NULL,                NULL },
+   { "::",                  NULL,             NULL,                NULL },
+   { NULL,                  NULL,             NULL,                NULL }
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               rc;
+   int               opt_index;
+   size_t            idx;
+   size_t            errs;
+   size_t            len;
+   netcalc_rset_t *  rs;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   if ((rc = netcalc_rset_init(&rs)) != 0)
+   {  fprintf(stderr, "%s: netcalc_rset_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   // adds ranges, overlapping ranges are rejected
+   for(idx = 0; ((my_adds[idx].range)); idx++)
+   {  rc = netcalc_rset_add_str(rs, my_adds[idx].range, my_adds[idx].comment, NULL);
+      if (rc != my_adds[idx].rc)
+      {  if (!(quiet))
+            printf("%s: returned %s; expected %s\n", my_adds[idx].range, netcalc_strerror(rc), netcalc_strerror(my_adds[idx].rc));
+         errs++;
+      };
+   };
+   netcalc_rset_stats(rs, &len, NULL);
+   if (len != 6)
+   {  if (!(quiet))
+         printf("set contains %zu ranges; expected 6\n", len);
+      errs++;
+   };
+
+   // queries of known ranges
+   for(idx = 0; ((my_queries[idx].address)); idx++)
+      errs += (size_t)my_query(rs, &my_queries[idx]);
+
+   netcalc_rset_free(rs);
+
+   // queries of random ranges
+   errs += (size_t)my_random(20000);
+
+   if (!(quiet))
+      printf("%zu errors\n", errs);
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// compares range containing address with expected range
+int
+my_query(
+         netcalc_rset_t *              rs,
+         const my_query_t *            query )
+{
+   int                  rc;
+   int                  err;
+   char *               comment;
+   netcalc_net_t *      first;
+   netcalc_net_t *      last;
+   char                 str1[128];
+   char                 str2[128];
+
+   rc = netcalc_rset_query_str(rs, query->address, &first, &last, &comment, NULL);
+   if (rc != ((query->first) ? 0 : NETCALC_ENOREC))
+   {  if (!(quiet))
+         printf("%s: returned %s\n", query->address, netcalc_strerror(rc));
+      if (rc == 0)
+      {  netcalc_net_free(first);
+         netcalc_net_free(last);
+         free(comment);
+      };
+      return(1);
+   };
+   if (rc != 0)
+   {  if ((verbose))
+         printf("%s: not within range\n", query->address);
+      return(0);
+   };
+
+   netcalc_ntop(first, str1, sizeof(str1), NETCALC_TYPE_ADDRESS, NETCALC_FLG_COMPR | NETCALC_FLG_SUPR);
+   netcalc_ntop(last,  str2, sizeof(str2), NETCALC_TYPE_ADDRESS, NETCALC_FLG_COMPR | NETCALC_FLG_SUPR);
+   err = 0;
+   if ( ((strcmp(str1, query->first))) || ((strcmp(str2, query->last))) )
+      err = 1;
+   if ( (!(comment)) != (!(query->comment)) )
+      err = 1;
+   else if ( ((comment)) && ((strcmp(comment, query->comment))) )
+      err = 1;
+   if ( ((err)) && (!(quiet)) )
+      printf("%s: returned %s-%s %s; expected %s-%s %s\n", query->address, str1, str2, ((comment)) ? comment : "", query->first, query->last, ((query->comment)) ? query->comment : "");
+   if ( (!(err)) && ((verbose)) )
+      printf("%s: %s-%s %s\n", query->address, str1, str2, ((comment)) ? comment : "");
+
+   netcalc_net_free(first);
+   netcalc_net_free(last);
+   if ((comment))
+      free(comment);
+
+   return(err);
+}
+
+
+// compares queries of ranges added in random order with linear search
+int
+my_random(
+         size_t                        count )
+{
+   int                  rc;
+   int                  err;
+   size_t               idx;
+   size_t               pos;
+   size_t               match;
+   size_t               tmp;
+   uint64_t             state;
+   uint64_t             addr;
+   uint64_t *           firsts;
+   uint64_t *           lasts;
+   size_t *             order;
+   void *               data;
+   netcalc_net_t        first;
+   netcalc_net_t        last;
+   netcalc_rset_t *     rs;
+
+   if ((verbose))
+      printf("querying %zu random ranges ...\n", count);
+
+   firsts = calloc(count, sizeof(uint64_t));
+   lasts  = calloc(count, sizeof(uint64_t));
+   order  = calloc(count, sizeof(size_t));
+   if ( (!(firsts)) || (!(lasts)) || (!(order)) )
+   {  free(firsts);
+      free(lasts);
+      free(order);
+      return(1);
+   };
+
+   // disjoint ranges within the low 64 bits of 2001:db8::/32
+   state = 0x9e3779b97f4a7c15ULL;
+   addr  = 0;
+   for(idx = 0; (idx < count); idx++)
+   {  state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      firsts[idx] = addr + (state % 1024);
+      lasts[idx]  = firsts[idx] + ((state >> 20) % 1024);
+      addr        = lasts[idx] + 1;
+      order[idx]  = idx;
+   };
+
+   // ranges are added in random order
+   for(idx = count - 1; (idx > 0); idx--)
+   {  state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      pos         = (size_t)(state % (idx + 1));
+      tmp         = order[idx];
+      order[idx]  = order[pos];
+      order[pos]  = tmp;
+   };
+
+   if ((rc = netcalc_rset_init(&rs)) != 0)
+   {  free(firsts);
+      free(lasts);
+      free(order);
+      return(1);
+   };
+
+   memset(&first, 0, sizeof(first));
+   first.net_flags   = NETCALC_AF_INET6;
+   first.net_cidr    = 128;
+   netcalc_addr_be64_set(&first.net_addr, 0, 0x20010db800000000ULL);
+   memcpy(&last, &first, sizeof(last));
+
+   err = 0;
+   for(idx = 0; ( (!(err)) && (idx < count) ); idx++)
+   {  netcalc_addr_be64_set(&first.net_addr, 1, firsts[order[idx]]);
+      netcalc_addr_be64_set(&last.net_addr,  1, lasts[order[idx]]);
+      if (netcalc_rset_add(rs, &first, &last, NULL, &firsts[order[idx]]) != 0)
+         err = 1;
+   };
+
+   // first and last addresses of each range
+   for(idx = 0; ( (!(err)) && (idx < count) ); idx++)
+   {  netcalc_addr_be64_set(&first.net_addr, 1, firsts[idx]);
+      netcalc_addr_be64_set(&last.net_addr,  1, lasts[idx]);
+      if ( (netcalc_rset_query(rs, &first, NULL, NULL, NULL, &data) != 0) || (data != &firsts[idx]) )
+         err = 1;
+      if ( (netcalc_rset_query(rs, &last, NULL, NULL, NULL, &data) != 0) || (data != &firsts[idx]) )
+         err = 1;
+      if ( ((err)) && (!(quiet)) )
+         printf("2001:db8::%llx-2001:db8::%llx: range not found\n", (unsigned long long)firsts[idx], (unsigned long long)lasts[idx]);
+   };
+
+   // each address is compared with the ranges in order
+   match = 0;
+   pos   = 0;
+   for(addr = 0; ( (!(err)) && (addr < (lasts[count-1] + 2)) ); addr += 7)
+   {  while ( (pos < count) && (lasts[pos] < addr) )
+         pos++;
+      idx = ( (pos < count) && (firsts[pos] <= addr) ) ? pos : count;
+      netcalc_addr_be64_set(&first.net_addr, 1, addr);
+      data = NULL;
+      rc = netcalc_rset_query(rs, &first, NULL, NULL, NULL, &data);
+      if (idx == count)
+         err = (rc == NETCALC_ENOREC) ? 0 : 1;
+      else
+         err = ( (rc == 0) && (data == &firsts[idx]) ) ? 0 : 1;
+      match += (rc == 0) ? 1 : 0;
+      if ( ((err)) && (!(quiet)) )
+         printf("2001:db8::%llx: returned %s\n", (unsigned long long)addr, netcalc_strerror(rc));
+   };
+
+   if ((verbose))
+      printf("%zu queries were within ranges\n", match);
+
+   netcalc_rset_free(rs);
+   free(firsts);
+   free(lasts);
+   free(order);
+
+   return(err);
+}
+
+
+/* end of source */
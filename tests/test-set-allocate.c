@@ -0,0 +1,411 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_SET_ALLOCATE_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <errno.h>
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-set-allocate"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_expected(
+         netcalc_set_t *               ns,
+         netcalc_net_t *               parent,
+         int                           cidr,
+         char *                        str,
+         size_t                        size );
+
+
+int
+my_pass(
+         const char *                  name,
+         const char * const *          data,
+         const char *                  parent,
+         const int *                   sizes );
+
+
+int
+my_record(
+         void );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   int               sizes[257];
+   size_t            idx;
+   size_t            errs;
+   uint32_t          seed;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   // check set 2
+   if ((my_pass("set2", test_set2, "203.0.113.0/24", (const int[]){ 29, 29, 25, 26, 27, 28, 26, 29, 30, 32, 31, 24, 27, 32, 30, -1 })))
+      errs++;
+   if ((my_pass("set2", test_set2, "203.0.113.192/29", (const int[]){ 30, 30, 31, 32, 32, -1 })))
+      errs++;
+   if ((my_pass("set2", test_set2, "2001:db8:d::/48", (const int[]){ 56, 64, 64, 52, 50, 60, 56, 63, 49, 55, 64, 51, 64, 58, 62, 48, -1 })))
+      errs++;
+   if ((my_pass("set2", test_set2, "2001:db8:d:101::/64", (const int[]){ 128, 127, 128, 126, 120, 128, 65, 66, 64, -1 })))
+      errs++;
+   if ((my_pass("set2", test_set2, "2001:db8:8000::/33", (const int[]){ 34, 48, 34, 35, 40, 33, -1 })))
+      errs++;
+
+   // check allocations of the prefix length of a record within the record
+   if ((my_record()))
+      errs++;
+
+   // check pseudo-random allocations
+   for(idx = 0, seed = 1; (idx < 256); idx++)
+   {  seed        = (seed * 1103515245) + 12345;
+      sizes[idx]  = 56 + (int)((seed >> 16) % 9);
+   };
+   sizes[idx] = -1;
+   if ((my_pass("set2", test_set2, "2001:db8:d::/48", sizes)))
+      errs++;
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// determines expected allocation by finding the first unallocated block
+// which is large enough for the requested prefix length
+int
+my_expected(
+         netcalc_set_t *               ns,
+         netcalc_net_t *               parent,
+         int                           cidr,
+         char *                        str,
+         size_t                        size )
+{
+   int               rc;
+   int               blk_cidr;
+   netcalc_cur_t *   cur;
+   netcalc_net_t *   blk;
+
+   str[0] = '\0';
+
+   if ((rc = netcalc_set_free_blocks(ns, parent, &cur)) != 0)
+      return(rc);
+   while((rc = netcalc_cur_next(cur, &blk, NULL, NULL, NULL, NULL)) == 0)
+   {  netcalc_net_field(blk, NETCALC_FLD_CIDR, &blk_cidr);
+      if (blk_cidr <= cidr)
+      {  netcalc_net_mask(blk, NULL, cidr);
+         netcalc_ntop(blk, str, size, NETCALC_TYPE_ADDRESS, NETCALC_FLG_SUPR | NETCALC_FLG_COMPR | NETCALC_FLG_CIDR);
+         netcalc_net_free(blk);
+         break;
+      };
+      netcalc_net_free(blk);
+   };
+   netcalc_cur_free(cur);
+
+   return( (rc == NETCALC_ENOREC) ? NETCALC_ENOREC : 0 );
+}
+
+
+int
+my_pass(
+         const char *                  name,
+         const char * const *          data,
+         const char *                  parent,
+         const int *                   sizes )
+{
+   int               rc;
+   int               exp_rc;
+   int               errs;
+   int               flags;
+   size_t            idx;
+   netcalc_set_t *   ns;
+   netcalc_net_t *   net;
+   netcalc_net_t *   res;
+   char              exp_str[NETCALC_ADDRESS_LENGTH];
+   char              res_str[NETCALC_ADDRESS_LENGTH];
+
+   errs  = 0;
+   flags = NETCALC_FLG_SUPR | NETCALC_FLG_COMPR | NETCALC_FLG_CIDR;
+
+   printf("testing %s within %s ...\n", name, parent);
+   printf("   loading set ...\n");
+
+   if ((rc = netcalc_set_init(&ns, NULL, 0)) != 0)
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   // add addresses to sets
+   for(idx = 0; ((data[idx])); idx++)
+   {  if ((verbose))
+         printf("      adding %s ...\n", data[idx]);
+      if ((rc = netcalc_set_add_str(ns, data[idx], NULL, NULL, 0)) != 0)
+      {  printf("%s: netcalc_set_add_str(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         errs++;
+      };
+   };
+
+   if ((rc = netcalc_net_init(&net, parent, 0)) != 0)
+   {  printf("%s: %s: netcalc_net_init(): %s\n", PROGRAM_NAME, parent, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      return(1);
+   };
+
+   // allocate blocks
+   for(idx = 0; (sizes[idx] != -1); idx++)
+   {  exp_rc = my_expected(ns, net, sizes[idx], exp_str, sizeof(exp_str));
+      rc     = netcalc_set_allocate(ns, net, sizes[idx], "allocated", NULL, 0, &res);
+      if (rc != exp_rc)
+      {  printf("%s: netcalc_set_allocate(/%i): expected %s; received %s\n", PROGRAM_NAME, sizes[idx], netcalc_strerror(exp_rc), netcalc_strerror(rc));
+         errs++;
+         continue;
+      };
+      if (rc != 0)
+      {  if (!(quiet))
+            printf("   allocating /%i ... %s\n", sizes[idx], netcalc_strerror(rc));
+         continue;
+      };
+      netcalc_ntop(res, res_str, sizeof(res_str), NETCALC_TYPE_ADDRESS, flags);
+      netcalc_net_free(res);
+      if (!(quiet))
+         printf("   allocating /%i ... %s\n", sizes[idx], res_str);
+      if ((strcmp(res_str, exp_str)))
+      {  printf("%s: netcalc_set_allocate(/%i): expected %s; received %s\n", PROGRAM_NAME, sizes[idx], exp_str, res_str);
+         errs++;
+      };
+      if ((rc = netcalc_set_query_str(ns, res_str, &res, NULL, NULL, NULL)) != 0)
+      {  printf("%s: netcalc_set_query_str(%s): %s\n", PROGRAM_NAME, res_str, netcalc_strerror(rc));
+         errs++;
+         continue;
+      };
+      netcalc_net_free(res);
+   };
+
+   netcalc_net_free(net);
+   netcalc_set_free(ns);
+
+   return(errs);
+}
+
+
+
+// verifies the block of a record is not allocated as a subnet of the record
+int
+my_record(
+         void )
+{
+   int               rc;
+   int               errs;
+   int               depth;
+   size_t            count;
+   netcalc_set_t *   ns;
+   netcalc_net_t *   net;
+   netcalc_net_t *   res;
+   netcalc_cur_t *   cur;
+   char              res_str[NETCALC_ADDRESS_LENGTH];
+
+   errs = 0;
+
+   printf("testing allocations within record 10.0.0.0/24 ...\n");
+
+   if ((rc = netcalc_set_init(&ns, NULL, 0)) != 0)
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   if ((rc = netcalc_set_add_str(ns, "10.0.0.0/24", NULL, NULL, 0)) != 0)
+   {  printf("%s: netcalc_set_add_str(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      return(1);
+   };
+   if ((rc = netcalc_net_init(&net, "10.0.0.0/24", 0)) != 0)
+   {  printf("%s: netcalc_net_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      return(1);
+   };
+
+   // block of record is not free
+   if ((rc = netcalc_set_allocate(ns, net, 24, "allocated", NULL, 0, &res)) != NETCALC_ENOREC)
+   {  printf("%s: netcalc_set_allocate(/24): expected %s; received %s\n", PROGRAM_NAME, netcalc_strerror(NETCALC_ENOREC), netcalc_strerror(rc));
+      if (rc == 0)
+         netcalc_net_free(res);
+      errs++;
+   };
+
+   // subnets of record are free
+   if ((rc = netcalc_set_allocate(ns, net, 25, "allocated", NULL, 0, &res)) != 0)
+   {  printf("%s: netcalc_set_allocate(/25): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   } else
+   {  netcalc_ntop(res, res_str, sizeof(res_str), NETCALC_TYPE_ADDRESS, NETCALC_FLG_SUPR | NETCALC_FLG_CIDR);
+      netcalc_net_free(res);
+      if (!(quiet))
+         printf("   allocating /25 ... %s\n", res_str);
+      if ((strcmp(res_str, "10.0.0.0/25")))
+      {  printf("%s: netcalc_set_allocate(/25): expected 10.0.0.0/25; received %s\n", PROGRAM_NAME, res_str);
+         errs++;
+      };
+   };
+
+   // record appears once and allocation appears once within record
+   count = 0;
+   if ((rc = netcalc_cur_init(ns, &cur)) == 0)
+   {  while((rc = netcalc_cur_next(cur, &res, NULL, NULL, NULL, &depth)) == 0)
+      {  netcalc_ntop(res, res_str, sizeof(res_str), NETCALC_TYPE_ADDRESS, NETCALC_FLG_SUPR | NETCALC_FLG_CIDR);
+         netcalc_net_free(res);
+         if ( ((count == 0) && ((depth != 0) || (strcmp(res_str, "10.0.0.0/24")))) ||
+              ((count == 1) && ((depth != 1) || (strcmp(res_str, "10.0.0.0/25")))) )
+            errs++;
+         count++;
+      };
+      netcalc_cur_free(cur);
+   };
+   if (count != 2)
+   {  printf("%s: set contains %zu records; expected 2\n", PROGRAM_NAME, count);
+      errs++;
+   };
+
+   netcalc_net_free(net);
+   netcalc_set_free(ns);
+
+   return(errs);
+}
+
+/* end of source */
@@ -0,0 +1,411 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_SET_CACHE_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <errno.h>
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-set-cache"
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+// MARK: - Datatypes
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_cmp(
+         netcalc_set_t *               ns,
+         netcalc_set_t *               ref,
+         size_t *                      queriesp );
+
+
+int
+my_load(
+         netcalc_set_t **              nsp,
+         size_t                        size );
+
+
+int
+my_modify(
+         netcalc_set_t *               ns,
+         netcalc_set_t *               ref,
+         const char *                  address,
+         int                           add );
+
+
+int
+my_pass(
+         const char *                  name,
+         size_t                        size );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   size_t            errs;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   // check set 2 with cache of a single entry
+   if ((my_pass("set2", 1)))
+      errs++;
+
+   // check set 2 with cache larger than set
+   if ((my_pass("set2", 100)))
+      errs++;
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// compares results of querying each address twice with results of the
+// reference set
+int
+my_cmp(
+         netcalc_set_t *               ns,
+         netcalc_set_t *               ref,
+         size_t *                      queriesp )
+{
+   int               rc1;
+   int               rc2;
+   int               errs;
+   int               flags;
+   int               pass;
+   size_t            idx;
+   netcalc_net_t *   net1;
+   netcalc_net_t *   net2;
+   char              str1[NETCALC_ADDRESS_LENGTH];
+   char              str2[NETCALC_ADDRESS_LENGTH];
+
+   errs  = 0;
+   flags = NETCALC_FLG_SUPR | NETCALC_FLG_COMPR | NETCALC_FLG_CIDR;
+
+   for(idx = 0; ((test_query2[idx].query_addr)); idx++)
+   {  for(pass = 0; (pass < 2); pass++)
+      {  net1 = NULL;
+         net2 = NULL;
+         rc1 = netcalc_set_query_str(ref, test_query2[idx].query_addr, &net1, NULL, NULL, NULL);
+         rc2 = netcalc_set_query_str(ns,  test_query2[idx].query_addr, &net2, NULL, NULL, NULL);
+         (*queriesp)++;
+         str1[0] = '\0';
+         str2[0] = '\0';
+         if ((net1))
+            netcalc_ntop(net1, str1, sizeof(str1), NETCALC_TYPE_ADDRESS, flags);
+         if ((net2))
+            netcalc_ntop(net2, str2, sizeof(str2), NETCALC_TYPE_ADDRESS, flags);
+         if ((net1))
+            netcalc_net_free(net1);
+         if ((net2))
+            netcalc_net_free(net2);
+         if ((verbose))
+            printf("      query %s: matched \"%s\" ...\n", test_query2[idx].query_addr, str2);
+         if ( (rc1 != rc2) || ((strcmp(str1, str2))) )
+         {  printf("%s: query %s: matched \"%s\"; expected \"%s\"\n", PROGRAM_NAME, test_query2[idx].query_addr, str2, str1);
+            errs++;
+         };
+      };
+   };
+
+   return(errs);
+}
+
+
+int
+my_load(
+         netcalc_set_t **              nsp,
+         size_t                        size )
+{
+   int               rc;
+   size_t            idx;
+
+   if ((rc = netcalc_set_init(nsp, NULL, 0)) != 0)
+   {  printf("%s: netcalc_set_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   if ((rc = netcalc_set_cache(*nsp, size)) != 0)
+   {  printf("%s: netcalc_set_cache(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(*nsp);
+      return(1);
+   };
+   for(idx = 0; ((test_set2[idx])); idx++)
+   {  if ((rc = netcalc_set_add_str(*nsp, test_set2[idx], NULL, NULL, 0)) != 0)
+      {  printf("%s: netcalc_set_add_str(%s): %s\n", PROGRAM_NAME, test_set2[idx], netcalc_strerror(rc));
+         netcalc_set_free(*nsp);
+         return(1);
+      };
+   };
+
+   return(0);
+}
+
+
+// applies same modification to both sets
+int
+my_modify(
+         netcalc_set_t *               ns,
+         netcalc_set_t *               ref,
+         const char *                  address,
+         int                           add )
+{
+   int               rc;
+   netcalc_net_t *   net;
+
+   printf("   %s %s ...\n", ((add)) ? "adding" : "deleting", address);
+
+   if ((rc = netcalc_net_init(&net, address, 0)) != 0)
+   {  printf("%s: %s: %s\n", PROGRAM_NAME, address, netcalc_strerror(rc));
+      return(1);
+   };
+   if ((add))
+   {  if ((rc = netcalc_set_add(ns, net, NULL, NULL, 0)) == 0)
+         rc = netcalc_set_add(ref, net, NULL, NULL, 0);
+   } else
+   {  if ((rc = netcalc_set_del(ns, net)) == 0)
+         rc = netcalc_set_del(ref, net);
+   };
+   netcalc_net_free(net);
+   if (rc != 0)
+   {  printf("%s: %s: %s\n", PROGRAM_NAME, address, netcalc_strerror(rc));
+      return(1);
+   };
+
+   return(0);
+}
+
+
+int
+my_pass(
+         const char *                  name,
+         size_t                        size )
+{
+   int               errs;
+   size_t            len;
+   size_t            queries;
+   uintmax_t         hits;
+   uintmax_t         misses;
+   netcalc_set_t *   ns;
+   netcalc_set_t *   ref;
+   netcalc_set_t *   clone;
+   netcalc_set_t *   ref_clone;
+
+   errs     = 0;
+   queries  = 0;
+
+   printf("testing %s with cache of %zu entries ...\n", name, size);
+
+   if ((my_load(&ns, size)))
+      return(1);
+   if ((my_load(&ref, 0)))
+   {  netcalc_set_free(ns);
+      return(1);
+   };
+
+   // verify results of cached queries
+   printf("   comparing queries ...\n");
+   errs += my_cmp(ns, ref, &queries);
+   netcalc_set_cache_stats(ns, &len, &hits, &misses);
+   if (len < size)
+   {  printf("%s: netcalc_set_cache_stats(): %zu entries; expected at least %zu entries\n", PROGRAM_NAME, len, size);
+      errs++;
+   };
+   if ( (hits != (queries / 2)) || ((hits + misses) != queries) )
+   {  printf("%s: netcalc_set_cache_stats(): %ju hits, %ju misses; expected %zu hits, %zu misses\n", PROGRAM_NAME, hits, misses, queries / 2, queries / 2);
+      errs++;
+   };
+
+   // verify modifications invalidate cached results
+   errs += my_modify(ns, ref, "203.0.113.0/24", 1);
+   errs += my_cmp(ns, ref, &queries);
+   errs += my_modify(ns, ref, "203.0.113.192/29", 0);
+   errs += my_cmp(ns, ref, &queries);
+
+   // verify copying records shared with clones invalidates cached results
+   printf("   comparing queries of clones ...\n");
+   if (netcalc_set_clone(&clone, ns) != 0)
+   {  netcalc_set_free(ns);
+      netcalc_set_free(ref);
+      return(errs+1);
+   };
+   if (netcalc_set_clone(&ref_clone, ref) != 0)
+   {  netcalc_set_free(clone);
+      netcalc_set_free(ns);
+      netcalc_set_free(ref);
+      return(errs+1);
+   };
+   errs += my_cmp(clone, ref_clone, &queries);
+   errs += my_cmp(ns, ref, &queries);
+   if (netcalc_set_add_str(ns, "203.0.113.196/30", NULL, NULL, 0) != NETCALC_EEXISTS)
+   {  printf("%s: netcalc_set_add_str(203.0.113.196/30): added existing network\n", PROGRAM_NAME);
+      errs++;
+   };
+   errs += my_modify(clone, ref_clone, "203.0.113.196/30", 0);
+   errs += my_cmp(clone, ref_clone, &queries);
+   errs += my_cmp(ns, ref, &queries);
+   errs += my_modify(ns, ref, "203.0.113.0/24", 0);
+   errs += my_cmp(ns, ref, &queries);
+   netcalc_set_free(ref_clone);
+   netcalc_set_free(clone);
+   errs += my_cmp(ns, ref, &queries);
+
+   // verify cache is disabled
+   netcalc_set_cache(ns, 0);
+   netcalc_set_cache_stats(ns, &len, &hits, &misses);
+   if ( ((len)) || ((hits)) || ((misses)) )
+   {  printf("%s: netcalc_set_cache(): cache not disabled\n", PROGRAM_NAME);
+      errs++;
+   };
+   errs += my_cmp(ns, ref, &queries);
+
+   netcalc_set_free(ns);
+   netcalc_set_free(ref);
+
+   return(errs);
+}
+
+
+/* end of source */
@@ -0,0 +1,419 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_SET_COVERED_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <errno.h>
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-set-covered"
+
+#define MY_MAX_RECS     128
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_check(
+         netcalc_set_t *               ns,
+         const char *                  name );
+
+
+int
+my_check_cursor(
+         netcalc_cur_t *               cur,
+         const char *                  name,
+         const char *                  type,
+         char                          exp[][NETCALC_ADDRESS_LENGTH],
+         const int *                   exp_depth,
+         size_t                        exp_len );
+
+
+int
+my_pass(
+         const char *                  name,
+         const char * const *          data );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+static const char * test_keys[] =
+{  "::/0",
+   "::/1",
+   "2001:db8::/32",
+   "2001:db8:d::/48",
+   "2001:db8:d:100::/55",
+   "2001:db8:d:100::/56",
+   "2001:db8:d:101::1",
+   "2001:db8:d:101::2",
+   "2001:db8:e::/47",
+   "3fff::/20",
+   "::ffff:0:0/96",
+   "::ffff:203.0.113.0/120",
+   "10.0.0.0/8",
+   "203.0.113.0/24",
+   "203.0.113.196/30",
+   "203.0.113.199",
+   NULL
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   size_t            errs;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   // check set 2
+   if ((my_pass("set2", test_set2)))
+      errs++;
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// compares covered and chain cursors against a walk of the entire set
+int
+my_check(
+         netcalc_set_t *               ns,
+         const char *                  name )
+{
+   int               rc;
+   int               errs;
+   int               flags;
+   int               depth;
+   int               base;
+   size_t            cov_len;
+   size_t            chain_len;
+   netcalc_net_t *   key;
+   netcalc_net_t *   net;
+   netcalc_cur_t *   cur;
+   char              cov[MY_MAX_RECS][NETCALC_ADDRESS_LENGTH];
+   char              chain[MY_MAX_RECS][NETCALC_ADDRESS_LENGTH];
+   int               cov_depth[MY_MAX_RECS];
+   int               chain_depth[MY_MAX_RECS];
+
+   errs        = 0;
+   flags       = NETCALC_FLG_SUPR | NETCALC_FLG_COMPR | NETCALC_FLG_CIDR;
+   cov_len     = 0;
+   chain_len   = 0;
+   base        = 0;
+
+   if (!(quiet))
+      printf("   checking %s ...\n", name);
+
+   if ((rc = netcalc_net_init(&key, name, 0)) != 0)
+   {  printf("%s: %s: netcalc_net_init(): %s\n", PROGRAM_NAME, name, netcalc_strerror(rc));
+      return(1);
+   };
+   if ((rc = netcalc_net_dup(&net, key)) != 0)
+   {  printf("%s: netcalc_net_dup(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_net_free(key);
+      return(1);
+   };
+   netcalc_net_convert(net, NETCALC_AF_INET6, NULL);
+   netcalc_net_free(key);
+
+   // determine expected records by walking entire set
+   if ((rc = netcalc_cur_init(ns, &cur)) != 0)
+   {  printf("%s: netcalc_cur_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_net_free(net);
+      return(1);
+   };
+   while((rc = netcalc_cur_next(cur, &key, NULL, NULL, NULL, &depth)) == 0)
+   {  switch(netcalc_net_cmp(key, net, NETCALC_FLG_NETWORK))
+      {  case NETCALC_CMP_SAME:
+            if (chain_len < MY_MAX_RECS)
+            {  netcalc_ntop(key, chain[chain_len], NETCALC_ADDRESS_LENGTH, NETCALC_TYPE_ADDRESS, flags);
+               chain_depth[chain_len++] = depth;
+            };
+            // fall through
+
+         case NETCALC_CMP_SUBNET:
+            if (!(cov_len))
+               base = depth;
+            if (cov_len < MY_MAX_RECS)
+            {  netcalc_ntop(key, cov[cov_len], NETCALC_ADDRESS_LENGTH, NETCALC_TYPE_ADDRESS, flags);
+               cov_depth[cov_len++] = depth - base;
+            };
+            break;
+
+         case NETCALC_CMP_SUPERNET:
+            if (chain_len < MY_MAX_RECS)
+            {  netcalc_ntop(key, chain[chain_len], NETCALC_ADDRESS_LENGTH, NETCALC_TYPE_ADDRESS, flags);
+               chain_depth[chain_len++] = depth;
+            };
+            break;
+
+         default:
+            break;
+      };
+      netcalc_net_free(key);
+   };
+   netcalc_cur_free(cur);
+   netcalc_net_free(net);
+
+   if ((rc = netcalc_net_init(&key, name, 0)) != 0)
+   {  printf("%s: %s: netcalc_net_init(): %s\n", PROGRAM_NAME, name, netcalc_strerror(rc));
+      return(1);
+   };
+
+   // check records covered by network
+   if ((rc = netcalc_set_query_covered(ns, key, &cur)) != 0)
+   {  printf("%s: netcalc_set_query_covered(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   } else
+   {  errs += my_check_cursor(cur, name, "covered", cov, cov_depth, cov_len);
+      netcalc_cur_free(cur);
+   };
+
+   // check supernet chain of network
+   if ((rc = netcalc_set_query_chain(ns, key, &cur)) != 0)
+   {  printf("%s: netcalc_set_query_chain(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   } else
+   {  errs += my_check_cursor(cur, name, "chain", chain, chain_depth, chain_len);
+      netcalc_cur_free(cur);
+   };
+
+   netcalc_net_free(key);
+
+   return(errs);
+}
+
+
+int
+my_check_cursor(
+         netcalc_cur_t *               cur,
+         const char *                  name,
+         const char *                  type,
+         char                          exp[][NETCALC_ADDRESS_LENGTH],
+         const int *                   exp_depth,
+         size_t                        exp_len )
+{
+   int               rc;
+   int               pass;
+   int               flags;
+   int               depth;
+   size_t            idx;
+   netcalc_net_t *   net;
+   char              net_str[NETCALC_ADDRESS_LENGTH];
+
+   flags = NETCALC_FLG_SUPR | NETCALC_FLG_COMPR | NETCALC_FLG_CIDR;
+
+   // second pass verifies cursor can be restarted
+   for(pass = 0; (pass < 2); pass++)
+   {  rc = netcalc_cur_first(cur, &net, NULL, NULL, NULL, &depth);
+      for(idx = 0; (rc == 0); idx++)
+      {  netcalc_ntop(net, net_str, sizeof(net_str), NETCALC_TYPE_ADDRESS, flags);
+         netcalc_net_free(net);
+         if ((verbose))
+            printf("      %s %s (depth %i) ...\n", type, net_str, depth);
+         if (idx >= exp_len)
+         {  printf("%s: %s: unexpected %s record %s\n", PROGRAM_NAME, name, type, net_str);
+            return(1);
+         };
+         if ((strcmp(net_str, exp[idx])))
+         {  printf("%s: %s: %s record %s; expected %s\n", PROGRAM_NAME, name, type, net_str, exp[idx]);
+            return(1);
+         };
+         if (depth != exp_depth[idx])
+         {  printf("%s: %s: %s record %s depth %i; expected %i\n", PROGRAM_NAME, name, type, net_str, depth, exp_depth[idx]);
+            return(1);
+         };
+         rc = netcalc_cur_next(cur, &net, NULL, NULL, NULL, &depth);
+      };
+      if (rc != NETCALC_ENOREC)
+      {  printf("%s: %s: netcalc_cur_next(): %s\n", PROGRAM_NAME, name, netcalc_strerror(rc));
+         return(1);
+      };
+      if (idx != exp_len)
+      {  printf("%s: %s: missing %s record %s\n", PROGRAM_NAME, name, type, exp[idx]);
+         return(1);
+      };
+   };
+
+   return(0);
+}
+
+
+int
+my_pass(
+         const char *                  name,
+         const char * const *          data )
+{
+   int               rc;
+   int               errs;
+   size_t            idx;
+   netcalc_set_t *   ns;
+
+   errs  = 0;
+
+   printf("testing %s ...\n", name);
+   printf("   loading set ...\n");
+
+   if ((rc = netcalc_set_init(&ns, NULL, 0)) != 0)
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   // add addresses to sets
+   for(idx = 0; ((data[idx])); idx++)
+   {  if ((verbose))
+         printf("      adding %s ...\n", data[idx]);
+      if ((rc = netcalc_set_add_str(ns, data[idx], NULL, NULL, 0)) != 0)
+      {  printf("%s: netcalc_set_add_str(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         errs++;
+      };
+   };
+
+   // check arbitrary networks
+   for(idx = 0; ((test_keys[idx])); idx++)
+      errs += my_check(ns, test_keys[idx]);
+
+   // check networks of each record
+   for(idx = 0; ((data[idx])); idx++)
+      errs += my_check(ns, data[idx]);
+
+   netcalc_set_free(ns);
+
+   return(errs);
+}
+
+
+/* end of source */
@@ -131,6 +131,78 @@ const char *      test_set2[] =
    NULL
 };
 
+const testfree_t        test_free2[] =
+{  {  .free_net =       "203.0.113.0/24",
+      .free_exp =       (const char *[])
+                        {  "203.0.113.0/25",
+                           "203.0.113.128/26",
+                           "203.0.113.200/29",
+                           "203.0.113.208/28",
+                           "203.0.113.224/27",
+                           NULL
+                        }
+   },
+   {  .free_net =       "203.0.113.192/29",
+      .free_exp =       (const char *[]){ "203.0.113.192/30", NULL }
+   },
+   {  .free_net =       "203.0.113.196/30",
+      .free_exp =       (const char *[]){ "203.0.113.196/31", NULL }
+   },
+   {  .free_net =       "203.0.113.198/31",
+      .free_exp =       (const char *[]){ "203.0.113.198", NULL }
+   },
+   {  .free_net =       "203.0.113.199/32",
+      .free_exp =       (const char *[]){ "203.0.113.199", NULL }
+   },
+   {  .free_net =       "203.0.113.200/29",
+      .free_exp =       (const char *[]){ "203.0.113.200/29", NULL }
+   },
+   {  .free_net =       "2001:db8:d::/48",
+      .free_exp =       (const char *[])
+                        {  "2001:db8:d:200::/55",
+                           "2001:db8:d:400::/54",
+                           "2001:db8:d:800::/53",
+                           "2001:db8:d:1000::/52",
+                           "2001:db8:d:2000::/51",
+                           "2001:db8:d:4000::/50",
+                           "2001:db8:d:8000::/50",
+                           "2001:db8:d:c000::/51",
+                           "2001:db8:d:e000::/52",
+                           "2001:db8:d:f001::/64",
+                           "2001:db8:d:f002::/63",
+                           "2001:db8:d:f004::/62",
+                           "2001:db8:d:f008::/61",
+                           "2001:db8:d:f010::/60",
+                           "2001:db8:d:f020::/59",
+                           "2001:db8:d:f040::/58",
+                           "2001:db8:d:f080::/57",
+                           "2001:db8:d:f100::/56",
+                           "2001:db8:d:f200::/55",
+                           "2001:db8:d:f400::/54",
+                           "2001:db8:d:f800::/54",
+                           "2001:db8:d:fc00::/55",
+                           "2001:db8:d:fe00::/56",
+                           "2001:db8:d:ff00::/57",
+                           "2001:db8:d:ff80::/58",
+                           "2001:db8:d:ffc0::/59",
+                           "2001:db8:d:ffe0::/60",
+                           "2001:db8:d:fff0::/61",
+                           "2001:db8:d:fff8::/62",
+                           "2001:db8:d:fffc::/63",
+                           NULL
+                        }
+   },
+   {  .free_net =       "2001:db8:d:101::/126",
+      .free_exp =       (const char *[])
+                        {  "2001:db8:d:101::",
+                           "2001:db8:d:101::2/127",
+                           NULL
+                        }
+   },
+   { NULL, NULL }
+};
+
+
 const testquery_t       test_query2[] =
 {  {  .query_addr =     "203.0.113.1",
       .query_exp  =     NULL
@@ -0,0 +1,598 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_SET_DIFF_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <errno.h>
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-set-diff"
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+// MARK: - Datatypes
+
+typedef struct _my_op
+{  int                     op_code;    // 'a' add, 'd' delete, 'u' update, or 'l' allocate
+   int                     op_cidr;
+   const char *            op_net;
+   const char *            op_comment;
+} my_op_t;
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_apply(
+         netcalc_set_t *               ns,
+         const my_op_t *               ops,
+         size_t *                      countp );
+
+
+int
+my_change(
+         void *                        ctx,
+         int                           op,
+         const netcalc_net_t *         net,
+         const char *                  comment1,
+         const char *                  comment2 );
+
+
+int
+my_cmp(
+         netcalc_set_t *               ns1,
+         netcalc_set_t *               ns2 );
+
+
+int
+my_count(
+         void *                        ctx,
+         int                           op,
+         const netcalc_net_t *         net,
+         const char *                  comment1,
+         const char *                  comment2 );
+
+
+int
+my_load(
+         netcalc_set_t **              nsp,
+         const char * const *          data,
+         const char *                  superblock );
+
+
+int
+my_pass(
+         const char *                  name,
+         const char * const *          data,
+         const char *                  superblock );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+static const my_op_t my_ops1[] =
+{  { 'a',  0, "2001:db8:d:102::/64",    "added" },
+   { 'd',  0, "2001:db8:d:100::/56",    NULL },
+   { 'u',  0, "2001:db8:d:101::1/128",  "updated" },
+   { 'l', 30, "203.0.113.192/29",       "allocated" },
+   { 'a',  0, "2001:db8:e::/48",        "supernet" },
+   { 0,    0, NULL,                     NULL }
+};
+
+
+static const my_op_t my_ops2[] =
+{  { 'd',  0, "2001:db8:d::/48",        NULL },
+   { 'a',  0, "2001:db8:d:a::1/128",    "added" },
+   { 'd',  0, "::1",                    NULL },
+   { 'u',  0, "127.0.0.1",              "updated" },
+   { 'a',  0, "2001:db8:c::/48",        NULL },
+   { 0,    0, NULL,                     NULL }
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   size_t            errs;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   // check set 2
+   if ((my_pass("set2", test_set2, NULL)))
+      errs++;
+
+   // check set 2 restricted to superblock
+   if ((my_pass("set2", test_set2, "2001:db8::/32")))
+      errs++;
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// applies modifications to set and counts modifications which succeed
+int
+my_apply(
+         netcalc_set_t *               ns,
+         const my_op_t *               ops,
+         size_t *                      countp )
+{
+   int               rc;
+   size_t            idx;
+   netcalc_net_t *   net;
+   netcalc_net_t *   alloc;
+
+   *countp = 0;
+
+   for(idx = 0; ((ops[idx].op_code)); idx++)
+   {  if ((verbose))
+         printf("      %c %s ...\n", ops[idx].op_code, ops[idx].op_net);
+      if ((rc = netcalc_net_init(&net, ops[idx].op_net, 0)) != 0)
+      {  printf("%s: netcalc_net_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         return(1);
+      };
+      alloc = NULL;
+      switch(ops[idx].op_code)
+      {  case 'a':  rc = netcalc_set_add(ns, net, ops[idx].op_comment, NULL, 0); break;
+         case 'd':  rc = netcalc_set_del(ns, net); break;
+         case 'l':  rc = netcalc_set_allocate(ns, net, ops[idx].op_cidr, ops[idx].op_comment, NULL, 0, &alloc); break;
+         default:   rc = netcalc_set_update(ns, net, ops[idx].op_comment, NULL, 0); break;
+      };
+      netcalc_net_free(net);
+      netcalc_net_free(alloc);
+      if (rc == 0)
+         (*countp)++;
+   };
+
+   return(0);
+}
+
+
+// applies change reported by netcalc_set_diff() to set
+int
+my_change(
+         void *                        ctx,
+         int                           op,
+         const netcalc_net_t *         net,
+         const char *                  comment1,
+         const char *                  comment2 )
+{
+   int               rc;
+   netcalc_net_t *   dup;
+   char              str[NETCALC_ADDRESS_LENGTH];
+
+   if ((verbose))
+   {  netcalc_ntop(net, str, sizeof(str), NETCALC_TYPE_ADDRESS, NETCALC_FLG_CIDR);
+      printf("      %c%s \"%s\" \"%s\"\n", (op == NETCALC_MOD_ADD) ? '+' : ((op == NETCALC_MOD_DEL) ? '-' : '~'), str, ((comment1)) ? comment1 : "", ((comment2)) ? comment2 : "");
+   };
+
+   switch(op)
+   {  case NETCALC_MOD_ADD:
+         if ((rc = netcalc_net_dup(&dup, net)) != 0)
+            break;
+         rc = ((comment1)) ? NETCALC_EINVAL : netcalc_set_add(ctx, dup, comment2, NULL, 0);
+         netcalc_net_free(dup);
+         break;
+
+      case NETCALC_MOD_DEL:
+         rc = ((comment2)) ? NETCALC_EINVAL : netcalc_set_del(ctx, net);
+         break;
+
+      case NETCALC_MOD_UPDATE:
+         rc = netcalc_set_update(ctx, net, comment2, NULL, 0);
+         break;
+
+      default:
+         rc = NETCALC_EINVAL;
+         break;
+   };
+   if (rc != 0)
+      printf("%s: change %i: %s\n", PROGRAM_NAME, op, netcalc_strerror(rc));
+
+   return(rc);
+}
+
+
+// compares records, comments, and query results of two sets
+int
+my_cmp(
+         netcalc_set_t *               ns1,
+         netcalc_set_t *               ns2 )
+{
+   int               rc1;
+   int               rc2;
+   int               errs;
+   int               flags;
+   int               depth1;
+   int               depth2;
+   size_t            idx;
+   char *            comment1;
+   char *            comment2;
+   netcalc_net_t *   net1;
+   netcalc_net_t *   net2;
+   netcalc_cur_t *   cur1;
+   netcalc_cur_t *   cur2;
+   char              str1[NETCALC_ADDRESS_LENGTH];
+   char              str2[NETCALC_ADDRESS_LENGTH];
+
+   errs  = 0;
+   flags = NETCALC_FLG_SUPR | NETCALC_FLG_COMPR | NETCALC_FLG_CIDR;
+
+   if ((rc1 = netcalc_cur_init(ns1, &cur1)) != 0)
+      return(1);
+   if ((rc2 = netcalc_cur_init(ns2, &cur2)) != 0)
+   {  netcalc_cur_free(cur1);
+      return(1);
+   };
+
+   // compare records
+   rc1 = netcalc_cur_next(cur1, &net1, &comment1, NULL, NULL, &depth1);
+   rc2 = netcalc_cur_next(cur2, &net2, &comment2, NULL, NULL, &depth2);
+   while( (rc1 == 0) && (rc2 == 0) )
+   {  netcalc_ntop(net1, str1, sizeof(str1), NETCALC_TYPE_ADDRESS, flags);
+      netcalc_ntop(net2, str2, sizeof(str2), NETCALC_TYPE_ADDRESS, flags);
+      if ((verbose))
+         printf("      record %s (depth %i) ...\n", str2, depth2);
+      if ( (strcmp(str1, str2)) || (depth1 != depth2) )
+      {  printf("%s: record %s (depth %i); expected %s (depth %i)\n", PROGRAM_NAME, str2, depth2, str1, depth1);
+         errs++;
+      } else if ( ((!(comment1)) != (!(comment2))) || ( ((comment1)) && ((strcmp(comment1, comment2))) ) )
+      {  printf("%s: record %s: comment \"%s\"; expected \"%s\"\n", PROGRAM_NAME, str2, ((comment2)) ? comment2 : "", ((comment1)) ? comment1 : "");
+         errs++;
+      };
+      netcalc_net_free(net1);
+      netcalc_net_free(net2);
+      free(comment1);
+      free(comment2);
+      rc1 = netcalc_cur_next(cur1, &net1, &comment1, NULL, NULL, &depth1);
+      rc2 = netcalc_cur_next(cur2, &net2, &comment2, NULL, NULL, &depth2);
+   };
+   netcalc_cur_free(cur1);
+   netcalc_cur_free(cur2);
+   if (rc1 != rc2)
+   {  printf("%s: netcalc_cur_next(): %s; expected %s\n", PROGRAM_NAME, netcalc_strerror(rc2), netcalc_strerror(rc1));
+      if ((rc1 == 0))
+      {  netcalc_net_free(net1);
+         free(comment1);
+      };
+      if ((rc2 == 0))
+      {  netcalc_net_free(net2);
+         free(comment2);
+      };
+      return(errs+1);
+   };
+
+   // compare queries
+   for(idx = 0; ((test_query2[idx].query_addr)); idx++)
+   {  net1 = NULL;
+      net2 = NULL;
+      rc1 = netcalc_set_query_str(ns1, test_query2[idx].query_addr, &net1, NULL, NULL, NULL);
+      rc2 = netcalc_set_query_str(ns2, test_query2[idx].query_addr, &net2, NULL, NULL, NULL);
+      str1[0] = '\0';
+      str2[0] = '\0';
+      if ((net1))
+         netcalc_ntop(net1, str1, sizeof(str1), NETCALC_TYPE_ADDRESS, flags);
+      if ((net2))
+         netcalc_ntop(net2, str2, sizeof(str2), NETCALC_TYPE_ADDRESS, flags);
+      if ((net1))
+         netcalc_net_free(net1);
+      if ((net2))
+         netcalc_net_free(net2);
+      if ( (rc1 != rc2) || ((strcmp(str1, str2))) )
+      {  printf("%s: query %s: matched \"%s\"; expected \"%s\"\n", PROGRAM_NAME, test_query2[idx].query_addr, str2, str1);
+         errs++;
+      };
+   };
+
+   return(errs);
+}
+
+
+// counts changes reported by netcalc_set_diff()
+int
+my_count(
+         void *                        ctx,
+         int                           op,
+         const netcalc_net_t *         net,
+         const char *                  comment1,
+         const char *                  comment2 )
+{
+   size_t *          countp;
+
+   countp = ctx;
+   (*countp)++;
+
+   if (!(net))
+      return(NETCALC_EINVAL);
+   if ( (op == NETCALC_MOD_ADD) && ((comment1)) )
+      return(NETCALC_EINVAL);
+   if ( (op == NETCALC_MOD_DEL) && ((comment2)) )
+      return(NETCALC_EINVAL);
+
+   return(0);
+}
+
+
+int
+my_load(
+         netcalc_set_t **              nsp,
+         const char * const *          data,
+         const char *                  superblock )
+{
+   int               rc;
+   size_t            idx;
+   netcalc_net_t *   sb;
+
+   sb = NULL;
+   if ( ((superblock)) && ((rc = netcalc_net_init(&sb, superblock, 0)) != 0) )
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   rc = netcalc_set_init(nsp, sb, 0);
+   netcalc_net_free(sb);
+   if (rc != 0)
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   // add addresses to sets, using odd addresses as comments
+   for(idx = 0; ((data[idx])); idx++)
+   {  rc = netcalc_set_add_str(*nsp, data[idx], ((idx & 1)) ? data[idx] : NULL, NULL, 0);
+      if ( (rc != 0) && ( (rc != NETCALC_ERANGE) || (!(superblock)) ) )
+      {  printf("%s: netcalc_set_add_str(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         netcalc_set_free(*nsp);
+         *nsp = NULL;
+         return(1);
+      };
+   };
+
+   return(0);
+}
+
+
+int
+my_pass(
+         const char *                  name,
+         const char * const *          data,
+         const char *                  superblock )
+{
+   int               rc;
+   int               errs;
+   size_t            idx;
+   size_t            count;
+   size_t            changes;
+   netcalc_set_t *   ns;
+   netcalc_set_t *   empty;
+   netcalc_set_t *   mod;
+   netcalc_set_t *   chg;
+   const my_op_t *   ops[] = { my_ops1, my_ops2, NULL };
+
+   errs  = 0;
+
+   if ((superblock))
+      printf("testing %s within superblock %s ...\n", name, superblock);
+   else
+      printf("testing %s ...\n", name);
+   printf("   loading sets ...\n");
+
+   if ((my_load(&ns, data, superblock)))
+      return(1);
+   if ((rc = netcalc_set_init(&empty, NULL, 0)) != 0)
+   {  printf("%s: netcalc_set_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      return(1);
+   };
+
+   // compare set with itself
+   printf("   comparing identical sets ...\n");
+   changes = 0;
+   if ((rc = netcalc_set_diff(ns, ns, &my_count, &changes)) != 0)
+   {  printf("%s: netcalc_set_diff(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   };
+   if (changes != 0)
+   {  printf("%s: netcalc_set_diff(): reported %zu changes; expected 0\n", PROGRAM_NAME, changes);
+      errs++;
+   };
+
+   // compare empty set with set
+   printf("   comparing empty set ...\n");
+   if ((rc = netcalc_set_init(&chg, NULL, 0)) != 0)
+   {  printf("%s: netcalc_set_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(empty);
+      netcalc_set_free(ns);
+      return(1);
+   };
+   if ((rc = netcalc_set_diff(empty, ns, &my_change, chg)) != 0)
+      errs++;
+   errs += my_cmp(ns, chg);
+   if ((rc = netcalc_set_diff(ns, empty, &my_change, chg)) != 0)
+      errs++;
+   errs += my_cmp(empty, chg);
+   netcalc_set_free(chg);
+
+   // compare modified sets
+   for(idx = 0; ((ops[idx])); idx++)
+   {  printf("   comparing modified set %zu ...\n", idx+1);
+      mod = NULL;
+      chg = NULL;
+      if ( ((rc = netcalc_set_clone(&mod, ns)) != 0) || ((rc = netcalc_set_clone(&chg, ns)) != 0) )
+      {  printf("%s: netcalc_set_clone(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         netcalc_set_free(mod);
+         errs++;
+         continue;
+      };
+      if ((my_apply(mod, ops[idx], &count)))
+         errs++;
+
+      // count changes
+      changes = 0;
+      if ((rc = netcalc_set_diff(ns, mod, &my_count, &changes)) != 0)
+      {  printf("%s: netcalc_set_diff(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         errs++;
+      };
+      if (changes != count)
+      {  printf("%s: netcalc_set_diff(): reported %zu changes; expected %zu\n", PROGRAM_NAME, changes, count);
+         errs++;
+      };
+
+      // apply changes to copy of original set
+      if ((rc = netcalc_set_diff(ns, mod, &my_change, chg)) != 0)
+         errs++;
+      errs += my_cmp(mod, chg);
+
+      // apply reverse changes
+      if ((rc = netcalc_set_diff(mod, ns, &my_change, chg)) != 0)
+         errs++;
+      errs += my_cmp(ns, chg);
+
+      netcalc_set_free(mod);
+      netcalc_set_free(chg);
+   };
+
+   netcalc_set_free(empty);
+   netcalc_set_free(ns);
+
+   return(errs);
+}
+
+
+/* end of source */
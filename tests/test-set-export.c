@@ -0,0 +1,565 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_SET_SNAPSHOT_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <errno.h>
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-set-export"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_cmp(
+         netcalc_set_t *               ns1,
+         netcalc_set_t *               ns2 );
+
+
+int
+my_corrupt(
+         const char *                  path,
+         long                          len,
+         long                          off );
+
+
+int
+my_pass(
+         const char *                  name,
+         const char * const *          data,
+         const char *                  superblock );
+
+
+int
+my_ratio(
+         void );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   size_t            errs;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   // check set 2
+   if ((my_pass("set2", test_set2, NULL)))
+      errs++;
+
+   // check set 2 restricted to superblock
+   if ((my_pass("set2", test_set2, "2001:db8::/32")))
+      errs++;
+
+   // check size of list of routes
+   if ((my_ratio()))
+      errs++;
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// compares records, comments, and query results of two sets
+int
+my_cmp(
+         netcalc_set_t *               ns1,
+         netcalc_set_t *               ns2 )
+{
+   int               rc1;
+   int               rc2;
+   int               errs;
+   int               flags;
+   int               depth1;
+   int               depth2;
+   size_t            idx;
+   char *            comment1;
+   char *            comment2;
+   netcalc_net_t *   net1;
+   netcalc_net_t *   net2;
+   netcalc_cur_t *   cur1;
+   netcalc_cur_t *   cur2;
+   char              str1[NETCALC_ADDRESS_LENGTH];
+   char              str2[NETCALC_ADDRESS_LENGTH];
+
+   errs  = 0;
+   flags = NETCALC_FLG_SUPR | NETCALC_FLG_COMPR | NETCALC_FLG_CIDR;
+
+   if ((rc1 = netcalc_cur_init(ns1, &cur1)) != 0)
+      return(1);
+   if ((rc2 = netcalc_cur_init(ns2, &cur2)) != 0)
+   {  netcalc_cur_free(cur1);
+      return(1);
+   };
+
+   // compare records
+   rc1 = netcalc_cur_next(cur1, &net1, &comment1, NULL, NULL, &depth1);
+   rc2 = netcalc_cur_next(cur2, &net2, &comment2, NULL, NULL, &depth2);
+   while( (rc1 == 0) && (rc2 == 0) )
+   {  netcalc_ntop(net1, str1, sizeof(str1), NETCALC_TYPE_ADDRESS, flags);
+      netcalc_ntop(net2, str2, sizeof(str2), NETCALC_TYPE_ADDRESS, flags);
+      if ((verbose))
+         printf("      record %s (depth %i) ...\n", str2, depth2);
+      if ( (strcmp(str1, str2)) || (depth1 != depth2) )
+      {  printf("%s: record %s (depth %i); expected %s (depth %i)\n", PROGRAM_NAME, str2, depth2, str1, depth1);
+         errs++;
+      } else if ( ((!(comment1)) != (!(comment2))) || ( ((comment1)) && ((strcmp(comment1, comment2))) ) )
+      {  printf("%s: record %s: comment \"%s\"; expected \"%s\"\n", PROGRAM_NAME, str2, ((comment2)) ? comment2 : "", ((comment1)) ? comment1 : "");
+         errs++;
+      };
+      netcalc_net_free(net1);
+      netcalc_net_free(net2);
+      free(comment1);
+      free(comment2);
+      rc1 = netcalc_cur_next(cur1, &net1, &comment1, NULL, NULL, &depth1);
+      rc2 = netcalc_cur_next(cur2, &net2, &comment2, NULL, NULL, &depth2);
+   };
+   netcalc_cur_free(cur1);
+   netcalc_cur_free(cur2);
+   if (rc1 != rc2)
+   {  printf("%s: netcalc_cur_next(): %s; expected %s\n", PROGRAM_NAME, netcalc_strerror(rc2), netcalc_strerror(rc1));
+      if ((rc1 == 0))
+      {  netcalc_net_free(net1);
+         free(comment1);
+      };
+      if ((rc2 == 0))
+      {  netcalc_net_free(net2);
+         free(comment2);
+      };
+      return(errs+1);
+   };
+
+   // compare queries
+   for(idx = 0; ((test_query2[idx].query_addr)); idx++)
+   {  net1 = NULL;
+      net2 = NULL;
+      rc1 = netcalc_set_query_str(ns1, test_query2[idx].query_addr, &net1, NULL, NULL, NULL);
+      rc2 = netcalc_set_query_str(ns2, test_query2[idx].query_addr, &net2, NULL, NULL, NULL);
+      str1[0] = '\0';
+      str2[0] = '\0';
+      if ((net1))
+         netcalc_ntop(net1, str1, sizeof(str1), NETCALC_TYPE_ADDRESS, flags);
+      if ((net2))
+         netcalc_ntop(net2, str2, sizeof(str2), NETCALC_TYPE_ADDRESS, flags);
+      if ((net1))
+         netcalc_net_free(net1);
+      if ((net2))
+         netcalc_net_free(net2);
+      if ( (rc1 != rc2) || ((strcmp(str1, str2))) )
+      {  printf("%s: query %s: matched \"%s\"; expected \"%s\"\n", PROGRAM_NAME, test_query2[idx].query_addr, str2, str1);
+         errs++;
+      };
+   };
+
+   return(errs);
+}
+
+
+// writes truncated or modified copy of list
+int
+my_corrupt(
+         const char *                  path,
+         long                          len,
+         long                          off )
+{
+   int               c;
+   long              pos;
+   FILE *            src;
+   FILE *            dst;
+   char              tmp[272];
+
+   snprintf(tmp, sizeof(tmp), "%s.bad", path);
+   if ((src = fopen(path, "rb")) == NULL)
+      return(1);
+   if ((dst = fopen(tmp, "wb")) == NULL)
+   {  fclose(src);
+      return(1);
+   };
+   for(pos = 0; ( ((c = fgetc(src)) != EOF) && (pos != len) ); pos++)
+      fputc( (pos == off) ? (c ^ 0xff) : c, dst);
+   fclose(src);
+   fclose(dst);
+
+   return(0);
+}
+
+
+int
+my_pass(
+         const char *                  name,
+         const char * const *          data,
+         const char *                  superblock )
+{
+   int               fd;
+   int               rc;
+   int               errs;
+   size_t            idx;
+   size_t            len;
+   struct stat       sb;
+   netcalc_set_t *   ns;
+   netcalc_set_t *   list;
+   netcalc_net_t *   net;
+   char              path[256];
+   char              bad[272];
+
+   errs  = 0;
+
+   if ((superblock))
+      printf("testing %s within superblock %s ...\n", name, superblock);
+   else
+      printf("testing %s ...\n", name);
+   printf("   loading set ...\n");
+
+   net = NULL;
+   if ( ((superblock)) && ((rc = netcalc_net_init(&net, superblock, 0)) != 0) )
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   rc = netcalc_set_init(&ns, net, 0);
+   netcalc_net_free(net);
+   if (rc != 0)
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   // add addresses to sets, using odd addresses as comments
+   len = 0;
+   for(idx = 0; ((data[idx])); idx++)
+   {  if ((verbose))
+         printf("      adding %s ...\n", data[idx]);
+      rc = netcalc_set_add_str(ns, data[idx], ((idx & 1)) ? data[idx] : NULL, NULL, 0);
+      if ( (rc != 0) && ( (rc != NETCALC_ERANGE) || (!(superblock)) ) )
+      {  printf("%s: netcalc_set_add_str(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         errs++;
+      };
+      if (rc == 0)
+         len += strlen(data[idx]) + (((idx & 1)) ? strlen(data[idx]) + 2 : 1);
+   };
+
+   // export list
+   printf("   exporting list ...\n");
+   snprintf(path, sizeof(path), "/tmp/netcalc-export-XXXXXX");
+   if ((fd = mkstemp(path)) == -1)
+   {  printf("%s: mkstemp(): unable to create temporary file\n", PROGRAM_NAME);
+      netcalc_set_free(ns);
+      return(1);
+   };
+   close(fd);
+   if ((rc = netcalc_set_export_compact(ns, path)) != 0)
+   {  printf("%s: netcalc_set_export_compact(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      unlink(path);
+      return(1);
+   };
+   if (stat(path, &sb) == 0)
+   {  if ((verbose))
+         printf("      list is %li bytes; text is %zu bytes ...\n", (long)sb.st_size, len);
+      if ((size_t)sb.st_size >= len)
+      {  printf("%s: list is %li bytes; expected less than %zu bytes\n", PROGRAM_NAME, (long)sb.st_size, len);
+         errs++;
+      };
+   };
+
+   // compare imported list with set
+   printf("   importing list ...\n");
+   if ((rc = netcalc_set_import_compact(&list, path)) != 0)
+   {  printf("%s: netcalc_set_import_compact(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      unlink(path);
+      return(1);
+   };
+   errs += my_cmp(ns, list);
+
+   // modify imported set
+   printf("   modifying imported set ...\n");
+   if ((rc = netcalc_set_add_str(ns, "2001:db8:d:102::/64", "added", NULL, 0)) != 0)
+   {  printf("%s: netcalc_set_add_str(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   };
+   if ((rc = netcalc_set_add_str(list, "2001:db8:d:102::/64", "added", NULL, 0)) != 0)
+   {  printf("%s: netcalc_set_add_str(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   };
+   if ( ((superblock)) && ((rc = netcalc_set_add_str(list, "2001:db9::/64", NULL, NULL, 0)) != NETCALC_ERANGE) )
+   {  printf("%s: netcalc_set_add_str(): expected %s; received %s\n", PROGRAM_NAME, netcalc_strerror(NETCALC_ERANGE), netcalc_strerror(rc));
+      errs++;
+   };
+   errs += my_cmp(ns, list);
+   netcalc_set_free(list);
+
+   // verify damaged lists are rejected
+   printf("   checking damaged lists ...\n");
+   snprintf(bad, sizeof(bad), "%s.bad", path);
+   if ((rc = netcalc_set_import_compact(&list, bad)) != NETCALC_EIO)
+   {  printf("%s: missing file: expected %s; received %s\n", PROGRAM_NAME, netcalc_strerror(NETCALC_EIO), netcalc_strerror(rc));
+      netcalc_set_free(list);
+      errs++;
+   };
+   my_corrupt(path, -1, 0);
+   if ((rc = netcalc_set_import_compact(&list, bad)) != NETCALC_EBADFILE)
+   {  printf("%s: bad magic: expected %s; received %s\n", PROGRAM_NAME, netcalc_strerror(NETCALC_EBADFILE), netcalc_strerror(rc));
+      netcalc_set_free(list);
+      errs++;
+   };
+   my_corrupt(path, (long)sb.st_size - 1, -1);
+   if ((rc = netcalc_set_import_compact(&list, bad)) != NETCALC_EBADFILE)
+   {  printf("%s: truncated: expected %s; received %s\n", PROGRAM_NAME, netcalc_strerror(NETCALC_EBADFILE), netcalc_strerror(rc));
+      netcalc_set_free(list);
+      errs++;
+   };
+   for(idx = 8; (idx < (size_t)sb.st_size); idx++)
+   {  my_corrupt(path, -1, (long)idx);
+      if ((rc = netcalc_set_import_compact(&list, bad)) == 0)
+         netcalc_set_free(list);
+   };
+   unlink(bad);
+
+   unlink(path);
+   netcalc_set_free(ns);
+
+   return(errs);
+}
+
+
+// verifies list of a table of routes is at least four times smaller than
+// the same routes listed as text
+int
+my_ratio(
+         void )
+{
+   int               rc;
+   int               fd;
+   int               cidr;
+   int               errs;
+   size_t            idx;
+   size_t            len;
+   uint32_t          pos;
+   uint32_t          span;
+   uint32_t          state;
+   netcalc_set_t *   ns;
+   netcalc_set_t *   list;
+   struct stat       sb;
+   char              path[256];
+   char              line[128];
+   char              comment[16];
+
+   printf("testing table of routes ...\n");
+
+   if ((rc = netcalc_set_init(&ns, NULL, 0)) != 0)
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   // add IPv4 routes of /22 to /24 and IPv6 routes of /44 to /48 with gaps
+   // between routes, each route is commented with one of a few origins
+   errs  = 0;
+   len   = 0;
+   state = 1;
+   for(idx = 0, pos = 0; (idx < 4096); idx++)
+   {  state = (state * 1103515245) + 12345;
+      cidr  = 22 + (int)((state >> 16) % 3);
+      span  = 1U << (24 - cidr);
+      pos   = ((pos + span - 1) & ~(span - 1));
+      snprintf(comment, sizeof(comment), "AS%u", 64496 + ((state >> 20) & 0x0f));
+      len  += (size_t)snprintf(line, sizeof(line), "10.%u.%u.0/%i", (pos >> 8) & 0xff, pos & 0xff, cidr);
+      len  += strlen(comment) + 2;
+      if ((rc = netcalc_set_add_str(ns, line, comment, NULL, 0)) != 0)
+      {  printf("%s: netcalc_set_add_str(%s): %s\n", PROGRAM_NAME, line, netcalc_strerror(rc));
+         errs++;
+      };
+      pos  += span + ((state >> 24) & 0x03);
+   };
+   for(idx = 0, pos = 0; (idx < 4096); idx++)
+   {  state = (state * 1103515245) + 12345;
+      cidr  = 44 + (int)((state >> 16) % 5);
+      span  = 1U << (48 - cidr);
+      pos   = ((pos + span - 1) & ~(span - 1));
+      snprintf(comment, sizeof(comment), "AS%u", 64496 + ((state >> 20) & 0x0f));
+      len  += (size_t)snprintf(line, sizeof(line), "2001:db8:%x::/%i", pos & 0xffff, cidr);
+      len  += strlen(comment) + 2;
+      if ((rc = netcalc_set_add_str(ns, line, comment, NULL, 0)) != 0)
+      {  printf("%s: netcalc_set_add_str(%s): %s\n", PROGRAM_NAME, line, netcalc_strerror(rc));
+         errs++;
+      };
+      pos  += span + ((state >> 24) & 0x03);
+   };
+
+   snprintf(path, sizeof(path), "/tmp/netcalc-export-XXXXXX");
+   if ((fd = mkstemp(path)) == -1)
+   {  printf("%s: mkstemp(): unable to create temporary file\n", PROGRAM_NAME);
+      netcalc_set_free(ns);
+      return(1);
+   };
+   close(fd);
+   if ((rc = netcalc_set_export_compact(ns, path)) != 0)
+   {  printf("%s: netcalc_set_export_compact(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      unlink(path);
+      return(1);
+   };
+   if (stat(path, &sb) != 0)
+   {  printf("%s: stat(): unable to read size of list\n", PROGRAM_NAME);
+      errs++;
+   } else
+   {  if ((verbose))
+         printf("   list is %li bytes; text is %zu bytes ...\n", (long)sb.st_size, len);
+      if (((size_t)sb.st_size * 4) > len)
+      {  printf("%s: list is %li bytes; expected at most %zu bytes\n", PROGRAM_NAME, (long)sb.st_size, len / 4);
+         errs++;
+      };
+   };
+
+   if ((rc = netcalc_set_import_compact(&list, path)) != 0)
+   {  printf("%s: netcalc_set_import_compact(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   } else
+   {  errs += my_cmp(ns, list);
+      netcalc_set_free(list);
+   };
+
+   unlink(path);
+   netcalc_set_free(ns);
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+/* end of source */
@@ -0,0 +1,395 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_SET_FREE_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <errno.h>
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-set-free"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_check(
+         netcalc_set_t *               ns,
+         const char *                  name,
+         const char **                 exp );
+
+
+int
+my_pass(
+         const char *                  name,
+         const char * const *          data,
+         const testfree_t *            tests );
+
+
+int
+my_pass_superblock(
+         const char *                  name,
+         const char * const *          data,
+         const testfree_t *            test );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   size_t            errs;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   // check set 2
+   if ((my_pass("set2", test_set2, test_free2)))
+      errs++;
+
+   // check set 2 restricted to superblock
+   if ((my_pass_superblock("set2", test_set2, &test_free2[0])))
+      errs++;
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+int
+my_check(
+         netcalc_set_t *               ns,
+         const char *                  name,
+         const char **                 exp )
+{
+   int               rc;
+   int               errs;
+   int               flags;
+   size_t            idx;
+   netcalc_net_t *   net;
+   netcalc_net_t *   blk;
+   netcalc_cur_t *   cur;
+   char              blk_str[NETCALC_ADDRESS_LENGTH];
+
+   errs  = 0;
+   flags = NETCALC_FLG_SUPR | NETCALC_FLG_COMPR | NETCALC_FLG_CIDR;
+   net   = NULL;
+
+   if (!(quiet))
+      printf("   checking free blocks within %s ...\n", ((name)) ? name : "superblock");
+
+   if ((name))
+   {  if ((rc = netcalc_net_init(&net, name, 0)) != 0)
+      {  printf("%s: %s: netcalc_net_init(): %s\n", PROGRAM_NAME, name, netcalc_strerror(rc));
+         return(1);
+      };
+   };
+
+   if ((rc = netcalc_set_free_blocks(ns, net, &cur)) != 0)
+   {  printf("%s: netcalc_set_free_blocks(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      if ((net))
+         netcalc_net_free(net);
+      return(1);
+   };
+   if ((net))
+      netcalc_net_free(net);
+
+   for(idx = 0; ((rc = netcalc_cur_next(cur, &blk, NULL, NULL, NULL, NULL)) == 0); idx++)
+   {  netcalc_ntop(blk, blk_str, sizeof(blk_str), NETCALC_TYPE_ADDRESS, flags);
+      netcalc_net_free(blk);
+      if ((verbose))
+         printf("      free block %s ...\n", blk_str);
+      if (!(exp[idx]))
+      {  printf("%s: unexpected free block %s\n", PROGRAM_NAME, blk_str);
+         errs++;
+         break;
+      };
+      if ((strcmp(blk_str, exp[idx])))
+      {  printf("%s: free block %s; expected %s\n", PROGRAM_NAME, blk_str, exp[idx]);
+         errs++;
+         break;
+      };
+   };
+   if ( (rc == NETCALC_ENOREC) && ((exp[idx])) )
+   {  printf("%s: missing free block %s\n", PROGRAM_NAME, exp[idx]);
+      errs++;
+   };
+   if ( (rc != 0) && (rc != NETCALC_ENOREC) )
+   {  printf("%s: netcalc_cur_next(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   };
+
+   // verify cursor can be restarted
+   if ( (!(errs)) && ((exp[0])) )
+   {  if ((rc = netcalc_cur_first(cur, &blk, NULL, NULL, NULL, NULL)) != 0)
+      {  printf("%s: netcalc_cur_first(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         errs++;
+      } else
+      {  netcalc_ntop(blk, blk_str, sizeof(blk_str), NETCALC_TYPE_ADDRESS, flags);
+         netcalc_net_free(blk);
+         if ((strcmp(blk_str, exp[0])))
+         {  printf("%s: restarted free block %s; expected %s\n", PROGRAM_NAME, blk_str, exp[0]);
+            errs++;
+         };
+      };
+   };
+
+   netcalc_cur_free(cur);
+
+   return(errs);
+}
+
+
+int
+my_pass(
+         const char *                  name,
+         const char * const *          data,
+         const testfree_t *            tests )
+{
+   int               rc;
+   int               errs;
+   size_t            idx;
+   netcalc_set_t *   ns;
+
+   errs  = 0;
+
+   printf("testing %s ...\n", name);
+   printf("   loading set ...\n");
+
+   if ((rc = netcalc_set_init(&ns, NULL, 0)) != 0)
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   // add addresses to sets
+   for(idx = 0; ((data[idx])); idx++)
+   {  if ((verbose))
+         printf("      adding %s ...\n", data[idx]);
+      if ((rc = netcalc_set_add_str(ns, data[idx], NULL, NULL, 0)) != 0)
+      {  printf("%s: netcalc_set_add_str(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         errs++;
+      };
+   };
+
+   // check free blocks
+   for(idx = 0; ((tests[idx].free_net)); idx++)
+      errs += my_check(ns, tests[idx].free_net, tests[idx].free_exp);
+
+   netcalc_set_free(ns);
+
+   return(errs);
+}
+
+
+int
+my_pass_superblock(
+         const char *                  name,
+         const char * const *          data,
+         const testfree_t *            test )
+{
+   int               rc;
+   int               errs;
+   int               flags;
+   size_t            idx;
+   netcalc_set_t *   ns;
+   netcalc_net_t *   superblock;
+   netcalc_net_t *   blk;
+   netcalc_cur_t *   cur;
+   char              blk_str[NETCALC_ADDRESS_LENGTH];
+
+   errs  = 0;
+   flags = NETCALC_FLG_SUPR | NETCALC_FLG_COMPR | NETCALC_FLG_CIDR;
+
+   printf("testing %s within superblock %s ...\n", name, test->free_net);
+   printf("   loading set ...\n");
+
+   if ((rc = netcalc_net_init(&superblock, test->free_net, 0)) != 0)
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   rc = netcalc_set_init(&ns, superblock, 0);
+   netcalc_net_free(superblock);
+   if (rc != 0)
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   // add addresses within superblock to sets
+   for(idx = 0; ((data[idx])); idx++)
+   {  rc = netcalc_set_add_str(ns, data[idx], NULL, NULL, 0);
+      if ( (rc != 0) && (rc != NETCALC_ERANGE) )
+      {  printf("%s: netcalc_set_add_str(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         errs++;
+      };
+   };
+
+   // check free blocks
+   errs += my_check(ns, NULL, test->free_exp);
+
+   // verify cursor is invalidated by modifying set
+   printf("   checking modified set ...\n");
+   if ((rc = netcalc_set_free_blocks(ns, NULL, &cur)) != 0)
+   {  printf("%s: netcalc_set_free_blocks(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      return(errs+1);
+   };
+   if ((rc = netcalc_set_add_str(ns, test->free_exp[0], NULL, NULL, 0)) != 0)
+   {  printf("%s: netcalc_set_add_str(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   };
+   if ((rc = netcalc_cur_next(cur, NULL, NULL, NULL, NULL, NULL)) != NETCALC_ESETMOD)
+   {  printf("%s: netcalc_cur_next(): expected %s; received %s\n", PROGRAM_NAME, netcalc_strerror(NETCALC_ESETMOD), netcalc_strerror(rc));
+      errs++;
+   };
+   if ((rc = netcalc_cur_first(cur, &blk, NULL, NULL, NULL, NULL)) != 0)
+   {  printf("%s: netcalc_cur_first(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   } else
+   {  netcalc_ntop(blk, blk_str, sizeof(blk_str), NETCALC_TYPE_ADDRESS, flags);
+      netcalc_net_free(blk);
+      if ((strcmp(blk_str, test->free_exp[1])))
+      {  printf("%s: free block %s; expected %s\n", PROGRAM_NAME, blk_str, test->free_exp[1]);
+         errs++;
+      };
+   };
+   netcalc_cur_free(cur);
+
+   netcalc_set_free(ns);
+
+   return(errs);
+}
+
+
+/* end of source */
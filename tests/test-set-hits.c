@@ -0,0 +1,364 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_SET_HITS_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <errno.h>
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-set-hits"
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+// MARK: - Datatypes
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_expected(
+         const char *                  str,
+         int                           flags );
+
+
+int
+my_pass(
+         const char *                  name,
+         int                           flags );
+
+
+int
+my_query(
+         netcalc_set_t *               ns );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   size_t            errs;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   // check set 2 without counting queries
+   if ((my_pass("set2", 0)))
+      errs++;
+
+   // check set 2 counting queries
+   if ((my_pass("set2", NETCALC_FLG_COUNT)))
+      errs++;
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// returns number of queries expected to match the network
+int
+my_expected(
+         const char *                  str,
+         int                           flags )
+{
+   size_t            idx;
+   int               hits;
+   netcalc_net_t *   exp;
+   char              exp_str[NETCALC_ADDRESS_LENGTH];
+
+   hits = 0;
+   for(idx = 0; ((test_query2[idx].query_addr)); idx++)
+   {  if (!(test_query2[idx].query_exp))
+         continue;
+      if (netcalc_net_init(&exp, test_query2[idx].query_exp, 0) != 0)
+         continue;
+      netcalc_ntop(exp, exp_str, sizeof(exp_str), NETCALC_TYPE_ADDRESS, flags);
+      netcalc_net_free(exp);
+      if (!(strcmp(str, exp_str)))
+         hits += (int)idx + 1;
+   };
+
+   return(hits);
+}
+
+
+int
+my_pass(
+         const char *                  name,
+         int                           flags )
+{
+   int                     rc;
+   int                     errs;
+   int                     exp;
+   int                     fmt;
+   size_t                  idx;
+   size_t                  count;
+   size_t                  nonzero;
+   uintmax_t               hits;
+   uintmax_t               max;
+   netcalc_set_t *         ns;
+   netcalc_net_t *         net;
+   netcalc_cur_t *         cur;
+   netcalc_rec_t *         rec;
+   const netcalc_rec_t *   top[3];
+   char                    str[NETCALC_ADDRESS_LENGTH];
+
+   errs  = 0;
+   fmt   = NETCALC_FLG_SUPR | NETCALC_FLG_COMPR | NETCALC_FLG_CIDR;
+
+   printf("testing %s%s ...\n", name, ((flags & NETCALC_FLG_COUNT)) ? " counting queries" : "");
+
+   if ((rc = netcalc_set_init(&ns, NULL, flags)) != 0)
+   {  printf("%s: netcalc_set_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   for(idx = 0; ((test_set2[idx])); idx++)
+   {  if ((rc = netcalc_set_add_str(ns, test_set2[idx], NULL, NULL, 0)) != 0)
+      {  printf("%s: netcalc_set_add_str(%s): %s\n", PROGRAM_NAME, test_set2[idx], netcalc_strerror(rc));
+         netcalc_set_free(ns);
+         return(1);
+      };
+   };
+
+   // query each address one more time than the previous address
+   if ((my_query(ns)))
+   {  netcalc_set_free(ns);
+      return(1);
+   };
+
+   // verify counters of records
+   printf("   checking counters ...\n");
+   if ((rc = netcalc_cur_init(ns, &cur)) != 0)
+   {  printf("%s: netcalc_cur_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      return(1);
+   };
+   nonzero  = 0;
+   max      = 0;
+   while((rc = netcalc_cur_next(cur, &net, NULL, NULL, NULL, NULL)) == 0)
+   {  netcalc_ntop(net, str, sizeof(str), NETCALC_TYPE_ADDRESS, fmt);
+      netcalc_net_free(net);
+      if ((rec = netcalc_cur_record(cur)) == NULL)
+      {  printf("%s: netcalc_cur_record(): record %s not returned\n", PROGRAM_NAME, str);
+         errs++;
+         continue;
+      };
+      exp   = ((flags & NETCALC_FLG_COUNT)) ? my_expected(str, fmt) : 0;
+      hits  = netcalc_rec_hits(rec);
+      if ((verbose))
+         printf("      record %s: %ju hits\n", str, hits);
+      if (hits != (uintmax_t)exp)
+      {  printf("%s: record %s: %ju hits; expected %i hits\n", PROGRAM_NAME, str, hits, exp);
+         errs++;
+      };
+      nonzero  += ((exp)) ? 1 : 0;
+      max       = ((uintmax_t)exp > max) ? (uintmax_t)exp : max;
+   };
+   if (rc != NETCALC_ENOREC)
+   {  printf("%s: netcalc_cur_next(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   };
+   if (netcalc_cur_record(cur) != NULL)
+   {  printf("%s: netcalc_cur_record(): record returned after end of set\n", PROGRAM_NAME);
+      errs++;
+   };
+   netcalc_cur_free(cur);
+
+   // verify most frequently matched records
+   printf("   checking most frequently matched records ...\n");
+   if ((rc = netcalc_set_hits_top(ns, top, (sizeof(top)/sizeof(top[0])), &count)) != 0)
+   {  printf("%s: netcalc_set_hits_top(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      return(errs+1);
+   };
+   if (count != ((nonzero < 3) ? nonzero : 3))
+   {  printf("%s: netcalc_set_hits_top(): %zu records; expected %zu records\n", PROGRAM_NAME, count, ((nonzero < 3) ? nonzero : 3));
+      errs++;
+   };
+   if ( ((count)) && (netcalc_rec_hits(top[0]) != max) )
+   {  printf("%s: netcalc_set_hits_top(): %ju hits; expected %ju hits\n", PROGRAM_NAME, netcalc_rec_hits(top[0]), max);
+      errs++;
+   };
+   for(idx = 1; (idx < count); idx++)
+   {  if (netcalc_rec_hits(top[idx-1]) < netcalc_rec_hits(top[idx]))
+      {  printf("%s: netcalc_set_hits_top(): records not in descending order\n", PROGRAM_NAME);
+         errs++;
+      };
+   };
+
+   // verify counters are cleared
+   printf("   checking reset of counters ...\n");
+   netcalc_set_hits_reset(ns);
+   if ( ((rc = netcalc_set_hits_top(ns, top, (sizeof(top)/sizeof(top[0])), &count)) != 0) || ((count)) )
+   {  printf("%s: netcalc_set_hits_reset(): %zu records with hits; expected 0 records\n", PROGRAM_NAME, count);
+      errs++;
+   };
+
+   netcalc_set_free(ns);
+
+   return(errs);
+}
+
+
+// queries each address one more time than the previous address
+int
+my_query(
+         netcalc_set_t *               ns )
+{
+   int               rc;
+   size_t            idx;
+   size_t            pass;
+
+   for(idx = 0; ((test_query2[idx].query_addr)); idx++)
+   {  for(pass = 0; (pass <= idx); pass++)
+      {  rc = netcalc_set_query_str(ns, test_query2[idx].query_addr, NULL, NULL, NULL, NULL);
+         if ( (rc != 0) && (rc != NETCALC_ENOREC) )
+         {  printf("%s: query %s: %s\n", PROGRAM_NAME, test_query2[idx].query_addr, netcalc_strerror(rc));
+            return(1);
+         };
+      };
+   };
+
+   return(0);
+}
+
+
+/* end of source */
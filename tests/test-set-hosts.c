@@ -0,0 +1,461 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_SET_HOSTS_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <errno.h>
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-set-hosts"
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+// MARK: - Datatypes
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_cmp(
+         netcalc_set_t *               ns,
+         netcalc_set_t *               ref,
+         size_t                        first,
+         size_t                        last );
+
+
+int
+my_load(
+         netcalc_set_t **              nsp,
+         int                           flags );
+
+
+int
+my_modify(
+         netcalc_set_t *               ns,
+         netcalc_set_t *               ref,
+         size_t                        first,
+         size_t                        last,
+         int                           add );
+
+
+int
+my_query(
+         netcalc_set_t *               ns,
+         netcalc_set_t *               ref,
+         const char *                  address );
+
+
+int
+my_stats(
+         netcalc_set_t *               ns,
+         netcalc_set_t *               ref );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               fd;
+   int               rc;
+   int               opt_index;
+   size_t            errs;
+   netcalc_set_t *   ns;
+   netcalc_set_t *   ref;
+   netcalc_set_t *   clone;
+   netcalc_set_t *   ref_clone;
+   netcalc_set_t *   snap;
+   char              path[256];
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   printf("testing set2 ...\n");
+   if ((my_load(&ns, NETCALC_FLG_HOSTS)))
+      return(1);
+   if ((my_load(&ref, 0)))
+      return(1);
+   errs += (size_t)my_cmp(ns, ref, 0, 0);
+   errs += (size_t)my_stats(ns, ref);
+
+   // verify index is maintained while records are added and deleted
+   printf("testing additions and deletions ...\n");
+   errs += (size_t)my_modify(ns, ref, 0, 1000, 1);
+   errs += (size_t)my_cmp(ns, ref, 0, 1000);
+   errs += (size_t)my_stats(ns, ref);
+   errs += (size_t)my_modify(ns, ref, 0, 1000, 0);
+   errs += (size_t)my_modify(ns, ref, 500, 1000, 1);
+   errs += (size_t)my_cmp(ns, ref, 0, 1000);
+   errs += (size_t)my_stats(ns, ref);
+
+   // verify index references copies of records shared with clones
+   printf("testing clones ...\n");
+   if ( ((rc = netcalc_set_clone(&clone, ns)) != 0) || ((rc = netcalc_set_clone(&ref_clone, ref)) != 0) )
+   {  printf("%s: netcalc_set_clone(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   if (netcalc_set_add_str(ns, "2001:db8:aa::1f5", NULL, NULL, 0) != NETCALC_EEXISTS)
+   {  printf("%s: netcalc_set_add_str(2001:db8:aa::1f5): added existing network\n", PROGRAM_NAME);
+      errs++;
+   };
+   errs += (size_t)my_modify(clone, ref_clone, 500, 750, 0);
+   errs += (size_t)my_modify(ns, ref, 750, 1000, 0);
+   errs += (size_t)my_cmp(clone, ref_clone, 0, 1000);
+   errs += (size_t)my_stats(clone, ref_clone);
+   netcalc_set_free(clone);
+   netcalc_set_free(ref_clone);
+   errs += (size_t)my_cmp(ns, ref, 0, 1000);
+   errs += (size_t)my_stats(ns, ref);
+
+   // verify index of set opened from snapshot
+   printf("testing snapshots ...\n");
+   snprintf(path, sizeof(path), "/tmp/netcalc-hosts-XXXXXX");
+   if ((fd = mkstemp(path)) == -1)
+   {  printf("%s: mkstemp(): unable to create temporary file\n", PROGRAM_NAME);
+      return(1);
+   };
+   close(fd);
+   if ((rc = netcalc_set_save(ns, path)) != 0)
+   {  printf("%s: netcalc_set_save(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      unlink(path);
+      return(1);
+   };
+   rc = netcalc_set_open_mmap(&snap, path);
+   unlink(path);
+   if (rc != 0)
+   {  printf("%s: netcalc_set_open_mmap(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   errs += (size_t)my_cmp(snap, ref, 0, 1000);
+   errs += (size_t)my_stats(snap, ref);
+   errs += (size_t)my_modify(snap, ref, 0, 250, 1);
+   errs += (size_t)my_cmp(snap, ref, 0, 1000);
+   errs += (size_t)my_stats(snap, ref);
+   netcalc_set_free(snap);
+
+   netcalc_set_free(ns);
+   netcalc_set_free(ref);
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// compares results of querying addresses of set 2 and hosts within range
+// with results of the reference set
+int
+my_cmp(
+         netcalc_set_t *               ns,
+         netcalc_set_t *               ref,
+         size_t                        first,
+         size_t                        last )
+{
+   int               errs;
+   size_t            idx;
+   char              addr[NETCALC_ADDRESS_LENGTH];
+
+   errs = 0;
+
+   for(idx = 0; ((test_query2[idx].query_addr)); idx++)
+      errs += my_query(ns, ref, test_query2[idx].query_addr);
+   for(idx = 0; ((test_set2[idx])); idx++)
+      errs += my_query(ns, ref, test_set2[idx]);
+   for(idx = first; (idx < last); idx++)
+   {  snprintf(addr, sizeof(addr), "2001:db8:aa::%zx", idx);
+      errs += my_query(ns, ref, addr);
+   };
+
+   return(errs);
+}
+
+
+int
+my_load(
+         netcalc_set_t **              nsp,
+         int                           flags )
+{
+   int               rc;
+   size_t            idx;
+
+   if ((rc = netcalc_set_init(nsp, NULL, flags)) != 0)
+   {  printf("%s: netcalc_set_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   for(idx = 0; ((test_set2[idx])); idx++)
+   {  if ((rc = netcalc_set_add_str(*nsp, test_set2[idx], NULL, NULL, 0)) != 0)
+      {  printf("%s: netcalc_set_add_str(%s): %s\n", PROGRAM_NAME, test_set2[idx], netcalc_strerror(rc));
+         netcalc_set_free(*nsp);
+         return(1);
+      };
+   };
+
+   return(0);
+}
+
+
+// adds or deletes hosts within range to both sets
+int
+my_modify(
+         netcalc_set_t *               ns,
+         netcalc_set_t *               ref,
+         size_t                        first,
+         size_t                        last,
+         int                           add )
+{
+   int               rc;
+   size_t            idx;
+   netcalc_net_t *   net;
+   char              addr[NETCALC_ADDRESS_LENGTH];
+
+   printf("   %s hosts %zu to %zu ...\n", ((add)) ? "adding" : "deleting", first, last - 1);
+
+   for(idx = first; (idx < last); idx++)
+   {  snprintf(addr, sizeof(addr), "2001:db8:aa::%zx", idx);
+      if ((rc = netcalc_net_init(&net, addr, 0)) != 0)
+      {  printf("%s: %s: %s\n", PROGRAM_NAME, addr, netcalc_strerror(rc));
+         return(1);
+      };
+      if ((add))
+      {  if ((rc = netcalc_set_add(ns, net, NULL, NULL, 0)) == 0)
+            rc = netcalc_set_add(ref, net, NULL, NULL, 0);
+      } else
+      {  if ((rc = netcalc_set_del(ns, net)) == 0)
+            rc = netcalc_set_del(ref, net);
+      };
+      netcalc_net_free(net);
+      if (rc != 0)
+      {  printf("%s: %s: %s\n", PROGRAM_NAME, addr, netcalc_strerror(rc));
+         return(1);
+      };
+   };
+
+   return(0);
+}
+
+
+int
+my_query(
+         netcalc_set_t *               ns,
+         netcalc_set_t *               ref,
+         const char *                  address )
+{
+   int               rc1;
+   int               rc2;
+   int               flags;
+   netcalc_net_t *   net1;
+   netcalc_net_t *   net2;
+   char              str1[NETCALC_ADDRESS_LENGTH];
+   char              str2[NETCALC_ADDRESS_LENGTH];
+
+   flags = NETCALC_FLG_SUPR | NETCALC_FLG_COMPR | NETCALC_FLG_CIDR;
+   net1  = NULL;
+   net2  = NULL;
+
+   rc1 = netcalc_set_query_str(ref, address, &net1, NULL, NULL, NULL);
+   rc2 = netcalc_set_query_str(ns,  address, &net2, NULL, NULL, NULL);
+   str1[0] = '\0';
+   str2[0] = '\0';
+   if ((net1))
+      netcalc_ntop(net1, str1, sizeof(str1), NETCALC_TYPE_ADDRESS, flags);
+   if ((net2))
+      netcalc_ntop(net2, str2, sizeof(str2), NETCALC_TYPE_ADDRESS, flags);
+   if ((net1))
+      netcalc_net_free(net1);
+   if ((net2))
+      netcalc_net_free(net2);
+   if ((verbose))
+      printf("      query %s: matched \"%s\" ...\n", address, str2);
+   if ( (rc1 != rc2) || ((strcmp(str1, str2))) )
+   {  printf("%s: query %s: matched \"%s\"; expected \"%s\"\n", PROGRAM_NAME, address, str2, str1);
+      return(1);
+   };
+
+   return(0);
+}
+
+
+// verifies index contains each host record of the reference set
+int
+my_stats(
+         netcalc_set_t *               ns,
+         netcalc_set_t *               ref )
+{
+   int               rc;
+   int               errs;
+   size_t            hosts;
+   size_t            count;
+   size_t            slots;
+   size_t            bytes;
+   size_t            probes;
+   size_t            maxprobe;
+   netcalc_net_t *   net;
+   netcalc_cur_t *   cur;
+   char              str[NETCALC_ADDRESS_LENGTH];
+
+   errs = 0;
+
+   // count records without prefix length
+   if ((rc = netcalc_cur_init(ref, &cur)) != 0)
+      return(1);
+   hosts = 0;
+   while((rc = netcalc_cur_next(cur, &net, NULL, NULL, NULL, NULL)) == 0)
+   {  netcalc_ntop(net, str, sizeof(str), NETCALC_TYPE_ADDRESS, NETCALC_FLG_CIDR);
+      netcalc_net_free(net);
+      hosts += (!(strchr(str, '/'))) ? 1 : 0;
+   };
+   netcalc_cur_free(cur);
+
+   netcalc_set_hosts_stats(ns, &count, &slots, &bytes, &probes, &maxprobe);
+   if ((verbose))
+      printf("      index: %zu hosts, %zu slots, %zu bytes, %zu probes, %zu maximum probe length\n", count, slots, bytes, probes, maxprobe);
+   if (count != hosts)
+   {  printf("%s: netcalc_set_hosts_stats(): %zu hosts; expected %zu hosts\n", PROGRAM_NAME, count, hosts);
+      errs++;
+   };
+   if ( ((count)) && ( (slots < (count * 2)) || (bytes < (slots * sizeof(void *))) || (probes < count) || (maxprobe < 1) ) )
+   {  printf("%s: netcalc_set_hosts_stats(): invalid statistics\n", PROGRAM_NAME);
+      errs++;
+   };
+
+   return(errs);
+}
+
+
+/* end of source */
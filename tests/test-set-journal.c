@@ -0,0 +1,735 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_SET_SNAPSHOT_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <errno.h>
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-set-journal"
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_cmp(
+         netcalc_set_t *               ns1,
+         netcalc_set_t *               ns2 );
+
+
+int
+my_expect(
+         netcalc_set_t *               ns,
+         const char * const *          data,
+         const char *                  superblock );
+
+
+int
+my_full( void );
+
+
+int
+my_pass(
+         const char *                  name,
+         const char * const *          data,
+         const char *                  superblock );
+
+
+int
+my_replay(
+         netcalc_set_t *               ns,
+         const char *                  snapshot,
+         const char *                  journal );
+
+
+int
+my_uniq( void );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   size_t            errs;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   // check set 2
+   if ((my_pass("set2", test_set2, NULL)))
+      errs++;
+
+   // check set 2 restricted to superblock
+   if ((my_pass("set2", test_set2, "2001:db8::/32")))
+      errs++;
+
+   // check journal which cannot be written
+   if ((my_full()))
+      errs++;
+
+   // check replay of unique set within superblock
+   if ((my_uniq()))
+      errs++;
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// compares records, comments, and query results of two sets
+int
+my_cmp(
+         netcalc_set_t *               ns1,
+         netcalc_set_t *               ns2 )
+{
+   int               rc1;
+   int               rc2;
+   int               errs;
+   int               flags;
+   int               depth1;
+   int               depth2;
+   size_t            idx;
+   char *            comment1;
+   char *            comment2;
+   netcalc_net_t *   net1;
+   netcalc_net_t *   net2;
+   netcalc_cur_t *   cur1;
+   netcalc_cur_t *   cur2;
+   char              str1[NETCALC_ADDRESS_LENGTH];
+   char              str2[NETCALC_ADDRESS_LENGTH];
+
+   errs  = 0;
+   flags = NETCALC_FLG_SUPR | NETCALC_FLG_COMPR | NETCALC_FLG_CIDR;
+
+   if ((rc1 = netcalc_cur_init(ns1, &cur1)) != 0)
+      return(1);
+   if ((rc2 = netcalc_cur_init(ns2, &cur2)) != 0)
+   {  netcalc_cur_free(cur1);
+      return(1);
+   };
+
+   // compare records
+   rc1 = netcalc_cur_next(cur1, &net1, &comment1, NULL, NULL, &depth1);
+   rc2 = netcalc_cur_next(cur2, &net2, &comment2, NULL, NULL, &depth2);
+   while( (rc1 == 0) && (rc2 == 0) )
+   {  netcalc_ntop(net1, str1, sizeof(str1), NETCALC_TYPE_ADDRESS, flags);
+      netcalc_ntop(net2, str2, sizeof(str2), NETCALC_TYPE_ADDRESS, flags);
+      if ((verbose))
+         printf("      record %s (depth %i) ...\n", str2, depth2);
+      if ( (strcmp(str1, str2)) || (depth1 != depth2) )
+      {  printf("%s: record %s (depth %i); expected %s (depth %i)\n", PROGRAM_NAME, str2, depth2, str1, depth1);
+         errs++;
+      } else if ( ((!(comment1)) != (!(comment2))) || ( ((comment1)) && ((strcmp(comment1, comment2))) ) )
+      {  printf("%s: record %s: comment \"%s\"; expected \"%s\"\n", PROGRAM_NAME, str2, ((comment2)) ? comment2 : "", ((comment1)) ? comment1 : "");
+         errs++;
+      };
+      netcalc_net_free(net1);
+      netcalc_net_free(net2);
+      free(comment1);
+      free(comment2);
+      rc1 = netcalc_cur_next(cur1, &net1, &comment1, NULL, NULL, &depth1);
+      rc2 = netcalc_cur_next(cur2, &net2, &comment2, NULL, NULL, &depth2);
+   };
+   netcalc_cur_free(cur1);
+   netcalc_cur_free(cur2);
+   if (rc1 != rc2)
+   {  printf("%s: netcalc_cur_next(): %s; expected %s\n", PROGRAM_NAME, netcalc_strerror(rc2), netcalc_strerror(rc1));
+      if ((rc1 == 0))
+      {  netcalc_net_free(net1);
+         free(comment1);
+      };
+      if ((rc2 == 0))
+      {  netcalc_net_free(net2);
+         free(comment2);
+      };
+      return(errs+1);
+   };
+
+   // compare queries
+   for(idx = 0; ((test_query2[idx].query_addr)); idx++)
+   {  net1 = NULL;
+      net2 = NULL;
+      rc1 = netcalc_set_query_str(ns1, test_query2[idx].query_addr, &net1, NULL, NULL, NULL);
+      rc2 = netcalc_set_query_str(ns2, test_query2[idx].query_addr, &net2, NULL, NULL, NULL);
+      str1[0] = '\0';
+      str2[0] = '\0';
+      if ((net1))
+         netcalc_ntop(net1, str1, sizeof(str1), NETCALC_TYPE_ADDRESS, flags);
+      if ((net2))
+         netcalc_ntop(net2, str2, sizeof(str2), NETCALC_TYPE_ADDRESS, flags);
+      if ((net1))
+         netcalc_net_free(net1);
+      if ((net2))
+         netcalc_net_free(net2);
+      if ( (rc1 != rc2) || ((strcmp(str1, str2))) )
+      {  printf("%s: query %s: matched \"%s\"; expected \"%s\"\n", PROGRAM_NAME, test_query2[idx].query_addr, str2, str1);
+         errs++;
+      };
+   };
+
+   return(errs);
+}
+
+
+// builds set from surviving records and compares with modified set
+int
+my_expect(
+         netcalc_set_t *               ns,
+         const char * const *          data,
+         const char *                  superblock )
+{
+   int               rc;
+   int               errs;
+   size_t            idx;
+   const char *      comment;
+   netcalc_set_t *   expect;
+   netcalc_net_t *   sb;
+
+   sb = NULL;
+   if ( ((superblock)) && ((rc = netcalc_net_init(&sb, superblock, 0)) != 0) )
+      return(1);
+   rc = netcalc_set_init(&expect, sb, 0);
+   netcalc_net_free(sb);
+   if (rc != 0)
+      return(1);
+
+   for(idx = 0; ((data[idx])); idx++)
+   {  if ((idx % 3) == 0)
+         continue;
+      comment = ((idx & 1)) ? data[idx] : NULL;
+      comment = ((idx % 5) == 0) ? "updated" : comment;
+      netcalc_set_add_str(expect, data[idx], comment, NULL, 0);
+   };
+
+   errs = my_cmp(expect, ns);
+   netcalc_set_free(expect);
+
+   return(errs);
+}
+
+
+// verifies set is not modified when modification cannot be journaled
+int
+my_full( void )
+{
+   int               fd;
+   int               rc;
+   int               errs;
+   off_t             size;
+   char *            comment;
+   netcalc_set_t *   ns;
+   netcalc_net_t *   net;
+   struct stat       sb;
+   struct rlimit     rl;
+   struct rlimit     orig;
+   char              journal[256];
+
+   errs = 0;
+
+   printf("testing journal which cannot be written ...\n");
+
+   if ((rc = netcalc_set_init(&ns, NULL, 0)) != 0)
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   snprintf(journal, sizeof(journal), "/tmp/netcalc-journal-XXXXXX");
+   if ((fd = mkstemp(journal)) == -1)
+   {  printf("%s: mkstemp(): unable to create temporary file\n", PROGRAM_NAME);
+      netcalc_set_free(ns);
+      return(1);
+   };
+   close(fd);
+   if ( ((rc = netcalc_set_journal(ns, journal)) != 0) || ((rc = netcalc_set_add_str(ns, "10.4.0.0/16", "original", NULL, 0)) != 0) )
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      unlink(journal);
+      return(1);
+   };
+
+   // limit size of files to current size of journal
+   if ( (stat(journal, &sb) == -1) || (getrlimit(RLIMIT_FSIZE, &orig) == -1) )
+   {  printf("%s: unable to determine size of journal\n", PROGRAM_NAME);
+      netcalc_set_free(ns);
+      unlink(journal);
+      return(1);
+   };
+   size        = sb.st_size;
+   rl.rlim_cur = (rlim_t)size;
+   rl.rlim_max = orig.rlim_max;
+   signal(SIGXFSZ, SIG_IGN);
+   if (setrlimit(RLIMIT_FSIZE, &rl) == -1)
+   {  printf("%s: setrlimit(): unable to limit size of journal\n", PROGRAM_NAME);
+      netcalc_set_free(ns);
+      unlink(journal);
+      return(1);
+   };
+
+   // modifications fail without modifying set
+   printf("   adding record ...\n");
+   if ((rc = netcalc_set_add_str(ns, "10.5.0.0/16", "added", NULL, 0)) != NETCALC_EIO)
+   {  printf("%s: netcalc_set_add_str(): %s; expected %s\n", PROGRAM_NAME, netcalc_strerror(rc), netcalc_strerror(NETCALC_EIO));
+      errs++;
+   };
+   if ((rc = netcalc_set_query_str(ns, "10.5.0.1", NULL, NULL, NULL, NULL)) != NETCALC_ENOREC)
+   {  printf("%s: netcalc_set_add_str(): record was added\n", PROGRAM_NAME);
+      errs++;
+   };
+
+   printf("   updating record ...\n");
+   if ((rc = netcalc_net_init(&net, "10.4.0.0/16", 0)) != 0)
+   {  printf("%s: netcalc_net_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   } else
+   {  if ((rc = netcalc_set_update(ns, net, "updated", NULL, 0)) != NETCALC_EIO)
+      {  printf("%s: netcalc_set_update(): %s; expected %s\n", PROGRAM_NAME, netcalc_strerror(rc), netcalc_strerror(NETCALC_EIO));
+         errs++;
+      };
+      comment = NULL;
+      rc      = netcalc_set_query_str(ns, "10.4.0.1", NULL, &comment, NULL, NULL);
+      if ( (rc != 0) || (!(comment)) || ((strcmp(comment, "original"))) )
+      {  printf("%s: netcalc_set_update(): record was updated\n", PROGRAM_NAME);
+         errs++;
+      };
+      free(comment);
+
+      printf("   deleting record ...\n");
+      if ((rc = netcalc_set_del(ns, net)) != NETCALC_EIO)
+      {  printf("%s: netcalc_set_del(): %s; expected %s\n", PROGRAM_NAME, netcalc_strerror(rc), netcalc_strerror(NETCALC_EIO));
+         errs++;
+      };
+      if ((rc = netcalc_set_query_str(ns, "10.4.0.1", NULL, NULL, NULL, NULL)) != 0)
+      {  printf("%s: netcalc_set_del(): record was deleted\n", PROGRAM_NAME);
+         errs++;
+      };
+      netcalc_net_free(net);
+   };
+
+   setrlimit(RLIMIT_FSIZE, &orig);
+   signal(SIGXFSZ, SIG_DFL);
+
+   // partial entries are not left in journal
+   if ( (stat(journal, &sb) == -1) || (sb.st_size != size) )
+   {  printf("%s: failed modifications were written to journal\n", PROGRAM_NAME);
+      errs++;
+   };
+
+   // journal continues to record modifications
+   printf("   replaying journal ...\n");
+   if ((rc = netcalc_set_add_str(ns, "10.5.0.0/16", "added", NULL, 0)) != 0)
+   {  printf("%s: netcalc_set_add_str(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   };
+   errs += my_replay(ns, NULL, journal);
+
+   unlink(journal);
+   netcalc_set_free(ns);
+
+   return(errs);
+}
+
+
+int
+my_pass(
+         const char *                  name,
+         const char * const *          data,
+         const char *                  superblock )
+{
+   int               fd;
+   int               rc;
+   int               errs;
+   size_t            idx;
+   FILE *            fs;
+   netcalc_set_t *   ns;
+   netcalc_net_t *   net;
+   netcalc_net_t *   sb;
+   char              snapshot[256];
+   char              journal[256];
+
+   errs  = 0;
+
+   if ((superblock))
+      printf("testing %s within superblock %s ...\n", name, superblock);
+   else
+      printf("testing %s ...\n", name);
+
+   sb = NULL;
+   if ( ((superblock)) && ((rc = netcalc_net_init(&sb, superblock, 0)) != 0) )
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   rc = netcalc_set_init(&ns, sb, 0);
+   netcalc_net_free(sb);
+   if (rc != 0)
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   // create journal and snapshot files
+   snprintf(journal, sizeof(journal), "/tmp/netcalc-journal-XXXXXX");
+   snprintf(snapshot, sizeof(snapshot), "/tmp/netcalc-snapshot-XXXXXX");
+   if ((fd = mkstemp(journal)) == -1)
+   {  printf("%s: mkstemp(): unable to create temporary file\n", PROGRAM_NAME);
+      netcalc_set_free(ns);
+      return(1);
+   };
+   close(fd);
+   if ((fd = mkstemp(snapshot)) == -1)
+   {  printf("%s: mkstemp(): unable to create temporary file\n", PROGRAM_NAME);
+      netcalc_set_free(ns);
+      unlink(journal);
+      return(1);
+   };
+   close(fd);
+   if ((rc = netcalc_set_journal(ns, journal)) != 0)
+   {  printf("%s: netcalc_set_journal(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      unlink(journal);
+      unlink(snapshot);
+      return(1);
+   };
+
+   // add addresses to set, using odd addresses as comments
+   printf("   adding records ...\n");
+   for(idx = 0; ((data[idx])); idx++)
+   {  if ((verbose))
+         printf("      adding %s ...\n", data[idx]);
+      rc = netcalc_set_add_str(ns, data[idx], ((idx & 1)) ? data[idx] : NULL, NULL, 0);
+      if ( (rc != 0) && ( (rc != NETCALC_ERANGE) || (!(superblock)) ) )
+      {  printf("%s: netcalc_set_add_str(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         errs++;
+      };
+   };
+
+   // delete every third record and update every fifth record
+   printf("   deleting and updating records ...\n");
+   for(idx = 0; ((data[idx])); idx++)
+   {  if ( ((idx % 3)) && ((idx % 5)) )
+         continue;
+      if ((rc = netcalc_net_init(&net, data[idx], 0)) != 0)
+      {  printf("%s: netcalc_net_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         errs++;
+         continue;
+      };
+      if ((idx % 3) == 0)
+      {  if ((verbose))
+            printf("      deleting %s ...\n", data[idx]);
+         rc = netcalc_set_del(ns, net);
+      } else
+      {  if ((verbose))
+            printf("      updating %s ...\n", data[idx]);
+         rc = netcalc_set_update(ns, net, "updated", NULL, 0);
+      };
+      netcalc_net_free(net);
+      if ( (rc != 0) && ( (rc != NETCALC_ENOREC) || (!(superblock)) ) )
+      {  printf("%s: %s: %s\n", PROGRAM_NAME, data[idx], netcalc_strerror(rc));
+         errs++;
+      };
+   };
+   errs += my_expect(ns, data, superblock);
+
+   // replay journal
+   printf("   replaying journal ...\n");
+   errs += my_replay(ns, NULL, journal);
+
+   // compact journal into snapshot and continue modifying set
+   printf("   compacting journal ...\n");
+   if ((rc = netcalc_set_compact(ns, snapshot)) != 0)
+   {  printf("%s: netcalc_set_compact(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   };
+   if ((rc = netcalc_set_add_str(ns, "2001:db8:d:102::/64", "added", NULL, 0)) != 0)
+   {  printf("%s: netcalc_set_add_str(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   };
+   errs += my_replay(ns, snapshot, journal);
+
+   // verify incomplete entry at end of journal is ignored
+   printf("   replaying incomplete journal ...\n");
+   if ((fs = fopen(journal, "ab")) != NULL)
+   {  fwrite("\x40\0\0\0\0\0\0\0\0\0", 10, 1, fs);
+      fclose(fs);
+   };
+   errs += my_replay(ns, snapshot, journal);
+
+   unlink(journal);
+   unlink(snapshot);
+   netcalc_set_free(ns);
+
+   return(errs);
+}
+
+
+// recovers set from snapshot and journal and compares with set
+int
+my_replay(
+         netcalc_set_t *               ns,
+         const char *                  snapshot,
+         const char *                  journal )
+{
+   int               rc;
+   int               errs;
+   netcalc_set_t *   replay;
+
+   if ((rc = netcalc_set_replay(&replay, snapshot, journal)) != 0)
+   {  printf("%s: netcalc_set_replay(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   errs = my_cmp(ns, replay);
+   netcalc_set_free(replay);
+
+   return(errs);
+}
+
+
+// verifies flags and superblock of set are recovered from journal
+int
+my_uniq( void )
+{
+   int               fd;
+   int               rc;
+   int               errs;
+   size_t            idx;
+   netcalc_set_t *   ns;
+   netcalc_set_t *   replay;
+   netcalc_set_t *   other;
+   netcalc_net_t *   sb;
+   netcalc_net_t *   net;
+   char              journal[256];
+   static const char * const adds[] = { "10.1.0.0/16", "10.2.0.0/16", "10.3.0.1", "10.3.0.2", NULL };
+
+   errs = 0;
+
+   printf("testing unique set within superblock 10.0.0.0/8 ...\n");
+
+   if ((rc = netcalc_net_init(&sb, "10.0.0.0/8", 0)) != 0)
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   rc = netcalc_set_init(&ns, sb, NETCALC_FLG_UNIQ | NETCALC_FLG_HOSTS);
+   netcalc_net_free(sb);
+   if (rc != 0)
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   snprintf(journal, sizeof(journal), "/tmp/netcalc-journal-XXXXXX");
+   if ((fd = mkstemp(journal)) == -1)
+   {  printf("%s: mkstemp(): unable to create temporary file\n", PROGRAM_NAME);
+      netcalc_set_free(ns);
+      return(1);
+   };
+   close(fd);
+   if ((rc = netcalc_set_journal(ns, journal)) != 0)
+   {  printf("%s: netcalc_set_journal(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      unlink(journal);
+      return(1);
+   };
+
+   // modify set, rejected modifications are not journaled
+   printf("   modifying set ...\n");
+   for(idx = 0; ((adds[idx])); idx++)
+   {  if ((rc = netcalc_set_add_str(ns, adds[idx], adds[idx], NULL, 0)) != 0)
+      {  printf("%s: netcalc_set_add_str(): %s: %s\n", PROGRAM_NAME, adds[idx], netcalc_strerror(rc));
+         errs++;
+      };
+   };
+   if ((rc = netcalc_set_add_str(ns, "10.1.2.0/24", NULL, NULL, 0)) != NETCALC_ESUBNET)
+   {  printf("%s: netcalc_set_add_str(): 10.1.2.0/24: %s; expected %s\n", PROGRAM_NAME, netcalc_strerror(rc), netcalc_strerror(NETCALC_ESUBNET));
+      errs++;
+   };
+   if ((rc = netcalc_set_add_str(ns, "192.0.2.0/24", NULL, NULL, 0)) != NETCALC_ERANGE)
+   {  printf("%s: netcalc_set_add_str(): 192.0.2.0/24: %s; expected %s\n", PROGRAM_NAME, netcalc_strerror(rc), netcalc_strerror(NETCALC_ERANGE));
+      errs++;
+   };
+   if ((rc = netcalc_net_init(&net, "10.2.0.0/16", 0)) == 0)
+   {  if ((rc = netcalc_set_del(ns, net)) != 0)
+      {  printf("%s: netcalc_set_del(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         errs++;
+      };
+      netcalc_net_free(net);
+   };
+   if ((rc = netcalc_net_init(&net, "10.3.0.1", 0)) == 0)
+   {  if ((rc = netcalc_set_update(ns, net, "updated", NULL, 0)) != 0)
+      {  printf("%s: netcalc_set_update(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         errs++;
+      };
+      netcalc_net_free(net);
+   };
+
+   // replay journal without snapshot
+   printf("   replaying journal ...\n");
+   if ((rc = netcalc_set_replay(&replay, NULL, journal)) != 0)
+   {  printf("%s: netcalc_set_replay(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   } else
+   {  errs += my_cmp(ns, replay);
+      if ((rc = netcalc_set_add_str(replay, "10.1.2.0/24", NULL, NULL, 0)) != NETCALC_ESUBNET)
+      {  printf("%s: replay: 10.1.2.0/24: %s; expected %s\n", PROGRAM_NAME, netcalc_strerror(rc), netcalc_strerror(NETCALC_ESUBNET));
+         errs++;
+      };
+      if ((rc = netcalc_set_add_str(replay, "192.0.2.0/24", NULL, NULL, 0)) != NETCALC_ERANGE)
+      {  printf("%s: replay: 192.0.2.0/24: %s; expected %s\n", PROGRAM_NAME, netcalc_strerror(rc), netcalc_strerror(NETCALC_ERANGE));
+         errs++;
+      };
+      netcalc_set_free(replay);
+   };
+
+   // journal is rejected by set with different flags
+   printf("   journaling set with different flags ...\n");
+   if ((rc = netcalc_set_init(&other, NULL, 0)) != 0)
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   } else
+   {  if ((rc = netcalc_set_journal(other, journal)) != NETCALC_EBADFILE)
+      {  printf("%s: netcalc_set_journal(): %s; expected %s\n", PROGRAM_NAME, netcalc_strerror(rc), netcalc_strerror(NETCALC_EBADFILE));
+         errs++;
+      };
+      netcalc_set_free(other);
+   };
+
+   unlink(journal);
+   netcalc_set_free(ns);
+
+   return(errs);
+}
+
+
+/* end of source */
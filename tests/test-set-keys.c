@@ -0,0 +1,430 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_SET_KEYS_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <errno.h>
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-set-keys"
+
+#define MY_COUNT     300
+#define MY_NETS      5
+#define MY_QUERIES   7
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+// MARK: - Datatypes
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_cmp(
+         netcalc_set_t *               ns );
+
+
+int
+my_modify(
+         netcalc_set_t *               ns,
+         size_t                        net,
+         size_t                        step,
+         int                           add );
+
+
+int
+my_order(
+         netcalc_set_t *               ns );
+
+
+int
+my_query(
+         netcalc_set_t *               ns,
+         const char *                  address );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+// networks of each family added to the same lists of records, EUI-48
+// addresses are stored as link-local addresses
+static const char *  my_nets[MY_NETS] =
+{  "::%zx:%zx:0/112",
+   "10.%zu.%zu.0/24",
+   "10.%zu.%zu.128/25",
+   "fe80::200:5eff:fe00:%02zx%02zx",
+   "2001:db8:%zx:%zx::/64"
+};
+
+static const char *  my_queries[MY_QUERIES] =
+{  "::%zx:%zx:1",
+   "10.%zu.%zu.1",
+   "10.%zu.%zu.129",
+   "10.%zu.%zu.0/23",
+   "fe80::200:5eff:fe00:%02zx%02zx",
+   "2001:db8:%zx:%zx::1",
+   "2001:db8:%zx::/48"
+};
+
+static int           my_present[MY_NETS][MY_COUNT];
+static netcalc_net_t *  my_recs[MY_NETS][MY_COUNT];
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               rc;
+   int               opt_index;
+   size_t            net;
+   size_t            idx;
+   size_t            errs;
+   netcalc_set_t *   ns;
+   char              addr[NETCALC_ADDRESS_LENGTH];
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   for(net = 0; (net < MY_NETS); net++)
+   {  for(idx = 0; (idx < MY_COUNT); idx++)
+      {  snprintf(addr, sizeof(addr), my_nets[net], (idx >> 8), (idx & 0xff));
+         if ((rc = netcalc_net_init(&my_recs[net][idx], addr, 0)) != 0)
+         {  printf("%s: %s: %s\n", PROGRAM_NAME, addr, netcalc_strerror(rc));
+            return(1);
+         };
+      };
+   };
+
+   if ((rc = netcalc_set_init(&ns, NULL, 0)) != 0)
+   {  printf("%s: netcalc_set_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   // interleave families within lists of records
+   printf("testing additions ...\n");
+   for(net = 0; (net < MY_NETS); net++)
+      errs += (size_t)my_modify(ns, net, 1, 1);
+   errs += (size_t)my_cmp(ns);
+
+   // deleting supernets moves subnets into the list of the supernet
+   printf("testing deletions ...\n");
+   for(net = 0; (net < MY_NETS); net++)
+      errs += (size_t)my_modify(ns, net, 3, 0);
+   errs += (size_t)my_cmp(ns);
+
+   // adding supernets moves records into the list of the supernet
+   printf("testing supernets ...\n");
+   for(net = 0; (net < MY_NETS); net++)
+      errs += (size_t)my_modify(ns, net, 3, 1);
+   errs += (size_t)my_cmp(ns);
+
+   // networks inserted between families shift the records of the families
+   printf("testing insertions between families ...\n");
+   errs += (size_t)my_modify(ns, 0, 1, 0);
+   errs += (size_t)my_cmp(ns);
+   errs += (size_t)my_modify(ns, 0, 1, 1);
+   errs += (size_t)my_cmp(ns);
+
+   netcalc_set_free(ns);
+   for(net = 0; (net < MY_NETS); net++)
+      for(idx = 0; (idx < MY_COUNT); idx++)
+         netcalc_net_free(my_recs[net][idx]);
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// compares results of queries of each family with the most specific network
+// which contains the query
+int
+my_cmp(
+         netcalc_set_t *               ns )
+{
+   size_t            errs;
+   size_t            idx;
+   size_t            query;
+   char              addr[NETCALC_ADDRESS_LENGTH];
+
+   errs = (size_t)my_order(ns);
+
+   for(query = 0; (query < MY_QUERIES); query++)
+   {  for(idx = 0; (idx < (MY_COUNT + 16)); idx++)
+      {  snprintf(addr, sizeof(addr), my_queries[query], (idx >> 8), (idx & 0xff));
+         errs += (size_t)my_query(ns, addr);
+      };
+   };
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// adds or deletes every 'step' network of a family
+int
+my_modify(
+         netcalc_set_t *               ns,
+         size_t                        net,
+         size_t                        step,
+         int                           add )
+{
+   int               rc;
+   size_t            idx;
+   char              addr[NETCALC_ADDRESS_LENGTH];
+
+   for(idx = 0; (idx < MY_COUNT); idx += step)
+   {  rc = ((add)) ? netcalc_set_add(ns, my_recs[net][idx], NULL, NULL, 0) : netcalc_set_del(ns, my_recs[net][idx]);
+      if (rc != 0)
+      {  snprintf(addr, sizeof(addr), my_nets[net], (idx >> 8), (idx & 0xff));
+         printf("%s: %s %s: %s\n", PROGRAM_NAME, ((add)) ? "adding" : "deleting", addr, netcalc_strerror(rc));
+         return(1);
+      };
+      my_present[net][idx] = add;
+   };
+
+   return(0);
+}
+
+
+// verifies records are listed in order by cursor
+int
+my_order(
+         netcalc_set_t *               ns )
+{
+   int               rc;
+   int               cmp;
+   size_t            count;
+   netcalc_net_t *   net;
+   netcalc_net_t *   prev;
+   netcalc_cur_t *   cur;
+   char              str1[NETCALC_ADDRESS_LENGTH];
+   char              str2[NETCALC_ADDRESS_LENGTH];
+
+   if ((rc = netcalc_cur_init(ns, &cur)) != 0)
+   {  printf("%s: netcalc_cur_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   count = 0;
+   prev  = NULL;
+   while((rc = netcalc_cur_next(cur, &net, NULL, NULL, NULL, NULL)) == 0)
+   {  count++;
+      if ( ((prev)) && ((cmp = netcalc_net_cmp(prev, net, NETCALC_FLG_NETWORK)) != NETCALC_CMP_BEFORE) && (cmp != NETCALC_CMP_SUPERNET) )
+      {  netcalc_ntop(prev, str1, sizeof(str1), NETCALC_TYPE_ADDRESS, NETCALC_FLG_CIDR);
+         netcalc_ntop(net,  str2, sizeof(str2), NETCALC_TYPE_ADDRESS, NETCALC_FLG_CIDR);
+         printf("%s: cursor: %s listed after %s\n", PROGRAM_NAME, str2, str1);
+         netcalc_net_free(prev);
+         netcalc_net_free(net);
+         netcalc_cur_free(cur);
+         return(1);
+      };
+      if ((prev))
+         netcalc_net_free(prev);
+      prev = net;
+   };
+   if ((prev))
+      netcalc_net_free(prev);
+   netcalc_cur_free(cur);
+
+   if ((verbose))
+      printf("   cursor listed %zu records ...\n", count);
+
+   return(0);
+}
+
+
+int
+my_query(
+         netcalc_set_t *               ns,
+         const char *                  address )
+{
+   int               rc;
+   int               cmp;
+   int               flags;
+   size_t            net;
+   size_t            idx;
+   netcalc_net_t *   query;
+   netcalc_net_t *   res;
+   netcalc_net_t *   rec;
+   netcalc_net_t *   best;
+   char              str1[NETCALC_ADDRESS_LENGTH];
+   char              str2[NETCALC_ADDRESS_LENGTH];
+
+   flags = NETCALC_FLG_SUPR | NETCALC_FLG_COMPR | NETCALC_FLG_CIDR;
+
+   if ((rc = netcalc_net_init(&query, address, 0)) != 0)
+   {  printf("%s: %s: %s\n", PROGRAM_NAME, address, netcalc_strerror(rc));
+      return(1);
+   };
+
+   // search networks of set for most specific network containing query
+   best = NULL;
+   for(net = 0; (net < MY_NETS); net++)
+   {  for(idx = 0; (idx < MY_COUNT); idx++)
+      {  if (!(my_present[net][idx]))
+            continue;
+         rec = my_recs[net][idx];
+         cmp = netcalc_net_cmp(query, rec, NETCALC_FLG_NETWORK);
+         if ( ( (cmp == NETCALC_CMP_SAME) || (cmp == NETCALC_CMP_SUBNET) ) && ( (!(best)) || (netcalc_net_cmp(rec, best, NETCALC_FLG_NETWORK) == NETCALC_CMP_SUBNET) ) )
+            best = rec;
+      };
+   };
+
+   res = NULL;
+   rc  = netcalc_set_query(ns, query, &res, NULL, NULL, NULL);
+   netcalc_net_free(query);
+
+   str1[0] = '\0';
+   str2[0] = '\0';
+   if ((best))
+      netcalc_ntop(best, str1, sizeof(str1), NETCALC_TYPE_ADDRESS, flags);
+   if ((res))
+      netcalc_ntop(res, str2, sizeof(str2), NETCALC_TYPE_ADDRESS, flags);
+   if ((res))
+      netcalc_net_free(res);
+
+   if ((verbose))
+      printf("   query %s: matched \"%s\" ...\n", address, str2);
+   if ( ( (rc == 0) != (str1[0] != '\0') ) || ((strcmp(str1, str2))) )
+   {  printf("%s: query %s: matched \"%s\"; expected \"%s\"\n", PROGRAM_NAME, address, str2, str1);
+      return(1);
+   };
+
+   return(0);
+}
+
+
+/* end of source */
@@ -0,0 +1,475 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_SET_RCU_C 1
+#include "libnetcalc-tests.h"
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <errno.h>
+#include <assert.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-set-rcu"
+
+#define MY_READERS      4
+#define MY_COMMITS      250
+#define MY_NET_A        "2001:db8:d:102::/64"
+#define MY_NET_B        "2001:db8:d:103::/64"
+
+
+//////////////////
+//              //
+//  Data Types  //
+//              //
+//////////////////
+// MARK: - Data Types
+
+typedef struct _my_reader my_reader_t;
+struct _my_reader
+{  netcalc_rcu_t *      rcu;
+   size_t               errs;
+   size_t               reads;
+   atomic_int *         started;
+   atomic_int *         done;
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_has(
+         netcalc_set_t *               ns,
+         const char *                  address );
+
+
+int
+my_modify(
+         netcalc_rcu_t *               rcu,
+         int                           add );
+
+
+void *
+my_reader(
+         void *                        arg );
+
+
+int
+my_test_threads(
+         void );
+
+
+int
+my_test_versions(
+         void );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   size_t            errs;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   if ((my_test_versions()))
+      errs++;
+
+   if ((my_test_threads()))
+      errs++;
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// determines if set contains record added by test
+int
+my_has(
+         netcalc_set_t *               ns,
+         const char *                  address )
+{
+   int               rc;
+   char *            comment;
+
+   comment = NULL;
+   if ((rc = netcalc_set_query_str(ns, address, NULL, &comment, NULL, NULL)) != 0)
+      return(0);
+   rc = ( ((comment)) && (!(strcmp(comment, "rcu"))) ) ? 1 : 0;
+   free(comment);
+
+   return(rc);
+}
+
+
+// adds or deletes both networks within a single version
+int
+my_modify(
+         netcalc_rcu_t *               rcu,
+         int                           add )
+{
+   int               rc;
+   netcalc_set_t *   ns;
+   netcalc_net_t *   net;
+
+   if ((rc = netcalc_rcu_begin(rcu, &ns)) != 0)
+   {  printf("%s: netcalc_rcu_begin(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   if ((add))
+   {  netcalc_set_add_str(ns, MY_NET_A, "rcu", NULL, 0);
+      netcalc_set_add_str(ns, MY_NET_B, "rcu", NULL, 0);
+   } else
+   {  if (netcalc_net_init(&net, MY_NET_A, 0) == 0)
+      {  netcalc_set_del(ns, net);
+         netcalc_net_free(net);
+      };
+      if (netcalc_net_init(&net, MY_NET_B, 0) == 0)
+      {  netcalc_set_del(ns, net);
+         netcalc_net_free(net);
+      };
+   };
+
+   if ((rc = netcalc_rcu_commit(rcu, ns)) != 0)
+   {  printf("%s: netcalc_rcu_commit(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_rcu_abort(rcu, ns);
+      return(1);
+   };
+
+   return(0);
+}
+
+
+// verifies each version observed by reader contains both or neither network
+void *
+my_reader(
+         void *                        arg )
+{
+   int               id;
+   int               has_a;
+   int               has_b;
+   my_reader_t *     rdr;
+   netcalc_set_t *   ns;
+
+   rdr = arg;
+
+   if (netcalc_rcu_register(rdr->rcu, &id) != 0)
+   {  rdr->errs++;
+      atomic_fetch_add(rdr->started, 1);
+      return(NULL);
+   };
+   atomic_fetch_add(rdr->started, 1);
+
+   while(!(atomic_load(rdr->done)))
+   {  ns    = netcalc_rcu_read_lock(rdr->rcu, id);
+      has_a = my_has(ns, MY_NET_A);
+      has_b = my_has(ns, MY_NET_B);
+      netcalc_rcu_read_unlock(rdr->rcu, id);
+      if (has_a != has_b)
+         rdr->errs++;
+      rdr->reads++;
+   };
+
+   netcalc_rcu_unregister(rdr->rcu, id);
+
+   return(NULL);
+}
+
+
+int
+my_test_threads(
+         void )
+{
+   int               rc;
+   int               idx;
+   size_t            errs;
+   atomic_int        done;
+   atomic_int        started;
+   netcalc_set_t *   ns;
+   netcalc_rcu_t *   rcu;
+   pthread_t         threads[MY_READERS];
+   my_reader_t       readers[MY_READERS];
+
+   printf("testing concurrent readers ...\n");
+
+   if ((rc = netcalc_set_init(&ns, NULL, 0)) != 0)
+   {  printf("%s: netcalc_set_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   for(idx = 0; ((test_set2[idx])); idx++)
+      netcalc_set_add_str(ns, test_set2[idx], NULL, NULL, 0);
+   if ((rc = netcalc_rcu_init(&rcu, ns, MY_READERS)) != 0)
+   {  printf("%s: netcalc_rcu_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      return(1);
+   };
+
+   // start readers
+   atomic_init(&done,    0);
+   atomic_init(&started, 0);
+   memset(readers, 0, sizeof(readers));
+   for(idx = 0; (idx < MY_READERS); idx++)
+   {  readers[idx].rcu     = rcu;
+      readers[idx].started = &started;
+      readers[idx].done    = &done;
+      if (pthread_create(&threads[idx], NULL, &my_reader, &readers[idx]) != 0)
+      {  printf("%s: pthread_create(): unable to create thread\n", PROGRAM_NAME);
+         atomic_store(&done, 1);
+         while(idx > 0)
+            pthread_join(threads[--idx], NULL);
+         netcalc_rcu_free(rcu);
+         return(1);
+      };
+   };
+
+   // publish versions while readers query set
+   errs = 0;
+   while(atomic_load(&started) < MY_READERS)
+      sched_yield();
+   for(idx = 0; (idx < MY_COMMITS); idx++)
+      errs += (size_t)my_modify(rcu, !(idx & 1));
+   atomic_store(&done, 1);
+
+   for(idx = 0; (idx < MY_READERS); idx++)
+   {  pthread_join(threads[idx], NULL);
+      if ((verbose))
+         printf("   reader %i: %zu reads ...\n", idx, readers[idx].reads);
+      if ((readers[idx].errs))
+         printf("%s: reader %i: observed partially modified set\n", PROGRAM_NAME, idx);
+      errs += readers[idx].errs;
+   };
+
+   netcalc_rcu_free(rcu);
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+int
+my_test_versions(
+         void )
+{
+   int               rc;
+   int               id;
+   int               id2;
+   int               idx;
+   size_t            errs;
+   netcalc_set_t *   ns;
+   netcalc_set_t *   old;
+   netcalc_rcu_t *   rcu;
+
+   printf("testing versions ...\n");
+
+   errs = 0;
+
+   if ((rc = netcalc_set_init(&ns, NULL, 0)) != 0)
+   {  printf("%s: netcalc_set_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   for(idx = 0; ((test_set2[idx])); idx++)
+      netcalc_set_add_str(ns, test_set2[idx], NULL, NULL, 0);
+   if ((rc = netcalc_rcu_init(&rcu, ns, 1)) != 0)
+   {  printf("%s: netcalc_rcu_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      return(1);
+   };
+
+   // register readers
+   if ((rc = netcalc_rcu_register(rcu, &id)) != 0)
+   {  printf("%s: netcalc_rcu_register(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_rcu_free(rcu);
+      return(1);
+   };
+   if ((rc = netcalc_rcu_register(rcu, &id2)) != NETCALC_ERANGE)
+   {  printf("%s: netcalc_rcu_register(): expected %s; received %s\n", PROGRAM_NAME, netcalc_strerror(NETCALC_ERANGE), netcalc_strerror(rc));
+      errs++;
+   };
+
+   // version held by reader is not modified by writer
+   printf("   publishing version ...\n");
+   old = netcalc_rcu_read_lock(rcu, id);
+   if (old != ns)
+   {  printf("%s: netcalc_rcu_read_lock(): unexpected version\n", PROGRAM_NAME);
+      errs++;
+   };
+   errs += (size_t)my_modify(rcu, 1);
+   if ((my_has(old, MY_NET_A)))
+   {  printf("%s: version held by reader was modified\n", PROGRAM_NAME);
+      errs++;
+   };
+   netcalc_rcu_read_unlock(rcu, id);
+
+   // reader observes published version
+   ns = netcalc_rcu_read_lock(rcu, id);
+   if ( (ns == old) || (!(my_has(ns, MY_NET_A))) || (!(my_has(ns, MY_NET_B))) )
+   {  printf("%s: netcalc_rcu_read_lock(): published version not observed\n", PROGRAM_NAME);
+      errs++;
+   };
+   netcalc_rcu_read_unlock(rcu, id);
+
+   // aborted modifications are not published
+   printf("   aborting version ...\n");
+   if ((rc = netcalc_rcu_begin(rcu, &ns)) == 0)
+   {  netcalc_set_add_str(ns, "2001:db8:d:104::/64", "rcu", NULL, 0);
+      netcalc_rcu_abort(rcu, ns);
+   };
+   ns = netcalc_rcu_read_lock(rcu, id);
+   if ((my_has(ns, "2001:db8:d:104::/64")))
+   {  printf("%s: aborted version was published\n", PROGRAM_NAME);
+      errs++;
+   };
+   netcalc_rcu_read_unlock(rcu, id);
+
+   errs += (size_t)my_modify(rcu, 0);
+   ns = netcalc_rcu_read_lock(rcu, id);
+   if ( ((my_has(ns, MY_NET_A))) || ((my_has(ns, MY_NET_B))) )
+   {  printf("%s: deleted networks observed\n", PROGRAM_NAME);
+      errs++;
+   };
+   netcalc_rcu_read_unlock(rcu, id);
+
+   netcalc_rcu_unregister(rcu, id);
+   netcalc_rcu_free(rcu);
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+/* end of source */
@@ -0,0 +1,489 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_SET_SEEK_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <errno.h>
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-set-seek"
+
+#define MY_MAX_RECS     128
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_check_reverse(
+         netcalc_set_t *               ns );
+
+
+int
+my_check_seek(
+         netcalc_set_t *               ns,
+         const char *                  name );
+
+
+int
+my_load(
+         netcalc_set_t *               ns );
+
+
+int
+my_pass(
+         const char *                  name,
+         const char * const *          data );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+static size_t  my_len   = 0;
+static int     my_depth[MY_MAX_RECS];
+static char    my_recs[MY_MAX_RECS][NETCALC_ADDRESS_LENGTH];
+
+static const char * test_keys[] =
+{  "::/0",
+   "::/1",
+   "2001:db8::/32",
+   "2001:db8:d::/48",
+   "2001:db8:d:100::/55",
+   "2001:db8:d:100::/56",
+   "2001:db8:d:101::1",
+   "2001:db8:d:101::2",
+   "2001:db8:d:ffff::1",
+   "2001:db8:f::/48",
+   "2001:db8:e::/47",
+   "3fff::/20",
+   "::ffff:0:0/96",
+   "::ffff:203.0.113.0/120",
+   "10.0.0.0/8",
+   "203.0.113.0/24",
+   "203.0.113.196/30",
+   "203.0.113.199",
+   "203.0.113.200",
+   "255.255.255.255",
+   "ffff::/16",
+   NULL
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   size_t            errs;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   // check set 2
+   if ((my_pass("set2", test_set2)))
+      errs++;
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// compares reverse iteration against forward iteration
+int
+my_check_reverse(
+         netcalc_set_t *               ns )
+{
+   int               rc;
+   int               flags;
+   int               depth;
+   size_t            idx;
+   netcalc_net_t *   net;
+   netcalc_cur_t *   cur;
+   char              net_str[NETCALC_ADDRESS_LENGTH];
+
+   flags = NETCALC_FLG_SUPR | NETCALC_FLG_COMPR | NETCALC_FLG_CIDR;
+
+   if (!(quiet))
+      printf("   checking reverse iteration ...\n");
+
+   if ((rc = netcalc_cur_init(ns, &cur)) != 0)
+   {  printf("%s: netcalc_cur_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   rc = netcalc_cur_last(cur, &net, NULL, NULL, NULL, &depth);
+   for(idx = my_len; ( (rc == 0) && (idx > 0) ); idx--)
+   {  netcalc_ntop(net, net_str, sizeof(net_str), NETCALC_TYPE_ADDRESS, flags);
+      netcalc_net_free(net);
+      if ((verbose))
+         printf("      previous %s (depth %i) ...\n", net_str, depth);
+      if ( (strcmp(net_str, my_recs[idx-1])) || (depth != my_depth[idx-1]) )
+      {  printf("%s: previous record %s (depth %i); expected %s (depth %i)\n", PROGRAM_NAME, net_str, depth, my_recs[idx-1], my_depth[idx-1]);
+         netcalc_cur_free(cur);
+         return(1);
+      };
+      rc = netcalc_cur_prev(cur, &net, NULL, NULL, NULL, &depth);
+   };
+   if ( (rc != NETCALC_ENOREC) || ((idx)) )
+   {  printf("%s: netcalc_cur_prev(): expected %s after %zu records; received %s\n", PROGRAM_NAME, netcalc_strerror(NETCALC_ENOREC), my_len - idx, netcalc_strerror(rc));
+      netcalc_cur_free(cur);
+      return(1);
+   };
+
+   // verify previous record is the record returned by netcalc_cur_next()
+   rc = netcalc_cur_first(cur, NULL, NULL, NULL, NULL, NULL);
+   for(idx = 0; ( (rc == 0) && (idx < my_len) ); idx++)
+   {  if ((rc = netcalc_cur_prev(cur, &net, NULL, NULL, NULL, &depth)) != 0)
+         break;
+      netcalc_ntop(net, net_str, sizeof(net_str), NETCALC_TYPE_ADDRESS, flags);
+      netcalc_net_free(net);
+      if ( (strcmp(net_str, my_recs[idx])) || (depth != my_depth[idx]) )
+      {  printf("%s: previous record %s (depth %i); expected %s (depth %i)\n", PROGRAM_NAME, net_str, depth, my_recs[idx], my_depth[idx]);
+         netcalc_cur_free(cur);
+         return(1);
+      };
+      netcalc_cur_next(cur, NULL, NULL, NULL, NULL, NULL);
+      rc = netcalc_cur_next(cur, NULL, NULL, NULL, NULL, NULL);
+   };
+   if (idx != my_len)
+   {  printf("%s: unable to alternate cursor direction at record %zu: %s\n", PROGRAM_NAME, idx, netcalc_strerror(rc));
+      netcalc_cur_free(cur);
+      return(1);
+   };
+
+   netcalc_cur_free(cur);
+
+   return(0);
+}
+
+
+// compares position of seek against a scan of the entire set
+int
+my_check_seek(
+         netcalc_set_t *               ns,
+         const char *                  name )
+{
+   int               rc;
+   int               errs;
+   int               flags;
+   int               depth;
+   size_t            idx;
+   netcalc_net_t *   key;
+   netcalc_net_t *   rec;
+   netcalc_net_t *   net;
+   netcalc_cur_t *   cur;
+   char              net_str[NETCALC_ADDRESS_LENGTH];
+
+   errs  = 0;
+   flags = NETCALC_FLG_SUPR | NETCALC_FLG_COMPR | NETCALC_FLG_CIDR;
+
+   if (!(quiet))
+      printf("   checking seek to %s ...\n", name);
+
+   if ((rc = netcalc_net_init(&key, name, 0)) != 0)
+   {  printf("%s: %s: netcalc_net_init(): %s\n", PROGRAM_NAME, name, netcalc_strerror(rc));
+      return(1);
+   };
+   if ((rc = netcalc_net_dup(&net, key)) != 0)
+   {  printf("%s: netcalc_net_dup(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_net_free(key);
+      return(1);
+   };
+   netcalc_net_convert(net, NETCALC_AF_INET6, NULL);
+
+   // determine first record which is not before the key
+   for(idx = 0; (idx < my_len); idx++)
+   {  netcalc_net_init(&rec, my_recs[idx], 0);
+      netcalc_net_convert(rec, NETCALC_AF_INET6, NULL);
+      rc = netcalc_net_cmp(rec, net, NETCALC_FLG_NETWORK);
+      netcalc_net_free(rec);
+      if ( (rc != NETCALC_CMP_BEFORE) && (rc != NETCALC_CMP_SUPERNET) )
+         break;
+   };
+   netcalc_net_free(net);
+
+   if ((rc = netcalc_cur_init(ns, &cur)) != 0)
+   {  printf("%s: netcalc_cur_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_net_free(key);
+      return(1);
+   };
+
+   rc = netcalc_cur_seek(cur, key, &net, NULL, NULL, NULL, &depth);
+   netcalc_net_free(key);
+   if (idx >= my_len)
+   {  if (rc != NETCALC_ENOREC)
+      {  printf("%s: %s: netcalc_cur_seek(): expected %s; received %s\n", PROGRAM_NAME, name, netcalc_strerror(NETCALC_ENOREC), netcalc_strerror(rc));
+         errs++;
+      };
+      netcalc_net_free(net);
+      netcalc_cur_free(cur);
+      return(errs);
+   };
+   if (rc != 0)
+   {  printf("%s: %s: netcalc_cur_seek(): %s\n", PROGRAM_NAME, name, netcalc_strerror(rc));
+      netcalc_cur_free(cur);
+      return(1);
+   };
+
+   // verify remaining records
+   for(; ( (rc == 0) && (idx < my_len) ); idx++)
+   {  netcalc_ntop(net, net_str, sizeof(net_str), NETCALC_TYPE_ADDRESS, flags);
+      netcalc_net_free(net);
+      if ((verbose))
+         printf("      next %s (depth %i) ...\n", net_str, depth);
+      if ( (strcmp(net_str, my_recs[idx])) || (depth != my_depth[idx]) )
+      {  printf("%s: %s: record %s (depth %i); expected %s (depth %i)\n", PROGRAM_NAME, name, net_str, depth, my_recs[idx], my_depth[idx]);
+         netcalc_cur_free(cur);
+         return(1);
+      };
+      rc = netcalc_cur_next(cur, &net, NULL, NULL, NULL, &depth);
+   };
+   if ( (rc != NETCALC_ENOREC) || (idx != my_len) )
+   {  printf("%s: %s: netcalc_cur_next(): expected %s at end of set; received %s\n", PROGRAM_NAME, name, netcalc_strerror(NETCALC_ENOREC), netcalc_strerror(rc));
+      errs++;
+   };
+
+   netcalc_cur_free(cur);
+
+   return(errs);
+}
+
+
+// records order of entire set
+int
+my_load(
+         netcalc_set_t *               ns )
+{
+   int               rc;
+   int               flags;
+   netcalc_net_t *   net;
+   netcalc_cur_t *   cur;
+
+   flags = NETCALC_FLG_SUPR | NETCALC_FLG_COMPR | NETCALC_FLG_CIDR;
+
+   if ((rc = netcalc_cur_init(ns, &cur)) != 0)
+   {  printf("%s: netcalc_cur_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   for(my_len = 0; (my_len < MY_MAX_RECS); my_len++)
+   {  if ((rc = netcalc_cur_next(cur, &net, NULL, NULL, NULL, &my_depth[my_len])) != 0)
+         break;
+      netcalc_ntop(net, my_recs[my_len], NETCALC_ADDRESS_LENGTH, NETCALC_TYPE_ADDRESS, flags);
+      netcalc_net_free(net);
+   };
+   netcalc_cur_free(cur);
+
+   return( (rc == NETCALC_ENOREC) ? 0 : 1 );
+}
+
+
+int
+my_pass(
+         const char *                  name,
+         const char * const *          data )
+{
+   int               rc;
+   int               errs;
+   size_t            idx;
+   netcalc_set_t *   ns;
+   netcalc_cur_t *   cur;
+
+   errs  = 0;
+
+   printf("testing %s ...\n", name);
+   printf("   loading set ...\n");
+
+   if ((rc = netcalc_set_init(&ns, NULL, 0)) != 0)
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   // verify empty set
+   if ((rc = netcalc_cur_init(ns, &cur)) != 0)
+   {  printf("%s: netcalc_cur_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      return(1);
+   };
+   if ((rc = netcalc_cur_last(cur, NULL, NULL, NULL, NULL, NULL)) != NETCALC_ENOREC)
+   {  printf("%s: netcalc_cur_last(): expected %s; received %s\n", PROGRAM_NAME, netcalc_strerror(NETCALC_ENOREC), netcalc_strerror(rc));
+      errs++;
+   };
+   netcalc_cur_free(cur);
+
+   // add addresses to sets
+   for(idx = 0; ((data[idx])); idx++)
+   {  if ((verbose))
+         printf("      adding %s ...\n", data[idx]);
+      if ((rc = netcalc_set_add_str(ns, data[idx], NULL, NULL, 0)) != 0)
+      {  printf("%s: netcalc_set_add_str(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         errs++;
+      };
+   };
+   if ((my_load(ns)))
+   {  netcalc_set_free(ns);
+      return(errs+1);
+   };
+
+   errs += my_check_reverse(ns);
+
+   // check arbitrary networks
+   for(idx = 0; ((test_keys[idx])); idx++)
+      errs += my_check_seek(ns, test_keys[idx]);
+
+   // check networks of each record
+   for(idx = 0; ((data[idx])); idx++)
+      errs += my_check_seek(ns, data[idx]);
+
+   // verify cursor is invalidated by modifying set
+   printf("   checking modified set ...\n");
+   if ((rc = netcalc_cur_init(ns, &cur)) != 0)
+   {  printf("%s: netcalc_cur_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      return(errs+1);
+   };
+   netcalc_cur_last(cur, NULL, NULL, NULL, NULL, NULL);
+   if ((rc = netcalc_set_add_str(ns, "2001:db8:c::/48", NULL, NULL, 0)) != 0)
+   {  printf("%s: netcalc_set_add_str(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   };
+   if ((rc = netcalc_cur_prev(cur, NULL, NULL, NULL, NULL, NULL)) != NETCALC_ESETMOD)
+   {  printf("%s: netcalc_cur_prev(): expected %s; received %s\n", PROGRAM_NAME, netcalc_strerror(NETCALC_ESETMOD), netcalc_strerror(rc));
+      errs++;
+   };
+   netcalc_cur_free(cur);
+
+   netcalc_set_free(ns);
+
+   return(errs);
+}
+
+
+/* end of source */
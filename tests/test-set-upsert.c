@@ -0,0 +1,620 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_SET_UPSERT_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <errno.h>
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-set-upsert"
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+// MARK: - Datatypes
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_cmp(
+         netcalc_set_t *               ns1,
+         netcalc_set_t *               ns2 );
+
+
+int
+my_keep(
+         void *                        ctx,
+         const netcalc_rec_t *         rec,
+         const char **                 commentp,
+         void **                       datap,
+         int *                         flagsp );
+
+
+int
+my_load(
+         netcalc_set_t **              nsp,
+         const char * const *          data,
+         const char *                  superblock,
+         int                           upsert );
+
+
+int
+my_pass(
+         const char *                  name,
+         const char * const *          data,
+         const char *                  superblock );
+
+
+int
+my_stale( void );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   size_t            errs;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   // check set 2
+   if ((my_pass("set2", test_set2, NULL)))
+      errs++;
+
+   // check set 2 restricted to superblock
+   if ((my_pass("set2", test_set2, "2001:db8::/32")))
+      errs++;
+
+   // check handles invalidated by clones
+   if ((my_stale()))
+      errs++;
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// compares records, comments, and query results of two sets
+int
+my_cmp(
+         netcalc_set_t *               ns1,
+         netcalc_set_t *               ns2 )
+{
+   int               rc1;
+   int               rc2;
+   int               errs;
+   int               flags;
+   int               depth1;
+   int               depth2;
+   size_t            idx;
+   char *            comment1;
+   char *            comment2;
+   netcalc_net_t *   net1;
+   netcalc_net_t *   net2;
+   netcalc_cur_t *   cur1;
+   netcalc_cur_t *   cur2;
+   char              str1[NETCALC_ADDRESS_LENGTH];
+   char              str2[NETCALC_ADDRESS_LENGTH];
+
+   errs  = 0;
+   flags = NETCALC_FLG_SUPR | NETCALC_FLG_COMPR | NETCALC_FLG_CIDR;
+
+   if ((rc1 = netcalc_cur_init(ns1, &cur1)) != 0)
+      return(1);
+   if ((rc2 = netcalc_cur_init(ns2, &cur2)) != 0)
+   {  netcalc_cur_free(cur1);
+      return(1);
+   };
+
+   // compare records
+   rc1 = netcalc_cur_next(cur1, &net1, &comment1, NULL, NULL, &depth1);
+   rc2 = netcalc_cur_next(cur2, &net2, &comment2, NULL, NULL, &depth2);
+   while( (rc1 == 0) && (rc2 == 0) )
+   {  netcalc_ntop(net1, str1, sizeof(str1), NETCALC_TYPE_ADDRESS, flags);
+      netcalc_ntop(net2, str2, sizeof(str2), NETCALC_TYPE_ADDRESS, flags);
+      if ((verbose))
+         printf("      record %s (depth %i) ...\n", str2, depth2);
+      if ( (strcmp(str1, str2)) || (depth1 != depth2) )
+      {  printf("%s: record %s (depth %i); expected %s (depth %i)\n", PROGRAM_NAME, str2, depth2, str1, depth1);
+         errs++;
+      } else if ( ((!(comment1)) != (!(comment2))) || ( ((comment1)) && ((strcmp(comment1, comment2))) ) )
+      {  printf("%s: record %s: comment \"%s\"; expected \"%s\"\n", PROGRAM_NAME, str2, ((comment2)) ? comment2 : "", ((comment1)) ? comment1 : "");
+         errs++;
+      };
+      netcalc_net_free(net1);
+      netcalc_net_free(net2);
+      free(comment1);
+      free(comment2);
+      rc1 = netcalc_cur_next(cur1, &net1, &comment1, NULL, NULL, &depth1);
+      rc2 = netcalc_cur_next(cur2, &net2, &comment2, NULL, NULL, &depth2);
+   };
+   netcalc_cur_free(cur1);
+   netcalc_cur_free(cur2);
+   if (rc1 != rc2)
+   {  printf("%s: netcalc_cur_next(): %s; expected %s\n", PROGRAM_NAME, netcalc_strerror(rc2), netcalc_strerror(rc1));
+      if ((rc1 == 0))
+      {  netcalc_net_free(net1);
+         free(comment1);
+      };
+      if ((rc2 == 0))
+      {  netcalc_net_free(net2);
+         free(comment2);
+      };
+      return(errs+1);
+   };
+
+   // compare queries
+   for(idx = 0; ((test_query2[idx].query_addr)); idx++)
+   {  net1 = NULL;
+      net2 = NULL;
+      rc1 = netcalc_set_query_str(ns1, test_query2[idx].query_addr, &net1, NULL, NULL, NULL);
+      rc2 = netcalc_set_query_str(ns2, test_query2[idx].query_addr, &net2, NULL, NULL, NULL);
+      str1[0] = '\0';
+      str2[0] = '\0';
+      if ((net1))
+         netcalc_ntop(net1, str1, sizeof(str1), NETCALC_TYPE_ADDRESS, flags);
+      if ((net2))
+         netcalc_ntop(net2, str2, sizeof(str2), NETCALC_TYPE_ADDRESS, flags);
+      if ((net1))
+         netcalc_net_free(net1);
+      if ((net2))
+         netcalc_net_free(net2);
+      if ( (rc1 != rc2) || ((strcmp(str1, str2))) )
+      {  printf("%s: query %s: matched \"%s\"; expected \"%s\"\n", PROGRAM_NAME, test_query2[idx].query_addr, str2, str1);
+         errs++;
+      };
+   };
+
+   return(errs);
+}
+
+
+// merges information by keeping comment of existing record
+int
+my_keep(
+         void *                        ctx,
+         const netcalc_rec_t *         rec,
+         const char **                 commentp,
+         void **                       datap,
+         int *                         flagsp )
+{
+   size_t *          countp;
+
+   countp = ctx;
+   (*countp)++;
+
+   if ( (!(rec)) || (!(commentp)) || (!(*commentp)) || (!(datap)) || (!(flagsp)) )
+      return(NETCALC_EINVAL);
+
+   *commentp = netcalc_rec_comment(rec);
+
+   return(0);
+}
+
+
+int
+my_load(
+         netcalc_set_t **              nsp,
+         const char * const *          data,
+         const char *                  superblock,
+         int                           upsert )
+{
+   int               rc;
+   size_t            idx;
+   netcalc_net_t *   sb;
+   netcalc_net_t *   net;
+   netcalc_rec_t *   rec;
+
+   sb = NULL;
+   if ( ((superblock)) && ((rc = netcalc_net_init(&sb, superblock, 0)) != 0) )
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   rc = netcalc_set_init(nsp, sb, 0);
+   netcalc_net_free(sb);
+   if (rc != 0)
+   {  printf("%s: %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   // add addresses to sets, using odd addresses as comments
+   for(idx = 0; ((data[idx])); idx++)
+   {  if ((upsert))
+      {  if ((rc = netcalc_net_init(&net, data[idx], 0)) == 0)
+         {  rc = netcalc_set_upsert(*nsp, net, ((idx & 1)) ? data[idx] : NULL, NULL, 0, NULL, NULL, &rec);
+            netcalc_net_free(net);
+            if ( (rc == 0) && (!(rec)) )
+               rc = NETCALC_EUNKNOWN;
+         };
+      } else
+      {  rc = netcalc_set_add_str(*nsp, data[idx], ((idx & 1)) ? data[idx] : NULL, NULL, 0);
+      };
+      if ( (rc != 0) && ( (rc != NETCALC_ERANGE) || (!(superblock)) ) )
+      {  printf("%s: loading %s: %s\n", PROGRAM_NAME, data[idx], netcalc_strerror(rc));
+         netcalc_set_free(*nsp);
+         *nsp = NULL;
+         return(1);
+      };
+   };
+
+   return(0);
+}
+
+
+int
+my_pass(
+         const char *                  name,
+         const char * const *          data,
+         const char *                  superblock )
+{
+   int               rc;
+   int               errs;
+   size_t            idx;
+   size_t            count;
+   size_t            merges;
+   netcalc_set_t *   ns;
+   netcalc_set_t *   exp;
+   netcalc_set_t *   clone;
+   netcalc_net_t *   net;
+   netcalc_rec_t *   rec;
+   netcalc_rec_t *   handle;
+   const char *      comment;
+
+   errs  = 0;
+
+   if ((superblock))
+      printf("testing %s within superblock %s ...\n", name, superblock);
+   else
+      printf("testing %s ...\n", name);
+
+   // load sets
+   printf("   loading sets ...\n");
+   if ((my_load(&ns, data, superblock, 1)))
+      return(1);
+   if ((my_load(&exp, data, superblock, 0)))
+   {  netcalc_set_free(ns);
+      return(1);
+   };
+   errs += my_cmp(exp, ns);
+
+   // repeat prefixes, replacing comments
+   printf("   repeating prefixes ...\n");
+   for(idx = 0; ((data[idx])); idx++)
+   {  if ((verbose))
+         printf("      upserting %s ...\n", data[idx]);
+      if ((rc = netcalc_net_init(&net, data[idx], 0)) != 0)
+      {  errs++;
+         continue;
+      };
+      rc = netcalc_set_upsert(ns, net, data[idx], NULL, 0, NULL, NULL, &rec);
+      if (rc == 0)
+         rc = netcalc_set_update(exp, net, data[idx], NULL, 0);
+      netcalc_net_free(net);
+      if ( (rc != 0) && ( (rc != NETCALC_ERANGE) || (!(superblock)) ) )
+      {  printf("%s: upserting %s: %s\n", PROGRAM_NAME, data[idx], netcalc_strerror(rc));
+         errs++;
+         continue;
+      };
+      if (rc != 0)
+         continue;
+      if ( (!(rec)) || (!(comment = netcalc_rec_comment(rec))) || ((strcmp(comment, data[idx]))) )
+      {  printf("%s: upserting %s: record handle does not reference record\n", PROGRAM_NAME, data[idx]);
+         errs++;
+      };
+   };
+   errs += my_cmp(exp, ns);
+
+   // merge repeated prefixes
+   printf("   merging prefixes ...\n");
+   merges = 0;
+   count  = 0;
+   for(idx = 0; ((data[idx])); idx++)
+   {  if ((rc = netcalc_net_init(&net, data[idx], 0)) != 0)
+      {  errs++;
+         continue;
+      };
+      rc = netcalc_set_upsert(ns, net, "replaced", NULL, NETCALC_FLG_USR1, &my_keep, &merges, &rec);
+      netcalc_net_free(net);
+      if (rc == 0)
+         count++;
+      if ( (rc == 0) && ((netcalc_rec_flags(rec) & NETCALC_USR) != NETCALC_FLG_USR1) )
+      {  printf("%s: merging %s: flags were not updated\n", PROGRAM_NAME, data[idx]);
+         errs++;
+      };
+   };
+   if (merges != count)
+   {  printf("%s: merge callback called %zu times; expected %zu\n", PROGRAM_NAME, merges, count);
+      errs++;
+   };
+   errs += my_cmp(exp, ns);
+
+   // update records using handles
+   printf("   updating records with handles ...\n");
+   handle = NULL;
+   if ((rc = netcalc_net_init(&net, "2001:db8:d:101::/64", 0)) == 0)
+   {  rc = netcalc_set_upsert(ns, net, NULL, NULL, 0, NULL, NULL, &handle);
+      if (rc == 0)
+         rc = netcalc_rec_update(ns, handle, netcalc_rec_serial(ns), "handle", &merges, 0, &handle);
+      if (rc == 0)
+         rc = netcalc_set_update(exp, net, "handle", NULL, 0);
+      netcalc_net_free(net);
+   };
+   if (rc != 0)
+   {  printf("%s: netcalc_rec_update(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   } else if ( ((strcmp(netcalc_rec_comment(handle), "handle"))) || (netcalc_rec_data(handle) != &merges) )
+   {  printf("%s: netcalc_rec_update(): record was not updated\n", PROGRAM_NAME);
+      errs++;
+   };
+   errs += my_cmp(exp, ns);
+
+   // update record shared with clone using handle
+   printf("   updating record shared with clone ...\n");
+   if ((rc = netcalc_set_clone(&clone, ns)) != 0)
+   {  printf("%s: netcalc_set_clone(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   } else
+   {  rec = NULL;
+      rc  = netcalc_rec_update(ns, handle, netcalc_rec_serial(ns), "original", NULL, 0, &rec);
+      if ( (rc == 0) && ((rc = netcalc_net_init(&net, "2001:db8:d:101::/64", 0)) == 0) )
+      {  rc = netcalc_set_update(exp, net, "original", NULL, 0);
+         netcalc_net_free(net);
+      };
+      if (rc != 0)
+      {  printf("%s: netcalc_rec_update(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+         errs++;
+      } else if ( (rec == handle) || ((strcmp(netcalc_rec_comment(handle), "handle"))) || ((strcmp(netcalc_rec_comment(rec), "original"))) )
+      {  printf("%s: netcalc_rec_update(): record shared with clone was modified\n", PROGRAM_NAME);
+         errs++;
+      };
+      errs += my_cmp(exp, ns);
+      netcalc_set_free(clone);
+   };
+
+   netcalc_set_free(exp);
+   netcalc_set_free(ns);
+
+   return(errs);
+}
+
+
+// updates record after the handle was invalidated by modifying a clone
+int
+my_stale( void )
+{
+   int               rc;
+   int               errs;
+   uint32_t          serial;
+   void *            data;
+   netcalc_set_t *   ns;
+   netcalc_set_t *   clone;
+   netcalc_net_t *   net;
+   netcalc_rec_t *   handle;
+   char *            comment;
+
+   errs = 0;
+
+   printf("testing stale record handles ...\n");
+
+   if ((rc = netcalc_set_init(&ns, NULL, 0)) != 0)
+   {  printf("%s: netcalc_set_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+   if ((rc = netcalc_net_init(&net, "10.2.0.0/16", 0)) != 0)
+   {  printf("%s: netcalc_net_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_set_free(ns);
+      return(1);
+   };
+
+   // invalidate handle by unsharing record from clone which is then freed
+   handle = NULL;
+   clone  = NULL;
+   if ((rc = netcalc_set_upsert(ns, net, "original", NULL, 0, NULL, NULL, &handle)) != 0)
+   {  printf("%s: netcalc_set_upsert(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      netcalc_net_free(net);
+      netcalc_set_free(ns);
+      return(1);
+   };
+   serial = netcalc_rec_serial(ns);
+   if ((rc = netcalc_set_clone(&clone, ns)) != 0)
+      printf("%s: netcalc_set_clone(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+   else if ((rc = netcalc_set_add_str(ns, "10.2.3.0/24", NULL, NULL, 0)) != 0)
+      printf("%s: netcalc_set_add_str(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+   netcalc_set_free(clone);
+   if (rc != 0)
+   {  netcalc_net_free(net);
+      netcalc_set_free(ns);
+      return(1);
+   };
+
+   // stale handle is rejected
+   if ((rc = netcalc_rec_update(ns, handle, serial, "stale", NULL, 0, &handle)) != NETCALC_ESETMOD)
+   {  printf("%s: netcalc_rec_update(): updated record with stale handle\n", PROGRAM_NAME);
+      errs++;
+   } else if ((handle))
+   {  printf("%s: netcalc_rec_update(): returned handle for stale handle\n", PROGRAM_NAME);
+      errs++;
+   };
+
+   // refresh handle and update record
+   if ((rc = netcalc_set_upsert(ns, net, "original", NULL, 0, NULL, NULL, &handle)) != 0)
+   {  printf("%s: netcalc_set_upsert(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   } else if ((rc = netcalc_rec_update(ns, handle, netcalc_rec_serial(ns), "updated", &errs, 0, &handle)) != 0)
+   {  printf("%s: netcalc_rec_update(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   } else if ( (!(handle)) || ((strcmp(netcalc_rec_comment(handle), "updated"))) || (netcalc_rec_data(handle) != &errs) )
+   {  printf("%s: netcalc_rec_update(): handle does not reference updated record\n", PROGRAM_NAME);
+      errs++;
+   };
+
+   // verify update is visible through set
+   comment = NULL;
+   data    = NULL;
+   if ((rc = netcalc_set_query(ns, net, NULL, &comment, &data, NULL)) != 0)
+   {  printf("%s: netcalc_set_query(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   } else if ( (!(comment)) || ((strcmp(comment, "updated"))) || (data != &errs) )
+   {  printf("%s: netcalc_set_query(): record was not updated\n", PROGRAM_NAME);
+      errs++;
+   };
+   free(comment);
+
+   // handle of deleted record is rejected
+   serial = netcalc_rec_serial(ns);
+   if ((rc = netcalc_set_del(ns, net)) != 0)
+   {  printf("%s: netcalc_set_del(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      errs++;
+   } else if ( ((rc = netcalc_rec_update(ns, handle, serial, "deleted", NULL, 0, &handle)) != NETCALC_ESETMOD) || ((handle)) )
+   {  printf("%s: netcalc_rec_update(): updated deleted record\n", PROGRAM_NAME);
+      errs++;
+   };
+
+   netcalc_net_free(net);
+   netcalc_set_free(ns);
+
+   return(errs);
+}
+
+
+/* end of source */
@@ -0,0 +1,487 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_SMALLSET_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libnetcalc.h"
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-smallset"
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+// MARK: - Datatypes
+
+typedef struct _my_test my_test_t;
+
+
+struct _my_test
+{  const char *            address;
+   int                     rc;
+   int                     idx;
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+int
+my_init(
+         void );
+
+
+int
+my_random(
+         size_t                        count );
+
+
+int
+my_reference(
+         const netcalc_net_t *         nets,
+         size_t                        nel,
+         const netcalc_net_t *         net );
+
+
+int
+my_tests(
+         void );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+static const char * my_networks[] =
+{  "10.0.0.0/8",                 // 0
+   "10.1.2.0/24",                // 1
+   "10.1.0.0/16",                // 2
+   "0.0.0.0/0",                  // 3
+   "192.168.0.0/16",             // 4
+   "2001:db8::/32",              // 5
+   "2001:db8:1::/48",            // 6
+   "192.168.0.0/16",             // 7
+   "2001:db8:1:2::5",            // 8
+   NULL
+};
+
+
+static const my_test_t my_tests_list[] =
+{  { "10.1.2.3",                 0,                1 },
+   { "10.1.3.3",                 0,                2 },
+   { "10.2.0.0",                 0,                0 },
+   { "11.0.0.1",                 0,                3 },
+   { "::ffff:10.1.2.200",        0,                1 },
+   { "10.1.0.0/16",              0,                2 },
+   { "10.1.0.0/15",              0,                0 },
+   { "10.0.0.0/7",               0,                3 },
+   { "0.0.0.0/0",                0,                3 },
+   { "192.168.44.1",             0,                4 },
+   { "2001:db8::1",              0,                5 },
+   { "2001:db8:1::1",            0,                6 },
+   { "2001:db8:1:2::5",          0,                8 },
+   { "2001:db8:1:2::5/64",       0,                6 },
+   { "2001:db8::/31",            NETCALC_ENOREC,   0 },
+   { "2001:db9::1",              NETCALC_ENOREC,   0 },
+   { "00:00:5e:00:53:01",        NETCALC_ENOTSUP,  0 },
+   { NULL,                       0,                0 }
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   size_t            errs;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   // invalid lists of networks
+   errs += (size_t)my_init();
+
+   // most specific networks of known addresses
+   errs += (size_t)my_tests();
+
+   // each comparison of random sets with scan of networks
+   errs += (size_t)my_random(2000);
+
+   if (!(quiet))
+      printf("%zu errors\n", errs);
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// verifies lists which may not be used to initialize sets
+int
+my_init(
+         void )
+{
+   int                     rc;
+   int                     err;
+   size_t                  idx;
+   netcalc_net_t           nets[NETCALC_SMALLSET_MAX + 1];
+   const netcalc_net_t *   ptrs[NETCALC_SMALLSET_MAX + 1];
+   netcalc_smallset_t *    ss;
+
+   memset(nets, 0, sizeof(nets));
+   for(idx = 0; (idx <= NETCALC_SMALLSET_MAX); idx++)
+   {  nets[idx].net_flags  = NETCALC_AF_INET6;
+      nets[idx].net_cidr   = 128;
+      ptrs[idx]            = &nets[idx];
+   };
+
+   err = 0;
+   if ((rc = netcalc_smallset_init(&ss, ptrs, 0)) != NETCALC_ERANGE)
+      err++;
+   if ((rc = netcalc_smallset_init(&ss, ptrs, NETCALC_SMALLSET_MAX + 1)) != NETCALC_ERANGE)
+      err++;
+   if ((rc = netcalc_smallset_init(&ss, ptrs, NETCALC_SMALLSET_MAX)) != 0)
+      err++;
+   else
+      netcalc_smallset_free(ss);
+   nets[5].net_flags = NETCALC_AF_EUI48;
+   if ((rc = netcalc_smallset_init(&ss, ptrs, NETCALC_SMALLSET_MAX)) != NETCALC_ENOTSUP)
+      err++;
+
+   if ( ((err)) && (!(quiet)) )
+      printf("netcalc_smallset_init(): accepted invalid list of networks\n");
+
+   return( ((err)) ? 1 : 0 );
+}
+
+
+// compares each comparison of random sets with scan of networks
+int
+my_random(
+         size_t                        count )
+{
+   int                     rc;
+   int                     expect;
+   int                     bits;
+   size_t                  num;
+   size_t                  nel;
+   size_t                  pos;
+   size_t                  query;
+   size_t                  idx;
+   size_t                  bit;
+   size_t                  impl;
+   uint64_t                state;
+   uint64_t                hits[3];
+   netcalc_addr_t          bases[2];
+   netcalc_net_t           nets[NETCALC_SMALLSET_MAX];
+   const netcalc_net_t *   ptrs[NETCALC_SMALLSET_MAX];
+   netcalc_net_t           net;
+   netcalc_smallset_t *    ss;
+
+   if ((verbose))
+      printf("querying %zu random sets ...\n", count);
+
+   state = 0x9e3779b97f4a7c15ULL;
+   memset(nets, 0, sizeof(nets));
+   memset(&net, 0, sizeof(net));
+
+   for(num = 0; (num < count); num++)
+   {  // networks of a set are derived from two addresses so that networks are nested
+      for(idx = 0; (idx < 2); idx++)
+      {  state ^= state << 13;
+         state ^= state >> 7;
+         state ^= state << 17;
+         bases[idx].addr64[0] = state;
+         state ^= state << 13;
+         state ^= state >> 7;
+         state ^= state << 17;
+         bases[idx].addr64[1] = state;
+         if ((state & 0x100))
+         {  bases[idx].addr64[0] = 0;
+            bases[idx].addr32[2] = _netcalc_ipv4_mapped_ipv6.net_addr.addr32[2];
+         };
+      };
+
+      nel = (num % NETCALC_SMALLSET_MAX) + 1;
+      for(pos = 0; (pos < nel); pos++)
+      {  state ^= state << 13;
+         state ^= state >> 7;
+         state ^= state << 17;
+         nets[pos].net_addr   = bases[state & 1];
+         nets[pos].net_flags  = ((nets[pos].net_addr.addr64[0] == 0) && (nets[pos].net_addr.addr32[2] == _netcalc_ipv4_mapped_ipv6.net_addr.addr32[2])) ? NETCALC_AF_INET : NETCALC_AF_INET6;
+         bits                 = (nets[pos].net_flags == NETCALC_AF_INET) ? 96 : 0;
+         nets[pos].net_cidr   = (uint8_t)(bits + (int)((state >> 8) % (uint64_t)(129 - bits)));
+         for(idx = 0; (idx < 4); idx++)
+            nets[pos].net_addr.addr32[idx] &= _netcalc_netmasks[nets[pos].net_cidr].addr32[idx];
+         ptrs[pos] = &nets[pos];
+      };
+      if ((rc = netcalc_smallset_init(&ss, ptrs, nel)) != 0)
+      {  if (!(quiet))
+            printf("random set %zu: netcalc_smallset_init(): %s\n", num, netcalc_strerror(rc));
+         return(1);
+      };
+
+      for(query = 0; (query < 64); query++)
+      {  // queries start with a network of the set shortened by up to three
+         // bits and are followed by random bits
+         state ^= state << 13;
+         state ^= state >> 7;
+         state ^= state << 17;
+         net = nets[state % nel];
+         bit = (net.net_cidr > ((state >> 8) % 4)) ? (net.net_cidr - ((state >> 8) % 4)) : 0;
+         for(; (bit < 128); bit++)
+         {  state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            if ((state & 1))
+               net.net_addr.addr8[bit/8] ^= (uint8_t)(0x80 >> (bit % 8));
+         };
+         net.net_cidr = ((state & 0x30) == 0) ? (uint8_t)((state >> 8) % 129) : 128;
+         for(idx = 0; (idx < 4); idx++)
+            net.net_addr.addr32[idx] &= _netcalc_netmasks[net.net_cidr].addr32[idx];
+
+         expect = my_reference(nets, nel, &net);
+         rc     = netcalc_smallset_query(ss, &net, &pos);
+         if ( ((expect < 0) && (rc != NETCALC_ENOREC)) || ((expect >= 0) && ((rc != 0) || (pos != (size_t)expect))) )
+         {  if (!(quiet))
+               printf("random set %zu: query %zu: returned %s %zu; expected %i\n", num, query, netcalc_strerror(rc), pos, expect);
+            netcalc_smallset_free(ss);
+            return(1);
+         };
+
+         // each comparison available to processor returns same networks
+         impl     = 1;
+         hits[0]  = netcalc_smallset_match_scalar(ss, &net.net_addr) & ss->ss_valid;
+#ifdef NETCALC_SMALLSET_X86
+         if ((__builtin_cpu_supports("sse2")))
+            hits[impl++] = netcalc_smallset_match_sse2(ss, &net.net_addr) & ss->ss_valid;
+         if ((__builtin_cpu_supports("avx2")))
+            hits[impl++] = netcalc_smallset_match_avx2(ss, &net.net_addr) & ss->ss_valid;
+#endif
+         for(idx = 1; (idx < impl); idx++)
+         {  if (hits[idx] != hits[0])
+            {  if (!(quiet))
+                  printf("random set %zu: query %zu: comparison %zu returned 0x%016llx; expected 0x%016llx\n", num, query, idx, (unsigned long long)hits[idx], (unsigned long long)hits[0]);
+               netcalc_smallset_free(ss);
+               return(1);
+            };
+         };
+      };
+
+      netcalc_smallset_free(ss);
+   };
+
+   return(0);
+}
+
+
+// returns position of most specific network containing network, -1 if none
+int
+my_reference(
+         const netcalc_net_t *         nets,
+         size_t                        nel,
+         const netcalc_net_t *         net )
+{
+   int               best;
+   size_t            pos;
+   size_t            idx;
+
+   best = -1;
+   for(pos = 0; (pos < nel); pos++)
+   {  if (nets[pos].net_cidr > net->net_cidr)
+         continue;
+      for(idx = 0; (idx < 4); idx++)
+         if ((net->net_addr.addr32[idx] & _netcalc_netmasks[nets[pos].net_cidr].addr32[idx]) != nets[pos].net_addr.addr32[idx])
+            break;
+      if (idx < 4)
+         continue;
+      if ( (best < 0) || (nets[pos].net_cidr > nets[best].net_cidr) )
+         best = (int)pos;
+   };
+
+   return(best);
+}
+
+
+// compares most specific networks of known addresses
+int
+my_tests(
+         void )
+{
+   int                     rc;
+   int                     err;
+   size_t                  len;
+   size_t                  idx;
+   size_t                  pos;
+   netcalc_net_t *         nets[NETCALC_SMALLSET_MAX];
+   netcalc_net_t *         net;
+   netcalc_smallset_t *    ss;
+
+   for(len = 0; ((my_networks[len])); len++)
+   {  if ((rc = netcalc_net_init(&nets[len], my_networks[len], 0)) != 0)
+      {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, my_networks[len], netcalc_strerror(rc));
+         return(1);
+      };
+   };
+   if ((rc = netcalc_smallset_init(&ss, (const netcalc_net_t * const *)nets, len)) != 0)
+   {  fprintf(stderr, "%s: netcalc_smallset_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   err = 0;
+   for(idx = 0; ((my_tests_list[idx].address)); idx++)
+   {  if ((rc = netcalc_net_init(&net, my_tests_list[idx].address, 0)) != 0)
+      {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, my_tests_list[idx].address, netcalc_strerror(rc));
+         err++;
+         continue;
+      };
+      pos = 0;
+      rc  = netcalc_smallset_query(ss, net, &pos);
+      netcalc_net_free(net);
+      if ( (rc != my_tests_list[idx].rc) || ((rc == 0) && (pos != (size_t)my_tests_list[idx].idx)) )
+      {  if (!(quiet))
+            printf("%s: returned %s %zu; expected %s %i\n", my_tests_list[idx].address, netcalc_strerror(rc), pos, netcalc_strerror(my_tests_list[idx].rc), my_tests_list[idx].idx);
+         err++;
+         continue;
+      };
+      if ((verbose))
+         printf("%s: %s\n", my_tests_list[idx].address, ((rc)) ? netcalc_strerror(rc) : my_networks[pos]);
+   };
+
+   netcalc_smallset_free(ss);
+   for(idx = 0; (idx < len); idx++)
+      netcalc_net_free(nets[idx]);
+
+   return( ((err)) ? 1 : 0 );
+}
+
+
+/* end of source */
@@ -0,0 +1,341 @@
+/*
+ *  Network Calculations Library
+ *  Copyright (C) 2025 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __TESTS_NETCALC_SUBNET_ITER_C 1
+#include "libnetcalc-tests.h"
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include <assert.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <netcalc.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef PROGRAM_NAME
+#define PROGRAM_NAME "netcalc-subnet-iter"
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+// MARK: - Datatypes
+
+typedef struct _my_test my_test_t;
+
+
+struct _my_test
+{  const char *            net;
+   int                     cidr;
+   int                     rc;
+   const char *            subnets[5];
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+extern int
+main(
+         int                           argc,
+         char *                        argv[] );
+
+
+
+int
+my_stream(
+         const char *                  address,
+         int                           cidr,
+         uint64_t                      count );
+
+
+int
+my_test(
+         const my_test_t *             test );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+#pragma mark - Variables
+
+static int verbose   = 0;
+static int quiet     = 0;
+
+
+static const my_test_t my_tests[] =
+{  { "10.0.0.0/22",               24,   0,                { "10.0.0.0/24", "10.0.1.0/24", "10.0.2.0/24", "10.0.3.0/24", NULL } },
+   { "10.0.0.7/22",               23,   0,                { "10.0.0.0/23", "10.0.2.0/23", NULL } },
+   { "10.0.0.0/24",               24,   0,                { "10.0.0.0/24", NULL } },
+   { "255.255.255.0/24",          26,   0,                { "255.255.255.0/26", "255.255.255.64/26", "255.255.255.128/26", "255.255.255.192/26", NULL } },
+   { "0.0.0.0/0",                 1,    0,                { "0.0.0.0/1", "128.0.0.0/1", NULL } },
+   { "ffff:ffff:ffff:ffff::/64",  66,   0,                { "ffff:ffff:ffff:ffff::/66", "ffff:ffff:ffff:ffff:4000::/66", "ffff:ffff:ffff:ffff:8000::/66", "ffff:ffff:ffff:ffff:c000::/66", NULL } },
+   { "::/0",                      1,    0,                { "::/1", "8000::/1", NULL } },
+   { "2001:db8::/127",            128,  0,                { "2001:db8::", "2001:db8::1", NULL } },
+   { "10.0.0.0/22",               20,   NETCALC_EINVAL,   { NULL } },
+   { "10.0.0.0/22",               33,   NETCALC_EINVAL,   { NULL } },
+   { "2001:db8::/32",             129,  NETCALC_EINVAL,   { NULL } },
+   { "00:00:5e:00:53:01",         48,   NETCALC_ENOTSUP,  { NULL } },
+   { NULL,                        0,    0,                { NULL } }
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+main(
+         int                           argc,
+         char *                        argv[] )
+{
+   int               c;
+   int               opt_index;
+   size_t            idx;
+   size_t            errs;
+
+   // getopt options
+   static const char *  short_opt = "hqVv";
+   static struct option long_opt[] =
+   {  {"help",             no_argument,       NULL, 'h' },
+      {"quiet",            no_argument,       NULL, 'q' },
+      {"silent",           no_argument,       NULL, 'q' },
+      {"version",          no_argument,       NULL, 'V' },
+      {"verbose",          no_argument,       NULL, 'v' },
+      { NULL, 0, NULL, 0 }
+   };
+
+   while((c = getopt_long(argc, argv, short_opt, long_opt, &opt_index)) != -1)
+   {  switch(c)
+      {  case -1:       /* no more arguments */
+         case 0:        /* long options toggles */
+            break;
+
+         case 'h':
+            printf("Usage: %s [OPTIONS]\n", PROGRAM_NAME);
+            printf("OPTIONS:\n");
+            printf("  -h, --help                print this help and exit\n");
+            printf("  -q, --quiet, --silent     do not print messages\n");
+            printf("  -V, --version             print version number and exit\n");
+            printf("  -v, --verbose             print verbose messages\n");
+            printf("\n");
+            return(0);
+
+         case 'q':
+            quiet++;
+            break;
+
+         case 'V':
+            printf("%s (%s) %s\n", PROGRAM_NAME, PACKAGE_NAME, PACKAGE_VERSION);
+            printf("Written by David M. Syzdek.\n");
+            return(0);
+
+         case 'v':
+            verbose++;
+            break;
+
+         case '?':
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+
+         default:
+            fprintf(stderr, "%s: unrecognized option `--%c'\n", PROGRAM_NAME, c);
+            fprintf(stderr, "Try `%s --help' for more information.\n", PROGRAM_NAME);
+            return(1);
+      };
+   };
+
+   errs = 0;
+
+   // subnets of known networks
+   for(idx = 0; ((my_tests[idx].net)); idx++)
+      if ((my_test(&my_tests[idx])))
+         errs++;
+
+   // subnets of large networks are streamed in order
+   errs += (size_t)my_stream("2001:db8::/32", 48, 65536);
+   errs += (size_t)my_stream("10.0.0.0/8",    32, 16777216);
+
+   if (!(quiet))
+      printf("%zu errors\n", errs);
+
+   return( ((errs)) ? 1 : 0 );
+}
+
+
+// verifies each subnet follows the previous subnet
+int
+my_stream(
+         const char *                  address,
+         int                           cidr,
+         uint64_t                      count )
+{
+   int                        rc;
+   uint64_t                   idx;
+   uint64_t                   dist;
+   netcalc_net_t *            net;
+   netcalc_net_t *            prev;
+   netcalc_subnet_iter_t *    iter;
+
+   if ((rc = netcalc_net_init(&net, address, 0)) != 0)
+   {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, address, netcalc_strerror(rc));
+      return(1);
+   };
+   rc = netcalc_subnet_iter_init(&iter, net, cidr);
+   netcalc_net_free(net);
+   if (rc != 0)
+   {  fprintf(stderr, "%s: netcalc_subnet_iter_init(): %s\n", PROGRAM_NAME, netcalc_strerror(rc));
+      return(1);
+   };
+
+   if ((verbose))
+      printf("%s/%i: streaming %llu subnets\n", address, cidr, (unsigned long long)count);
+
+   prev = NULL;
+   for(idx = 0; ((rc = netcalc_subnet_iter_next(iter, &net)) == 0); idx++)
+   {  if ((prev))
+      {  if ( ((netcalc_net_distance(prev, net, &dist))) || (dist != 1) || (netcalc_net_cmp(prev, net, NETCALC_FLG_NETWORK) != NETCALC_CMP_BEFORE) )
+         {  if (!(quiet))
+               printf("%s/%i: subnet %llu does not follow previous subnet\n", address, cidr, (unsigned long long)idx);
+            rc = 1;
+            netcalc_net_free(net);
+            break;
+         };
+         netcalc_net_free(prev);
+      };
+      prev = net;
+   };
+   if ((prev))
+      netcalc_net_free(prev);
+   netcalc_subnet_iter_free(iter);
+
+   if (rc == 1)
+      return(1);
+   if (idx != count)
+   {  if (!(quiet))
+         printf("%s/%i: returned %llu subnets; expected %llu\n", address, cidr, (unsigned long long)idx, (unsigned long long)count);
+      return(1);
+   };
+
+   return(0);
+}
+
+
+// compares subnets of network with expected subnets
+int
+my_test(
+         const my_test_t *             test )
+{
+   int                        rc;
+   int                        err;
+   size_t                     idx;
+   netcalc_net_t *            net;
+   netcalc_net_t *            subnet;
+   netcalc_subnet_iter_t *    iter;
+   char                       str[128];
+
+   if ((rc = netcalc_net_init(&net, test->net, 0)) != 0)
+   {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, test->net, netcalc_strerror(rc));
+      return(1);
+   };
+   rc = netcalc_subnet_iter_init(&iter, net, test->cidr);
+   netcalc_net_free(net);
+   if (rc != test->rc)
+   {  if (!(quiet))
+         printf("%s into /%i: returned %s; expected %s\n", test->net, test->cidr, netcalc_strerror(rc), netcalc_strerror(test->rc));
+      if (rc == 0)
+         netcalc_subnet_iter_free(iter);
+      return(1);
+   };
+   if (rc != 0)
+      return(0);
+
+   err = 0;
+   for(idx = 0; ( (!(err)) && ((rc = netcalc_subnet_iter_next(iter, &subnet)) == 0) ); idx++)
+   {  netcalc_strfnet(subnet, str, sizeof(str), "%A", 0);
+      if (!(test->subnets[idx]))
+         err = 1;
+      else if ((rc = netcalc_net_init(&net, test->subnets[idx], 0)) != 0)
+         err = 1;
+      else
+      {  err = (netcalc_net_cmp(subnet, net, NETCALC_FLG_NETWORK) == NETCALC_CMP_SAME) ? 0 : 1;
+         netcalc_net_free(net);
+      };
+      if ( ((err)) && (!(quiet)) )
+         printf("%s into /%i: subnet %zu: returned %s; expected %s\n", test->net, test->cidr, idx, str, ((test->subnets[idx])) ? test->subnets[idx] : "end of subnets");
+      if ( (!(err)) && ((verbose)) )
+         printf("%s into /%i: subnet %zu: %s\n", test->net, test->cidr, idx, str);
+      netcalc_net_free(subnet);
+   };
+   if ( (!(err)) && ((test->subnets[idx])) )
+   {  if (!(quiet))
+         printf("%s into /%i: returned %zu subnets; expected %s\n", test->net, test->cidr, idx, test->subnets[idx]);
+      err = 1;
+   };
+
+   // iterator remains at end of subnets
+   if ( (!(err)) && (netcalc_subnet_iter_next(iter, &subnet) != NETCALC_ENOREC) )
+      err = 1;
+
+   netcalc_subnet_iter_free(iter);
+
+   return(err);
+}
+
+
+/* end of source */